@@ -0,0 +1,142 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "artifact_store.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "logger.hpp"
+
+namespace
+{
+    const uint64_t magic = 0x3146524143484346; // "FCHCARF1"
+}
+
+artifact_store::artifact_store()
+{
+    _mesh_hash = 0;
+    _hits = 0;
+    _misses = 0;
+}
+
+void artifact_store::open(const std::string& dir, uint64_t mesh_hash)
+{
+    _dir = dir;
+    _mesh_hash = mesh_hash;
+
+    boost::filesystem::create_directories(_dir);
+
+    LOG_DEBUG << "Module artifacts are cached in " << _dir;
+}
+
+std::string artifact_store::path(const std::string& module, const std::string& name, const pt::ptree& cfg) const
+{
+    std::stringstream json;
+    pt::write_json(json, cfg, false);
+
+    content_hash h;
+    h.add(_mesh_hash);
+    h.add(module);
+    h.add(name);
+    h.add(json.str());
+
+    std::stringstream ss;
+    ss << module << "_" << name << "_" << std::hex << std::setw(16) << std::setfill('0') << h.value() << ".bin";
+
+    return (boost::filesystem::path(_dir) / ss.str()).string();
+}
+
+bool artifact_store::load(const std::string& module, const std::string& name, const pt::ptree& cfg,
+                          std::vector<double>& values, size_t n)
+{
+    if (!enabled())
+        return false;
+
+    auto file = path(module, name, cfg);
+    std::ifstream in(file, std::ios::binary);
+
+    uint64_t m = 0;
+    uint64_t count = 0;
+    if (in)
+    {
+        in.read(reinterpret_cast<char*>(&m), sizeof(m));
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    }
+
+    if (!in || m != magic || count != n)
+    {
+        LOG_DEBUG << "Artifact " << module << "." << name << " missed";
+        _misses++;
+        return false;
+    }
+
+    values.resize(n);
+    in.read(reinterpret_cast<char*>(values.data()), n * sizeof(double));
+
+    if (!in)
+    {
+        LOG_WARNING << "Artifact " << file << " is truncated, computing it again";
+        _misses++;
+        return false;
+    }
+
+    LOG_DEBUG << "Artifact " << module << "." << name << " loaded from " << file;
+    _hits++;
+    return true;
+}
+
+void artifact_store::save(const std::string& module, const std::string& name, const pt::ptree& cfg,
+                          const std::vector<double>& values)
+{
+    if (!enabled())
+        return;
+
+    auto file = path(module, name, cfg);
+
+    // written to the side and moved into place, so that concurrent runs never see a partial artifact
+    auto tmp = file + "." + boost::filesystem::unique_path().string();
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+
+        uint64_t count = values.size();
+        out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+
+        if (!out)
+        {
+            LOG_WARNING << "Unable to write artifact " << file;
+            out.close();
+            boost::filesystem::remove(tmp);
+            return;
+        }
+    }
+
+    boost::filesystem::rename(tmp, file);
+    LOG_DEBUG << "Artifact " << module << "." << name << " saved to " << file;
+}
@@ -0,0 +1,140 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace pt = boost::property_tree;
+
+/**
+ * 64 bit FNV-1a hash, built up incrementally from the things a key depends on
+ */
+class content_hash
+{
+public:
+    content_hash()
+            : _hash(14695981039346656037ULL)
+    {
+    }
+
+    void add(const void* data, size_t n)
+    {
+        auto p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; i++)
+        {
+            _hash ^= p[i];
+            _hash *= 1099511628211ULL;
+        }
+    }
+
+    void add(const std::string& s)
+    {
+        add(s.data(), s.size());
+    }
+
+    void add(double d)
+    {
+        add(&d, sizeof(d));
+    }
+
+    void add(uint64_t i)
+    {
+        add(&i, sizeof(i));
+    }
+
+    uint64_t value() const
+    {
+        return _hash;
+    }
+
+private:
+    uint64_t _hash;
+};
+
+/**
+ * Directory of the fields that modules compute in init from the terrain alone, e.g., the sky-view factor,
+ * so that later runs on the same mesh can load them instead of computing them again.
+ *
+ * An artifact is keyed by the mesh (geometry and parameters), the module, the artifact's name and the module's config,
+ * so changing any of these computes it again. The store is disabled unless a directory is given, in which case
+ * load always misses and save does nothing, so modules don't need to check.
+ */
+class artifact_store
+{
+public:
+    artifact_store();
+
+    /**
+     * Enables the store
+     * @param dir Directory of the artifacts, created if it doesn't exist
+     * @param mesh_hash Hash of the mesh the artifacts are computed from, see triangulation::hash
+     */
+    void open(const std::string& dir, uint64_t mesh_hash);
+
+    bool enabled() const
+    {
+        return !_dir.empty();
+    }
+
+    /**
+     * Loads an artifact
+     * @param module ID of the module
+     * @param name Name of the artifact
+     * @param cfg Config the artifact depends on, usually the module's
+     * @param values Loaded values
+     * @param n Expected number of values, a stored artifact of a different size is a miss
+     * @return True if the artifact was loaded
+     */
+    bool load(const std::string& module, const std::string& name, const pt::ptree& cfg, std::vector<double>& values, size_t n);
+
+    /**
+     * Stores an artifact, replacing any with the same key
+     */
+    void save(const std::string& module, const std::string& name, const pt::ptree& cfg, const std::vector<double>& values);
+
+    size_t hits() const
+    {
+        return _hits;
+    }
+
+    size_t misses() const
+    {
+        return _misses;
+    }
+
+private:
+    std::string _dir;
+    uint64_t _mesh_hash;
+
+    size_t _hits;
+    size_t _misses;
+
+    // file of the artifact
+    std::string path(const std::string& module, const std::string& name, const pt::ptree& cfg) const;
+};
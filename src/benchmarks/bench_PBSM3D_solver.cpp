@@ -0,0 +1,213 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include <viennacl/compressed_matrix.hpp>
+#include <viennacl/linalg/gmres.hpp>
+#include <viennacl/linalg/ilu.hpp>
+
+#include "synthetic.hpp"
+#include "math/column_operator.hpp"
+
+// A PBSM3D suspension layer system over a synthetic mesh: upwinded advection by a uniform wind that increases with
+// height, settling, strong vertical and very weak lateral diffusion, and a saltation source under every face.
+// Assembled the way PBSM3D::run does, into the column operator of the line solver.
+static const size_t nLayer = 5;
+
+static math::column_operator make_suspension(mesh& m, std::vector<double>& b)
+{
+    size_t ntri = m->size_faces();
+    double h = 5.0 / nLayer; // prism height
+    double w = 0.5;          // settling velocity
+    double K_lat = 0.00001;
+
+    math::column_operator op(ntri, nLayer);
+    b.assign(ntri * nLayer, 0.);
+
+#pragma omp parallel for
+    for (size_t i = 0; i < ntri; i++)
+    {
+        auto face = m->face(i);
+
+        std::array<int, 3> neighbours;
+        for (int f = 0; f < 3; f++)
+        {
+            auto neigh = face->neighbor(f);
+            neighbours[f] = neigh == nullptr || neigh->_is_ghost ? -1 : neigh->cell_local_id;
+        }
+        op.set_neighbours(i, neighbours);
+
+        double area = face->get_area();
+
+        for (size_t z = 0; z < nLayer; z++)
+        {
+            double cz = z * h + h / 2.;
+            double u_z = 2 + std::log(1 + cz);
+            double K = 0.4 * 0.3 * cz; // kappa u* z
+
+            double C_ii = 0;
+            for (int f = 0; f < 3; f++)
+            {
+                double A = face->edge_length(f) * h;
+                double udotm = u_z * face->edge_unit_normal(f).x(); // wind along x
+                double alpha = A * K_lat;
+
+                if (neighbours[f] < 0)
+                {
+                    C_ii += -0.1e-1 * alpha - A * udotm;
+                    continue;
+                }
+
+                if (udotm > 0)
+                {
+                    C_ii += -A * udotm - alpha;
+                    op.lateral(i, z, f) = alpha;
+                }
+                else
+                {
+                    C_ii += -alpha;
+                    op.lateral(i, z, f) = -A * udotm + alpha;
+                }
+            }
+
+            // settling is downward, so the top face has udotm = -w and the bottom +w
+            double alpha_v = area * K / h;
+            if (z + 1 < nLayer)
+            {
+                C_ii += -alpha_v;
+                op.up(i, z) = area * w + alpha_v;
+            }
+            else
+            {
+                C_ii += -alpha_v;
+            }
+
+            if (z > 0)
+            {
+                C_ii += -area * w - alpha_v;
+                op.down(i, z) = alpha_v;
+            }
+            else
+            {
+                // saltation layer under the bottom prism
+                double alpha4 = area * K / h;
+                C_ii += -area * w - alpha4;
+                b[i] = -alpha4 * 0.01;
+            }
+
+            op.diag(i, z) = C_ii;
+        }
+    }
+
+    return op;
+}
+
+// The same system as a compressed_matrix, as the ILUT path assembles it
+static void to_compressed(math::column_operator& op, mesh& m, viennacl::compressed_matrix<vcl_scalar_type>& C)
+{
+    size_t ntri = op.columns();
+    std::vector<std::map<unsigned int, vcl_scalar_type>> rows(op.size());
+
+#pragma omp parallel for
+    for (size_t i = 0; i < ntri; i++)
+    {
+        auto face = m->face(i);
+        for (size_t z = 0; z < nLayer; z++)
+        {
+            size_t idx = ntri * z + i;
+            rows[idx][idx] = op.diag(i, z);
+            if (z + 1 < nLayer)
+                rows[idx][idx + ntri] = op.up(i, z);
+            if (z > 0)
+                rows[idx][idx - ntri] = op.down(i, z);
+
+            for (int f = 0; f < 3; f++)
+            {
+                auto neigh = face->neighbor(f);
+                if (neigh != nullptr && !neigh->_is_ghost)
+                    rows[idx][ntri * z + neigh->cell_local_id] = op.lateral(i, z, f);
+            }
+        }
+    }
+
+    viennacl::copy(rows, C);
+}
+
+// One steady-state suspension solve per iteration, as per PBSM3D timestep. The preconditioner is rebuilt each time,
+// as the coefficients change every timestep.
+static void BM_PBSM3D_suspension_ilut(benchmark::State& state)
+{
+    auto m = synthetic::make_mesh(state.range(0));
+
+    std::vector<double> b_host;
+    auto op = make_suspension(m, b_host);
+
+    viennacl::compressed_matrix<vcl_scalar_type> C;
+    to_compressed(op, m, C);
+
+    std::vector<vcl_scalar_type> b_vcl(b_host.begin(), b_host.end());
+    viennacl::vector<vcl_scalar_type> b(b_vcl.size());
+    viennacl::copy(b_vcl, b);
+
+    size_t iters = 0;
+    for (auto _ : state)
+    {
+        viennacl::linalg::ilut_precond<viennacl::compressed_matrix<vcl_scalar_type>> ilut(
+                C, viennacl::linalg::ilut_tag(20, 1e-4));
+        viennacl::linalg::gmres_tag gmres(1e-8, 1000, 30);
+
+        viennacl::vector<vcl_scalar_type> x = viennacl::linalg::solve(C, b, gmres, ilut);
+        benchmark::DoNotOptimize(x);
+        iters = gmres.iters();
+    }
+
+    state.counters["faces"] = m->size_faces();
+    state.counters["gmres_iterations"] = iters;
+}
+BENCHMARK(BM_PBSM3D_suspension_ilut)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces())->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_PBSM3D_suspension_line(benchmark::State& state)
+{
+    auto m = synthetic::make_mesh(state.range(0));
+
+    std::vector<double> b;
+    auto op = make_suspension(m, b);
+
+    size_t iters = 0;
+    for (auto _ : state)
+    {
+        std::vector<double> x;
+        iters = op.solve(b, x, 1e-8, 1000, 30);
+        benchmark::DoNotOptimize(x);
+    }
+
+    state.counters["faces"] = m->size_faces();
+    state.counters["gmres_iterations"] = iters;
+}
+BENCHMARK(BM_PBSM3D_suspension_line)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces())->UseRealTime()->Unit(benchmark::kMillisecond);
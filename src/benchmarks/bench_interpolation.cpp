@@ -0,0 +1,77 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "interpolation.hpp"
+
+static std::vector< boost::tuple<double,double,double> > make_samples(size_t n)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> xy(0.0, 10000.0);
+    std::normal_distribution<double> value(0.0, 5.0);
+
+    std::vector< boost::tuple<double,double,double> > samples;
+    for(size_t i = 0; i < n; i++)
+        samples.push_back(boost::make_tuple(xy(gen), xy(gen), value(gen)));
+
+    return samples;
+}
+
+// One spatial interpolation, as done per face per variable per timestep by the interp_met modules.
+// The interpolant is created once and reused, as the modules do.
+static void interpolate(benchmark::State& state, interp_alg alg)
+{
+    size_t n = state.range(0);
+    auto samples = make_samples(n);
+    auto query = boost::make_tuple(5000.0, 5000.0, 0.0);
+
+    interpolation interp(alg, n);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(interp(samples, query));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_interpolation_tpspline(benchmark::State& state)
+{
+    interpolate(state, interp_alg::tpspline);
+}
+BENCHMARK(BM_interpolation_tpspline)->RangeMultiplier(2)->Range(4, 64);
+
+static void BM_interpolation_idw(benchmark::State& state)
+{
+    interpolate(state, interp_alg::idw);
+}
+BENCHMARK(BM_interpolation_idw)->RangeMultiplier(2)->Range(4, 64);
+
+static void BM_interpolation_nearest(benchmark::State& state)
+{
+    interpolate(state, interp_alg::nearest_sta);
+}
+BENCHMARK(BM_interpolation_nearest)->RangeMultiplier(2)->Range(4, 64);
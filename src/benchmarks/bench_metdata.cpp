@@ -0,0 +1,92 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <boost/filesystem.hpp>
+
+#include "synthetic.hpp"
+#include "timeseries.hpp"
+
+static const boost::posix_time::ptime start = boost::posix_time::from_iso_string("20171001T000000");
+
+// Parsing an ascii forcing file
+static void BM_timeseries_open(benchmark::State& state)
+{
+    size_t nsteps = state.range(0);
+    auto path = (boost::filesystem::path(synthetic::tmp_dir()) / ("open_" + std::to_string(nsteps) + ".txt")).string();
+    synthetic::write_forcing(path, start, nsteps, boost::posix_time::hours(1), 0);
+
+    for (auto _ : state)
+    {
+        timeseries ts;
+        ts.open(path);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * nsteps);
+}
+BENCHMARK(BM_timeseries_open)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+
+// Filling all the stations with a timestep of ascii forcing
+static void metdata_next(benchmark::State& state, boost::posix_time::time_duration forcing_dt, boost::posix_time::time_duration model_dt)
+{
+    size_t nstations = state.range(0);
+    const size_t nsteps = 2000;
+
+    auto dir = boost::filesystem::path(synthetic::tmp_dir()) / ("stations_" + std::to_string(nstations) + "_" + std::to_string(forcing_dt.total_seconds()));
+    boost::filesystem::create_directories(dir);
+    auto stations = synthetic::make_stations(nstations, synthetic::min_faces, dir.string(), start, nsteps, forcing_dt);
+
+    metdata md(synthetic::proj4);
+    md.load_from_ascii(stations, 0);
+    md.set_model_dt(model_dt, 0);
+    md.subset(md.start_time(), md.end_time());
+
+    size_t timesteps = 0;
+    for (auto _ : state)
+    {
+        if(!md.next())
+        {
+            state.PauseTiming();
+            md.subset(md.start_time(), md.end_time());
+            state.ResumeTiming();
+            md.next();
+        }
+        timesteps++;
+    }
+
+    state.counters["station_timesteps_per_second"] = benchmark::Counter(timesteps * nstations, benchmark::Counter::kIsRate);
+}
+
+static void BM_metdata_next_ascii(benchmark::State& state)
+{
+    metdata_next(state, boost::posix_time::hours(1), boost::posix_time::hours(1));
+}
+BENCHMARK(BM_metdata_next_ascii)->RangeMultiplier(10)->Range(1, 1000);
+
+// 3 hourly forcing interpolated to the hourly model timestep
+static void BM_metdata_next_ascii_interpolated(benchmark::State& state)
+{
+    metdata_next(state, boost::posix_time::hours(3), boost::posix_time::hours(1));
+}
+BENCHMARK(BM_metdata_next_ascii_interpolated)->RangeMultiplier(10)->Range(1, 1000);
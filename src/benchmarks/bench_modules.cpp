@@ -0,0 +1,74 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "synthetic.hpp"
+#include "module_base.hpp"
+
+// Runs a data parallel module over every face of a synthetic mesh, one iteration being one model timestep.
+// Reports faces*timesteps per second, the headline throughput number of the model.
+static void run_module(benchmark::State& state, const std::string& name)
+{
+    auto m = synthetic::make_mesh(state.range(0));
+
+    pt::ptree cfg;
+    auto module = module_factory::create(name, cfg);
+    module->global_param = boost::make_shared<global>();
+
+    // the module's variables plus the synthetic forcing
+    std::set<std::string> variables = {"t", "rh", "p", "u"};
+    for(auto& v : *module->provides())
+        variables.insert(v.name);
+    std::set<std::string> vectors;
+    std::set<std::string> module_data = {module->ID};
+    m->init_face_data(variables, vectors, module_data);
+    synthetic::fill_forcing(m);
+
+    module->init(m);
+
+    for (auto _ : state)
+    {
+        #pragma omp parallel for
+        for(size_t i = 0; i < m->size_faces(); i++)
+        {
+            auto f = m->face(i);
+            module->run(f);
+        }
+    }
+
+    state.counters["faces_timesteps_per_second"] = benchmark::Counter(state.iterations() * m->size_faces(), benchmark::Counter::kIsRate);
+    state.counters["faces"] = m->size_faces();
+}
+
+static void BM_module_Harder_precip_phase(benchmark::State& state)
+{
+    run_module(state, "Harder_precip_phase");
+}
+BENCHMARK(BM_module_Harder_precip_phase)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces())->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_module_threshold_p_phase(benchmark::State& state)
+{
+    run_module(state, "threshold_p_phase");
+}
+BENCHMARK(BM_module_threshold_p_phase)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces())->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,116 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "sno_batch.hpp"
+
+using namespace snobalMacros;
+
+// Turbulent fluxes for a block of points with random stabilities, per point with sno::hle1 and lane-wise with sno_batch::hle1.
+// sno::hle1 includes its input checks, which sno_batch does while gathering the lanes.
+struct hle1_inputs
+{
+    explicit hle1_inputs(size_t n)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> t(-20., 5.);
+        std::uniform_real_distribution<double> dt(-10., 5.);
+        std::uniform_real_distribution<double> w(0.5, 10.);
+
+        for(size_t i = 0; i < n; i++)
+        {
+            ta.push_back(t(gen) + FREEZE);
+            ts.push_back(std::min(ta.back() + dt(gen), FREEZE));
+            u.push_back(w(gen));
+        }
+    }
+
+    void fill(sno& s, sno_batch& batch)
+    {
+        for(size_t l = 0; l < ta.size(); l++)
+        {
+            batch.press[l] = 80000.;
+            batch.ta[l] = ta[l];
+            batch.ts[l] = ts[l];
+            batch.za[l] = 2.;
+            batch.ea[l] = s.sati(ta[l]) * 0.6;
+            batch.es[l] = s.sati(ts[l]);
+            batch.zq[l] = 2.;
+            batch.u[l] = u[l];
+            batch.zu[l] = 3.;
+            batch.z0[l] = 0.001;
+        }
+    }
+
+    std::vector<double> ta, ts, u;
+};
+
+static void BM_snobal_hle1(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    hle1_inputs in(n);
+    sno s;
+    sno_batch batch;
+    batch.resize(n);
+    in.fill(s, batch);
+
+    for (auto _ : state)
+    {
+        for(size_t l = 0; l < n; l++)
+        {
+            double h, le, e;
+            s.hle1(batch.press[l], batch.ta[l], batch.ts[l], batch.za[l], batch.ea[l], batch.es[l],
+                   batch.zq[l], batch.u[l], batch.zu[l], batch.z0[l], &h, &le, &e);
+            benchmark::DoNotOptimize(h);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_snobal_hle1)->Arg(64)->Arg(4096);
+
+static void BM_snobal_hle1_batch(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    hle1_inputs in(n);
+    sno s;
+    sno_batch batch;
+    batch.resize(n);
+
+    for (auto _ : state)
+    {
+        // hle1 converts ta in place
+        state.PauseTiming();
+        in.fill(s, batch);
+        state.ResumeTiming();
+
+        batch.hle1(n);
+        benchmark::DoNotOptimize(batch.h.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_snobal_hle1_batch)->Arg(64)->Arg(4096);
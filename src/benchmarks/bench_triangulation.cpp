@@ -0,0 +1,109 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "synthetic.hpp"
+
+// random query points inside the mesh
+static std::vector<Point_2> make_queries(mesh& m, size_t n)
+{
+    auto bbox = m->bounding_box();
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> x(bbox.xmin(), bbox.xmax());
+    std::uniform_real_distribution<double> y(bbox.ymin(), bbox.ymax());
+
+    std::vector<Point_2> queries;
+    for(size_t i = 0; i < n; i++)
+        queries.emplace_back(x(gen), y(gen));
+
+    return queries;
+}
+
+static void BM_triangulation_from_json(benchmark::State& state)
+{
+    size_t n = std::sqrt(state.range(0) / 2.0);
+    auto json = synthetic::mesh_json(n, n);
+
+    for (auto _ : state)
+    {
+        triangulation m;
+        m.from_json(json);
+        benchmark::DoNotOptimize(m.size_faces());
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * n * n);
+}
+BENCHMARK(BM_triangulation_from_json)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces())->Unit(benchmark::kMillisecond);
+
+static void BM_triangulation_find_closest_face(benchmark::State& state)
+{
+    auto m = synthetic::make_mesh(state.range(0));
+    auto queries = make_queries(m, 4096);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(m->find_closest_face(queries[i++ % queries.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_triangulation_find_closest_face)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces());
+
+static void BM_triangulation_locate_face(benchmark::State& state)
+{
+    auto m = synthetic::make_mesh(state.range(0));
+    auto queries = make_queries(m, 4096);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(m->locate_face(queries[i++ % queries.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_triangulation_locate_face)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces());
+
+// Sweep over every face reading its geometry, as the modules do in init and some in run
+static void BM_triangulation_face_geometry_sweep(benchmark::State& state)
+{
+    auto m = synthetic::make_mesh(state.range(0));
+
+    for (auto _ : state)
+    {
+        double sum = 0;
+        #pragma omp parallel for reduction(+:sum)
+        for(size_t i = 0; i < m->size_faces(); i++)
+        {
+            auto f = m->face(i);
+            sum += f->slope() + f->aspect() + f->get_area() + f->center().z();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * m->size_faces());
+}
+BENCHMARK(BM_triangulation_face_geometry_sweep)->RangeMultiplier(10)->Range(synthetic::min_faces, synthetic::max_faces())->UseRealTime();
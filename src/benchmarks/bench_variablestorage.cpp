@@ -0,0 +1,88 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <set>
+#include <string>
+
+#include "variablestorage.hpp"
+
+static std::set<std::string> make_variables(size_t n)
+{
+    // the common forcing variables first so the lookups below always exist
+    std::set<std::string> variables = {"t", "rh", "p", "u", "vw_dir", "Qsi", "Qli"};
+    for(size_t i = variables.size(); i < n; i++)
+        variables.insert("var_" + std::to_string(i));
+
+    return variables;
+}
+
+// Construction builds the minimal perfect hash function, which happens for every face at init
+static void BM_variablestorage_init(benchmark::State& state)
+{
+    auto variables = make_variables(state.range(0));
+
+    for (auto _ : state)
+    {
+        variablestorage<double> v(variables);
+        benchmark::DoNotOptimize(v.size());
+    }
+}
+BENCHMARK(BM_variablestorage_init)->RangeMultiplier(4)->Range(8, 512);
+
+// The compile time hash path used by the modules, e.g., (*face)["t"_s]
+static void BM_variablestorage_lookup_hash(benchmark::State& state)
+{
+    auto variables = make_variables(state.range(0));
+    variablestorage<double> v(variables);
+
+    for (auto _ : state)
+    {
+        v["t"_s] += 1.0;
+        v["rh"_s] += 1.0;
+        v["p"_s] += 1.0;
+        v["Qsi"_s] += 1.0;
+        benchmark::DoNotOptimize(v["t"_s]);
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_variablestorage_lookup_hash)->RangeMultiplier(4)->Range(8, 512);
+
+// The runtime string path used by metdata and output
+static void BM_variablestorage_lookup_string(benchmark::State& state)
+{
+    auto variables = make_variables(state.range(0));
+    variablestorage<double> v(variables);
+
+    const std::string names[4] = {"t", "rh", "p", "Qsi"};
+
+    for (auto _ : state)
+    {
+        for(auto& n : names)
+            v[n] += 1.0;
+        benchmark::DoNotOptimize(v["t"]);
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_variablestorage_lookup_string)->RangeMultiplier(4)->Range(8, 512);
@@ -0,0 +1,278 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "synthetic.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+
+#include <boost/filesystem.hpp>
+#include <ogr_spatialref.h>
+
+namespace synthetic
+{
+    // lower left corner of the synthetic domains
+    const double x0 = 500000.0;
+    const double y0 = 5650000.0;
+
+    // a few gaussian hills and some ripples so slope/aspect aren't trivial
+    static double terrain(double x, double y, double width, double height)
+    {
+        double z = 1000.0;
+
+        const double hills[3][3] = { {0.3, 0.3, 800.0},
+                                     {0.7, 0.6, 1200.0},
+                                     {0.4, 0.8, 500.0} };
+        double s = 0.15 * std::max(width, height);
+        for(auto& h : hills)
+        {
+            double dx = x - h[0] * width;
+            double dy = y - h[1] * height;
+            z += h[2] * std::exp(-(dx * dx + dy * dy) / (2 * s * s));
+        }
+
+        z += 10.0 * std::sin(x / 90.0) * std::cos(y / 120.0);
+
+        return z;
+    }
+
+    static pt::ptree value(double v)
+    {
+        pt::ptree node;
+        node.put("", v);
+        return node;
+    }
+
+    template<typename T>
+    static pt::ptree triple(T a, T b, T c)
+    {
+        pt::ptree node;
+        node.push_back(std::make_pair("", value(a)));
+        node.push_back(std::make_pair("", value(b)));
+        node.push_back(std::make_pair("", value(c)));
+        return node;
+    }
+
+    pt::ptree mesh_json(size_t nx, size_t ny, double dx)
+    {
+        pt::ptree json;
+
+        double width = nx * dx;
+        double height = ny * dx;
+
+        auto vid = [&](size_t i, size_t j) -> int
+        {
+            return static_cast<int>(j * (nx + 1) + i);
+        };
+
+        // two triangles per cell, the lower left (0) and upper right (1)
+        auto fid = [&](long i, long j, int which) -> int
+        {
+            if(i < 0 || j < 0 || i >= static_cast<long>(nx) || j >= static_cast<long>(ny))
+                return -1;
+            return static_cast<int>(2 * (j * nx + i) + which);
+        };
+
+        pt::ptree vertex;
+        for(size_t j = 0; j <= ny; j++)
+        {
+            for(size_t i = 0; i <= nx; i++)
+            {
+                double x = i * dx;
+                double y = j * dx;
+                vertex.push_back(std::make_pair("", triple(x0 + x, y0 + y, terrain(x, y, width, height))));
+            }
+        }
+
+        // vertexes are counter clockwise, neighbour k is opposite vertex k
+        pt::ptree elem;
+        pt::ptree neigh;
+        for(size_t j = 0; j < ny; j++)
+        {
+            for(size_t i = 0; i < nx; i++)
+            {
+                long li = i;
+                long lj = j;
+
+                elem.push_back(std::make_pair("", triple(vid(i, j), vid(i + 1, j), vid(i, j + 1))));
+                neigh.push_back(std::make_pair("", triple(fid(li, lj, 1), fid(li - 1, lj, 1), fid(li, lj - 1, 1))));
+
+                elem.push_back(std::make_pair("", triple(vid(i + 1, j), vid(i + 1, j + 1), vid(i, j + 1))));
+                neigh.push_back(std::make_pair("", triple(fid(li, lj + 1, 0), fid(li, lj, 0), fid(li + 1, lj, 0))));
+            }
+        }
+
+        json.put("mesh.nvertex", (nx + 1) * (ny + 1));
+        json.put("mesh.nelem", 2 * nx * ny);
+        json.put("mesh.is_geographic", 0);
+        json.put("mesh.proj4", proj4);
+        json.add_child("mesh.vertex", vertex);
+        json.add_child("mesh.elem", elem);
+        json.add_child("mesh.neigh", neigh);
+
+        return json;
+    }
+
+    mesh make_mesh(size_t nfaces)
+    {
+        static std::map<size_t, mesh> cache;
+
+        auto itr = cache.find(nfaces);
+        if(itr != cache.end())
+            return itr->second;
+
+        size_t n = std::max<size_t>(1, static_cast<size_t>(std::sqrt(nfaces / 2.0)));
+
+        auto json = mesh_json(n, n);
+        auto m = boost::make_shared<triangulation>();
+        m->from_json(json);
+
+        std::set<std::string> variables = {"t", "rh", "p", "u"};
+        m->init_timeseries(variables);
+        fill_forcing(m);
+
+        cache[nfaces] = m;
+        return m;
+    }
+
+    void fill_forcing(mesh& m)
+    {
+        #pragma omp parallel for
+        for(size_t i = 0; i < m->size_faces(); i++)
+        {
+            auto f = m->face(i);
+            double z = f->get_z();
+
+            (*f)["t"_s] = 5.0 - 0.0065 * (z - 1000.0);
+            (*f)["rh"_s] = 60.0 + 20.0 * std::sin(f->get_x() / 500.0);
+            (*f)["p"_s] = std::max(0.0, std::cos(f->get_y() / 700.0));
+            (*f)["u"_s] = 2.0 + std::fabs(std::sin(z));
+        }
+    }
+
+    void write_forcing(const std::string& path, boost::posix_time::ptime start, size_t nsteps,
+                       boost::posix_time::time_duration dt, unsigned int seed)
+    {
+        std::mt19937 gen(seed);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        std::ofstream out(path);
+        out << "datetime\tt\trh\tu\tvw_dir\tp\tQsi\tQli\n";
+
+        double offset = 2.0 * noise(gen);
+        bool storm = false;
+
+        auto t = start;
+        for(size_t i = 0; i < nsteps; i++, t += dt)
+        {
+            double hour = t.time_of_day().total_seconds() / 3600.0;
+            double day = 2.0 * M_PI * (hour - 9.0) / 24.0;
+
+            // storms start and stop at random
+            if(uniform(gen) < (storm ? 0.2 : 0.05))
+                storm = !storm;
+
+            double temp = -5.0 + offset + 8.0 * std::sin(day) + 0.5 * noise(gen);
+            double rh = std::min(100.0, std::max(10.0, 70.0 - 20.0 * std::sin(day) + (storm ? 20.0 : 0.0) + 2.0 * noise(gen)));
+            double u = std::max(0.0, 3.0 + (storm ? 4.0 : 0.0) + noise(gen));
+            double vw_dir = 360.0 * uniform(gen);
+            double p = storm ? std::fabs(noise(gen)) : 0.0;
+            double qsi = std::max(0.0, 800.0 * std::sin(M_PI * (hour - 6.0) / 12.0)) * (storm ? 0.3 : 1.0);
+            double qli = 250.0 + (storm ? 60.0 : 0.0) + 5.0 * noise(gen);
+
+            out << boost::posix_time::to_iso_string(t) << "\t"
+                << temp << "\t" << rh << "\t" << u << "\t" << vw_dir << "\t"
+                << p << "\t" << qsi << "\t" << qli << "\n";
+        }
+    }
+
+    std::vector<metdata::ascii_metdata> make_stations(size_t nstations, size_t nfaces, const std::string& dir,
+                                                      boost::posix_time::ptime start, size_t nsteps,
+                                                      boost::posix_time::time_duration dt)
+    {
+        // same extent as make_mesh
+        size_t n = std::max<size_t>(1, static_cast<size_t>(std::sqrt(nfaces / 2.0)));
+        double extent = n * 30.0;
+
+        OGRSpatialReference utm, geo;
+        utm.importFromProj4(proj4.c_str());
+        geo.SetWellKnownGeogCS("WGS84");
+        OGRCoordinateTransformation* coordTrans = OGRCreateCoordinateTransformation(&utm, &geo);
+
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        std::vector<metdata::ascii_metdata> stations;
+        for(size_t i = 0; i < nstations; i++)
+        {
+            metdata::ascii_metdata s;
+            s.id = "station" + std::to_string(i);
+            s.path = (boost::filesystem::path(dir) / (s.id + ".txt")).string();
+
+            double x = x0 + extent * uniform(gen);
+            double y = y0 + extent * uniform(gen);
+            s.elevation = terrain(x - x0, y - y0, extent, extent);
+
+            coordTrans->Transform(1, &x, &y);
+            s.longitude = x;
+            s.latitude = y;
+
+            write_forcing(s.path, start, nsteps, dt, i);
+            stations.push_back(s);
+        }
+
+        delete coordTrans;
+        return stations;
+    }
+
+    std::string tmp_dir()
+    {
+        struct tmp_dir_remover
+        {
+            boost::filesystem::path path;
+            ~tmp_dir_remover()
+            {
+                boost::system::error_code ec;
+                boost::filesystem::remove_all(path, ec);
+            }
+        };
+
+        static tmp_dir_remover dir{boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("chm-bench-%%%%-%%%%")};
+        boost::filesystem::create_directories(dir.path);
+
+        return dir.path.string();
+    }
+
+    size_t max_faces()
+    {
+        const char* env = std::getenv("CHM_BENCH_MAX_FACES");
+        if(env)
+            return std::strtoull(env, nullptr, 10);
+
+        return 1000000;
+    }
+}
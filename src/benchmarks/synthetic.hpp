@@ -0,0 +1,101 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "triangulation.hpp"
+#include "metdata.hpp"
+
+namespace pt = boost::property_tree;
+
+/**
+ * Synthetic meshes and forcing for the benchmarks so that domains of any size can be produced without external data.
+ */
+namespace synthetic
+{
+    /// UTM 11N, roughly the Canadian Rockies
+    const std::string proj4 = "+proj=utm +zone=11 +ellps=GRS80 +towgs84=0,0,0,0,0,0,0 +units=m +no_defs";
+
+    /**
+     * Builds the .mesh json for a regular nx by ny grid of cells of size dx (m), each split into two triangles,
+     * over a smooth terrain of a few hills. This is the same representation as a .mesh file,
+     * so the mesh is loaded via triangulation::from_json exactly as a real one is.
+     * Memory is dominated by the ptree, roughly 1 kB per triangle.
+     * @param nx
+     * @param ny
+     * @param dx
+     * @return
+     */
+    pt::ptree mesh_json(size_t nx, size_t ny, double dx = 30.0);
+
+    /**
+     * Returns a mesh with approximately nfaces triangles. Meshes are cached so each size is only built once per process.
+     * The mesh has the "t", "rh", "p", "u" variables initialized and filled with smooth synthetic fields
+     * @param nfaces
+     * @return
+     */
+    mesh make_mesh(size_t nfaces);
+
+    /**
+     * Fills the "t", "rh", "p", "u" face variables with smooth synthetic fields, as if the interp_met modules had run
+     * @param m
+     */
+    void fill_forcing(mesh& m);
+
+    /**
+     * Writes an ascii forcing file of nsteps timesteps with diurnal cycles of t, rh, Qsi, Qli and occasional precipitation
+     * @param path
+     * @param start
+     * @param nsteps
+     * @param dt
+     * @param seed Varies the station's values
+     */
+    void write_forcing(const std::string& path, boost::posix_time::ptime start, size_t nsteps,
+                       boost::posix_time::time_duration dt, unsigned int seed);
+
+    /**
+     * Writes nstations forcing files into dir, with the stations randomly located over the extent of the mesh made by make_mesh(nfaces)
+     * @return The metdata description of the stations, ready for metdata::load_from_ascii
+     */
+    std::vector<metdata::ascii_metdata> make_stations(size_t nstations, size_t nfaces, const std::string& dir,
+                                                      boost::posix_time::ptime start, size_t nsteps,
+                                                      boost::posix_time::time_duration dt);
+
+    /**
+     * Temporary directory for the generated files. Removed at exit.
+     * @return
+     */
+    std::string tmp_dir();
+
+    /// Largest mesh to benchmark, from the CHM_BENCH_MAX_FACES environment variable. Default 1e6.
+    size_t max_faces();
+
+    /// Smallest mesh to benchmark
+    const size_t min_faces = 10000;
+}
@@ -38,12 +38,31 @@ core::core()
     _use_netcdf=false;
     _load_from_checkpoint=false;
     _do_checkpoint=false;
+    _spinup.cycles = 0;
+    _load_balance.enable = false;
+    _load_balance.frequency = 0;
+    _load_balance.threshold = 0;
+    _load_balance.step_time = 0;
+    _load_balance.busy = 0;
+    _load_balance.steps = 0;
     _metdata= nullptr;
+    radius = 0;
 }
 
 core::~core()
 {
     LOG_DEBUG << "Finished";
+
+    // the sinks write from their own threads, so drain them before they go
+    for (auto& sink : {_cout_log_sink, _log_sink})
+    {
+        if (sink)
+        {
+            logging::core::get()->remove_sink(sink);
+            sink->stop();
+            sink->flush();
+        }
+    }
 }
 
 void core::config_options( pt::ptree &value)
@@ -75,6 +94,9 @@ void core::config_options( pt::ptree &value)
     );
 
 
+    // directory to keep the fields modules compute in init in, for later runs on the same mesh
+    _artifact_dir = value.get("artifact_cache", "");
+
     std::string ia = value.get<std::string>("interpolant","spline");
 
     if( ia == "spline")
@@ -317,6 +339,77 @@ void core::config_checkpoint( pt::ptree& value)
 
 
 }
+void core::config_spinup( pt::ptree& value)
+{
+    LOG_DEBUG << "Found spinup section";
+
+    _spinup.cycles = value.get("cycles", 1);
+    _spinup.timesteps = value.get("timesteps", 0);
+    _spinup.tolerance = value.get("tolerance", 0.0);
+
+    auto end = value.get_optional<std::string>("end");
+    if (end)
+        _spinup.end = boost::posix_time::from_iso_string(*end);
+
+    if (_spinup.timesteps == 0 && _spinup.end.is_not_a_date_time())
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Spin-up requires either timesteps or end"));
+    }
+
+    if (auto variables = value.get_child_optional("variables"))
+    {
+        for (auto &itr : *variables)
+            _spinup.variables.push_back(itr.second.data());
+    }
+
+    if (_spinup.tolerance > 0 && _spinup.variables.empty())
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Spin-up to a tolerance requires a list of variables to check"));
+    }
+
+    LOG_DEBUG << "Spinning up for at most " << _spinup.cycles << " cycles";
+}
+
+void core::config_load_balance( pt::ptree& value)
+{
+    LOG_DEBUG << "Found load_balance section";
+
+    _load_balance.frequency = value.get("frequency", 0);
+    _load_balance.threshold = value.get("threshold", 1.2);
+
+    if (_load_balance.threshold < 1)
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Load balancing threshold is the ratio of the slowest process to the mean, so must be at least 1"));
+    }
+
+#ifdef USE_MPI
+    _load_balance.enable = true;
+    _load_balance.face_cost.assign(_mesh->size_faces(), 0.);
+
+    if (_load_balance.frequency > 0)
+        LOG_DEBUG << "Checking the load balance every " << _load_balance.frequency << " timesteps";
+#else
+    LOG_WARNING << "Load balancing is between MPI processes and this build doesn't use MPI, ignoring";
+#endif
+}
+
+std::string core::forcing_cache_file(const pt::ptree& forcing, const std::vector<std::string>& files)
+{
+    std::stringstream key;
+    key << version << _forcing_cache_key << _mesh->proj4() << _mesh->size_faces();
+#ifdef USE_MPI
+    key << _comm_world.rank() << "/" << _comm_world.size();
+#endif
+
+    // the filters, model_dt, UTC_offset, subsetting and interpolation all change the cached values
+    pt::write_json(key, forcing, false);
+
+    for(auto& f : files)
+        key << f << boost::filesystem::file_size(f) << boost::filesystem::last_write_time(f);
+
+    return forcing_cache::file_name(std::hash<std::string>()(key.str()));
+}
+
 void core::config_forcing(pt::ptree &value)
 {
     LOG_DEBUG << "Found forcing section";
@@ -331,14 +424,65 @@ void core::config_forcing(pt::ptree &value)
     //need to determine if we have been given a netcdf file
     _use_netcdf = value.get("use_netcdf",false);
 
+    // A directory to keep a binary copy of the filtered forcing in. Later runs with the same forcing, mesh and
+    // options load that instead of reading the forcing files.
+    auto cache_dir = value.get_optional<std::string>("cache");
+    bool from_cache = false;
+
+    auto load_cache = [&](const std::vector<std::string>& files)
+    {
+        auto dir = cwd_dir / *cache_dir;
+        auto file = dir / forcing_cache_file(value, files);
+
+        if(_metdata->load_from_cache(file.string()))
+            return true;
+
+        LOG_DEBUG << "No forcing cache, writing it to " << file.string();
+        boost::filesystem::create_directories(dir);
+        _metdata->write_cache(file.string());
+        return false;
+    };
+
 
     timer c;
     c.tic();
     size_t nstations = 0;
+    std::vector<std::string> files;
     //we need to treat this very differently than the txt files
     if(_use_netcdf)
     {
-        std::string file = value.get<std::string>("file");
+        // file may be a single file, a glob pattern, or a list of files/patterns that together form one timeseries
+        std::vector<std::string> patterns;
+        auto& file_node = value.get_child("file");
+        if(file_node.empty())
+        {
+            patterns.push_back(file_node.data());
+        }
+        else
+        {
+            for(auto& itr : file_node)
+                patterns.push_back(itr.second.data());
+        }
+
+        files = metdata::expand_netcdf_files(patterns);
+
+        if(cache_dir)
+            from_cache = load_cache(files);
+    }
+
+    if(_use_netcdf && !from_cache)
+    {
+        // only load the part of the NetCDF grid that is needed for this mesh
+        if(value.get("subset_to_mesh",false))
+        {
+            // by default buffer the mesh extent by the station search radius
+            double buffer = value.get("subset_buffer", radius);
+            auto bbox = _mesh->bounding_box();
+
+            LOG_DEBUG << "Subsetting NetCDF forcing to the mesh extent with a buffer of " << buffer << " m";
+            _metdata->subset_netcdf_to_extent(bbox.xmin(), bbox.ymin(), bbox.xmax(), bbox.ymax(), buffer);
+        }
+
         std::map<std::string, boost::shared_ptr<filter_base> > netcdf_filters;
         try
         {
@@ -360,15 +504,15 @@ void core::config_forcing(pt::ptree &value)
         }
 
         // this delegates all filter responsibility to metdata from now on
-        _metdata->load_from_netcdf(file, netcdf_filters);
-        nstations = _metdata->nstations();
-    } else
+        _metdata->load_from_netcdf(files, netcdf_filters);
+    }
+    else if(!_use_netcdf)
     {
         std::vector<metdata::ascii_metdata> ascii_data;
 
         for (auto &itr : value)
         {
-            if(itr.first != "UTC_offset")
+            if(itr.first != "UTC_offset" && itr.first != "model_dt" && itr.first != "interpolation" && itr.first != "cache")
             {
                 metdata::ascii_metdata data;
 
@@ -420,9 +564,19 @@ void core::config_forcing(pt::ptree &value)
 
             }
         }
-        _metdata->load_from_ascii(ascii_data, _global->_utc_offset);
-        nstations = _metdata->nstations();
+
+        if(cache_dir)
+        {
+            for(auto& itr : ascii_data)
+                files.push_back(itr.path);
+
+            from_cache = load_cache(files);
+        }
+
+        if(!from_cache)
+            _metdata->load_from_ascii(ascii_data, _global->_utc_offset);
     }
+    nstations = _metdata->nstations();
 
     LOG_DEBUG << "Found # stations = " <<  nstations;
     if(nstations == 0)
@@ -430,6 +584,22 @@ void core::config_forcing(pt::ptree &value)
         CHM_THROW_EXCEPTION(forcing_error,"No input forcing files found!");
     }
 
+    // run at a finer timestep than the forcing by interpolating between forcing records
+    // the cache is already at the model timestep
+    auto model_dt = value.get_optional<long>("model_dt");
+    if(model_dt && !from_cache)
+    {
+        std::map<std::string, std::string> methods;
+        auto interp = value.get_child_optional("interpolation");
+        if(interp)
+        {
+            for(auto& itr : *interp)
+                methods[itr.first] = itr.second.data();
+        }
+
+        _metdata->set_model_dt(boost::posix_time::seconds(*model_dt), _global->_utc_offset, methods);
+    }
+
 
     auto f = o_path / "stations.vtp";
     _metdata->write_stations_to_ptv(f.string());
@@ -459,7 +629,10 @@ void core::determine_startend_ts_forcing()
     if(_load_from_checkpoint)
     {
         size_t t = 0;
-        _in_savestate.get_ncfile().getAtt("restart_time_sec").getValues(&t);
+        {
+            std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+            _in_savestate.get_ncfile().getAtt("restart_time_sec").getValues(&t);
+        }
         _start_ts = new boost::posix_time::ptime(boost::posix_time::from_time_t(t));
 
         LOG_WARNING << "Loading from checkpoint. Overriding start time to match. New start time = " << *_start_ts;
@@ -555,91 +728,209 @@ void core::config_meshes( pt::ptree &value)
 
     mesh_path = (cwd_dir / mesh_path).string();
 
-    pt::ptree mesh = read_json(mesh_path);
+    // reads the .mesh file and merges in the additional parameter and initial condition files
+    auto read_mesh = [&]() -> pt::ptree
+    {
+        pt::ptree mesh = read_json(mesh_path);
 
-    //we need to check if we've read in a geographic (lat/long) mesh or a UTM mesh. We then need to swap in the right distance and point_bearing functions
-    //so the modules and future code can blindly use them without worrying about these things
+        bool is_geographic = (bool)mesh.get<int>("mesh.is_geographic");
 
-    bool is_geographic = (bool)mesh.get<int>("mesh.is_geographic");
-    _global->_is_geographic = is_geographic; // save it here so modules can determine if this is true
-    if(is_geographic)
-    {
+        bool triarea_found = false;
+        //see if we have additional parameter files to load
+        try
+        {
+            for(auto &itr : value.get_child("parameters"))
+            {
+                LOG_DEBUG << "Parameter file: " << itr.second.data();
 
-        math::gis::point_from_bearing = & math::gis::point_from_bearing_latlong;
-        math::gis::distance = &math::gis::distance_latlong;
-    } else
-    {
+                auto param_mesh_path = (cwd_dir / itr.second.data()).string();
 
-        math::gis::point_from_bearing = &math::gis::point_from_bearing_UTM;
-        math::gis::distance = &math::gis::distance_UTM;
-    }
+                pt::ptree param_json = read_json(param_mesh_path);
 
-    bool triarea_found = false;
-    //see if we have additional parameter files to load
-    try
-    {
-        for(auto &itr : value.get_child("parameters"))
-        {
-            LOG_DEBUG << "Parameter file: " << itr.second.data();
+                for(auto& ktr : param_json)
+                {
+                    //use put to ensure there are no duplciate parameters...
+                    std::string key = ktr.first.data();
+                    mesh.put_child( "parameters." + key ,ktr.second);
 
-            auto param_mesh_path = (cwd_dir / itr.second.data()).string();
+                    if( key == "area")
+                        triarea_found = true;
 
-            pt::ptree param_json = read_json(param_mesh_path);
+                    LOG_DEBUG << "Inserted parameter " << ktr.first.data() << " into the config tree.";
+                }
+
+            }
+
+        }
+        catch(pt::ptree_bad_path &e)
+        {
+            LOG_DEBUG << "No addtional parameters found in mesh section.";
+        }
+        if(is_geographic && !triarea_found)
+        {
+            BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Geographic meshes require the triangle area be present in a .param file. Please include this."));
+        }
 
-            for(auto& ktr : param_json)
+        try
+        {
+            for(auto &itr : value.get_child("initial_conditions"))
             {
-                //use put to ensure there are no duplciate parameters...
-                std::string key = ktr.first.data();
-                mesh.put_child( "parameters." + key ,ktr.second);
+                LOG_DEBUG << "Initial condition file: " << itr.second.data();
 
-                if( key == "area")
-                    triarea_found = true;
+                auto param_mesh_path = (cwd_dir / itr.second.data()).string();
 
-                LOG_DEBUG << "Inserted parameter " << ktr.first.data() << " into the config tree.";
-            }
+                pt::ptree ic_json = read_json(param_mesh_path);
 
+                for(auto& ktr : ic_json)
+                {
+                    //use put to ensure there are no duplciate parameters...
+                    std::string key = ktr.first.data();
+                    mesh.put_child( "initial_conditions." + key ,ktr.second);
+                    LOG_DEBUG << "Inserted initial condition " << ktr.first.data() << " into the config tree.";
+                }
+
+            }
+        }
+        catch(pt::ptree_bad_path &e)
+        {
+            LOG_DEBUG << "No addtional initial conditions found in mesh section.";
         }
 
-    }
-    catch(pt::ptree_bad_path &e)
-    {
-        LOG_DEBUG << "No addtional parameters found in mesh section.";
-    }
-    if(is_geographic && !triarea_found)
-    {
-        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Geographic meshes require the triangle area be present in a .param file. Please include this."));
-    }
+        return mesh;
+    };
 
-    try
+    // The mesh is packed into flat arrays and the json tree released before the triangulation is built from them.
+    // With MPI, one rank per node reads the mesh into a window shared by the node's ranks, so the json is parsed
+    // and held once per node rather than once per rank. Only this raw buffer is shared: each rank still builds its
+    // own full triangulation, topology and parameters from it.
+    std::vector<char> buffer;
+    const char* packed = nullptr;
+    size_t packed_size = 0;
+
+#ifdef USE_MPI
+    MPI_Comm node_comm = MPI_COMM_NULL;
+    MPI_Win node_win = MPI_WIN_NULL;
+
+    if(value.get("node_shared", true))
     {
-        for(auto &itr : value.get_child("initial_conditions"))
+        MPI_Comm_split_type(_comm_world, MPI_COMM_TYPE_SHARED, _comm_world.rank(), MPI_INFO_NULL, &node_comm);
+
+        int node_rank = 0;
+        MPI_Comm_rank(node_comm, &node_rank);
+
+        // Whatever node rank 0 throws while reading or packing the mesh is broadcast before the next collective,
+        // so every rank on the node fails with the same error rather than waiting on the window forever
+        std::string node_error;
+        auto capture_error = [&](const std::function<void()>& f)
+        {
+            try
+            {
+                f();
+            }
+            catch(boost::exception& e)
+            {
+                auto msg = boost::get_error_info<errstr_info>(e);
+                node_error = msg ? *msg : boost::diagnostic_information(e);
+            }
+            catch(std::exception& e)
+            {
+                node_error = e.what();
+            }
+            catch(...)
+            {
+                node_error = "unknown error";
+            }
+        };
+        auto check_node_error = [&]()
         {
-            LOG_DEBUG << "Initial condition file: " << itr.second.data();
+            int length = static_cast<int>(node_error.size());
+            MPI_Bcast(&length, 1, MPI_INT, 0, node_comm);
+            if(length == 0)
+                return;
 
-            auto param_mesh_path = (cwd_dir / itr.second.data()).string();
+            node_error.resize(length);
+            MPI_Bcast(&node_error[0], length, MPI_CHAR, 0, node_comm);
 
-            pt::ptree ic_json = read_json(param_mesh_path);
+            if(node_win != MPI_WIN_NULL)
+                MPI_Win_free(&node_win);
+            MPI_Comm_free(&node_comm);
 
-            for(auto& ktr : ic_json)
+            BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Unable to load the node's shared mesh: " + node_error));
+        };
+
+        MPI_Aint size = 0;
+        char* base = nullptr;
+        {
+            pt::ptree mesh;
+            if(node_rank == 0)
             {
-                //use put to ensure there are no duplciate parameters...
-                std::string key = ktr.first.data();
-                mesh.put_child( "initial_conditions." + key ,ktr.second);
-                LOG_DEBUG << "Inserted initial condition " << ktr.first.data() << " into the config tree.";
+                capture_error([&]()
+                              {
+                                  mesh = read_mesh();
+                                  size = mesh_arrays::packed_size(mesh);
+                              });
             }
+            check_node_error();
 
+            MPI_Win_allocate_shared(size, 8, MPI_INFO_NULL, node_comm, &base, &node_win);
+
+            if(node_rank == 0)
+                capture_error([&]() { mesh_arrays::pack(mesh, base, size); });
+            check_node_error();
         }
+        // the packed mesh is visible to the rest of the node
+        MPI_Win_fence(0, node_win);
+
+        int disp_unit = 0;
+        MPI_Win_shared_query(node_win, 0, &size, &disp_unit, &base);
+        packed = base;
+        packed_size = size;
+
+        LOG_DEBUG << "MPI Process " << _comm_world.rank() << " is using the node's shared mesh of " << packed_size << " bytes";
     }
-    catch(pt::ptree_bad_path &e)
+    else
+#endif
     {
-        LOG_DEBUG << "No addtional initial conditions found in mesh section.";
+        pt::ptree mesh = read_mesh();
+        buffer.resize(mesh_arrays::packed_size(mesh));
+        mesh_arrays::pack(mesh, buffer.data(), buffer.size());
+        packed = buffer.data();
+        packed_size = buffer.size();
+    }
+
+    mesh_arrays arrays(packed, packed_size);
+
+    //we need to check if we've read in a geographic (lat/long) mesh or a UTM mesh. We then need to swap in the right distance and point_bearing functions
+    //so the modules and future code can blindly use them without worrying about these things
+
+    bool is_geographic = arrays.is_geographic();
+    _global->_is_geographic = is_geographic; // save it here so modules can determine if this is true
+    if(is_geographic)
+    {
+
+        math::gis::point_from_bearing = & math::gis::point_from_bearing_latlong;
+        math::gis::distance = &math::gis::distance_latlong;
+    } else
+    {
+
+        math::gis::point_from_bearing = &math::gis::point_from_bearing_UTM;
+        math::gis::distance = &math::gis::distance_UTM;
     }
 
     //we need to let the mesh know about any parameters the modules will provide so they can be correctly build into the static hashmaps
     for(auto& p : _provided_parameters)
         _mesh->_parameters.insert(p);
     
-    _mesh->from_json(mesh);
+    _mesh->from_arrays(arrays);
+
+#ifdef USE_MPI
+    if(node_win != MPI_WIN_NULL)
+    {
+        // collective, so the shared mesh is only released once every rank on the node has built its own
+        MPI_Win_free(&node_win);
+        MPI_Comm_free(&node_comm);
+    }
+#endif
 
     _provided_parameters = _mesh->parameters();
     
@@ -708,6 +999,29 @@ void core::config_output(pt::ptree &value)
 
     _find_and_insert_subjson(value);
 
+    // mesh and raster outputs may instead write statistics of their variables over a window, e.g., the daily maximum
+    auto config_aggregate = [&](output_info& out, pt::ptree& cfg)
+    {
+        auto stats = cfg.get_child_optional("statistics");
+        if (!stats)
+            return;
+
+        std::vector<face_aggregator::statistic> statistics;
+        if (stats->empty())
+            statistics.push_back(face_aggregator::to_statistic(stats->data()));
+        else
+            for (auto &jtr: *stats)
+                statistics.push_back(face_aggregator::to_statistic(jtr.second.data()));
+
+        size_t timesteps = 1;
+        auto window = face_aggregator::to_window(cfg.get<std::string>("window", "daily"), timesteps);
+
+        std::vector<std::string> variables(out.variables.begin(), out.variables.end());
+        out.aggregate = std::make_shared<face_aggregator>(_mesh, variables, statistics, window, timesteps);
+
+        LOG_DEBUG << "Output " << out.fname << " writes " << out.aggregate->output_variables().size() << " statistics per window";
+    };
+
     for (auto &itr : value)
     {
         output_info out;
@@ -717,7 +1031,7 @@ void core::config_output(pt::ptree &value)
             continue;
         }
 
-        if ((out_type != "mesh"))  // anything else *should* be a time series*......
+        if (out_type != "mesh" && out_type != "raster")  // anything else *should* be a time series*......
         {
             out.type = output_info::time_series;
             out.name = out_type;
@@ -817,7 +1131,111 @@ void core::config_output(pt::ptree &value)
             out.frequency = itr.second.get("frequency",1); //defaults to every timestep
             LOG_DEBUG << "Output every " << out.frequency <<" timesteps.";
 
-            out.mesh_output_formats.push_back(output_info::mesh_outputs::vtu);
+            config_aggregate(out, itr.second);
+            auto written = out.variables;
+            if(out.aggregate)
+                written = std::set<std::string>(out.aggregate->output_variables().begin(), out.aggregate->output_variables().end());
+
+            out.pvd.add("VTKFile.<xmlattr>.type", "Collection");
+            out.pvd.add("VTKFile.<xmlattr>.version", "0.1");
+
+            // either a single format or a list of them
+            std::vector<std::string> formats;
+            auto fmt = itr.second.get_child_optional("format");
+            if(!fmt)
+                formats.push_back("vtu");
+            else if(fmt->empty())
+                formats.push_back(fmt->data());
+            else
+                for (auto &jtr: *fmt)
+                    formats.push_back(jtr.second.data());
+
+            for(auto& jtr : formats)
+            {
+                if(jtr == "vtu")
+                {
+                    out.mesh_output_formats.push_back(output_info::mesh_outputs::vtu);
+                }
+                else if(jtr == "netcdf")
+                {
+                    out.mesh_output_formats.push_back(output_info::mesh_outputs::ugrid);
+
+                    // all ranks write into this one file
+                    out.ugrid = std::make_shared<ugrid_output>(_mesh, out.fname + ".nc", written,
+                                                               itr.second.get("write_parameters",true),
+                                                               itr.second.get<size_t>("chunk_time",0));
+                }
+                else
+                {
+                    BOOST_THROW_EXCEPTION(config_error() << errstr_info("Unknown mesh output format " + jtr + ", expected vtu or netcdf"));
+                }
+            }
+
+        }
+        else if (out_type == "raster")
+        {
+            out.type = output_info::raster;
+
+            auto fname = itr.second.get<std::string>("base_name","output");
+            auto f = o_path / "rasters" / fname;
+            boost::filesystem::create_directories(f.parent_path());
+            out.fname = f.string();
+
+            std::vector<std::string> variables;
+            try
+            {
+                for (auto &jtr: itr.second.get_child("variables"))
+                {
+                    out.variables.insert(jtr.second.data());
+                    variables.push_back(jtr.second.data());
+                }
+            }
+            catch (pt::ptree_bad_path &e)
+            {
+                BOOST_THROW_EXCEPTION(config_error() << errstr_info("Raster output " + fname + " requires a list of variables"));
+            }
+
+            double resolution = 0;
+            try
+            {
+                resolution = itr.second.get<double>("resolution");
+            }
+            catch(const pt::ptree_error &e)
+            {
+                BOOST_THROW_EXCEPTION(config_error() << errstr_info("Raster output " + fname + " requires a resolution"));
+            }
+
+            // xmin, ymin, xmax, ymax in mesh coordinates, defaults to the mesh extent
+            std::vector<double> extent;
+            if(itr.second.get_child_optional("extent"))
+            {
+                for (auto &jtr: itr.second.get_child("extent"))
+                    extent.push_back(jtr.second.get_value<double>());
+            }
+
+            auto format = itr.second.get<std::string>("format","tiff");
+            raster_output::format fmt;
+            if(format == "tiff")
+                fmt = raster_output::format::tiff;
+            else if(format == "netcdf")
+                fmt = raster_output::format::netcdf;
+            else
+                BOOST_THROW_EXCEPTION(config_error() << errstr_info("Raster output " + fname + " has unknown format " + format + ", expected tiff or netcdf"));
+
+            auto aggregate = itr.second.get<size_t>("aggregate",1);
+
+            config_aggregate(out, itr.second);
+            if(out.aggregate)
+                variables = out.aggregate->output_variables();
+
+            std::string suffix = "";
+#ifdef USE_MPI
+            suffix = "_" + std::to_string(_comm_world.rank());
+#endif
+            out.raster = std::make_shared<raster_output>(_mesh, out.fname, variables, fmt, resolution, aggregate, extent, suffix);
+
+            out.frequency = itr.second.get("frequency",1); //defaults to every timestep
+            LOG_DEBUG << "Raster output every " << out.frequency <<" timesteps.";
 
         } else
         {
@@ -921,11 +1339,13 @@ core::cmdl_opt core::config_cmdl_options(int argc, char **argv)
     if (vm.count("help"))
     {
         cout << desc << std::endl;
+        flush_log();
         exit(0);
     }
     else if (vm.count("version"))
     {
         cout << version << std::endl;
+        flush_log();
         exit(0);
     }
 
@@ -967,6 +1387,8 @@ core::cmdl_opt core::config_cmdl_options(int argc, char **argv)
     {
         LOG_ERROR << "Configuration file required.";
         cout << desc << std::endl;
+        // exit() doesn't unwind, so ~core never drains the sinks
+        flush_log();
         exit(1);
     }
 
@@ -1226,12 +1648,72 @@ void core::init(int argc, char **argv)
      *  forcing
      * The rest may be optional, and will override the defaults.
      */
+
+    // An ensemble runs each member's modules over the same mesh and forcing. Each member may override the module
+    // config and perturb the parameters. Member 0 is set up as a normal run, the others are kept in _members.
+    auto ensemble = cfg.get_child_optional("ensemble");
+    pt::ptree member0_parameters;
+    std::string ensemble_output_dir;
+    if(ensemble)
+    {
+        auto members = ensemble->get_child_optional("members");
+        if(!members || members->empty())
+        {
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info("Ensemble requires a list of members"));
+        }
+
+        // module IDs and keys are used as-is, so don't let a . in them be taken as a path
+        auto merge_config = [](pt::ptree base, const pt::ptree& overrides)
+        {
+            for (auto &mod : overrides)
+            {
+                pt::ptree::path_type mod_path(mod.first, '/');
+                auto mod_cfg = base.get_child(mod_path, pt::ptree());
+                for (auto &key : mod.second)
+                {
+                    mod_cfg.put_child(pt::ptree::path_type(key.first, '/'), key.second);
+                }
+                base.put_child(mod_path, mod_cfg);
+            }
+            return base;
+        };
+
+        size_t m = 0;
+        for (auto &itr : *members)
+        {
+            ensemble_member member;
+            member.config = merge_config(cfg.get_child("config"), itr.second.get_child("config", pt::ptree()));
+            member.parameters = itr.second.get_child("parameters", pt::ptree());
+
+            if(m == 0)
+            {
+                cfg.put_child("config", member.config);
+                member0_parameters = member.parameters;
+            }
+            else
+            {
+                _members.push_back(member);
+            }
+            m++;
+        }
+
+        LOG_DEBUG << "Running an ensemble of " << m << " members";
+
+        // each member writes to its own output directory
+        if(cfg.get_child_optional("output"))
+        {
+            ensemble_output_dir = cfg.get<std::string>("output.output_dir", "output");
+            cfg.put("output.output_dir", (boost::filesystem::path(ensemble_output_dir) / "member_0").string());
+        }
+    }
+
     config_modules(cfg.get_child("modules"), cfg.get_child("config"), cmdl_options.get<3>(), cmdl_options.get<4>());
     config_meshes(cfg.get_child("meshes")); // this must come before forcing, as meshes initializes the required distance functions based on geographic/utm meshes
 
     // This needs to be initialized with the mesh prior to the forcing and output being dealt with. 
     // met data needs to know about the meshes' coordinate system. Probably worth pulling this apart further
     _metdata = std::make_shared<metdata>(_mesh->proj4());
+    _global->_station_table = _metdata->table();
     
     //output should come before forcing, controls if we should output the vtp file of station locations
     try
@@ -1243,6 +1725,17 @@ void core::init(int argc, char **argv)
         LOG_DEBUG << "Optional section Output not found";
     }
 
+    // the forcing NetCDF subsetting needs to know the station search radius before the options section is processed
+    radius = cfg.get("option.station_search_radius", 0.0);
+
+    // the forcing cache depends on which stations are kept, and over what period, which these decide
+    {
+        std::stringstream key;
+        for(auto section : {"option", "meshes", "checkpoint", "load_balance"})
+            pt::write_json(key, cfg.get_child(section, pt::ptree()), false);
+        _forcing_cache_key = key.str();
+    }
+
     config_forcing(cfg.get_child("forcing"));
 
     /*
@@ -1257,9 +1750,21 @@ void core::init(int argc, char **argv)
     }
 
 
+    try
+    {
+        config_load_balance(cfg.get_child("load_balance"));
+    } catch (pt::ptree_bad_path &e)
+    {
+        LOG_DEBUG << "Optional section load_balance not found";
+    }
+
     // INSERT STATION TRIMMING HERE (after options for interpolation stuff has occurred)
     populate_face_station_lists();
-    populate_distributed_station_lists();
+
+    // faces that load balancing moves to this process may use any of the stations. Whether faces can be moved is only
+    // known once the modules are initialised, so if they can't the stations are pruned then
+    if (!_load_balance.enable || _load_balance.frequency == 0)
+        populate_distributed_station_lists();
 
 
     boost::filesystem::path full_path(boost::filesystem::current_path());
@@ -1296,9 +1801,23 @@ void core::init(int argc, char **argv)
         LOG_DEBUG << "Optional section checkpoint not found";
     }
 
-//#ifdef NOMATLAB
-//            config_matlab(value);
-//#endif
+    try
+    {
+        config_spinup(cfg.get_child("spinup"));
+    } catch (pt::ptree_bad_path &e)
+    {
+        LOG_DEBUG << "Optional section spinup not found";
+    }
+
+    // the checkpoint holds a single member's state, and point mode prunes the outputs the members would need
+    if(ensemble && (_do_checkpoint || _load_from_checkpoint || point_mode.enable))
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("An ensemble can't be checkpointed or run in point mode"));
+    }
+
+//#ifdef NOMATLAB
+//            config_matlab(value);
+//#endif
 
     //if we are to run in point mode, we need to remove all the input and outputs that aren't associated with point mode
     // we do this so the user doesn't have to modify a lot of the config file when going between point and dist mode.
@@ -1356,7 +1875,7 @@ void core::init(int argc, char **argv)
 
     for(auto& o : _outputs)
     {
-        if( o.type != output_info::mesh )
+        if( o.type != output_info::mesh && !o.aggregate)
             continue;
 
         for (auto& var : o.variables)
@@ -1369,6 +1888,14 @@ void core::init(int argc, char **argv)
         }
     }
 
+    for (auto& var : _spinup.variables)
+    {
+        if(!boost::algorithm::any_of_equal(_provided_var_module,var))
+        {
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info("Spin-up variable " + var + " is not provided by any module."));
+        }
+    }
+
     determine_startend_ts_forcing();
 
     //set interpolation algorithm
@@ -1397,7 +1924,34 @@ void core::init(int argc, char **argv)
         module_list.insert(itr.first->ID);
     }
 
-    _mesh->init_face_data(_provided_var_module, _provided_var_vector, module_list);
+    // the aggregated outputs' statistics are written into face variables of their own
+    auto face_variables = _provided_var_module;
+    for(auto& itr : _outputs)
+    {
+        if(itr.aggregate)
+            face_variables.insert(itr.aggregate->output_variables().begin(), itr.aggregate->output_variables().end());
+    }
+
+    _mesh->init_face_data(face_variables, _provided_var_vector, module_list);
+
+    if(ensemble)
+    {
+        LOG_DEBUG << "Allocating face state for " << _members.size() << " more ensemble members";
+
+        // the members start from the unperturbed parameters and initial conditions
+        for (auto &member : _members)
+        {
+            _mesh->copy_state(member.state);
+        }
+
+        perturb_parameters(member0_parameters);
+        for (auto &member : _members)
+        {
+            swap_member(member);
+            perturb_parameters(member.parameters);
+            swap_member(member);
+        }
+    }
 
     if(point_mode.enable)
     {
@@ -1415,6 +1969,16 @@ void core::init(int argc, char **argv)
 
 
     timer c;
+
+    if(!_artifact_dir.empty())
+    {
+        c.tic();
+        auto hash = _mesh->hash();
+        LOG_DEBUG << "Mesh hash " << std::hex << hash << std::dec << " took " << c.toc<ms>() << "ms";
+
+        _global->_artifacts.open((cwd_dir / _artifact_dir).string(), hash);
+    }
+
     LOG_DEBUG << "Running init() for each module";
     c.tic();
 
@@ -1430,6 +1994,46 @@ void core::init(int argc, char **argv)
     // data parallel or domain parallel after the fact.
     _schedule_modules();
 
+#ifdef USE_MPI
+    // the faces can only be moved if all of their state can be
+    if (_load_balance.frequency > 0)
+    {
+        std::string reason;
+        if (ensemble)
+            reason = "in an ensemble";
+        else if (point_mode.enable)
+            reason = "in point mode";
+        else if (_do_checkpoint || _load_from_checkpoint)
+            reason = "when checkpointing";
+
+        for (auto& itr : _outputs)
+        {
+            if (itr.type == output_info::output_type::time_series || itr.type == output_info::output_type::raster)
+                reason = "with timeseries or raster outputs";
+        }
+
+        for (auto& itr : _modules)
+        {
+            auto m = itr.first;
+            bool has_data = _mesh->face(0)->get_module_data<face_info>(m->ID) != nullptr;
+            if ((has_data || m->parallel_type() == module_base::parallel::domain) && !m->migrates())
+                reason = "with module " + m->ID + ", which can't move its face data";
+        }
+
+        // every process has to agree, as moving the faces is collective
+        bool ok = boost::mpi::all_reduce(_comm_world, reason.empty(), std::logical_and<bool>());
+        if (!ok)
+        {
+            LOG_WARNING << "Load balancing can't move faces between processes " << (reason.empty() ? "on another process" : reason)
+                        << ", so will only report the imbalance";
+            _load_balance.frequency = 0;
+
+            // every station was only kept for the faces this process might have been given
+            populate_distributed_station_lists();
+        }
+    }
+#endif
+
 //load a checkpoint as the last thing we do before a run
     if(_load_from_checkpoint  )
     {
@@ -1446,6 +2050,82 @@ void core::init(int argc, char **argv)
 
         LOG_DEBUG << "Done loading snapshot [ " << c.toc<s>() << "s]";
     }
+
+    // The other members get their own modules, in the order already determined, and their own outputs.
+    // Everything else was set up above and is shared.
+    auto member0_path = o_path;
+    for (size_t m = 0; m < _members.size(); m++)
+    {
+        auto &member = _members[m];
+        LOG_DEBUG << "Initializing ensemble member " << m + 1;
+
+        for (auto &itr : _modules)
+        {
+            auto module = module_factory::create(itr.first->ID,
+                                                 member.config.get_child(pt::ptree::path_type(itr.first->ID, '/'), pt::ptree()));
+            module->IDnum = itr.first->IDnum;
+            module->global_param = _global;
+            member.modules.push_back(std::make_pair(module, itr.second));
+        }
+
+        swap_member(member);
+
+        for (auto &itr : _modules)
+        {
+            itr.first->init(_mesh);
+        }
+        _schedule_modules();
+
+        if(!ensemble_output_dir.empty())
+        {
+            auto output = cfg.get_child("output");
+            output.put("output_dir", (boost::filesystem::path(ensemble_output_dir) / ("member_" + std::to_string(m + 1))).string());
+            config_output(output);
+
+            for (auto &itr : _outputs)
+            {
+                if (itr.type == output_info::output_type::time_series)
+                {
+                    itr.ts.init(_provided_var_module, _metdata->start_time(), _metdata->end_time(), _metdata->dt());
+                }
+            }
+        }
+
+        swap_member(member);
+    }
+    o_path = member0_path;
+
+    if(_global->artifacts().enabled())
+    {
+        LOG_INFO << "Module artifacts: " << _global->artifacts().hits() << " loaded from the cache, "
+                 << _global->artifacts().misses() << " computed";
+    }
+}
+
+void core::perturb_parameters(const pt::ptree& parameters)
+{
+    for (auto &itr : parameters)
+    {
+        auto name = itr.first;
+        if(_mesh->parameters().count(name) == 0)
+        {
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info("Ensemble perturbs parameter " + name + " which isn't a mesh or module parameter"));
+        }
+
+        double scale = itr.second.get("scale", 1.0);
+        double offset = itr.second.get("offset", 0.0);
+
+        LOG_DEBUG << "Perturbing " << name << " by *" << scale << " + " << offset;
+
+        #pragma omp parallel for
+        for (size_t i = 0; i < _mesh->size_faces(); i++)
+        {
+            auto face = _mesh->face(i);
+            double& p = face->parameter(name);
+            if (p != -9999.)
+                p = p * scale + offset;
+        }
+    }
 }
 
 void core::_find_and_insert_subjson(pt::ptree& value)
@@ -1924,19 +2604,28 @@ void core::run()
     timer c;
 
 
-    //setup a XML writer for the PVD paraview format
-    pt::ptree pvd;
-    pvd.add("VTKFile.<xmlattr>.type", "Collection");
-    pvd.add("VTKFile.<xmlattr>.version", "0.1");
-
-
     LOG_DEBUG << "Loading first timestep's met data";
     // Populate the stations with the first timestep's data.
     // We can do this _once_ without incrementing the internal iterators
+    // The spin-up period is kept in memory so that it isn't read and filtered again for each cycle
+    if (_spinup.cycles > 0)
+        _metdata->cache(true);
+
     _metdata->next();
 
+    if (_spinup.cycles > 0)
+    {
+        spinup();
+
+        // the run starts over from the first timestep, continuing from the spun up state
+        _metdata->replay(0);
+    }
+
     LOG_DEBUG << "Starting model run";
 
+    // the spin-up's face costs are kept, but its time isn't part of the first timestep
+    _load_balance.step_time = 0;
+
     c.tic();
 
     double meantime = 0;
@@ -1957,213 +2646,350 @@ void core::run()
             ss << _global->posix_time();
 
             c.tic();
-            size_t chunks = 0;
-            try
+
+            if (!run_timestep(current_ts))
+                done = true;
+
+            // the other ensemble members, over the same forcing
+            for (auto &member : _members)
             {
-                for (auto &itr : _chunked_modules)
-                {
+                swap_member(member);
+                if (!run_timestep(current_ts))
+                    done = true;
+                swap_member(member);
+            }
 
-                    if (itr.at(0)->parallel_type() == module_base::parallel::data)
-                    {
+            // summarize the messages the per-face loops dropped this timestep
+            log_limiter::report();
 
-                        #pragma omp parallel for
-                        for (size_t i = 0; i < _mesh->size_faces(); i++)
-                        {
-                            auto face = _mesh->face(i);
-                            if (point_mode.enable && face->_debug_name != _outputs[0].name)
-                                continue;
-
-                             //module calls
-                             for (auto &jtr : itr)
-                             {
-                                 jtr->run(face);
-                             }
-                        }
+#ifdef USE_MPI
+            if (_load_balance.enable)
+                balance_load();
+#endif
 
+            if(!_metdata->next())
+                done = true;
 
-                    } else
-                    {
-                        //module calls for domain parallel
-                        for (auto &jtr : itr)
-                        {
-                          jtr->run(_mesh);
-                        }
-                    }
+            auto timestep = c.toc<ms>();
+            meantime += timestep;
 
-                    chunks++;
+            current_ts++;
+            _global->timestep_counter++;
 
-                }
-            }
-            catch (exception_base &e)
+            double mt = meantime / current_ts;
+            bool ms = true;
+            if (mt > 1000)
             {
-                LOG_ERROR << "Exception at timestep: " << _global->posix_time();
-                //if we die in a module, try to dump our time series out so we can figure out wtf went wrong
-                LOG_ERROR << "Exception has occured. Timeseries and meshes WILL BE INCOMPLETE!";
-                *_end_ts = _global->posix_time();
-                done = true;
-                LOG_ERROR << boost::diagnostic_information(e);
+                mt /= 1000.;
+                ms = false;
+            }
+
+            std::string s = std::to_string(std::lround(mt)) + (ms == true ? " ms" : "s");
 
+            //we need it in seconds now
+            if (ms)
+            {
+                mt /= 1000.0;
             }
 
-            //check that we actually need a mesh output.
-            for (auto &itr : _outputs)
+            boost::posix_time::ptime pt(boost::posix_time::second_clock::local_time());
+            pt = pt + boost::posix_time::seconds(size_t(mt) * (max_ts - current_ts));
+
+            LOG_DEBUG << "Avg timestep duration " << s << "\tEstimated completion: " << boost::posix_time::to_simple_string(pt);
+            _global->first_time_step = false;
+
+
+        }
+        double elapsed = c.toc<s>();
+        LOG_DEBUG << "Total runtime was " << elapsed << "s";
+
+    // keeps the forcing cache if the whole run period was read
+    _metdata->finish_cache();
+
+
+
+    finish_outputs();
+    for (auto &member : _members)
+    {
+        swap_member(member);
+        finish_outputs();
+        swap_member(member);
+    }
+
+    if(_notification_script != "")
+    {
+        LOG_DEBUG << "Calling notification script";
+        std::system(_notification_script.c_str());
+    }
+}
+
+bool core::run_modules()
+{
+    bool ok = true;
+    double run_start = omp_get_wtime();
+
+    size_t chunks = 0;
+    try
+    {
+        for (auto &itr : _chunked_modules)
+        {
+
+            if (itr.at(0)->parallel_type() == module_base::parallel::data)
             {
-                if(itr.type == output_info::output_type::mesh)
+
+                #pragma omp parallel for
+                for (size_t i = 0; i < _mesh->size_faces(); i++)
                 {
-                    std::vector<std::string> output;
-                    output.assign(itr.variables.begin(),itr.variables.end()); //convert to list to match internal lists
+                    auto face = _mesh->face(i);
+                    if (point_mode.enable && face->_debug_name != _outputs[0].name)
+                        continue;
+
+                     double start = _load_balance.enable ? omp_get_wtime() : 0;
+
+                     //module calls
+                     for (auto &jtr : itr)
+                     {
+                         jtr->run(face);
+                     }
 
-                    _mesh->update_vtk_data(output); //update the internal vtk mesh
-                    break; // we're done as soon as we've called update once. No need to do it multiple times.
+                     if (_load_balance.enable)
+                         _load_balance.face_cost[i] += omp_get_wtime() - start;
                 }
-            }
 
-            // save the current state
-            if(_do_checkpoint && (current_ts % _checkpoint_feq ==0) )
+
+            } else
             {
-                LOG_DEBUG << "Checkpointing...";
-                c.tic();
-                for (auto &itr : _chunked_modules)
+                double start = omp_get_wtime();
+
+                //module calls for domain parallel
+                for (auto &jtr : itr)
                 {
-                    //module calls
-                    for (auto &jtr : itr)
-                    {
-                        jtr->checkpoint(_mesh, _savestate);
-                    }
+                  jtr->run(_mesh);
+                }
+
+                // a domain parallel module's time can't be put on individual faces, so is spread over them
+                if (_load_balance.enable)
+                {
+                    double per_face = (omp_get_wtime() - start) / _mesh->size_faces();
+                    for (auto& cost : _load_balance.face_cost)
+                        cost += per_face;
                 }
-                std::stringstream timestr;
+            }
 
-                timestr << _global->posix_time() + boost::posix_time::seconds(_global->_dt); // start from current TS + dt
+            chunks++;
 
-                //also write it out in seconds because netcdf is struggling with the string
-                unsigned long long int ts_sec = _global->posix_time_int()+_global->_dt;
+        }
+    }
+    catch (exception_base &e)
+    {
+        LOG_ERROR << "Exception at timestep: " << _global->posix_time();
+        //if we die in a module, try to dump our time series out so we can figure out wtf went wrong
+        LOG_ERROR << "Exception has occured. Timeseries and meshes WILL BE INCOMPLETE!";
+        *_end_ts = _global->posix_time();
+        ok = false;
+        LOG_ERROR << boost::diagnostic_information(e);
 
-                _savestate.get_ncfile().putAtt("restart_time",timestr.str());
-                _savestate.get_ncfile().putAtt("restart_time_sec", netCDF::ncUint64,ts_sec);
+    }
 
-                LOG_DEBUG << "Done checkpoint [ " << c.toc<s>() << "s]";
-            }
+    _load_balance.step_time += omp_get_wtime() - run_start;
 
-            for (auto &itr : _outputs)
+    return ok;
+}
+
+bool core::run_timestep(size_t current_ts)
+{
+    timer c;
+    bool ok = run_modules();
+
+    // save the current state
+    if(_do_checkpoint && (current_ts % _checkpoint_feq ==0) )
+    {
+        LOG_DEBUG << "Checkpointing...";
+        c.tic();
+        for (auto &itr : _chunked_modules)
+        {
+            //module calls
+            for (auto &jtr : itr)
             {
-                if (itr.type == output_info::output_type::mesh)
-                {
-                    if(current_ts % itr.frequency == 0)
-                    {
+                jtr->checkpoint(_mesh, _savestate);
+            }
+        }
+        std::stringstream timestr;
 
-                        #pragma omp parallel
-                        {
-                            #pragma omp single
-                            {
-                                for (auto jtr : itr.mesh_output_formats)
-                                {
-                                    #pragma omp task
-                                    {
-                                        std::string base_name = itr.fname + std::to_string(_global->posix_time_int());
-                                        boost::filesystem::path p(base_name);
-
-                                        if (jtr == output_info::mesh_outputs::vtu  )
-                                        {
-
-                                            // this really only works if we let rank0 handle the io.
-                                            // If we let each process do it, they walk all over each other's output
-#ifdef USE_MPI
-                                            if(_comm_world.rank() == 0)
-                                            {
-                                                for(int rank = 0; rank < _comm_world.size(); rank++)
-                                                {
-#else
-                                                    int rank = 0;
-#endif
-                                                    pt::ptree &dataset = pvd.add("VTKFile.Collection.DataSet", "");
-                                                    dataset.add("<xmlattr>.timestep", _global->posix_time_int());
-                                                    dataset.add("<xmlattr>.group", "");
-                                                    dataset.add("<xmlattr>.part", rank);
-                                                    dataset.add("<xmlattr>.file", p.filename().string()+"_"+std::to_string(rank) + ".vtu");
-#ifdef USE_MPI
-                                                }
-                                            }
-#endif
+        timestr << _global->posix_time() + boost::posix_time::seconds(_global->_dt); // start from current TS + dt
 
-                                            //because a full path can be provided for the base_name, we need to strip this off
-                                            //to make it a relative path in the xml file.
+        //also write it out in seconds because netcdf is struggling with the string
+        unsigned long long int ts_sec = _global->posix_time_int()+_global->_dt;
 
-#ifdef USE_MPI
-                                            _mesh->write_vtu(base_name + "_"+std::to_string(_comm_world.rank() )+ ".vtu");
-#else
-                                            _mesh->write_vtu(base_name + "_"+std::to_string(rank)+ ".vtu");
-#endif
+        {
+            // forcing files may be being read in the background
+            std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+            _savestate.get_ncfile().putAtt("restart_time", timestr.str());
+            _savestate.get_ncfile().putAtt("restart_time_sec", netCDF::ncUint64, ts_sec);
+        }
 
-                                        }
+        LOG_DEBUG << "Done checkpoint [ " << c.toc<s>() << "s]";
+    }
 
+    for (auto &itr : _outputs)
+    {
+        if (itr.type == output_info::output_type::time_series)
+            continue;
 
+        if (itr.aggregate)
+        {
+            itr.aggregate->update(_global->posix_time());
 
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+            auto next = _global->posix_time() + boost::posix_time::seconds(_global->_dt);
+            if (itr.aggregate->window_complete(_global->posix_time(), next))
+            {
+                auto start = itr.aggregate->emit();
+                write_output(itr, (start - boost::posix_time::from_time_t(0)).total_seconds());
             }
+        }
+        else if (current_ts % itr.frequency == 0)
+        {
+            write_output(itr, _global->posix_time_int());
+        }
+    }
 
-            //If we are output a timeseries at specific triangles, we do that here
-            //Each output knows what face it corresponds to
-            for (auto &itr : _outputs)
+    //If we are output a timeseries at specific triangles, we do that here
+    //Each output knows what face it corresponds to
+    for (auto &itr : _outputs)
+    {
+        //only update the full timeseries
+        if (itr.type == output_info::output_type::time_series)
+        {
+            for (auto v : _provided_var_module)
             {
-                //only update the full timeseries
-                if (itr.type == output_info::output_type::time_series)
-                {
-                    for (auto v : _provided_var_module)
-                    {
-                        auto data = (*itr.face)[v];
-                        itr.ts.at(v, current_ts) = data;
-                    }
-                }
+                auto data = (*itr.face)[v];
+                itr.ts.at(v, current_ts) = data;
             }
+        }
+    }
 
-            if(!_metdata->next())
-                done = true;
+    return ok;
+}
 
-            auto timestep = c.toc<ms>();
-            meantime += timestep;
+void core::spinup()
+{
+    size_t timesteps = _spinup.timesteps;
+    if (!_spinup.end.is_not_a_date_time())
+        timesteps = (_spinup.end - _metdata->start_time()).total_seconds() / _metdata->dt_seconds() + 1;
+    timesteps = std::min(timesteps, _metdata->n_timestep());
 
-            current_ts++;
-            _global->timestep_counter++;
+    LOG_DEBUG << "Spinning up over " << timesteps << " timesteps from " << _metdata->current_time_str();
 
-            double mt = meantime / current_ts;
-            bool ms = true;
-            if (mt > 1000)
+    // each member's values of the convergence variables at the end of the previous cycle, as [member][variable][face]
+    std::vector< std::vector< std::vector<double> > > previous(_members.size() + 1);
+
+    // largest change in any of the variables since the previous cycle
+    auto change = [&](std::vector< std::vector<double> >& prev)
+    {
+        double max_change = 0;
+        prev.resize(_spinup.variables.size());
+
+        for (size_t v = 0; v < _spinup.variables.size(); v++)
+        {
+            auto& var = _spinup.variables[v];
+            auto& p = prev[v];
+            bool first = p.empty();
+            p.resize(_mesh->size_faces());
+
+            #pragma omp parallel for reduction(max:max_change)
+            for (size_t i = 0; i < _mesh->size_faces(); i++)
             {
-                mt /= 1000.;
-                ms = false;
+                double d = (*_mesh->face(i))[var];
+                if (!first && d != -9999. && p[i] != -9999.)
+                    max_change = std::max(max_change, std::fabs(d - p[i]));
+                p[i] = d;
             }
+        }
+        return max_change;
+    };
 
-            std::string s = std::to_string(std::lround(mt)) + (ms == true ? " ms" : "s");
+    for (size_t cycle = 0; cycle < _spinup.cycles; cycle++)
+    {
+        timer c;
+        c.tic();
 
-            //we need it in seconds now
-            if (ms)
+        if (cycle > 0)
+            _metdata->replay(0);
+
+        for (size_t step = 0; step < timesteps; step++)
+        {
+            // the first cycle reads the forcing, the later ones replay it
+            if (step > 0 && !_metdata->next())
             {
-                mt /= 1000.0;
+                timesteps = step;
+                break;
             }
 
-            boost::posix_time::ptime pt(boost::posix_time::second_clock::local_time());
-            pt = pt + boost::posix_time::seconds(size_t(mt) * (max_ts - current_ts));
+            _global->_current_date = _metdata->current_time();
 
-            LOG_DEBUG << "Avg timestep duration " << s << "\tEstimated completion: " << boost::posix_time::to_simple_string(pt);
+            if (!run_modules())
+            {
+                BOOST_THROW_EXCEPTION(chm_error() << errstr_info("Spin-up failed at " + _metdata->current_time_str()));
+            }
+            for (auto &member : _members)
+            {
+                swap_member(member);
+                if (!run_modules())
+                {
+                    BOOST_THROW_EXCEPTION(chm_error() << errstr_info("Spin-up failed at " + _metdata->current_time_str()));
+                }
+                swap_member(member);
+            }
+
+            log_limiter::report();
+
+            _global->timestep_counter++;
             _global->first_time_step = false;
+        }
 
+        if (cycle == 0)
+            _metdata->cache(false);
 
+        double max_change = change(previous[0]);
+        for (size_t m = 0; m < _members.size(); m++)
+        {
+            swap_member(_members[m]);
+            max_change = std::max(max_change, change(previous[m + 1]));
+            swap_member(_members[m]);
         }
-        double elapsed = c.toc<s>();
-        LOG_DEBUG << "Total runtime was " << elapsed << "s";
 
+#ifdef USE_MPI
+        max_change = boost::mpi::all_reduce(_comm_world, max_change, boost::mpi::maximum<double>());
+#endif
 
+        LOG_DEBUG << "Spin-up cycle " << cycle + 1 << " took " << c.toc<s>() << "s, largest change " << max_change;
 
-    std::string base_name="";
+        if (cycle > 0 && max_change <= _spinup.tolerance && !_spinup.variables.empty())
+        {
+            LOG_DEBUG << "Spin-up converged after " << cycle + 1 << " cycles";
+            break;
+        }
+    }
+
+    _global->timestep_counter = 0;
+}
 
+void core::finish_outputs()
+{
+    // write out the statistics of the window the run ended part way through
     for (auto &itr : _outputs)
     {
-        if (itr.type == output_info::output_type::mesh)
+        if (itr.aggregate && itr.aggregate->steps() > 0)
+        {
+            LOG_DEBUG << "Writing the partial window of " << itr.aggregate->steps() << " timesteps to " << itr.fname;
+            auto start = itr.aggregate->emit();
+            write_output(itr, (start - boost::posix_time::from_time_t(0)).total_seconds());
+        }
+    }
+
+    for (auto &itr : _outputs)
+    {
+        if (itr.type == output_info::output_type::mesh && itr.has_format(output_info::mesh_outputs::vtu))
         {
 
 #ifdef USE_MPI
@@ -2171,12 +2997,11 @@ void core::run()
             {
 #endif
 #if (BOOST_VERSION / 100 % 1000) < 56
-                pt::write_xml(base_name + ".pvd",
-                              pvd, std::locale(), pt::xml_writer_make_settings<char>(' ', 4));
+                pt::write_xml(itr.fname + ".pvd",
+                              itr.pvd, std::locale(), pt::xml_writer_make_settings<char>(' ', 4));
 #else
                 pt::write_xml(itr.fname + ".pvd",
-                              pvd, std::locale(), pt::xml_writer_settings<std::string>(' ', 4));
-                break;
+                              itr.pvd, std::locale(), pt::xml_writer_settings<std::string>(' ', 4));
 #endif
 #ifdef USE_MPI
             }
@@ -2184,6 +3009,19 @@ void core::run()
         }
     }
 
+    // wait for the background raster writers and write out the buffered netcdf mesh steps
+    for (auto &itr : _outputs)
+    {
+        if (itr.type == output_info::output_type::raster)
+        {
+            itr.raster->finish();
+        }
+        if (itr.ugrid)
+        {
+            itr.ugrid->finish();
+        }
+    }
+
     for (auto &itr : _outputs)
     {
         //save the full timeseries
@@ -2193,18 +3031,304 @@ void core::run()
             itr.ts.to_file(itr.fname);
         }
     }
+}
+
+#ifdef USE_MPI
+void core::balance_load()
+{
+    // the slowest process holds the others up at the next collective
+    double max = boost::mpi::all_reduce(_comm_world, _load_balance.step_time, boost::mpi::maximum<double>());
+    double sum = boost::mpi::all_reduce(_comm_world, _load_balance.step_time, std::plus<double>());
+    double mean = sum / _comm_world.size();
 
+    LOG_DEBUG << "Load imbalance (slowest/mean process time) " << (mean > 0 ? max / mean : 1.);
 
-    if(_notification_script != "")
+    _load_balance.busy += _load_balance.step_time;
+    _load_balance.step_time = 0;
+    _load_balance.steps++;
+
+    if (_load_balance.frequency == 0 || _load_balance.steps < _load_balance.frequency)
+        return;
+
+    // the aggregated outputs' partial windows can't be moved, so wait until they've all been written
+    for (auto& itr : _outputs)
     {
-        LOG_DEBUG << "Calling notification script";
-        std::system(_notification_script.c_str());
+        if (itr.aggregate && itr.aggregate->steps() != 0)
+            return;
+    }
+
+    max = boost::mpi::all_reduce(_comm_world, _load_balance.busy, boost::mpi::maximum<double>());
+    sum = boost::mpi::all_reduce(_comm_world, _load_balance.busy, std::plus<double>());
+    mean = sum / _comm_world.size();
+    double imbalance = mean > 0 ? max / mean : 1.;
+
+    LOG_DEBUG << "Load imbalance over the last " << _load_balance.steps << " timesteps " << imbalance;
+
+    if (imbalance > _load_balance.threshold)
+        rebalance();
+
+    std::fill(_load_balance.face_cost.begin(), _load_balance.face_cost.end(), 0.);
+    _load_balance.busy = 0;
+    _load_balance.steps = 0;
+}
+
+void core::rebalance()
+{
+    timer c;
+    c.tic();
+
+    int rank = _comm_world.rank();
+    mesh_partition old_partition = _mesh->partition();
+    size_t nfaces = old_partition.faces();
+
+    // every process computes the same partition from every face's cost
+    std::vector<double> cost(nfaces, 0.);
+    for (size_t i = 0; i < _mesh->size_faces(); i++)
+        cost[_mesh->face(i)->cell_global_id] = _load_balance.face_cost[i];
+    MPI_Allreduce(MPI_IN_PLACE, cost.data(), static_cast<int>(nfaces), MPI_DOUBLE, MPI_SUM, _comm_world);
+
+    auto partition = mesh_partition::weighted(cost, _comm_world.size());
+    double before = mesh_partition::imbalance(old_partition.cost(cost));
+    double after = mesh_partition::imbalance(partition.cost(cost));
+
+    if (partition == old_partition || after >= before)
+    {
+        LOG_DEBUG << "Repartitioning by the measured face costs wouldn't improve the imbalance of " << before;
+        return;
+    }
+
+    LOG_INFO << "Rebalancing the mesh, the measured face costs should go from an imbalance of " << before << " to " << after;
+
+    // what is moved with each face, in this order. Every process has the same
+    auto first = _mesh->face(0);
+    std::vector<std::string> variables = first->variables();
+    std::vector<std::string> parameters = first->parameters();
+    std::vector<std::string> ics = first->initial_conditions();
+    std::vector<std::string> vectors = first->vectors();
+    for (auto* names : {&variables, &parameters, &ics, &vectors})
+        std::sort(names->begin(), names->end());
+
+    std::set<std::string> variable_set(variables.begin(), variables.end());
+    std::set<std::string> vector_set(vectors.begin(), vectors.end());
+    std::set<std::string> module_set;
+    for (auto& itr : _modules)
+        module_set.insert(itr.first->ID);
+
+    // faces go to each other process in global id order, so no ids are sent
+    std::vector<std::vector<double>> send(_comm_world.size());
+    std::vector<std::vector<double>> recv(_comm_world.size());
+    std::vector<boost::mpi::request> requests;
+
+    for (int r = 0; r < _comm_world.size(); r++)
+    {
+        size_t begin = std::max(old_partition.begin(rank), partition.begin(r));
+        size_t end = std::min(old_partition.end(rank), partition.end(r));
+        if (r == rank || begin >= end)
+            continue;
+
+        auto& buf = send[r];
+        for (size_t id = begin; id < end; id++)
+        {
+            auto face = _mesh->face(id - old_partition.begin(rank));
+
+            for (auto& v : variables)
+                buf.push_back((*face)[v]);
+            for (auto& v : parameters)
+                buf.push_back(face->parameter(v));
+            for (auto& v : ics)
+                buf.push_back(face->get_initial_condition(v));
+            for (auto& v : vectors)
+            {
+                auto vec = face->face_vector(v);
+                buf.insert(buf.end(), {vec.x(), vec.y(), vec.z()});
+            }
+            for (auto& itr : _modules)
+                itr.first->pack_face(face, buf);
+        }
+
+        requests.push_back(_comm_world.isend(r, 0, buf));
+    }
+
+    for (int r = 0; r < _comm_world.size(); r++)
+    {
+        size_t begin = std::max(old_partition.begin(r), partition.begin(rank));
+        size_t end = std::min(old_partition.end(r), partition.end(rank));
+        if (r == rank || begin >= end)
+            continue;
+
+        requests.push_back(_comm_world.irecv(r, 0, recv[r]));
+    }
+
+    boost::mpi::wait_all(requests.begin(), requests.end());
+
+    // the faces that left are now someone else's
+    for (size_t id = old_partition.begin(rank); id < old_partition.end(rank); id++)
+    {
+        if (partition.owner(id) != static_cast<size_t>(rank))
+            _mesh->face(id - old_partition.begin(rank))->release_state();
+    }
+
+    _mesh->repartition(partition);
+
+    for (int r = 0; r < _comm_world.size(); r++)
+    {
+        size_t begin = std::max(old_partition.begin(r), partition.begin(rank));
+        size_t end = std::min(old_partition.end(r), partition.end(rank));
+        if (r == rank || begin >= end)
+            continue;
+
+        const double* p = recv[r].data();
+        for (size_t id = begin; id < end; id++)
+        {
+            auto face = _mesh->face(id - partition.begin(rank));
+
+            face->init_time_series(variable_set);
+            face->init_vectors(vector_set);
+            face->init_module_data(module_set);
+
+            // never owned by this process before, so it has no stations yet
+            if (face->stations().empty())
+            {
+                auto stations = _metdata->get_stations(face->get_x(), face->get_y());
+                face->stations().insert(std::end(face->stations()), std::begin(stations), std::end(stations));
+                face->nearest_station() = _metdata->nearest_station(face->get_x(), face->get_y()).at(0);
+            }
+
+            for (auto& v : variables)
+                (*face)[v] = *p++;
+            for (auto& v : parameters)
+                face->parameter(v) = *p++;
+            for (auto& v : ics)
+                face->set_initial_condition(v, *p++);
+            for (auto& v : vectors)
+            {
+                face->set_face_vector(v, Vector_3(p[0], p[1], p[2]));
+                p += 3;
+            }
+            for (auto& itr : _modules)
+                itr.first->unpack_face(face, p);
+        }
+
+        if (p != recv[r].data() + recv[r].size())
+            BOOST_THROW_EXCEPTION(chm_error() << errstr_info("Face state from MPI process " + std::to_string(r) +
+                                                              " doesn't match the faces it was to move"));
+    }
+
+    _load_balance.face_cost.assign(_mesh->size_faces(), 0.);
+
+    for (auto& itr : _modules)
+        itr.first->repartitioned(_mesh);
+
+    for (auto& itr : _outputs)
+    {
+        if (itr.ugrid)
+            itr.ugrid->repartitioned();
+        if (itr.aggregate)
+            itr.aggregate->repartitioned();
+    }
+
+    LOG_DEBUG << "MPI Process " << rank << " now has " << _mesh->size_faces() << " faces [ " << c.toc<ms>() << "ms]";
+}
+#endif
+
+void core::swap_member(ensemble_member& member)
+{
+    std::swap(_modules, member.modules);
+    std::swap(_chunked_modules, member.chunked_modules);
+    std::swap(_outputs, member.outputs);
+    _mesh->swap_state(member.state);
+}
+
+void core::write_output(output_info& out, uint64_t time)
+{
+    if (out.type == output_info::output_type::raster)
+    {
+        // only copies out the face values, the raster is written in the background
+        out.raster->write(time);
+        return;
+    }
+
+    // gathers onto rank 0 under MPI, so has to be out here and not in a task
+    if(out.ugrid)
+        out.ugrid->write(time);
+
+    if(out.has_format(output_info::mesh_outputs::vtu))
+    {
+        std::vector<std::string> output;
+        if(out.aggregate)
+            output = out.aggregate->output_variables();
+        else
+            output.assign(out.variables.begin(),out.variables.end()); //convert to list to match internal lists
+
+        _mesh->update_vtk_data(output); //update the internal vtk mesh
+    }
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for (auto jtr : out.mesh_output_formats)
+            {
+                #pragma omp task
+                {
+                    std::string base_name = out.fname + std::to_string(time);
+                    boost::filesystem::path p(base_name);
+
+                    if (jtr == output_info::mesh_outputs::vtu  )
+                    {
+
+                        // this really only works if we let rank0 handle the io.
+                        // If we let each process do it, they walk all over each other's output
+#ifdef USE_MPI
+                        if(_comm_world.rank() == 0)
+                        {
+                            for(int rank = 0; rank < _comm_world.size(); rank++)
+                            {
+#else
+                                int rank = 0;
+#endif
+                                pt::ptree &dataset = out.pvd.add("VTKFile.Collection.DataSet", "");
+                                dataset.add("<xmlattr>.timestep", time);
+                                dataset.add("<xmlattr>.group", "");
+                                dataset.add("<xmlattr>.part", rank);
+                                dataset.add("<xmlattr>.file", p.filename().string()+"_"+std::to_string(rank) + ".vtu");
+#ifdef USE_MPI
+                            }
+                        }
+#endif
+
+                        //because a full path can be provided for the base_name, we need to strip this off
+                        //to make it a relative path in the xml file.
+
+#ifdef USE_MPI
+                        _mesh->write_vtu(base_name + "_"+std::to_string(_comm_world.rank() )+ ".vtu");
+#else
+                        _mesh->write_vtu(base_name + "_"+std::to_string(rank)+ ".vtu");
+#endif
+
+                    }
+                }
+            }
+        }
     }
 }
 
 void core::end()
 {
     LOG_DEBUG << "Cleaning up";
+
+    log_limiter::report();
+
+    // the log file is copied to the output once we're done
+    flush_log();
+}
+
+void core::flush_log()
+{
+    if (_cout_log_sink)
+        _cout_log_sink->flush();
+    if (_log_sink)
+        _log_sink->flush();
 }
 
 void core::populate_face_station_lists()
@@ -42,10 +42,12 @@
 #include <chrono>
 #include <map>
 #include <stdio.h>
+#include <glob.h>
 #include <cstdlib>
 #include <chrono>
 #include <algorithm>
 #include <memory> //unique ptr
+#include <functional>
 
 //boost includes
 #include <boost/graph/graph_traits.hpp>
@@ -89,6 +91,10 @@ namespace po = boost::program_options;
 #include "timeseries/netcdf.hpp"
 #include "gsl/gsl_errno.h"
 #include "metdata.hpp"
+#include "raster_output.hpp"
+#include "ugrid_output.hpp"
+#include "face_aggregator.hpp"
+#include "mesh_arrays.hpp"
 
 #ifdef USE_MPI
 #include <boost/mpi.hpp>
@@ -182,6 +188,8 @@ public:
     void config_output(pt::ptree& value);
     void config_global( pt::ptree& value);
     void config_checkpoint( pt::ptree& value);
+    void config_spinup( pt::ptree& value);
+    void config_load_balance( pt::ptree& value);
 
     /**
      * Determines what the start end times should be, and ensures consistency from a check pointed file
@@ -224,6 +232,12 @@ public:
 
     void run();
     void end();
+
+    /**
+     * Blocks until the asynchronous log sinks have written every queued record. Call before any exit path that
+     * skips ~core, e.g., exit() or an abort, so the last records, usually the error, aren't lost.
+     */
+    void flush_log();
     pt::ptree _cfg;
     boost::filesystem::path o_path; //path to output folder
     boost::filesystem::path log_file_path; // fully qualified path to the log file
@@ -275,6 +289,18 @@ protected:
     bool _use_netcdf; // flag if we are using netcdf. If we are, it enables incremental reads of the netcdf file for speed.
     std::shared_ptr<metdata> _metdata; //met data loader, shared for use with boost::bind
 
+    // directory of the module init artifacts, empty if they aren't cached
+    std::string _artifact_dir;
+
+    // the config, other than the forcing section, that the forcing cache depends on
+    std::string _forcing_cache_key;
+
+    /**
+     * Name of the forcing cache file for this forcing section and these forcing files. Anything the filtered forcing
+     * depends on is part of the name, so a changed configuration misses the cache instead of loading stale forcing.
+     */
+    std::string forcing_cache_file(const pt::ptree& forcing, const std::vector<std::string>& files);
+
     //calculates the order modules are to be run in
     void _determine_module_dep();
 
@@ -302,6 +328,40 @@ protected:
 
     } point_mode;
 
+    // Spin-up repeats the first part of the forcing before the run, to bring the model state into equilibrium with it
+    struct spinup_info
+    {
+        size_t cycles; // maximum number of times to repeat the period, 0 = no spin-up
+        size_t timesteps; // length of the period
+        boost::posix_time::ptime end; // or the end of the period, if set
+        double tolerance; // stop once no face variable changes by more than this over a cycle
+        std::vector<std::string> variables; // face variables to check for convergence
+    } _spinup;
+
+    // runs the modules over the spin-up period until the state converges, without writing outputs
+    void spinup();
+
+    // Load balancing measures the time the modules take on each face. Under MPI, when the processes' times are too uneven,
+    // the mesh is repartitioned by the measured costs and the faces' state is moved to their new processes
+    struct load_balance_info
+    {
+        bool enable;
+        size_t frequency; // timesteps between checks of the imbalance, 0 = only report it
+        double threshold; // repartition once the slowest process takes this many times the mean
+        std::vector<double> face_cost; // time [s] the modules took on each local face since the last check
+        double step_time; // time [s] this process took to run the modules this timestep
+        double busy; // time [s] this process took to run the modules since the last check
+        size_t steps; // timesteps since the last check
+    } _load_balance;
+
+#ifdef USE_MPI
+    // reports this timestep's imbalance and repartitions when it has been over the threshold since the last check
+    void balance_load();
+
+    // repartitions the mesh by the measured face costs and moves the faces' state to their new processes
+    void rebalance();
+#endif
+
 
     class output_info
     {
@@ -318,13 +378,15 @@ protected:
         enum output_type
         {
             time_series,
-            mesh
+            mesh,
+            raster
         };
         enum mesh_outputs
         {
             vtp,
             vtu,
-            ascii
+            ascii,
+            ugrid
         };
 
         output_type type;
@@ -337,11 +399,60 @@ protected:
         mesh_elem face;
         timeseries ts;
         size_t frequency;
+        std::shared_ptr<raster_output> raster;
+        std::shared_ptr<ugrid_output> ugrid;
+
+        // if set, the output is of statistics over a time window and is written at the end of each window
+        std::shared_ptr<face_aggregator> aggregate;
+
+        // paraview collection of the vtu files
+        pt::ptree pvd;
+
+        bool has_format(mesh_outputs format) const
+        {
+            return std::find(mesh_output_formats.begin(), mesh_output_formats.end(), format) != mesh_output_formats.end();
+        }
 
     };
 
     std::vector<output_info> _outputs;
 
+    // writes a mesh or raster output of the current face values, stamped with time [s since epoch]
+    void write_output(output_info& out, uint64_t time);
+
+    // runs the modules for one timestep. Returns false if a module threw
+    bool run_modules();
+
+    // runs the modules for one timestep and writes the outputs. Returns false if a module threw
+    bool run_timestep(size_t current_ts);
+
+    // writes the partial statistics windows, the pvd files and the timeseries at the end of the run
+    void finish_outputs();
+
+    /**
+     * An ensemble member other than the active one. The mesh, geometry, stations and forcing are shared with the active
+     * member and only what differs between members is held here: the module instances, the outputs and the face state.
+     * swap_member exchanges these with the core's, so the member can be run as if it were the only one.
+     */
+    struct ensemble_member
+    {
+        std::vector< std::pair<module,size_t> > modules;
+        std::vector< std::vector < module> > chunked_modules;
+        std::vector<output_info> outputs;
+        std::vector<face_state> state;
+
+        pt::ptree config; // module config overrides
+        pt::ptree parameters; // parameter perturbations
+    };
+
+    // ensemble members 1..N-1, member 0 is the active one
+    std::vector<ensemble_member> _members;
+
+    void swap_member(ensemble_member& member);
+
+    // applies p = p*scale + offset to each of the parameters, on the faces currently swapped in
+    void perturb_parameters(const pt::ptree& parameters);
+
     netcdf _savestate; //file to save to when checkpointing.
     netcdf _in_savestate; // if we are loading from checkpoint
     bool _do_checkpoint; // should we check point?
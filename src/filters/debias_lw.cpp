@@ -52,3 +52,15 @@ void debias_lw::process(std::shared_ptr<station>& station)
     
     (*station)[var]=data;
 }
+
+void debias_lw::process(station_table& columns)
+{
+    double* data = columns[var];
+    size_t n = columns.size();
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++)
+    {
+        data[i] = is_nan(data[i]) ? data[i] : data[i] + fac;
+    }
+}
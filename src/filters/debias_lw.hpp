@@ -50,4 +50,5 @@ public:
     ~debias_lw();
     void init();
     void process(std::shared_ptr<station>& station);
+    void process(station_table& columns);
 };
@@ -28,6 +28,7 @@
 #include <boost/property_tree/json_parser.hpp>
 
 #include "station.hpp"
+#include "station_table.hpp"
 
 #include "factory.hpp"
 
@@ -44,8 +45,28 @@ public:
     virtual ~filter_base(){};
 
     virtual void init(){};
+
+    /**
+     * Filters a single station
+     */
     virtual void process(std::shared_ptr<station>& station){};
 
+    /**
+     * Filters one timestep of all the stations at once, working on a contiguous column of values per variable.
+     * Filters should override this with loops over the columns.
+     * The default is a compatibility wrapper that calls process(station) for each station of the table.
+     */
+    virtual void process(station_table& columns)
+    {
+        auto& stations = columns.stations();
+
+        #pragma omp parallel for
+        for (size_t i = 0; i < stations.size(); i++)
+        {
+            process(stations[i]);
+        }
+    }
+
     /// Denotes a new met variable that this filter provides. Must be specified in the ctor of a filter prior to use
     /// @param name Name of the new meteorological variable
     void provides(const std::string& name)
@@ -60,7 +81,7 @@ public:
         return _provides;
     }
 
-    bool is_nan(double variable)
+    static bool is_nan(double variable)
     {
         if( variable == -9999.0)
             return true;
@@ -65,3 +65,21 @@ void goodison_undercatch::process(std::shared_ptr<station>& station)
     (*station)[var]=data;
 
 }
+
+void goodison_undercatch::process(station_table& columns)
+{
+    double* data = columns[var];
+    const double* u = columns["u"];
+    size_t n = columns.size();
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++)
+    {
+        double CE = 100.00 - 0.44*u[i]*u[i]-1.98*u[i]; // in %
+        CE /= 100.0; // fraction
+
+        // p = 0 stays 0, even if u is missing
+        if (data[i] != 0)
+            data[i] = !is_nan(data[i]) && !is_nan(u[i]) ? data[i] / CE : -9999;
+    }
+}
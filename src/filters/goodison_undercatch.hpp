@@ -52,4 +52,5 @@ public:
     ~goodison_undercatch();
     void init();
     void process(std::shared_ptr<station>& station);
+    void process(station_table& columns);
 };
@@ -60,3 +60,16 @@ void macdonald_undercatch::process(std::shared_ptr<station>& station)
     (*station)[var]=data;
 
 }
+
+void macdonald_undercatch::process(station_table& columns)
+{
+    double* data = columns[var];
+    const double* u = columns["u"];
+    size_t n = columns.size();
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++)
+    {
+        data[i] = !is_nan(data[i]) && !is_nan(u[i]) ? data[i] / (1.010 * exp(-0.09*u[i])) : -9999;
+    }
+}
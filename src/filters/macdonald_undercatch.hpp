@@ -52,4 +52,5 @@ public:
     ~macdonald_undercatch();
     void init();
     void process(std::shared_ptr<station>& station);
+    void process(station_table& columns);
 };
@@ -57,3 +57,21 @@ void scale_wind_speed::process(std::shared_ptr<station>& station)
     (*station)["U_R"_s]=U_R;
 
 }
+
+void scale_wind_speed::process(station_table& columns)
+{
+    const double* U_F = columns[var]; // Here wind u [m/s] at Z_U
+    double* U_R = columns["U_R"];
+    size_t n = columns.size();
+
+    // Atmosphere::log_scale_wind, hoisted as the heights are the same for every station. Assume 0 snow depth
+    double z0 = Snow::Z0_SNOW;
+    double ln_out = log((Z_R - z0) / z0);
+    double ln_in = log((Z_F - z0) / z0);
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++)
+    {
+        U_R[i] = is_nan(U_F[i]) ? -9999 : U_F[i] * ln_out / ln_in;
+    }
+}
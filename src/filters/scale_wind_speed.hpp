@@ -59,4 +59,5 @@ public:
     ~scale_wind_speed();
     void init();
     void process(std::shared_ptr<station>& station);
+    void process(station_table& columns);
 };
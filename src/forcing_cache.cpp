@@ -0,0 +1,255 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "forcing_cache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+#include "exception.hpp"
+#include "logger.hpp"
+
+namespace
+{
+    const uint64_t magic = 0x3148434D43484346; // "FCHCMCH1"
+
+    // position of the timestep count in the header, which is only known once the cache is complete
+    const std::streamoff timesteps_offset = sizeof(uint64_t);
+
+    template<typename T>
+    void write_value(std::ofstream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write_string(std::ofstream& out, const std::string& s)
+    {
+        write_value(out, static_cast<uint64_t>(s.size()));
+        out.write(s.data(), s.size());
+    }
+
+    // reads from a mapped file, checking it doesn't run off the end
+    class reader
+    {
+    public:
+        reader(const char* data, size_t size, const std::string& path)
+                : _data(data), _size(size), _pos(0), _path(path)
+        {
+        }
+
+        template<typename T>
+        T value()
+        {
+            T v;
+            std::memcpy(&v, take(sizeof(T)), sizeof(T));
+            return v;
+        }
+
+        std::string string()
+        {
+            auto n = value<uint64_t>();
+            return std::string(take(n), n);
+        }
+
+        const char* take(size_t n)
+        {
+            if (_pos + n > _size)
+                BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Forcing cache " + _path + " is truncated"));
+
+            auto p = _data + _pos;
+            _pos += n;
+            return p;
+        }
+
+        size_t pos() const
+        {
+            return _pos;
+        }
+
+    private:
+        const char* _data;
+        size_t _size;
+        size_t _pos;
+        std::string _path;
+    };
+}
+
+forcing_cache::forcing_cache()
+{
+    _timesteps = 0;
+    _records = nullptr;
+}
+
+forcing_cache::~forcing_cache()
+{
+    // an unfinished cache is never used
+    if (_out.is_open())
+        close(false);
+}
+
+std::string forcing_cache::file_name(uint64_t key)
+{
+    std::stringstream ss;
+    ss << "forcing_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return ss.str();
+}
+
+void forcing_cache::open(const std::string& path)
+{
+    try
+    {
+        _map.open(path);
+    }
+    catch (std::exception& e)
+    {
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Unable to map forcing cache " + path + ": " + e.what()));
+    }
+
+    reader r(_map.data(), _map.size(), path);
+
+    if (r.value<uint64_t>() != magic)
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info(path + " is not a forcing cache"));
+
+    _timesteps = r.value<uint64_t>();
+    auto nvars = r.value<uint64_t>();
+    auto nstations = r.value<uint64_t>();
+    _start = boost::posix_time::from_time_t(0) + boost::posix_time::seconds(r.value<int64_t>());
+    _dt = boost::posix_time::seconds(r.value<int64_t>());
+
+    _variables.resize(nvars);
+    for (auto& v : _variables)
+        v = r.string();
+
+    _stations.resize(nstations);
+    for (auto& s : _stations)
+    {
+        s.id = r.string();
+        s.x = r.value<double>();
+        s.y = r.value<double>();
+        s.z = r.value<double>();
+    }
+
+    // the records are aligned for the floats
+    r.take((sizeof(float) - r.pos() % sizeof(float)) % sizeof(float));
+
+    size_t n = _timesteps * nvars * nstations;
+    _records = reinterpret_cast<const float*>(r.take(n * sizeof(float)));
+
+    LOG_DEBUG << "Mapped forcing cache " << path << " of " << _timesteps << " timesteps, " << nvars << " variables and "
+              << nstations << " stations";
+}
+
+void forcing_cache::create(const std::string& path, const std::vector<std::string>& variables,
+                           const std::vector<station_info>& stations, boost::posix_time::ptime start,
+                           boost::posix_time::time_duration dt)
+{
+    _path = path;
+    _variables = variables;
+    _stations = stations;
+    _start = start;
+    _dt = dt;
+    _timesteps = 0;
+
+    // unique per writer so concurrent runs building the same cache don't truncate each other's file
+    _tmp_path = _path + "." + boost::filesystem::unique_path().string();
+    _out.open(_tmp_path, std::ios::binary | std::ios::trunc);
+    if (!_out)
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Unable to create forcing cache " + _tmp_path));
+
+    write_value(_out, magic);
+    write_value(_out, static_cast<uint64_t>(0));
+    write_value(_out, static_cast<uint64_t>(_variables.size()));
+    write_value(_out, static_cast<uint64_t>(_stations.size()));
+    write_value(_out, static_cast<int64_t>((_start - boost::posix_time::from_time_t(0)).total_seconds()));
+    write_value(_out, static_cast<int64_t>(_dt.total_seconds()));
+
+    for (auto& v : _variables)
+        write_string(_out, v);
+
+    for (auto& s : _stations)
+    {
+        write_string(_out, s.id);
+        write_value(_out, s.x);
+        write_value(_out, s.y);
+        write_value(_out, s.z);
+    }
+
+    std::streamoff pos = _out.tellp();
+    for (; pos % sizeof(float) != 0; pos++)
+        _out.put(0);
+
+    _buffer.resize(_variables.size() * _stations.size());
+}
+
+void forcing_cache::append(const std::vector<const double*>& columns)
+{
+    if (columns.size() != _variables.size())
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Forcing cache record has " + std::to_string(columns.size()) +
+                                                             " variables, expected " + std::to_string(_variables.size())));
+
+    const size_t n = _stations.size();
+    for (size_t v = 0; v < columns.size(); v++)
+    {
+        for (size_t i = 0; i < n; i++)
+            _buffer[v * n + i] = static_cast<float>(columns[v][i]);
+    }
+
+    _out.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size() * sizeof(float));
+    _timesteps++;
+}
+
+void forcing_cache::close(bool complete)
+{
+    if (!_out.is_open())
+        return;
+
+    if (complete)
+    {
+        _out.seekp(timesteps_offset);
+        write_value(_out, static_cast<uint64_t>(_timesteps));
+    }
+    _out.close();
+
+    if (complete && _out)
+    {
+        boost::filesystem::rename(_tmp_path, _path);
+        LOG_DEBUG << "Wrote forcing cache " << _path << " of " << _timesteps << " timesteps";
+    }
+    else
+    {
+        boost::filesystem::remove(_tmp_path);
+        LOG_DEBUG << "Forcing cache " << _path << " was not complete and was removed";
+    }
+}
+
+const float* forcing_cache::record(size_t timestep) const
+{
+    if (timestep >= _timesteps)
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Forcing cache has no timestep " + std::to_string(timestep)));
+
+    return _records + timestep * _variables.size() * _stations.size();
+}
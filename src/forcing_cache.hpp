@@ -0,0 +1,136 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+/**
+ * Binary file of the station values metdata produces each timestep, after the filters, subsetting and temporal interpolation,
+ * so that later runs over the same forcing can skip reading, parsing and filtering it.
+ *
+ * The file is a header, the variable names and the stations, followed by one record per timestep holding a float per station
+ * for each variable, i.e., [timestep][variable][station]. It is memory mapped for reading.
+ *
+ * It is written to a uniquely named temporary file next to <path> as the forcing is read and only renamed to <path> once
+ * every timestep has been written, so a run that stops early doesn't leave an incomplete cache behind and concurrent runs
+ * building the same cache don't clobber each other.
+ */
+class forcing_cache
+{
+public:
+    struct station_info
+    {
+        std::string id;
+        double x;
+        double y;
+        double z;
+    };
+
+    forcing_cache();
+    ~forcing_cache();
+
+    /**
+     * Maps an existing cache. Throws forcing_error if it isn't a valid cache
+     */
+    void open(const std::string& path);
+
+    /**
+     * Starts writing a new cache
+     * @param path Final path of the cache
+     * @param variables Variables of each record
+     * @param stations Stations of each record, in order
+     * @param start Time of the first record
+     * @param dt Time between records
+     */
+    void create(const std::string& path, const std::vector<std::string>& variables, const std::vector<station_info>& stations,
+                boost::posix_time::ptime start, boost::posix_time::time_duration dt);
+
+    /**
+     * Appends the next record, one column per variable in the order given to create
+     */
+    void append(const std::vector<const double*>& columns);
+
+    /**
+     * Finishes writing. If complete, the cache is moved into place, otherwise it is removed
+     */
+    void close(bool complete);
+
+    /**
+     * Record of timestep, as [variable][station]
+     */
+    const float* record(size_t timestep) const;
+
+    const std::vector<std::string>& variables() const
+    {
+        return _variables;
+    }
+
+    const std::vector<station_info>& stations() const
+    {
+        return _stations;
+    }
+
+    size_t timesteps() const
+    {
+        return _timesteps;
+    }
+
+    boost::posix_time::ptime start_time() const
+    {
+        return _start;
+    }
+
+    boost::posix_time::time_duration dt() const
+    {
+        return _dt;
+    }
+
+    /**
+     * File name of the cache for a key that covers everything the cached values depend on
+     */
+    static std::string file_name(uint64_t key);
+
+private:
+    std::vector<std::string> _variables;
+    std::vector<station_info> _stations;
+    size_t _timesteps;
+    boost::posix_time::ptime _start;
+    boost::posix_time::time_duration _dt;
+
+    // reading
+    boost::iostreams::mapped_file_source _map;
+    const float* _records;
+
+    // writing
+    std::string _path;
+    std::string _tmp_path;
+    std::ofstream _out;
+    std::vector<float> _buffer;
+};
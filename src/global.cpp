@@ -27,10 +27,22 @@ global::global()
 {
     first_time_step = true;
     _utc_offset = 0;
+    _dt = 0;
+    _is_geographic = false;
     _is_point_mode = false;
     timestep_counter=0;
 }
 
+std::shared_ptr<station_table> global::station_data()
+{
+    return _station_table;
+}
+
+artifact_store& global::artifacts()
+{
+    return _artifacts;
+}
+
 bool global::is_geographic()
 {
     return _is_geographic;
@@ -25,6 +25,7 @@
 
 
 
+#include <memory>
 #include <string>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -34,6 +35,8 @@ namespace pt = boost::property_tree;
 #include <tbb/concurrent_vector.h>
 
 #include "interpolation.hpp"
+#include "station_table.hpp"
+#include "artifact_store.hpp"
 
 #include "math/coordinates.hpp"
 
@@ -56,6 +59,7 @@ class global
     //This is because global gets passed to all modules and a rogue module could do something dumb
     //const doesn't save us as we actually do want to modify things
     friend class core;
+    friend class LehningSnowpackTest;
 
 private:
     boost::posix_time::ptime _current_date;
@@ -64,11 +68,27 @@ private:
     bool _is_geographic;
     bool _is_point_mode;
 
+    std::shared_ptr<station_table> _station_table;
+
+    artifact_store _artifacts;
+
 
 public:
 
     bool is_point_mode();
 
+    /**
+     * Current timestep of all the stations, a column per variable. Resolve column handles from this once, outside of the
+     * loops over faces, and index them with the face's stations.
+     */
+    std::shared_ptr<station_table> station_data();
+
+    /**
+     * Store of the fields modules compute in init from the terrain alone. Modules can load these instead of computing them
+     * again when a run on the same mesh and config has already stored them.
+     */
+    artifact_store& artifacts();
+
     // UTC offset
     int _utc_offset;
     bool is_geographic();
@@ -72,7 +72,7 @@ double interpolation::operator()(std::vector< boost::tuple<double,double,double>
 
     if (sample_points.size() > 15 && ia == interp_alg::tpspline)
     {
-        LOG_WARNING << "More than 15 sample points is likely to cause slow downs";
+        LOG_WARNING_LIMITED << "More than 15 sample points is likely to cause slow downs";
     }
 
 //    if(sample_points.size() != this->size || this->size == 0)
@@ -25,6 +25,10 @@
 
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
 
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
@@ -45,6 +49,7 @@
 #include <boost/log/sources/record_ostream.hpp>
 
 #include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 
 
@@ -92,7 +97,10 @@ inline std::basic_ostream< CharT, TraitsT >& operator<< (std::basic_ostream< Cha
 }
 
 typedef src::severity_logger_mt<log_level> sev_logger;
-typedef sinks::synchronous_sink< sinks::text_ostream_backend> text_sink;
+
+// records are put on a lock-free queue and formatted and written by the sink's own thread, so logging from
+// the omp loops doesn't serialize them on the sink. Call flush() before reading the log file.
+typedef sinks::asynchronous_sink< sinks::text_ostream_backend> text_sink;
 
 BOOST_LOG_INLINE_GLOBAL_LOGGER_DEFAULT(logger, sev_logger)
 BOOST_LOG_ATTRIBUTE_KEYWORD(severity, "Severity", log_level)
@@ -103,4 +111,81 @@ BOOST_LOG_ATTRIBUTE_KEYWORD(severity, "Severity", log_level)
 #define	LOG_DEBUG       BOOST_LOG_NAMED_SCOPE(__PRETTY_FUNCTION__) BOOST_LOG_SEV(logger::get(), debug) 
 #define	LOG_WARNING 	BOOST_LOG_NAMED_SCOPE(__PRETTY_FUNCTION__) BOOST_LOG_SEV(logger::get(), warning) 
 #define	LOG_ERROR 	BOOST_LOG_NAMED_SCOPE(__PRETTY_FUNCTION__) BOOST_LOG_SEV(logger::get(), error) 
-#define	LOG_INFO 	BOOST_LOG_NAMED_SCOPE(__PRETTY_FUNCTION__) BOOST_LOG_SEV(logger::get(), info) 
\ No newline at end of file
+#define	LOG_INFO 	BOOST_LOG_NAMED_SCOPE(__PRETTY_FUNCTION__) BOOST_LOG_SEV(logger::get(), info)
+
+
+/**
+ * Bounds how many records a call site emits, for logging from per-face loops where one bad input would otherwise
+ * log for every face. The first max_records hits at a site are logged, the rest are only counted.
+ * report() logs how many records each site dropped and starts the count again. Use via the LOG_*_LIMITED macros.
+ */
+class log_limiter
+{
+public:
+    static const size_t max_records = 10;
+
+    log_limiter(const char* file, int line, log_level level)
+            : _file(file), _line(line), _level(level), _hits(0)
+    {
+        const char* name = std::strrchr(file, '/');
+        if (name)
+            _file = name + 1;
+
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry().push_back(this);
+    }
+
+    /**
+     * Counts a hit, true if it should be logged
+     */
+    bool hit()
+    {
+        return _hits.fetch_add(1, std::memory_order_relaxed) < max_records;
+    }
+
+    /**
+     * Logs the number of records dropped at each site since the last report
+     */
+    static void report()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (auto site : registry())
+        {
+            size_t hits = site->_hits.exchange(0, std::memory_order_relaxed);
+            if (hits > max_records)
+            {
+                BOOST_LOG_SEV(logger::get(), site->_level) << "The previous message from " << site->_file << ":"
+                                                           << site->_line << " was repeated " << hits - max_records
+                                                           << " more times (" << hits << " in total)";
+            }
+        }
+    }
+
+private:
+    static std::vector<log_limiter*>& registry()
+    {
+        static std::vector<log_limiter*> sites;
+        return sites;
+    }
+
+    static std::mutex& registry_mutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    const char* _file;
+    int _line;
+    log_level _level;
+    std::atomic<size_t> _hits;
+};
+
+// the limiter is a static local of a lambda, so one per call site. The loops make this a single statement that runs its body at most once.
+#define LOG_LIMITED(lvl) \
+    for (bool _log_limited = [] { static log_limiter site(__FILE__, __LINE__, lvl); return site.hit(); }(); \
+         _log_limited; _log_limited = false) \
+        for (attrs::named_scope::sentry _log_scope(__PRETTY_FUNCTION__, __FILE__, __LINE__); _log_limited; _log_limited = false) \
+            BOOST_LOG_SEV(logger::get(), lvl)
+
+#define LOG_WARNING_LIMITED LOG_LIMITED(warning)
+#define LOG_ERROR_LIMITED LOG_LIMITED(error)
@@ -46,6 +46,25 @@ int main (int argc, char *argv[])
         kernel.end(); //make sure endwin() is called so ncurses cleans up
 
         LOG_ERROR << boost::diagnostic_information(e);
+        kernel.flush_log();
+
+        return -1;
+    }
+    catch( std::exception& e)
+    {
+        kernel.end();
+
+        LOG_ERROR << e.what();
+        kernel.flush_log();
+
+        return -1;
+    }
+    catch( ... )
+    {
+        kernel.end();
+
+        LOG_ERROR << "Unknown exception";
+        kernel.flush_log();
 
         return -1;
     }
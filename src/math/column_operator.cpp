@@ -0,0 +1,319 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include "column_operator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "exception.hpp"
+
+namespace math
+{
+    static double dot(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        double sum = 0;
+        const size_t n = a.size();
+
+        #pragma omp parallel for reduction(+:sum)
+        for (size_t i = 0; i < n; i++)
+            sum += a[i] * b[i];
+
+        return sum;
+    }
+
+    column_operator::column_operator()
+            : _ncol(0), _nlayer(0), _error(0)
+    {
+    }
+
+    column_operator::column_operator(size_t ncol, size_t nlayer)
+            : _ncol(ncol), _nlayer(nlayer), _neighbours(3 * ncol, -1), _diag(ncol * nlayer, 0.),
+              _up(ncol * nlayer, 0.), _down(ncol * nlayer, 0.), _lateral(3 * ncol * nlayer, 0.), _error(0)
+    {
+    }
+
+    void column_operator::set_neighbours(size_t i, const std::array<int, 3>& neighbours)
+    {
+        for (size_t j = 0; j < 3; j++)
+            _neighbours[3 * i + j] = neighbours[j];
+    }
+
+    void column_operator::apply(const double* x, double* y) const
+    {
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < _ncol; i++)
+        {
+            const int* n = &_neighbours[3 * i];
+
+            for (size_t z = 0; z < _nlayer; z++)
+            {
+                size_t c = _ncol * z + i;
+                double sum = _diag[c] * x[c];
+
+                if (z > 0)
+                    sum += _down[c] * x[c - _ncol];
+                if (z + 1 < _nlayer)
+                    sum += _up[c] * x[c + _ncol];
+
+                for (size_t j = 0; j < 3; j++)
+                {
+                    if (n[j] >= 0)
+                        sum += _lateral[3 * c + j] * x[_ncol * z + n[j]];
+                }
+
+                y[c] = sum;
+            }
+        }
+    }
+
+    void column_operator::factor()
+    {
+        _cp.resize(size());
+        _inv_denom.resize(size());
+
+        bool singular = false;
+
+        #pragma omp parallel for schedule(static) reduction(||:singular)
+        for (size_t i = 0; i < _ncol; i++)
+        {
+            for (size_t z = 0; z < _nlayer; z++)
+            {
+                size_t c = _ncol * z + i;
+
+                double denom = _diag[c];
+                if (z > 0)
+                    denom -= _down[c] * _cp[c - _ncol];
+
+                if (denom == 0 || !std::isfinite(denom))
+                {
+                    singular = true;
+                    denom = 1;
+                }
+
+                _inv_denom[c] = 1. / denom;
+                _cp[c] = _up[c] * _inv_denom[c];
+            }
+        }
+
+        if (singular)
+            BOOST_THROW_EXCEPTION(chm_error() << errstr_info("column_operator: zero pivot in a column tridiagonal"));
+    }
+
+    void column_operator::line_solve(const double* r, double* y) const
+    {
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < _ncol; i++)
+        {
+            // forward sweep
+            for (size_t z = 0; z < _nlayer; z++)
+            {
+                size_t c = _ncol * z + i;
+                double d = r[c];
+                if (z > 0)
+                    d -= _down[c] * y[c - _ncol];
+                y[c] = d * _inv_denom[c];
+            }
+
+            // back substitution
+            for (size_t z = _nlayer - 1; z-- > 0;)
+            {
+                size_t c = _ncol * z + i;
+                y[c] -= _cp[c] * y[c + _ncol];
+            }
+        }
+    }
+
+    size_t column_operator::solve(const std::vector<double>& b, std::vector<double>& x, double tol,
+                                  size_t max_iterations, size_t krylov_dim)
+    {
+        const size_t n = size();
+        x.resize(n, 0.);
+        _error = 0;
+
+        double b_norm = std::sqrt(dot(b, b));
+        if (b_norm == 0)
+        {
+            std::fill(x.begin(), x.end(), 0.);
+            return 0;
+        }
+
+        factor();
+
+        const size_t m = krylov_dim;
+        std::vector<std::vector<double>> V(m + 1, std::vector<double>(n));
+        std::vector<std::vector<double>> H(m + 1, std::vector<double>(m, 0.));
+        std::vector<double> cs(m), sn(m), g(m + 1), y(m);
+        std::vector<double> w(n), u(n);
+
+        // r = b - A x
+        auto residual = [&](std::vector<double>& r)
+        {
+            apply(x.data(), r.data());
+
+            #pragma omp parallel for
+            for (size_t k = 0; k < n; k++)
+                r[k] = b[k] - r[k];
+        };
+
+        size_t iterations = 0;
+        residual(V[0]);
+        double beta = std::sqrt(dot(V[0], V[0]));
+        _error = beta / b_norm;
+
+        while (_error > tol && iterations < max_iterations)
+        {
+            #pragma omp parallel for
+            for (size_t k = 0; k < n; k++)
+                V[0][k] /= beta;
+
+            std::fill(g.begin(), g.end(), 0.);
+            g[0] = beta;
+
+            size_t j = 0;
+            while (j < m && iterations < max_iterations)
+            {
+                // right preconditioned, w = A M^-1 v_j
+                line_solve(V[j].data(), u.data());
+                apply(u.data(), w.data());
+
+                // modified Gram-Schmidt
+                for (size_t i = 0; i <= j; i++)
+                {
+                    H[i][j] = dot(w, V[i]);
+
+                    #pragma omp parallel for
+                    for (size_t k = 0; k < n; k++)
+                        w[k] -= H[i][j] * V[i][k];
+                }
+                H[j + 1][j] = std::sqrt(dot(w, w));
+
+                if (H[j + 1][j] != 0)
+                {
+                    #pragma omp parallel for
+                    for (size_t k = 0; k < n; k++)
+                        V[j + 1][k] = w[k] / H[j + 1][j];
+                }
+
+                // Givens rotations to keep H upper triangular
+                for (size_t i = 0; i < j; i++)
+                {
+                    double t = cs[i] * H[i][j] + sn[i] * H[i + 1][j];
+                    H[i + 1][j] = -sn[i] * H[i][j] + cs[i] * H[i + 1][j];
+                    H[i][j] = t;
+                }
+
+                double r = std::hypot(H[j][j], H[j + 1][j]);
+                cs[j] = r == 0 ? 1 : H[j][j] / r;
+                sn[j] = r == 0 ? 0 : H[j + 1][j] / r;
+                H[j][j] = r;
+                H[j + 1][j] = 0;
+
+                g[j + 1] = -sn[j] * g[j];
+                g[j] = cs[j] * g[j];
+
+                iterations++;
+                j++;
+
+                _error = std::fabs(g[j]) / b_norm;
+                if (_error <= tol || r == 0)
+                    break;
+            }
+
+            // x += M^-1 V y, with H y = g
+            for (size_t i = j; i-- > 0;)
+            {
+                double sum = g[i];
+                for (size_t k = i + 1; k < j; k++)
+                    sum -= H[i][k] * y[k];
+                y[i] = H[i][i] == 0 ? 0 : sum / H[i][i];
+            }
+
+            #pragma omp parallel for
+            for (size_t k = 0; k < n; k++)
+            {
+                double sum = 0;
+                for (size_t i = 0; i < j; i++)
+                    sum += y[i] * V[i][k];
+                w[k] = sum;
+            }
+            line_solve(w.data(), u.data());
+
+            #pragma omp parallel for
+            for (size_t k = 0; k < n; k++)
+                x[k] += u[k];
+
+            // the true residual, for the restart
+            residual(V[0]);
+            beta = std::sqrt(dot(V[0], V[0]));
+            _error = beta / b_norm;
+
+            if (beta == 0)
+                break;
+        }
+
+        return iterations;
+    }
+
+    column_operator column_operator::restrict_to(const std::vector<unsigned int>& columns) const
+    {
+        column_operator sub(columns.size(), _nlayer);
+
+        std::vector<int> pos(_ncol, -1);
+        for (size_t k = 0; k < columns.size(); k++)
+            pos[columns[k]] = k;
+
+        const size_t nsub = columns.size();
+
+        #pragma omp parallel for
+        for (size_t k = 0; k < nsub; k++)
+        {
+            size_t i = columns[k];
+            for (size_t j = 0; j < 3; j++)
+            {
+                int n = _neighbours[3 * i + j];
+                sub._neighbours[3 * k + j] = n >= 0 ? pos[n] : -1;
+            }
+
+            for (size_t z = 0; z < _nlayer; z++)
+            {
+                size_t c = _ncol * z + i;
+                size_t sc = nsub * z + k;
+
+                sub._diag[sc] = _diag[c];
+                sub._up[sc] = _up[c];
+                sub._down[sc] = _down[c];
+
+                for (size_t j = 0; j < 3; j++)
+                {
+                    if (sub._neighbours[3 * k + j] >= 0)
+                        sub._lateral[3 * sc + j] = _lateral[3 * c + j];
+                }
+            }
+        }
+
+        return sub;
+    }
+}
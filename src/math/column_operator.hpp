@@ -0,0 +1,146 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace math
+{
+    /**
+     * Sparse operator over ncol columns of nlayer cells, as in the PBSM3D suspension layer. Each cell couples
+     * strongly to the cells above and below it and weakly to up to 3 lateral neighbours in its layer.
+     * Cell (i, z) is unknown ncol * z + i, the ordering PBSM3D uses for its matrix.
+     *
+     * The operator is applied matrix-free from the per-cell coefficients. solve() is a restarted GMRES preconditioned
+     * by exact tridiagonal solves down each column (vertical line block-Jacobi), which removes the strong vertical
+     * coupling and leaves the Krylov method only the lateral one.
+     */
+    class column_operator
+    {
+    public:
+        column_operator();
+        column_operator(size_t ncol, size_t nlayer);
+
+        /**
+         * Sets column i's lateral neighbours, -1 where there is none
+         */
+        void set_neighbours(size_t i, const std::array<int, 3>& neighbours);
+
+        /// Coefficient of cell (i, z) itself
+        double& diag(size_t i, size_t z)
+        {
+            return _diag[_ncol * z + i];
+        }
+
+        /// Coefficient of the cell above, (i, z + 1)
+        double& up(size_t i, size_t z)
+        {
+            return _up[_ncol * z + i];
+        }
+
+        /// Coefficient of the cell below, (i, z - 1)
+        double& down(size_t i, size_t z)
+        {
+            return _down[_ncol * z + i];
+        }
+
+        /// Coefficient of lateral neighbour j of cell (i, z)
+        double& lateral(size_t i, size_t z, size_t j)
+        {
+            return _lateral[3 * (_ncol * z + i) + j];
+        }
+
+        /**
+         * y = A x
+         */
+        void apply(const double* x, double* y) const;
+
+        /**
+         * Solves each column's tridiagonal system, ignoring the lateral coupling. Requires factor().
+         */
+        void line_solve(const double* r, double* y) const;
+
+        /**
+         * Factors the column tridiagonals for line_solve(). Throws a chm_error on a zero pivot.
+         */
+        void factor();
+
+        /**
+         * Solves A x = b, starting from x, with line preconditioned GMRES
+         * @param tol Relative residual |b - A x| / |b| to stop at
+         * @param krylov_dim Krylov dimension before restart
+         * @return Number of iterations
+         */
+        size_t solve(const std::vector<double>& b, std::vector<double>& x, double tol, size_t max_iterations,
+                     size_t krylov_dim);
+
+        /**
+         * Relative residual of the last solve
+         */
+        double error() const
+        {
+            return _error;
+        }
+
+        /**
+         * The operator over the given columns only. Lateral couplings to columns outside are dropped.
+         * @param columns Column ids in this operator, in the order they take in the new one
+         */
+        column_operator restrict_to(const std::vector<unsigned int>& columns) const;
+
+        size_t columns() const
+        {
+            return _ncol;
+        }
+
+        size_t layers() const
+        {
+            return _nlayer;
+        }
+
+        size_t size() const
+        {
+            return _ncol * _nlayer;
+        }
+
+    private:
+        size_t _ncol;
+        size_t _nlayer;
+
+        std::vector<int> _neighbours; // 3 per column
+        std::vector<double> _diag;
+        std::vector<double> _up;
+        std::vector<double> _down;
+        std::vector<double> _lateral; // 3 per cell
+
+        // Thomas algorithm factors of the column tridiagonals
+        std::vector<double> _cp;
+        std::vector<double> _inv_denom;
+
+        double _error;
+    };
+}
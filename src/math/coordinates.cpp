@@ -30,79 +30,105 @@ namespace math
 
         Point_2 point_from_bearing_latlong(Point_3 src, double bearing, double distance)
         {
-            // http://stackoverflow.com/questions/1125144/how-do-i-find-the-lat-long-that-is-x-km-north-of-a-given-lat-long
-            double Latitude = src.y();
-            double Longitude = src.x();
-            double PI = M_PI;
-            double DegreesToRadians = PI / 180.0;
-            double RadiansToDegrees = 180.0/PI;
-
-            double EarthRadius = 6378137.0;
-            double latA = Latitude * DegreesToRadians;
-            double lonA = Longitude * DegreesToRadians;
-            double angularDistance = distance / EarthRadius;
-            double trueCourse = bearing * DegreesToRadians;
-
-            double lat = asin(
-                    sin(latA) * cos(angularDistance) +
-                    cos(latA) * sin(angularDistance) * cos(trueCourse));
-
-            double dlon = atan2(
-                    sin(trueCourse) * sin(angularDistance) * cos(latA),
-                    cos(angularDistance) - sin(latA) * sin(lat));
-
-            double lon = ( fmod( lonA + dlon + PI , PI*2) ) - PI;
-
-            return Point_2(lat * RadiansToDegrees,lon * RadiansToDegrees);
-
+            return LatLong::point_from_bearing(src, bearing, distance);
         }
 
         Point_2 point_from_bearing_UTM(Point_3 src, double bearing, double distance)
         {
-
-            double DegreesToRadians = M_PI / 180.0;
-
-            bearing = bearing * DegreesToRadians;
-
-            double dist_x = distance * sin(bearing);
-            double dist_y = distance * cos(bearing);
-
-            return Point_2(src.x() + dist_x, src.y() + dist_y);
+            return UTM::point_from_bearing(src, bearing, distance);
         }
 
         double distance_latlong(Point_3 pt1, Point_3 pt2)
         {
-            double PI = M_PI;
-            double DegreesToRadians = PI / 180.0;
-
-            double lat1=pt1.y() * DegreesToRadians;
-            double lon1=pt1.x() * DegreesToRadians;
+            return LatLong::distance(pt1, pt2);
+        }
 
-            double lat2=pt2.y() * DegreesToRadians;
-            double lon2=pt2.x() * DegreesToRadians;
+        double distance_UTM(Point_3 pt1, Point_3 pt2)
+        {
+            return UTM::distance(pt1, pt2);
+        }
 
-            double R = 6378137.0;; // metres, earth r
-            double phi1 = lat1;
-            double phi2 = lat2;
-            double delta_phi = (lat2-lat1);
-            double delta_lon = (lon2-lon1);
+        void UTM::point_from_bearing(const Point_3& src, double bearing, const double* distance,
+                                     double* x, double* y, size_t n)
+        {
+            bearing = bearing * (M_PI / 180.0);
+
+            double sin_b = sin(bearing);
+            double cos_b = cos(bearing);
+            double x0 = src.x();
+            double y0 = src.y();
+
+            for (size_t i = 0; i < n; i++)
+            {
+                x[i] = x0 + distance[i] * sin_b;
+                y[i] = y0 + distance[i] * cos_b;
+            }
+        }
 
-            double a = sin(delta_phi/2.) * sin(delta_phi/2.) +
-                    cos(phi1) * cos(phi2) *
-                    sin(delta_lon/2.) * sin(delta_lon/2.);
-            double c = 2. * atan2(sqrt(a), sqrt(1.-a));
+        void UTM::distance(const Point_3& src, const double* x, const double* y, double* d, size_t n)
+        {
+            double x0 = src.x();
+            double y0 = src.y();
+
+            for (size_t i = 0; i < n; i++)
+            {
+                double dx = x[i] - x0;
+                double dy = y[i] - y0;
+                d[i] = sqrt(dx * dx + dy * dy);
+            }
+        }
 
-            double d = R * c;
+        constexpr double LatLong::earth_radius;
 
-            return d;
+        void LatLong::point_from_bearing(const Point_3& src, double bearing, const double* distance,
+                                         double* x, double* y, size_t n)
+        {
+            // only the angular distance changes along the ray
+            double latA = src.y() * (M_PI / 180.0);
+            double lonA = src.x() * (M_PI / 180.0);
+            double trueCourse = bearing * (M_PI / 180.0);
+
+            double sin_latA = sin(latA);
+            double cos_latA = cos(latA);
+            double sin_tc = sin(trueCourse);
+            double cos_tc = cos(trueCourse);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                double angularDistance = distance[i] / earth_radius;
+                double sin_ad = sin(angularDistance);
+                double cos_ad = cos(angularDistance);
+
+                double lat = asin(sin_latA * cos_ad + cos_latA * sin_ad * cos_tc);
+                double dlon = atan2(sin_tc * sin_ad * cos_latA, cos_ad - sin_latA * sin(lat));
+                double lon = (fmod(lonA + dlon + M_PI, M_PI * 2)) - M_PI;
+
+                x[i] = lon * (180.0 / M_PI);
+                y[i] = lat * (180.0 / M_PI);
+            }
         }
 
-        double distance_UTM(Point_3 pt1, Point_3 pt2)
+        void LatLong::distance(const Point_3& src, const double* x, const double* y, double* d, size_t n)
         {
-            Point_2 p1(pt1.x(),pt1.y());
-            Point_2 p2(pt2.x(),pt2.y());
+            double lat1 = src.y() * (M_PI / 180.0);
+            double lon1 = src.x() * (M_PI / 180.0);
+            double cos_lat1 = cos(lat1);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                double lat2 = y[i] * (M_PI / 180.0);
+                double lon2 = x[i] * (M_PI / 180.0);
+
+                double delta_phi = (lat2 - lat1);
+                double delta_lon = (lon2 - lon1);
+
+                double a = sin(delta_phi / 2.) * sin(delta_phi / 2.) +
+                           cos_lat1 * cos(lat2) *
+                           sin(delta_lon / 2.) * sin(delta_lon / 2.);
+                double c = 2. * atan2(sqrt(a), sqrt(1. - a));
 
-            return sqrt( CGAL::squared_distance(p1,p2) );
+                d[i] = earth_radius * c;
+            }
         }
 
         boost::function<double(Point_3 pt1, Point_3 pt2)> distance;
@@ -23,6 +23,7 @@
 
 #pragma once
 #include <cmath>
+#include <cstddef>
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/squared_distance_2.h>
 #include <boost/function.hpp>
@@ -67,6 +68,108 @@ namespace math
         extern boost::function<double(Point_3 pt1, Point_3 pt2)> distance;
         extern boost::function<Point_2(Point_3 src, double bearing, double distance)> point_from_bearing;
 
+        /**
+         * Geometry of projected (UTM) meshes. Along with LatLong, this is the compile time counterpart of distance and
+         * point_from_bearing above: hot loops (e.g., ray marching) take the policy as a template parameter and are
+         * instantiated for both, selected by global::is_geographic(), so the calls inline.
+         */
+        struct UTM
+        {
+            /**
+             * Same as point_from_bearing_UTM
+             */
+            static Point_2 point_from_bearing(const Point_3& src, double bearing, double distance)
+            {
+                bearing = bearing * (M_PI / 180.0);
+                return Point_2(src.x() + distance * sin(bearing), src.y() + distance * cos(bearing));
+            }
+
+            /**
+             * Same as distance_UTM
+             */
+            static double distance(const Point_3& pt1, const Point_3& pt2)
+            {
+                double dx = pt2.x() - pt1.x();
+                double dy = pt2.y() - pt1.y();
+                return sqrt(dx * dx + dy * dy);
+            }
+
+            /**
+             * n points along one bearing from src
+             * @param src Source point
+             * @param bearing Degrees, CW from north
+             * @param distance n distances, meters
+             * @param x n x coordinates of the points
+             * @param y n y coordinates of the points
+             */
+            static void point_from_bearing(const Point_3& src, double bearing, const double* distance,
+                                           double* x, double* y, size_t n);
+
+            /**
+             * Distances from src to n points
+             */
+            static void distance(const Point_3& src, const double* x, const double* y, double* d, size_t n);
+        };
+
+        /**
+         * Geometry of geographic meshes, x is longitude and y latitude in decimal degrees. See UTM.
+         */
+        struct LatLong
+        {
+            static constexpr double earth_radius = 6378137.0; // m
+
+            /**
+             * Same as point_from_bearing_latlong
+             */
+            static Point_2 point_from_bearing(const Point_3& src, double bearing, double distance)
+            {
+                // http://stackoverflow.com/questions/1125144/how-do-i-find-the-lat-long-that-is-x-km-north-of-a-given-lat-long
+                double latA = src.y() * (M_PI / 180.0);
+                double lonA = src.x() * (M_PI / 180.0);
+                double angularDistance = distance / earth_radius;
+                double trueCourse = bearing * (M_PI / 180.0);
+
+                double lat = asin(
+                        sin(latA) * cos(angularDistance) +
+                        cos(latA) * sin(angularDistance) * cos(trueCourse));
+
+                double dlon = atan2(
+                        sin(trueCourse) * sin(angularDistance) * cos(latA),
+                        cos(angularDistance) - sin(latA) * sin(lat));
+
+                double lon = (fmod(lonA + dlon + M_PI, M_PI * 2)) - M_PI;
+
+                return Point_2(lon * (180.0 / M_PI), lat * (180.0 / M_PI));
+            }
+
+            /**
+             * Same as distance_latlong, haversine formula
+             */
+            static double distance(const Point_3& pt1, const Point_3& pt2)
+            {
+                double lat1 = pt1.y() * (M_PI / 180.0);
+                double lon1 = pt1.x() * (M_PI / 180.0);
+
+                double lat2 = pt2.y() * (M_PI / 180.0);
+                double lon2 = pt2.x() * (M_PI / 180.0);
+
+                double delta_phi = (lat2 - lat1);
+                double delta_lon = (lon2 - lon1);
+
+                double a = sin(delta_phi / 2.) * sin(delta_phi / 2.) +
+                           cos(lat1) * cos(lat2) *
+                           sin(delta_lon / 2.) * sin(delta_lon / 2.);
+                double c = 2. * atan2(sqrt(a), sqrt(1. - a));
+
+                return earth_radius * c;
+            }
+
+            static void point_from_bearing(const Point_3& src, double bearing, const double* distance,
+                                           double* x, double* y, size_t n);
+
+            static void distance(const Point_3& src, const double* x, const double* y, double* d, size_t n);
+        };
+
         /**
          * Converts a North-based bearing to polar coodinates.
          * @param bearing In degrees, N=0
@@ -0,0 +1,213 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "lookup_table.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "exception.hpp"
+
+namespace math
+{
+    // cells per axis to start refining from
+    static const size_t initial_cells = 16;
+
+    static double error(double exact, double approx)
+    {
+        return std::fabs(exact - approx) / std::max(1.0, std::fabs(exact));
+    }
+
+    lookup_table_1d::lookup_table_1d()
+            : _x0(0), _x1(0), _inv_dx(0), _last(0), _max_error(0), _y(2, 0.)
+    {
+    }
+
+    lookup_table_1d::lookup_table_1d(const std::function<double(double)>& f, double x0, double x1, double tol,
+                                     size_t max_cells)
+            : _x0(x0), _x1(x1)
+    {
+        if (!(x1 > x0))
+            BOOST_THROW_EXCEPTION(chm_error() << errstr_info("lookup_table_1d: empty range"));
+
+        size_t n = initial_cells;
+        _y.resize(n + 1);
+        for (size_t k = 0; k <= n; k++)
+            _y[k] = f(x0 + (x1 - x0) * k / n);
+
+        std::vector<double> mid;
+        while (true)
+        {
+            double dx = (x1 - x0) / n;
+
+            mid.resize(n);
+            _max_error = 0;
+            for (size_t k = 0; k < n; k++)
+            {
+                mid[k] = f(x0 + dx * (k + 0.5));
+                _max_error = std::max(_max_error, error(mid[k], 0.5 * (_y[k] + _y[k + 1])));
+            }
+
+            if (_max_error <= tol)
+                break;
+
+            if (2 * n > max_cells)
+                BOOST_THROW_EXCEPTION(chm_error() << errstr_info(
+                        "lookup_table_1d: can't reach a tolerance of " + std::to_string(tol) + " with " +
+                        std::to_string(max_cells) + " cells, error is " + std::to_string(_max_error)));
+
+            // the midpoints become the new nodes
+            std::vector<double> y(2 * n + 1);
+            for (size_t k = 0; k < n; k++)
+            {
+                y[2 * k] = _y[k];
+                y[2 * k + 1] = mid[k];
+            }
+            y[2 * n] = _y[n];
+
+            _y.swap(y);
+            n *= 2;
+        }
+
+        _inv_dx = n / (x1 - x0);
+        _last = static_cast<double>(n - 1);
+    }
+
+    void lookup_table_1d::operator()(const double* x, double* y, size_t n) const
+    {
+        const double* table = _y.data();
+
+#ifdef _OPENMP
+        #pragma omp simd
+#endif
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t k;
+            double w;
+            locate(x[i], _x0, _inv_dx, _last, k, w);
+
+            y[i] = table[k] + w * (table[k + 1] - table[k]);
+        }
+    }
+
+    lookup_table_2d::lookup_table_2d()
+            : _x0(0), _x1(0), _y0(0), _y1(0), _inv_dx(0), _inv_dy(0), _last_x(0), _last_y(0), _stride(2),
+              _max_error(0), _z(4, 0.)
+    {
+    }
+
+    lookup_table_2d::lookup_table_2d(const std::function<double(double, double)>& f, double x0, double x1, double y0,
+                                     double y1, double tol, size_t max_cells)
+            : _x0(x0), _x1(x1), _y0(y0), _y1(y1)
+    {
+        if (!(x1 > x0) || !(y1 > y0))
+            BOOST_THROW_EXCEPTION(chm_error() << errstr_info("lookup_table_2d: empty range"));
+
+        size_t nx = initial_cells;
+        size_t ny = initial_cells;
+
+        while (true)
+        {
+            double dx = (x1 - x0) / nx;
+            double dy = (y1 - y0) / ny;
+            _stride = nx + 1;
+
+            _z.resize((nx + 1) * (ny + 1));
+            for (size_t j = 0; j <= ny; j++)
+                for (size_t i = 0; i <= nx; i++)
+                    _z[j * _stride + i] = f(x0 + dx * i, y0 + dy * j);
+
+            // midpoints of the edges along x, along y, and of the cells
+            double ex = 0, ey = 0, ec = 0;
+            for (size_t j = 0; j <= ny; j++)
+            {
+                for (size_t i = 0; i <= nx; i++)
+                {
+                    double z = _z[j * _stride + i];
+                    double x = x0 + dx * i;
+                    double y = y0 + dy * j;
+
+                    if (i < nx)
+                        ex = std::max(ex, error(f(x + 0.5 * dx, y), 0.5 * (z + _z[j * _stride + i + 1])));
+
+                    if (j < ny)
+                        ey = std::max(ey, error(f(x, y + 0.5 * dy), 0.5 * (z + _z[(j + 1) * _stride + i])));
+
+                    if (i < nx && j < ny)
+                    {
+                        double c = 0.25 * (z + _z[j * _stride + i + 1] +
+                                           _z[(j + 1) * _stride + i] + _z[(j + 1) * _stride + i + 1]);
+                        ec = std::max(ec, error(f(x + 0.5 * dx, y + 0.5 * dy), c));
+                    }
+                }
+            }
+
+            _max_error = std::max(ec, std::max(ex, ey));
+            if (_max_error <= tol)
+                break;
+
+            // refine the axis the error is coming from
+            bool refine_x = ex > tol || (ec > tol && ex >= ey);
+            bool refine_y = ey > tol || (ec > tol && ey >= ex);
+
+            size_t new_nx = refine_x ? 2 * nx : nx;
+            size_t new_ny = refine_y ? 2 * ny : ny;
+
+            if (new_nx * new_ny > max_cells)
+                BOOST_THROW_EXCEPTION(chm_error() << errstr_info(
+                        "lookup_table_2d: can't reach a tolerance of " + std::to_string(tol) + " with " +
+                        std::to_string(max_cells) + " cells, error is " + std::to_string(_max_error)));
+
+            nx = new_nx;
+            ny = new_ny;
+        }
+
+        _inv_dx = nx / (x1 - x0);
+        _inv_dy = ny / (y1 - y0);
+        _last_x = static_cast<double>(nx - 1);
+        _last_y = static_cast<double>(ny - 1);
+    }
+
+    void lookup_table_2d::operator()(const double* x, const double* y, double* z, size_t n) const
+    {
+        const double* table = _z.data();
+
+#ifdef _OPENMP
+        #pragma omp simd
+#endif
+        for (size_t l = 0; l < n; l++)
+        {
+            size_t i, j;
+            double wx, wy;
+            lookup_table_1d::locate(x[l], _x0, _inv_dx, _last_x, i, wx);
+            lookup_table_1d::locate(y[l], _y0, _inv_dy, _last_y, j, wy);
+
+            const double* z0 = &table[j * _stride + i];
+            const double* z1 = z0 + _stride;
+
+            double lower = z0[0] + wx * (z0[1] - z0[0]);
+            double upper = z1[0] + wx * (z1[1] - z1[0]);
+            z[l] = lower + wy * (upper - lower);
+        }
+    }
+}
@@ -0,0 +1,189 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace math
+{
+    /**
+     * Precomputed tables for expensive, smooth functions of one or two met inputs that would otherwise be
+     * evaluated per face, per timestep (e.g., an iterative solve). Build them once in a module's init.
+     *
+     * Tables are on a uniform grid that is refined (doubled) until the interpolant is within tol of the function at
+     * every cell midpoint, where the interpolation error of a smooth function peaks. The error measure is
+     * |f - table| <= tol * max(1, |f|), i.e., absolute for small values and relative for large ones.
+     *
+     * Outside the range the end cells are extrapolated, so check in_range() and call the exact function instead.
+     */
+    class lookup_table_1d
+    {
+    public:
+        lookup_table_1d();
+
+        /**
+         * Tabulates f on [x0, x1]
+         * @param f Function to tabulate
+         * @param tol Error bound, see above
+         * @param max_cells Refinement limit, throws a chm_error if tol can't be met with this many cells
+         */
+        lookup_table_1d(const std::function<double(double)>& f, double x0, double x1, double tol,
+                        size_t max_cells = 1 << 20);
+
+        /**
+         * Linear interpolation at x
+         */
+        double operator()(double x) const
+        {
+            size_t k;
+            double w;
+            locate(x, _x0, _inv_dx, _last, k, w);
+
+            return _y[k] + w * (_y[k + 1] - _y[k]);
+        }
+
+        /**
+         * Interpolates n values at once, y[i] = table(x[i])
+         */
+        void operator()(const double* x, double* y, size_t n) const;
+
+        bool in_range(double x) const
+        {
+            return x >= _x0 && x <= _x1;
+        }
+
+        /**
+         * Largest error found at the cell midpoints when the table was built
+         */
+        double max_error() const
+        {
+            return _max_error;
+        }
+
+        /**
+         * Number of tabulated points
+         */
+        size_t size() const
+        {
+            return _y.size();
+        }
+
+        /**
+         * Cell k holding x and the weight of its upper node. Out of range (and NaN) x maps to the end cells.
+         */
+        static void locate(double x, double x0, double inv_dx, double last, size_t& k, double& w)
+        {
+            double t = (x - x0) * inv_dx;
+            double i = std::floor(t);
+
+            // written so that NaN ends up in cell 0
+            i = i > 0. ? i : 0.;
+            i = i < last ? i : last;
+
+            k = static_cast<size_t>(i);
+            w = t - i;
+        }
+
+    private:
+        double _x0, _x1;
+        double _inv_dx;
+        double _last; // index of the last cell
+        double _max_error;
+        std::vector<double> _y;
+    };
+
+    /**
+     * Bilinear table of a smooth function of two variables on [x0, x1] x [y0, y1], see lookup_table_1d.
+     * Each axis is refined on its own, so a function that is nearly linear in one variable stays coarse in it.
+     */
+    class lookup_table_2d
+    {
+    public:
+        lookup_table_2d();
+
+        /**
+         * Tabulates f on [x0, x1] x [y0, y1]
+         * @param f Function to tabulate
+         * @param tol Error bound, see lookup_table_1d
+         * @param max_cells Refinement limit, throws a chm_error if tol can't be met with this many cells
+         */
+        lookup_table_2d(const std::function<double(double, double)>& f, double x0, double x1, double y0, double y1,
+                        double tol, size_t max_cells = 1 << 22);
+
+        /**
+         * Bilinear interpolation at (x, y)
+         */
+        double operator()(double x, double y) const
+        {
+            size_t i, j;
+            double wx, wy;
+            lookup_table_1d::locate(x, _x0, _inv_dx, _last_x, i, wx);
+            lookup_table_1d::locate(y, _y0, _inv_dy, _last_y, j, wy);
+
+            const double* z0 = &_z[j * _stride + i];
+            const double* z1 = z0 + _stride;
+
+            double lower = z0[0] + wx * (z0[1] - z0[0]);
+            double upper = z1[0] + wx * (z1[1] - z1[0]);
+            return lower + wy * (upper - lower);
+        }
+
+        /**
+         * Interpolates n values at once, z[i] = table(x[i], y[i])
+         */
+        void operator()(const double* x, const double* y, double* z, size_t n) const;
+
+        bool in_range(double x, double y) const
+        {
+            return x >= _x0 && x <= _x1 && y >= _y0 && y <= _y1;
+        }
+
+        /**
+         * Largest error found at the cell and edge midpoints when the table was built
+         */
+        double max_error() const
+        {
+            return _max_error;
+        }
+
+        /**
+         * Number of tabulated points
+         */
+        size_t size() const
+        {
+            return _z.size();
+        }
+
+    private:
+        double _x0, _x1, _y0, _y1;
+        double _inv_dx, _inv_dy;
+        double _last_x, _last_y;
+        size_t _stride; // points per row
+        double _max_error;
+        std::vector<double> _z; // row major, x varies fastest
+    };
+}
@@ -0,0 +1,254 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "face_aggregator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <boost/lexical_cast.hpp>
+
+#include "exception.hpp"
+
+face_aggregator::face_aggregator(boost::shared_ptr<triangulation> mesh, const std::vector<std::string>& variables,
+                                 const std::vector<statistic>& statistics, window w, size_t timesteps)
+        : _mesh(mesh), _variables(variables), _statistics(statistics), _window(w), _timesteps(timesteps)
+{
+    if (_variables.empty())
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Aggregated output requires a list of variables"));
+
+    if (_statistics.empty())
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Aggregated output requires a list of statistics"));
+
+    if (_window == window::timesteps && _timesteps == 0)
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Aggregation window must be at least 1 timestep"));
+
+    _need_sum = std::find(_statistics.begin(), _statistics.end(), statistic::mean) != _statistics.end() ||
+                std::find(_statistics.begin(), _statistics.end(), statistic::sum) != _statistics.end();
+    _need_min = std::find(_statistics.begin(), _statistics.end(), statistic::min) != _statistics.end();
+    _need_max = std::find(_statistics.begin(), _statistics.end(), statistic::max) != _statistics.end();
+
+    for (auto& v : _variables)
+    {
+        for (auto s : _statistics)
+            _output_variables.push_back(v + "_" + to_string(s));
+    }
+
+    size_t n = _mesh->size_faces();
+    size_t nvar = _variables.size();
+
+    _count.assign(nvar, std::vector<uint32_t>(n));
+    if (_need_sum)
+        _sum.assign(nvar, std::vector<double>(n));
+    if (_need_min)
+        _min.assign(nvar, std::vector<double>(n));
+    if (_need_max)
+        _max.assign(nvar, std::vector<double>(n));
+
+    reset();
+}
+
+face_aggregator::statistic face_aggregator::to_statistic(const std::string& name)
+{
+    if (name == "mean")
+        return statistic::mean;
+    if (name == "min")
+        return statistic::min;
+    if (name == "max")
+        return statistic::max;
+    if (name == "sum")
+        return statistic::sum;
+    if (name == "count")
+        return statistic::count;
+
+    BOOST_THROW_EXCEPTION(config_error() << errstr_info("Unknown statistic " + name + ", expected mean, min, max, sum or count"));
+}
+
+std::string face_aggregator::to_string(statistic s)
+{
+    switch (s)
+    {
+        case statistic::mean:
+            return "mean";
+        case statistic::min:
+            return "min";
+        case statistic::max:
+            return "max";
+        case statistic::sum:
+            return "sum";
+        case statistic::count:
+            return "count";
+    }
+    return "";
+}
+
+face_aggregator::window face_aggregator::to_window(const std::string& name, size_t& timesteps)
+{
+    timesteps = 1;
+
+    if (name == "daily")
+        return window::daily;
+    if (name == "monthly")
+        return window::monthly;
+
+    try
+    {
+        timesteps = boost::lexical_cast<size_t>(name);
+    }
+    catch (boost::bad_lexical_cast& e)
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Unknown aggregation window " + name + ", expected daily, monthly or a number of timesteps"));
+    }
+
+    return window::timesteps;
+}
+
+void face_aggregator::reset()
+{
+    const double inf = std::numeric_limits<double>::infinity();
+
+    for (size_t v = 0; v < _variables.size(); v++)
+    {
+        std::fill(_count[v].begin(), _count[v].end(), 0);
+        if (_need_sum)
+            std::fill(_sum[v].begin(), _sum[v].end(), 0.);
+        if (_need_min)
+            std::fill(_min[v].begin(), _min[v].end(), inf);
+        if (_need_max)
+            std::fill(_max[v].begin(), _max[v].end(), -inf);
+    }
+
+    _steps = 0;
+}
+
+void face_aggregator::repartitioned()
+{
+    if (_steps != 0)
+        BOOST_THROW_EXCEPTION(chm_error() << errstr_info("Aggregated output can only be repartitioned between windows"));
+
+    size_t n = _mesh->size_faces();
+    for (size_t v = 0; v < _variables.size(); v++)
+    {
+        _count[v].resize(n);
+        if (_need_sum)
+            _sum[v].resize(n);
+        if (_need_min)
+            _min[v].resize(n);
+        if (_need_max)
+            _max[v].resize(n);
+    }
+
+    reset();
+}
+
+void face_aggregator::update(const boost::posix_time::ptime& time)
+{
+    if (_steps == 0)
+        _start = time;
+
+#pragma omp parallel for
+    for (size_t i = 0; i < _mesh->size_faces(); i++)
+    {
+        auto face = _mesh->face(i);
+
+        for (size_t v = 0; v < _variables.size(); v++)
+        {
+            double d = (*face)[_variables[v]];
+            if (d == -9999. || std::isnan(d))
+                continue;
+
+            _count[v][i]++;
+            if (_need_sum)
+                _sum[v][i] += d;
+            if (_need_min)
+                _min[v][i] = std::min(_min[v][i], d);
+            if (_need_max)
+                _max[v][i] = std::max(_max[v][i], d);
+        }
+    }
+
+    _steps++;
+}
+
+bool face_aggregator::window_complete(const boost::posix_time::ptime& time, const boost::posix_time::ptime& next) const
+{
+    switch (_window)
+    {
+        case window::timesteps:
+            return _steps >= _timesteps;
+        case window::daily:
+            return next.date() != time.date();
+        case window::monthly:
+            return next.date().month() != time.date().month() || next.date().year() != time.date().year();
+    }
+    return true;
+}
+
+boost::posix_time::ptime face_aggregator::emit()
+{
+#pragma omp parallel for
+    for (size_t i = 0; i < _mesh->size_faces(); i++)
+    {
+        auto face = _mesh->face(i);
+
+        size_t k = 0;
+        for (size_t v = 0; v < _variables.size(); v++)
+        {
+            uint32_t n = _count[v][i];
+
+            for (auto s : _statistics)
+            {
+                double d = -9999.;
+                switch (s)
+                {
+                    case statistic::mean:
+                        if (n > 0)
+                            d = _sum[v][i] / n;
+                        break;
+                    case statistic::min:
+                        if (n > 0)
+                            d = _min[v][i];
+                        break;
+                    case statistic::max:
+                        if (n > 0)
+                            d = _max[v][i];
+                        break;
+                    case statistic::sum:
+                        if (n > 0)
+                            d = _sum[v][i];
+                        break;
+                    case statistic::count:
+                        d = n;
+                        break;
+                }
+
+                (*face)[_output_variables[k++]] = d;
+            }
+        }
+    }
+
+    auto start = _start;
+    reset();
+    return start;
+}
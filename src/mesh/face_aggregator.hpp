@@ -0,0 +1,145 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "triangulation.hpp"
+
+/**
+ * Per-face statistics of face variables over a time window, e.g., the daily mean and maximum, for the mesh and raster outputs.
+ *
+ * Each timestep's values are folded into running accumulators, so memory does not depend on the window or run length.
+ * At the end of a window the statistics are written into the face variables <variable>_<statistic>, e.g., swe_max,
+ * which the outputs then write like any other variable. Missing values (-9999 or NaN) are skipped.
+ */
+class face_aggregator
+{
+public:
+    enum class statistic
+    {
+        mean,
+        min,
+        max,
+        sum,
+        count
+    };
+
+    enum class window
+    {
+        timesteps,
+        daily,
+        monthly
+    };
+
+    /**
+     * @param mesh Faces to aggregate over
+     * @param variables Face variables to aggregate
+     * @param statistics Statistics to compute for each variable
+     * @param w Window length
+     * @param timesteps Number of timesteps in a window, for window::timesteps
+     */
+    face_aggregator(boost::shared_ptr<triangulation> mesh, const std::vector<std::string>& variables,
+                    const std::vector<statistic>& statistics, window w, size_t timesteps = 1);
+
+    /**
+     * Parses mean, min, max, sum or count. Throws config_error otherwise
+     */
+    static statistic to_statistic(const std::string& name);
+
+    static std::string to_string(statistic s);
+
+    /**
+     * Parses daily, monthly or a number of timesteps. Throws config_error otherwise
+     */
+    static window to_window(const std::string& name, size_t& timesteps);
+
+    /**
+     * The face variables the statistics are written to, <variable>_<statistic>
+     */
+    const std::vector<std::string>& output_variables() const
+    {
+        return _output_variables;
+    }
+
+    /**
+     * Adds the current face values to the window
+     * @param time Time of the current values
+     */
+    void update(const boost::posix_time::ptime& time);
+
+    /**
+     * Whether the window ends with the step at time, i.e., the step at next belongs to the next window
+     */
+    bool window_complete(const boost::posix_time::ptime& time, const boost::posix_time::ptime& next) const;
+
+    /**
+     * Writes the statistics into the output variables and starts a new window
+     * @return Time of the first step of the window that was written
+     */
+    boost::posix_time::ptime emit();
+
+    /**
+     * Number of steps in the current window
+     */
+    size_t steps() const
+    {
+        return _steps;
+    }
+
+    /**
+     * Resizes the accumulators to the local faces after load balancing has moved faces between processes.
+     * Only done between windows, i.e., when steps() is 0, as the partial window of the faces that moved is lost otherwise.
+     */
+    void repartitioned();
+
+private:
+    boost::shared_ptr<triangulation> _mesh;
+    std::vector<std::string> _variables;
+    std::vector<statistic> _statistics;
+    std::vector<std::string> _output_variables;
+
+    window _window;
+    size_t _timesteps;
+
+    // [variable][face]. Only those the statistics need are allocated
+    std::vector<std::vector<double>> _sum;
+    std::vector<std::vector<double>> _min;
+    std::vector<std::vector<double>> _max;
+    std::vector<std::vector<uint32_t>> _count;
+
+    bool _need_sum;
+    bool _need_min;
+    bool _need_max;
+
+    size_t _steps;
+    boost::posix_time::ptime _start;
+
+    void reset();
+};
@@ -0,0 +1,319 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include "mesh_arrays.hpp"
+
+#include <cstring>
+
+#include "exception.hpp"
+#include "logger.hpp"
+
+namespace
+{
+    const uint64_t magic = 0x3148534D4D484321ULL; // "!CHMMSH1"
+
+    // everything is stored in 8 byte words so the arrays stay aligned
+    size_t words(size_t bytes)
+    {
+        return (bytes + 7) / 8;
+    }
+
+    // writes the packed layout, or only counts its size when out is null
+    class writer
+    {
+    public:
+        writer(char* out)
+                : _out(out), _pos(0)
+        {
+        }
+
+        template<typename T>
+        void put(T value)
+        {
+            static_assert(sizeof(T) == 8, "packed values are 8 bytes");
+            if (_out)
+                std::memcpy(_out + _pos, &value, 8);
+            _pos += 8;
+        }
+
+        void put(const std::string& s)
+        {
+            put<uint64_t>(s.size());
+            if (_out)
+            {
+                std::memset(_out + _pos, 0, 8 * words(s.size()));
+                std::memcpy(_out + _pos, s.data(), s.size());
+            }
+            _pos += 8 * words(s.size());
+        }
+
+        size_t pos() const
+        {
+            return _pos;
+        }
+
+    private:
+        char* _out;
+        size_t _pos;
+    };
+
+    class reader
+    {
+    public:
+        reader(const char* in, size_t size)
+                : _in(in), _size(size), _pos(0)
+        {
+        }
+
+        template<typename T>
+        T get()
+        {
+            check(8);
+            T value;
+            std::memcpy(&value, _in + _pos, 8);
+            _pos += 8;
+            return value;
+        }
+
+        std::string get_string()
+        {
+            size_t n = get<uint64_t>();
+            check(8 * words(n));
+            std::string s(_in + _pos, n);
+            _pos += 8 * words(n);
+            return s;
+        }
+
+        // the next n values, in place
+        template<typename T>
+        const T* array(size_t n)
+        {
+            check(8 * n);
+            auto p = reinterpret_cast<const T*>(_in + _pos);
+            _pos += 8 * n;
+            return p;
+        }
+
+    private:
+        void check(size_t n)
+        {
+            if (_pos + n > _size)
+                BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Packed mesh is truncated"));
+        }
+
+        const char* _in;
+        size_t _size;
+        size_t _pos;
+    };
+
+    // the columns of a parameters or initial_conditions section that have values
+    std::vector<const pt::ptree::value_type*> columns(const pt::ptree& mesh, const std::string& section, size_t nelem)
+    {
+        std::vector<const pt::ptree::value_type*> result;
+
+        auto child = mesh.get_child_optional(section);
+        if (!child)
+            return result;
+
+        for (auto& itr : *child)
+        {
+            // we could have an item like this
+            // "area": [],
+            // and we need to ensure we *don't* load those
+            if (itr.second.empty())
+                continue;
+
+            if (itr.second.size() > nelem)
+                BOOST_THROW_EXCEPTION(config_error() << errstr_info(
+                        section + " " + itr.first + " has " + std::to_string(itr.second.size()) + " values but the mesh has " +
+                        std::to_string(nelem) + " elems"));
+
+            result.push_back(&itr);
+        }
+        return result;
+    }
+
+    void pack_into(const pt::ptree& mesh, writer& w)
+    {
+        size_t nvertex = mesh.get<size_t>("mesh.nvertex");
+        size_t nelem = mesh.get<size_t>("mesh.nelem");
+
+        auto& vertex = mesh.get_child("mesh.vertex");
+        auto& elem = mesh.get_child("mesh.elem");
+        auto& neigh = mesh.get_child("mesh.neigh");
+        auto permutation = mesh.get_child_optional("mesh.cell_global_id");
+
+        if (vertex.size() != nvertex)
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info(
+                    "Expected: " + std::to_string(nvertex) + " vertex, got: " + std::to_string(vertex.size())));
+
+        if (elem.size() != nelem)
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info(
+                    "Expected: " + std::to_string(nelem) + " elems, got: " + std::to_string(elem.size())));
+
+        if (neigh.size() != nelem)
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info(
+                    "Expected: " + std::to_string(nelem) + " neighbours, got: " + std::to_string(neigh.size())));
+
+        if (permutation && permutation->size() != nelem)
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info(
+                    "Expected: " + std::to_string(nelem) + " cell_global_id, got: " + std::to_string(permutation->size())));
+
+        std::string proj4 = mesh.get<std::string>("mesh.proj4", "");
+        if (proj4 == "")
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info("proj4 field in .mesh file is empty!"));
+
+        auto parameters = columns(mesh, "parameters", nelem);
+        auto ics = columns(mesh, "initial_conditions", nelem);
+
+        w.put<uint64_t>(magic);
+        w.put<uint64_t>(mesh.get<int>("mesh.is_geographic") == 1);
+        w.put<uint64_t>(nvertex);
+        w.put<uint64_t>(nelem);
+        w.put<uint64_t>(permutation ? 1 : 0);
+        w.put<uint64_t>(parameters.size());
+        w.put<uint64_t>(ics.size());
+        w.put(proj4);
+
+        for (auto p : parameters)
+        {
+            w.put(p->first);
+            w.put<uint64_t>(p->second.size());
+        }
+        for (auto p : ics)
+        {
+            w.put(p->first);
+            w.put<uint64_t>(p->second.size());
+        }
+
+        // iterate over the vertex triples
+        for (auto& itr : vertex)
+        {
+            size_t n = 0;
+            for (auto& jtr : itr.second)
+            {
+                if (n++ < 3)
+                    w.put<double>(jtr.second.get_value<double>());
+            }
+            if (n != 3)
+                BOOST_THROW_EXCEPTION(config_error() << errstr_info("Vertex with " + std::to_string(n) + " coordinates"));
+        }
+
+        for (auto* section : {&elem, &neigh})
+        {
+            for (auto& itr : *section)
+            {
+                size_t n = 0;
+                for (auto& jtr : itr.second)
+                {
+                    if (n++ < 3)
+                        w.put<int64_t>(jtr.second.get_value<int64_t>());
+                }
+                if (n != 3)
+                    BOOST_THROW_EXCEPTION(config_error() << errstr_info("Elem with " + std::to_string(n) + " entries"));
+            }
+        }
+
+        if (permutation)
+        {
+            for (auto& itr : *permutation)
+                w.put<int64_t>(itr.second.get_value<int64_t>());
+        }
+
+        for (auto* section : {&parameters, &ics})
+        {
+            for (auto p : *section)
+            {
+                for (auto& jtr : p->second)
+                    w.put<double>(jtr.second.get_value<double>());
+            }
+        }
+    }
+}
+
+size_t mesh_arrays::packed_size(const pt::ptree& mesh)
+{
+    writer w(nullptr);
+    pack_into(mesh, w);
+    return w.pos();
+}
+
+void mesh_arrays::pack(const pt::ptree& mesh, char* buffer, size_t size)
+{
+    // zero length parameters are dropped by pack_into
+    if (auto parameters = mesh.get_child_optional("parameters"))
+    {
+        for (auto& itr : *parameters)
+        {
+            if (itr.second.empty())
+                LOG_WARNING << "Parameter " + itr.first + " is zero length and will be ignored.";
+        }
+    }
+
+    writer w(buffer);
+    pack_into(mesh, w);
+
+    if (w.pos() != size)
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Packed mesh is " + std::to_string(w.pos()) + " bytes, expected " +
+                                                          std::to_string(size)));
+}
+
+mesh_arrays::mesh_arrays(const char* buffer, size_t size)
+{
+    reader r(buffer, size);
+
+    if (r.get<uint64_t>() != magic)
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Not a packed mesh"));
+
+    _is_geographic = r.get<uint64_t>() == 1;
+    _nvertex = r.get<uint64_t>();
+    _nelem = r.get<uint64_t>();
+    bool has_permutation = r.get<uint64_t>() == 1;
+    size_t nparam = r.get<uint64_t>();
+    size_t nic = r.get<uint64_t>();
+    _proj4 = r.get_string();
+
+    _parameters.resize(nparam);
+    for (auto& p : _parameters)
+    {
+        p.name = r.get_string();
+        p.size = r.get<uint64_t>();
+    }
+    _initial_conditions.resize(nic);
+    for (auto& p : _initial_conditions)
+    {
+        p.name = r.get_string();
+        p.size = r.get<uint64_t>();
+    }
+
+    _vertex = r.array<double>(3 * _nvertex);
+    _elem = r.array<int64_t>(3 * _nelem);
+    _neigh = r.array<int64_t>(3 * _nelem);
+    _cell_global_id = has_permutation ? r.array<int64_t>(_nelem) : nullptr;
+
+    for (auto& p : _parameters)
+        p.values = r.array<double>(p.size);
+    for (auto& p : _initial_conditions)
+        p.values = r.array<double>(p.size);
+}
@@ -0,0 +1,143 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace pt = boost::property_tree;
+
+/**
+ * The immutable part of a .mesh file, with its parameter and initial condition files merged in, packed into one flat buffer:
+ * the vertices, the faces' vertices and neighbours, the optional face permutation, and a column per parameter and initial condition.
+ *
+ * A packed buffer holds no pointers, so it can be placed in memory shared between processes. With MPI this lets one rank per node
+ * parse the json into a shared window and every rank on the node build its triangulation from that single copy.
+ * Only the buffer is shared; the triangulation each rank builds from it is still a full private copy of the mesh.
+ * Building from the buffer also means the json tree can be released before the triangulation is built.
+ *
+ * A mesh_arrays is a view onto a packed buffer, which must outlive it.
+ */
+class mesh_arrays
+{
+public:
+    /**
+     * Bytes needed to pack the mesh json. Throws config_error if the json is inconsistent
+     */
+    static size_t packed_size(const pt::ptree& mesh);
+
+    /**
+     * Packs the mesh json into buffer, which must be packed_size(mesh) bytes and 8 byte aligned
+     */
+    static void pack(const pt::ptree& mesh, char* buffer, size_t size);
+
+    /**
+     * View onto a packed buffer. Throws mesh_error if it isn't one
+     */
+    mesh_arrays(const char* buffer, size_t size);
+
+    bool is_geographic() const
+    {
+        return _is_geographic;
+    }
+
+    const std::string& proj4() const
+    {
+        return _proj4;
+    }
+
+    size_t nvertex() const
+    {
+        return _nvertex;
+    }
+
+    size_t nelem() const
+    {
+        return _nelem;
+    }
+
+    /// x, y, z of vertex i
+    const double* vertex(size_t i) const
+    {
+        return _vertex + 3 * i;
+    }
+
+    /// The 3 vertices of face i
+    const int64_t* elem(size_t i) const
+    {
+        return _elem + 3 * i;
+    }
+
+    /// The 3 neighbours of face i, -1 where there is none
+    const int64_t* neigh(size_t i) const
+    {
+        return _neigh + 3 * i;
+    }
+
+    /// The mesh.cell_global_id permutation, nullptr if the mesh doesn't have one
+    const int64_t* cell_global_id() const
+    {
+        return _cell_global_id;
+    }
+
+    /**
+     * A per-face column, e.g., a parameter. It may be shorter than nelem, in which case the remaining faces don't have a value
+     */
+    struct column
+    {
+        std::string name;
+        size_t size;
+        const double* values;
+    };
+
+    /// Parameters with at least one value. Zero length parameters are dropped when packing
+    const std::vector<column>& parameters() const
+    {
+        return _parameters;
+    }
+
+    const std::vector<column>& initial_conditions() const
+    {
+        return _initial_conditions;
+    }
+
+private:
+    bool _is_geographic;
+    std::string _proj4;
+    size_t _nvertex;
+    size_t _nelem;
+
+    const double* _vertex;
+    const int64_t* _elem;
+    const int64_t* _neigh;
+    const int64_t* _cell_global_id;
+
+    std::vector<column> _parameters;
+    std::vector<column> _initial_conditions;
+};
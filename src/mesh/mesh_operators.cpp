@@ -0,0 +1,326 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "mesh_operators.hpp"
+
+#include <array>
+#include <cmath>
+
+#include "triangulation.hpp"
+#include "exception.hpp"
+#include "logger.hpp"
+
+namespace
+{
+    // a face and its 3 neighbours
+    const size_t max_row = 4;
+
+    typedef std::array<size_t, max_row> row_cols;
+    typedef std::array<double, max_row> row_weights;
+
+    // packs the per-row entries into the CSR arrays
+    void compress(const std::vector<size_t>& count, const std::vector<row_cols>& cols,
+                  const std::vector<row_weights>& weights, mesh_stencil& s)
+    {
+        size_t n = count.size();
+
+        s.ptr.assign(n + 1, 0);
+        for (size_t i = 0; i < n; i++)
+            s.ptr[i + 1] = s.ptr[i] + count[i];
+
+        s.col.resize(s.ptr[n]);
+        s.weight.resize(s.ptr[n]);
+
+#pragma omp parallel for
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t k = 0; k < count[i]; k++)
+            {
+                s.col[s.ptr[i] + k] = cols[i][k];
+                s.weight[s.ptr[i] + k] = weights[i][k];
+            }
+        }
+    }
+
+    // the face followed by its locally owned neighbours, as local ids. Returns the number of entries
+    template<typename Face>
+    size_t local_stencil(Face& f, size_t i, row_cols& cols, std::array<int, max_row>& edge)
+    {
+        size_t n = 0;
+        cols[n] = i;
+        edge[n++] = -1;
+
+        for (int j = 0; j < 3; j++)
+        {
+            auto neigh = f->neighbor(j);
+            if (neigh != nullptr && !neigh->_is_ghost)
+            {
+                cols[n] = neigh->cell_local_id;
+                edge[n++] = j;
+            }
+        }
+        return n;
+    }
+}
+
+void mesh_stencil::apply(const double* in, double* out) const
+{
+    const size_t n = rows();
+    const size_t* p = ptr.data();
+    const size_t* c = col.data();
+    const double* w = weight.data();
+
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; i++)
+    {
+        double sum = 0;
+
+#pragma omp simd reduction(+:sum)
+        for (size_t k = p[i]; k < p[i + 1]; k++)
+            sum += w[k] * in[c[k]];
+
+        out[i] = sum;
+    }
+}
+
+void mesh_stencil::apply(const std::vector<double>& in, std::vector<double>& out) const
+{
+    if (in.size() != rows())
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Mesh operator expects " + std::to_string(rows()) +
+                                                           " values but was given " + std::to_string(in.size())));
+    out.resize(rows());
+    apply(in.data(), out.data());
+}
+
+mesh_operators::mesh_operators(triangulation& domain)
+{
+    LOG_DEBUG << "Building mesh operators";
+
+    build_smoothing(domain);
+    build_gradient(domain);
+    build_laplacian(domain);
+}
+
+void mesh_operators::divergence(const double* u, const double* v, double* out) const
+{
+    // grad_x and grad_y share the same sparsity
+    const size_t n = grad_x.rows();
+    const size_t* p = grad_x.ptr.data();
+    const size_t* c = grad_x.col.data();
+    const double* wx = grad_x.weight.data();
+    const double* wy = grad_y.weight.data();
+
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; i++)
+    {
+        double sum = 0;
+
+#pragma omp simd reduction(+:sum)
+        for (size_t k = p[i]; k < p[i + 1]; k++)
+            sum += wx[k] * u[c[k]] + wy[k] * v[c[k]];
+
+        out[i] = sum;
+    }
+}
+
+void mesh_operators::divergence(const std::vector<double>& u, const std::vector<double>& v, std::vector<double>& out) const
+{
+    if (u.size() != grad_x.rows() || v.size() != grad_x.rows())
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Mesh operator expects " + std::to_string(grad_x.rows()) +
+                                                           " values per component"));
+    out.resize(grad_x.rows());
+    divergence(u.data(), v.data(), out.data());
+}
+
+void mesh_operators::build_smoothing(triangulation& domain)
+{
+    size_t n = domain.size_faces();
+    std::vector<size_t> count(n);
+    std::vector<row_cols> cols(n);
+    std::vector<row_weights> weights(n);
+
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
+    {
+        auto f = domain.face(i);
+
+        row_cols stencil;
+        std::array<int, max_row> edge;
+        size_t m = local_stencil(f, i, stencil, edge);
+
+        // no neighbours, keep the face's own value
+        if (m == 1)
+        {
+            count[i] = 1;
+            cols[i][0] = i;
+            weights[i][0] = 1;
+            continue;
+        }
+
+        std::vector<boost::tuple<double, double, double> > u;
+        for (size_t k = 1; k < m; k++)
+        {
+            auto neigh = f->neighbor(edge[k]);
+            u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(), 0.));
+        }
+
+        auto query = boost::make_tuple(f->get_x(), f->get_y(), f->get_z());
+
+        // the spline is linear in the sample values, so its weights are its values for each unit sample.
+        // The LU decomposition only depends on the sample locations and is reused
+        interpolation interp(interp_alg::tpspline, u.size(), {{"reuse_LU", "true"}});
+
+        count[i] = u.size();
+        for (size_t k = 0; k < u.size(); k++)
+        {
+            for (size_t l = 0; l < u.size(); l++)
+                u[l].get<2>() = (k == l) ? 1. : 0.;
+
+            cols[i][k] = stencil[k + 1];
+            weights[i][k] = interp(u, query);
+        }
+    }
+
+    compress(count, cols, weights, smoothing);
+}
+
+void mesh_operators::build_gradient(triangulation& domain)
+{
+    size_t n = domain.size_faces();
+    std::vector<size_t> count(n);
+    std::vector<row_cols> cols(n);
+    std::vector<row_weights> wx(n), wy(n);
+
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
+    {
+        auto f = domain.face(i);
+
+        std::array<int, max_row> edge;
+        size_t m = local_stencil(f, i, cols[i], edge);
+        count[i] = m;
+
+        double xi = f->get_x();
+        double yi = f->get_y();
+
+        // least squares fit of the plane through the neighbours' centres
+        std::array<double, max_row> dx, dy;
+        double a = 0, b = 0, c = 0;
+        for (size_t k = 1; k < m; k++)
+        {
+            auto neigh = f->neighbor(edge[k]);
+            dx[k] = neigh->get_x() - xi;
+            dy[k] = neigh->get_y() - yi;
+
+            a += dx[k] * dx[k];
+            b += dx[k] * dy[k];
+            c += dy[k] * dy[k];
+        }
+
+        double det = a * c - b * b;
+
+        if (m > 2 && det > 1e-10 * a * c)
+        {
+            wx[i][0] = 0;
+            wy[i][0] = 0;
+            for (size_t k = 1; k < m; k++)
+            {
+                wx[i][k] = (c * dx[k] - b * dy[k]) / det;
+                wy[i][k] = (a * dy[k] - b * dx[k]) / det;
+
+                wx[i][0] -= wx[i][k];
+                wy[i][0] -= wy[i][k];
+            }
+        }
+        else
+        {
+            // Green-Gauss, with the edge value the mean of the two faces and the face's own value on the other edges
+            double area = f->get_area();
+
+            wx[i].fill(0);
+            wy[i].fill(0);
+
+            std::array<bool, 3> has_neigh = {false, false, false};
+            for (size_t k = 1; k < m; k++)
+            {
+                has_neigh[edge[k]] = true;
+
+                auto nrm = f->edge_unit_normal(edge[k]);
+                double L = f->edge_length(edge[k]);
+
+                wx[i][k] = 0.5 * nrm.x() * L / area;
+                wy[i][k] = 0.5 * nrm.y() * L / area;
+                wx[i][0] += 0.5 * nrm.x() * L / area;
+                wy[i][0] += 0.5 * nrm.y() * L / area;
+            }
+
+            for (int j = 0; j < 3; j++)
+            {
+                if (has_neigh[j])
+                    continue;
+
+                auto nrm = f->edge_unit_normal(j);
+                double L = f->edge_length(j);
+
+                wx[i][0] += nrm.x() * L / area;
+                wy[i][0] += nrm.y() * L / area;
+            }
+        }
+    }
+
+    compress(count, cols, wx, grad_x);
+    compress(count, cols, wy, grad_y);
+}
+
+void mesh_operators::build_laplacian(triangulation& domain)
+{
+    size_t n = domain.size_faces();
+    std::vector<size_t> count(n);
+    std::vector<row_cols> cols(n);
+    std::vector<row_weights> weights(n);
+
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
+    {
+        auto f = domain.face(i);
+
+        std::array<int, max_row> edge;
+        size_t m = local_stencil(f, i, cols[i], edge);
+        count[i] = m;
+
+        double area = f->get_area();
+
+        weights[i][0] = 0;
+        for (size_t k = 1; k < m; k++)
+        {
+            auto neigh = f->neighbor(edge[k]);
+            double d = std::sqrt((neigh->get_x() - f->get_x()) * (neigh->get_x() - f->get_x()) +
+                                 (neigh->get_y() - f->get_y()) * (neigh->get_y() - f->get_y()));
+
+            weights[i][k] = f->edge_length(edge[k]) / (d * area);
+            weights[i][0] -= weights[i][k];
+        }
+    }
+
+    compress(count, cols, weights, laplacian);
+}
@@ -0,0 +1,97 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class triangulation;
+
+/**
+ * A linear operator over the locally owned faces, stored as a sparse matrix in CSR form.
+ * Row i is face(i) and its weights are for the faces with local ids col[ptr[i] .. ptr[i+1]].
+ */
+struct mesh_stencil
+{
+    std::vector<size_t> ptr;
+    std::vector<size_t> col;
+    std::vector<double> weight;
+
+    /**
+     * out = this * in. Both are one value per locally owned face, indexed by the face's local id, and must not overlap.
+     */
+    void apply(const double* in, double* out) const;
+    void apply(const std::vector<double>& in, std::vector<double>& out) const;
+
+    /**
+     * Number of rows, i.e., locally owned faces
+     */
+    size_t rows() const
+    {
+        return ptr.empty() ? 0 : ptr.size() - 1;
+    }
+};
+
+/**
+ * Fixed-stencil operators on the locally owned faces, built once from the mesh geometry.
+ *
+ * Only the face's locally owned (non-ghost) neighbours are used, so applying an operator needs no communication.
+ * Values are columns with one entry per face(i), which can be gathered from and scattered to the face variables.
+ * Get them from triangulation::operators() rather than building them; they are rebuilt when the geometry changes,
+ * so don't hold on to a reference across timesteps.
+ */
+class mesh_operators
+{
+public:
+    mesh_operators(triangulation& domain);
+
+    /**
+     * Thin plate spline of the neighbours' values at the face centre, as the wind modules have always smoothed with.
+     * A face without neighbours keeps its value.
+     */
+    mesh_stencil smoothing;
+
+    /**
+     * x and y components of the horizontal gradient. Least squares fit over the neighbours,
+     * falling back to Green-Gauss where the neighbours don't span the plane.
+     */
+    mesh_stencil grad_x;
+    mesh_stencil grad_y;
+
+    /**
+     * Two-point flux Laplacian, with no flux across the edges without a local neighbour
+     */
+    mesh_stencil laplacian;
+
+    /**
+     * out = d(u)/dx + d(v)/dy
+     */
+    void divergence(const double* u, const double* v, double* out) const;
+    void divergence(const std::vector<double>& u, const std::vector<double>& v, std::vector<double>& out) const;
+
+private:
+    void build_smoothing(triangulation& domain);
+    void build_gradient(triangulation& domain);
+    void build_laplacian(triangulation& domain);
+};
@@ -0,0 +1,130 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include "mesh_partition.hpp"
+
+#include <algorithm>
+
+#include "exception.hpp"
+
+mesh_partition::mesh_partition(size_t nfaces, size_t nparts)
+{
+    if (nparts == 0 || nfaces < nparts)
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Can't split " + std::to_string(nfaces) + " faces into " +
+                                                           std::to_string(nparts) + " partitions"));
+
+    _offset.resize(nparts + 1);
+    _offset[0] = 0;
+    for (size_t p = 0; p < nparts; p++)
+        _offset[p + 1] = _offset[p] + nfaces / nparts + (p < nfaces % nparts ? 1 : 0);
+}
+
+mesh_partition mesh_partition::weighted(const std::vector<double>& cost, size_t nparts)
+{
+    size_t n = cost.size();
+    if (nparts == 0 || n < nparts)
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Can't split " + std::to_string(n) + " faces into " +
+                                                           std::to_string(nparts) + " partitions"));
+
+    // faces without a measured cost still take some time to visit
+    double total = 0;
+    size_t measured = 0;
+    for (auto c : cost)
+    {
+        if (c > 0)
+        {
+            total += c;
+            measured++;
+        }
+    }
+    double min_cost = measured > 0 ? 1e-3 * total / measured : 1.;
+
+    std::vector<double> prefix(n + 1, 0.);
+    for (size_t i = 0; i < n; i++)
+        prefix[i + 1] = prefix[i] + (cost[i] > 0 ? cost[i] : min_cost);
+
+    mesh_partition p;
+    p._offset.resize(nparts + 1);
+    p._offset[0] = 0;
+    p._offset[nparts] = n;
+
+    for (size_t k = 1; k < nparts; k++)
+    {
+        double target = prefix[n] * k / nparts;
+
+        // cut at whichever face boundary is closest to the target
+        size_t cut = std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin();
+        if (cut > 0 && target - prefix[cut - 1] < prefix[cut] - target)
+            cut--;
+
+        // leave at least one face for this part and each of the ones after it
+        cut = std::max(cut, p._offset[k - 1] + 1);
+        cut = std::min(cut, n - (nparts - k));
+
+        p._offset[k] = cut;
+    }
+
+    return p;
+}
+
+size_t mesh_partition::owner(size_t global_id) const
+{
+    if (global_id >= faces())
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Face " + std::to_string(global_id) + " is outside the partition of " +
+                                                           std::to_string(faces()) + " faces"));
+
+    return std::upper_bound(_offset.begin(), _offset.end(), global_id) - _offset.begin() - 1;
+}
+
+std::vector<double> mesh_partition::cost(const std::vector<double>& cost) const
+{
+    if (cost.size() != faces())
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Partition is of " + std::to_string(faces()) + " faces but was given " +
+                                                           std::to_string(cost.size()) + " costs"));
+
+    std::vector<double> part_cost(parts(), 0.);
+    for (size_t p = 0; p < parts(); p++)
+    {
+        for (size_t i = begin(p); i < end(p); i++)
+            part_cost[p] += cost[i];
+    }
+    return part_cost;
+}
+
+double mesh_partition::imbalance(const std::vector<double>& part_cost)
+{
+    if (part_cost.empty())
+        return 1.;
+
+    double sum = 0;
+    double max = 0;
+    for (auto c : part_cost)
+    {
+        sum += c;
+        max = std::max(max, c);
+    }
+
+    double mean = sum / part_cost.size();
+    return mean > 0 ? max / mean : 1.;
+}
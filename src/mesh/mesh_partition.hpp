@@ -0,0 +1,111 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A split of the faces, in global id order, into contiguous ranges, one per MPI process.
+ *
+ * The even split gives every part the same number of faces. The weighted split instead balances a per-face cost, e.g.,
+ * the time the modules measured on each face, so that the faces that are expensive to run are spread over the processes.
+ */
+class mesh_partition
+{
+public:
+    /**
+     * Splits nfaces as evenly as possible, the first parts taking one more face when it doesn't divide
+     */
+    mesh_partition(size_t nfaces, size_t nparts);
+
+    /**
+     * Splits the faces so that each part's total cost is as close as possible to the mean, keeping at least one face per part.
+     * A face with no cost is given a small one so that it still counts. Throws mesh_error if there are fewer faces than parts.
+     * @param cost Cost of each face, by global id
+     */
+    static mesh_partition weighted(const std::vector<double>& cost, size_t nparts);
+
+    size_t parts() const
+    {
+        return _offset.size() - 1;
+    }
+
+    size_t faces() const
+    {
+        return _offset.back();
+    }
+
+    /**
+     * First global id in the part
+     */
+    size_t begin(size_t part) const
+    {
+        return _offset.at(part);
+    }
+
+    /**
+     * One past the last global id in the part
+     */
+    size_t end(size_t part) const
+    {
+        return _offset.at(part + 1);
+    }
+
+    size_t size(size_t part) const
+    {
+        return end(part) - begin(part);
+    }
+
+    /**
+     * Part that owns the face
+     */
+    size_t owner(size_t global_id) const;
+
+    /**
+     * Total cost of each part
+     */
+    std::vector<double> cost(const std::vector<double>& cost) const;
+
+    bool operator==(const mesh_partition& other) const
+    {
+        return _offset == other._offset;
+    }
+
+    bool operator!=(const mesh_partition& other) const
+    {
+        return !(*this == other);
+    }
+
+    /**
+     * Ratio of the largest to the mean of the parts' costs. 1 is perfectly balanced
+     */
+    static double imbalance(const std::vector<double>& part_cost);
+
+private:
+    mesh_partition() = default;
+
+    std::vector<size_t> _offset; // parts + 1, part p is [_offset[p], _offset[p+1])
+};
@@ -0,0 +1,469 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "raster_output.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <gdal_priv.h>
+#include <cpl_string.h>
+#include <ogr_spatialref.h>
+
+#include "exception.hpp"
+#include "logger.hpp"
+#include "timer.hpp"
+
+constexpr float raster_output::nodata;
+
+raster_output::raster_output(boost::shared_ptr<triangulation> mesh, const std::string& fname,
+                             const std::vector<std::string>& variables, format fmt, double resolution,
+                             size_t aggregate, std::vector<double> extent, const std::string& suffix)
+        : _mesh(mesh), _fname(fname), _suffix(suffix), _variables(variables), _format(fmt), _nc_record(0),
+          _stop(false)
+{
+    if (_variables.empty())
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Raster output " + _fname + " has no variables"));
+
+    if (!(resolution > 0))
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Raster output " + _fname + " needs a resolution > 0"));
+
+    if (aggregate < 1)
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Raster output " + _fname + " needs aggregate >= 1"));
+
+    GDALAllRegister();
+
+    OGRSpatialReference srs;
+    if (srs.importFromProj4(_mesh->proj4().c_str()) == OGRERR_NONE)
+    {
+        char* wkt = nullptr;
+        srs.exportToWkt(&wkt);
+        _wkt = wkt;
+        CPLFree(wkt);
+    }
+    else
+    {
+        LOG_WARNING << "Raster output " << _fname << ": unable to convert the mesh proj4 to WKT, no projection will be written";
+    }
+
+    timer c;
+    c.tic();
+    build_lookup(resolution, aggregate, extent);
+    LOG_DEBUG << "Raster output " << _fname << " is " << _nx << " x " << _ny << " pixels covered by " << _faces.size()
+              << " faces [" << c.toc<s>() << "s]";
+
+    _thread = std::thread(&raster_output::writer, this);
+}
+
+raster_output::~raster_output()
+{
+    try
+    {
+        finish();
+    }
+    catch (exception_base& e)
+    {
+        LOG_ERROR << "Raster output " << _fname << " failed: " << boost::diagnostic_information(e);
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR << "Raster output " << _fname << " failed: " << e.what();
+    }
+}
+
+void raster_output::build_lookup(double resolution, size_t aggregate, std::vector<double> extent)
+{
+    if (extent.empty())
+    {
+        auto bbox = _mesh->bounding_box();
+        extent = {bbox.xmin(), bbox.ymin(), bbox.xmax(), bbox.ymax()};
+    }
+
+    if (extent.size() != 4 || !(extent[2] > extent[0]) || !(extent[3] > extent[1]))
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info(
+                "Raster output " + _fname + " extent must be [xmin, ymin, xmax, ymax]"));
+
+    _dx = resolution * aggregate;
+    _nx = static_cast<size_t>(std::ceil((extent[2] - extent[0]) / _dx));
+    _ny = static_cast<size_t>(std::ceil((extent[3] - extent[1]) / _dx));
+    _x0 = extent[0];
+    _y1 = extent[3];
+
+    // fine pixels, i.e., before aggregation
+    size_t nx = _nx * aggregate;
+    size_t ny = _ny * aggregate;
+    std::vector<int32_t> fine(nx * ny, -1);
+
+    // scan the pixel centres within each triangle's bounding box
+    for (size_t f = 0; f < _mesh->size_faces(); f++)
+    {
+        auto face = _mesh->face(f);
+        auto& a = face->vertex(0)->point();
+        auto& b = face->vertex(1)->point();
+        auto& c = face->vertex(2)->point();
+
+        double area = (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+        if (area == 0)
+            continue;
+
+        double xmin = std::min(a.x(), std::min(b.x(), c.x()));
+        double xmax = std::max(a.x(), std::max(b.x(), c.x()));
+        double ymin = std::min(a.y(), std::min(b.y(), c.y()));
+        double ymax = std::max(a.y(), std::max(b.y(), c.y()));
+
+        long i0 = std::max(0L, static_cast<long>(std::ceil((xmin - _x0) / resolution - 0.5)));
+        long i1 = std::min(static_cast<long>(nx) - 1, static_cast<long>(std::floor((xmax - _x0) / resolution - 0.5)));
+        long j0 = std::max(0L, static_cast<long>(std::ceil((_y1 - ymax) / resolution - 0.5)));
+        long j1 = std::min(static_cast<long>(ny) - 1, static_cast<long>(std::floor((_y1 - ymin) / resolution - 0.5)));
+
+        int32_t id = -1;
+        for (long j = j0; j <= j1; j++)
+        {
+            double y = _y1 - (j + 0.5) * resolution;
+            for (long i = i0; i <= i1; i++)
+            {
+                double x = _x0 + (i + 0.5) * resolution;
+
+                double d0 = (b.x() - a.x()) * (y - a.y()) - (b.y() - a.y()) * (x - a.x());
+                double d1 = (c.x() - b.x()) * (y - b.y()) - (c.y() - b.y()) * (x - b.x());
+                double d2 = (a.x() - c.x()) * (y - c.y()) - (a.y() - c.y()) * (x - c.x());
+
+                bool neg = d0 < 0 || d1 < 0 || d2 < 0;
+                bool pos = d0 > 0 || d1 > 0 || d2 > 0;
+
+                // centres on a shared edge go to the first face found
+                size_t p = j * nx + i;
+                if (!(neg && pos) && fine[p] < 0)
+                {
+                    if (id < 0)
+                    {
+                        id = static_cast<int32_t>(_faces.size());
+                        _faces.push_back(face);
+                    }
+                    fine[p] = id;
+                }
+            }
+        }
+    }
+
+    if (aggregate == 1)
+    {
+        _pixel_face.swap(fine);
+        return;
+    }
+
+    // list the faces, and how many fine pixels of each, that make up each output pixel
+    _pixel_ptr.resize(_nx * _ny + 1);
+    _pixel_ptr[0] = 0;
+
+    std::vector<int32_t> block;
+    for (size_t J = 0; J < _ny; J++)
+    {
+        for (size_t I = 0; I < _nx; I++)
+        {
+            block.clear();
+            for (size_t j = J * aggregate; j < (J + 1) * aggregate; j++)
+                for (size_t i = I * aggregate; i < (I + 1) * aggregate; i++)
+                    if (fine[j * nx + i] >= 0)
+                        block.push_back(fine[j * nx + i]);
+
+            std::sort(block.begin(), block.end());
+            for (size_t k = 0; k < block.size();)
+            {
+                size_t n = 1;
+                while (k + n < block.size() && block[k + n] == block[k])
+                    n++;
+
+                _pixel_face.push_back(block[k]);
+                _pixel_count.push_back(static_cast<uint32_t>(n));
+                k += n;
+            }
+
+            _pixel_ptr[J * _nx + I + 1] = _pixel_face.size();
+        }
+    }
+}
+
+void raster_output::rasterise(const float* face_values, float* out) const
+{
+    size_t n = _nx * _ny;
+
+    if (_pixel_ptr.empty())
+    {
+        for (size_t p = 0; p < n; p++)
+        {
+            int32_t f = _pixel_face[p];
+            float v = f < 0 ? nodata : face_values[f];
+            out[p] = std::isnan(v) ? nodata : v;
+        }
+        return;
+    }
+
+    for (size_t p = 0; p < n; p++)
+    {
+        double sum = 0;
+        size_t count = 0;
+        for (size_t k = _pixel_ptr[p]; k < _pixel_ptr[p + 1]; k++)
+        {
+            float v = face_values[_pixel_face[k]];
+            if (v == nodata || std::isnan(v))
+                continue;
+
+            sum += _pixel_count[k] * static_cast<double>(v);
+            count += _pixel_count[k];
+        }
+
+        out[p] = count > 0 ? static_cast<float>(sum / count) : nodata;
+    }
+}
+
+void raster_output::write(uint64_t time)
+{
+    if (_is_parameter.empty())
+    {
+        auto face = _mesh->face(0);
+        for (auto& v : _variables)
+        {
+            if (face->has(v))
+                _is_parameter.push_back(false);
+            else if (face->has_parameter(v))
+                _is_parameter.push_back(true);
+            else
+                BOOST_THROW_EXCEPTION(config_error() << errstr_info(
+                        "Raster output " + _fname + ": " + v + " is not a variable or parameter on the mesh"));
+        }
+    }
+
+    job j;
+    j.time = time;
+    j.values.resize(_variables.size(), std::vector<float>(_faces.size()));
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < _faces.size(); i++)
+    {
+        auto face = _faces[i];
+        for (size_t v = 0; v < _variables.size(); v++)
+            j.values[v][i] = static_cast<float>(_is_parameter[v] ? face->parameter(_variables[v]) : (*face)[_variables[v]]);
+    }
+
+    {
+        // don't let the model get too far ahead of the writer
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this] { return _queue.size() < max_queued || _error || _stop; });
+
+        if (_error)
+        {
+            auto e = _error;
+            _error = nullptr;
+            std::rethrow_exception(e);
+        }
+
+        if (_stop)
+            BOOST_THROW_EXCEPTION(chm_error() << errstr_info("Raster output " + _fname + " written to after finish()"));
+
+        _queue.push_back(std::move(j));
+    }
+    _cv.notify_all();
+}
+
+void raster_output::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+
+    if (_thread.joinable())
+        _thread.join();
+
+    if (_nc)
+    {
+        std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+        _nc->close();
+        _nc.reset();
+    }
+
+    if (_error)
+    {
+        auto e = _error;
+        _error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void raster_output::writer()
+{
+    while (true)
+    {
+        job j;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this] { return !_queue.empty() || _stop; });
+
+            if (_queue.empty())
+                break;
+
+            j = std::move(_queue.front());
+            _queue.pop_front();
+        }
+        _cv.notify_all();
+
+        try
+        {
+            if (_format == format::tiff)
+                write_tiff(j);
+            else
+                write_netcdf(j);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _error = std::current_exception();
+            _queue.clear();
+            _cv.notify_all();
+            break;
+        }
+    }
+}
+
+void raster_output::write_tiff(const job& j)
+{
+    std::string fname = _fname + std::to_string(j.time) + _suffix + ".tif";
+
+    char** options = nullptr;
+    options = CSLSetNameValue(options, "COMPRESS", "DEFLATE");
+    options = CSLSetNameValue(options, "TILED", "YES");
+
+    GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+    GDALDataset* ds = driver->Create(fname.c_str(), _nx, _ny, _variables.size(), GDT_Float32, options);
+    CSLDestroy(options);
+
+    if (!ds)
+        BOOST_THROW_EXCEPTION(chm_error() << errstr_info("Unable to create " + fname));
+
+    double transform[6] = {_x0, _dx, 0, _y1, 0, -_dx};
+    ds->SetGeoTransform(transform);
+    if (!_wkt.empty())
+        ds->SetProjection(_wkt.c_str());
+
+    std::vector<float> buffer(_nx * _ny);
+    for (size_t v = 0; v < _variables.size(); v++)
+    {
+        rasterise(j.values[v].data(), buffer.data());
+
+        auto band = ds->GetRasterBand(v + 1);
+        band->SetDescription(_variables[v].c_str());
+        band->SetNoDataValue(nodata);
+
+        if (band->RasterIO(GF_Write, 0, 0, _nx, _ny, buffer.data(), _nx, _ny, GDT_Float32, 0, 0) != CE_None)
+        {
+            GDALClose(ds);
+            BOOST_THROW_EXCEPTION(chm_error() << errstr_info("Unable to write " + _variables[v] + " to " + fname));
+        }
+    }
+
+    GDALClose(ds);
+}
+
+void raster_output::write_netcdf(const job& j)
+{
+    if (!_nc)
+    {
+        std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+
+        std::string fname = _fname + _suffix + ".nc";
+        _nc = std::make_unique<netCDF::NcFile>(fname, netCDF::NcFile::replace, netCDF::NcFile::nc4);
+        _nc->putAtt("Conventions", "CF-1.7");
+
+        auto time = _nc->addDim("time");
+        auto y = _nc->addDim("y", _ny);
+        auto x = _nc->addDim("x", _nx);
+
+        auto tv = _nc->addVar("time", netCDF::ncInt64, time);
+        tv.putAtt("standard_name", "time");
+        tv.putAtt("units", "seconds since 1970-01-01 00:00:00");
+        tv.putAtt("calendar", "standard");
+
+        auto xv = _nc->addVar("x", netCDF::ncDouble, x);
+        auto yv = _nc->addVar("y", netCDF::ncDouble, y);
+        if (_mesh->is_geographic())
+        {
+            xv.putAtt("standard_name", "longitude");
+            xv.putAtt("units", "degrees_east");
+            yv.putAtt("standard_name", "latitude");
+            yv.putAtt("units", "degrees_north");
+        }
+        else
+        {
+            xv.putAtt("standard_name", "projection_x_coordinate");
+            xv.putAtt("units", "m");
+            yv.putAtt("standard_name", "projection_y_coordinate");
+            yv.putAtt("units", "m");
+        }
+
+        std::vector<double> coord(_nx);
+        for (size_t i = 0; i < _nx; i++)
+            coord[i] = this->x(i);
+        xv.putVar(coord.data());
+
+        coord.resize(_ny);
+        for (size_t i = 0; i < _ny; i++)
+            coord[i] = this->y(i);
+        yv.putVar(coord.data());
+
+        auto crs = _nc->addVar("crs", netCDF::ncInt);
+        if (!_wkt.empty())
+        {
+            crs.putAtt("crs_wkt", _wkt);
+            crs.putAtt("spatial_ref", _wkt); // GDAL reads this one
+        }
+
+        std::vector<netCDF::NcDim> dims = {time, y, x};
+        std::vector<size_t> chunks = {1, std::min<size_t>(_ny, 1024), std::min<size_t>(_nx, 1024)};
+        for (auto& name : _variables)
+        {
+            auto v = _nc->addVar(name, netCDF::ncFloat, dims);
+            v.setChunking(netCDF::NcVar::nc_CHUNKED, chunks);
+            v.setCompression(true, true, 4);
+            v.setFill(true, nodata);
+            v.putAtt("grid_mapping", "crs");
+        }
+    }
+
+    std::vector<float> buffer(_nx * _ny);
+    for (size_t v = 0; v < _variables.size(); v++)
+    {
+        // rasterise outside of the lock so forcing reads aren't held up
+        rasterise(j.values[v].data(), buffer.data());
+
+        std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+        _nc->getVar(_variables[v]).putVar({_nc_record, 0, 0}, {1, _ny, _nx}, buffer.data());
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+    long long t = static_cast<long long>(j.time);
+    _nc->getVar("time").putVar({_nc_record}, {1}, &t);
+    _nc->sync();
+    _nc_record++;
+}
@@ -0,0 +1,177 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "triangulation.hpp"
+#include "netcdf.hpp"
+
+/**
+ * Rasterises face variables onto a regular grid and writes them as GeoTIFF or CF-NetCDF.
+ *
+ * Which face each pixel centre lies in is found once, when the output is created, by scanning each triangle's pixels.
+ * With aggregation, each output pixel is the mean of aggregate x aggregate of these fine pixels, and the faces
+ * (and how many fine pixels each covers) are stored per output pixel so a timestep is a weighted sum of face values.
+ *
+ * write() only copies the face values and queues them; rasterising and the file I/O are done by a background thread
+ * so the model can get on with the next timestep.
+ */
+class raster_output
+{
+public:
+    enum class format
+    {
+        tiff,
+        netcdf
+    };
+
+    /**
+     * @param mesh Triangulation to rasterise. Only the faces on this process are used.
+     * @param fname Base file name. tiff outputs are fname + posix time + suffix + .tif, netcdf outputs are fname + suffix + .nc
+     * @param variables Face variables or parameters to write
+     * @param fmt File format
+     * @param resolution Pixel size of the face lookup, in mesh units
+     * @param aggregate Output pixels are aggregate x aggregate pixels of the face lookup
+     * @param extent xmin, ymin, xmax, ymax of the grid in mesh units. Defaults to the mesh bounding box if empty.
+     * @param suffix Appended to the file names, e.g., the MPI rank
+     */
+    raster_output(boost::shared_ptr<triangulation> mesh, const std::string& fname,
+                  const std::vector<std::string>& variables, format fmt, double resolution, size_t aggregate = 1,
+                  std::vector<double> extent = {}, const std::string& suffix = "");
+
+    /**
+     * Waits for the queued timesteps to be written. Errors are logged, call finish() to have them thrown.
+     */
+    ~raster_output();
+
+    /**
+     * Copies the current face values and queues them to be written with the given time.
+     * Throws if the background writer has failed.
+     * @param time Seconds since the epoch
+     */
+    void write(uint64_t time);
+
+    /**
+     * Writes everything that is queued and stops the background writer. Throws if writing failed.
+     */
+    void finish();
+
+    /**
+     * Rasterises one variable's face values (in the order of faces()) onto the output grid.
+     * Pixels that aren't covered by the mesh, or only by faces with missing values, are set to nodata.
+     * @param face_values One value per face
+     * @param out cols() * rows() values, row major from the top (north) row
+     */
+    void rasterise(const float* face_values, float* out) const;
+
+    /**
+     * Faces that cover at least one pixel
+     */
+    const std::vector<mesh_elem>& faces() const
+    {
+        return _faces;
+    }
+
+    size_t cols() const
+    {
+        return _nx;
+    }
+
+    size_t rows() const
+    {
+        return _ny;
+    }
+
+    /**
+     * x, y of the centre of output pixel (i, j), j counting down from the top row
+     */
+    double x(size_t i) const
+    {
+        return _x0 + (i + 0.5) * _dx;
+    }
+
+    double y(size_t j) const
+    {
+        return _y1 - (j + 0.5) * _dx;
+    }
+
+    static constexpr float nodata = -9999.f;
+
+private:
+    // one timestep of face values, one vector per variable
+    struct job
+    {
+        uint64_t time;
+        std::vector<std::vector<float>> values;
+    };
+
+    void build_lookup(double resolution, size_t aggregate, std::vector<double> extent);
+
+    void writer();
+    void write_tiff(const job& j);
+    void write_netcdf(const job& j);
+
+    boost::shared_ptr<triangulation> _mesh;
+    std::string _fname;
+    std::string _suffix;
+    std::vector<std::string> _variables;
+    std::vector<bool> _is_parameter; // variable is a face parameter, found on the first write
+    format _format;
+    std::string _wkt;
+
+    // output grid
+    double _x0, _y1; // top left corner
+    double _dx;
+    size_t _nx, _ny;
+
+    std::vector<mesh_elem> _faces;
+
+    // output pixel p is covered by _pixel_face[_pixel_ptr[p] ... _pixel_ptr[p+1]), each covering _pixel_count fine pixels.
+    // Without aggregation _pixel_ptr is empty and _pixel_face holds one face per pixel (-1 if none)
+    std::vector<size_t> _pixel_ptr;
+    std::vector<int32_t> _pixel_face;
+    std::vector<uint32_t> _pixel_count;
+
+    // netcdf file, created by the writer on its first timestep
+    std::unique_ptr<netCDF::NcFile> _nc;
+    size_t _nc_record;
+
+    // background writer
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<job> _queue;
+    bool _stop;
+    std::exception_ptr _error;
+    static const size_t max_queued = 4;
+};
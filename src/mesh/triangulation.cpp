@@ -15,7 +15,11 @@
 
 
 
+#include <numeric>
+
 #include "triangulation.hpp"
+#include "mesh_arrays.hpp"
+#include "artifact_store.hpp"
 
 triangulation::triangulation()
 {
@@ -93,6 +97,37 @@ std::set<std::string> triangulation::parameters()
     return _parameters;
 }
 
+uint64_t triangulation::hash()
+{
+    content_hash h;
+    h.add(_srs_wkt);
+
+    for (auto& f : _faces)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            auto p = f->vertex(j)->point();
+            h.add(p.x());
+            h.add(p.y());
+            h.add(p.z());
+        }
+    }
+
+    for (auto& name : _parameters)
+        h.add(name);
+
+    for (size_t i = 0; i < size_faces(); i++)
+    {
+        auto f = face(i);
+        h.add(static_cast<uint64_t>(f->cell_global_id));
+
+        for (auto& name : _parameters)
+            h.add(f->has_parameter(name) ? f->parameter(name) : -9999.);
+    }
+
+    return h.value();
+}
+
 bool triangulation::is_geographic()
 {
     return _is_geographic;
@@ -228,33 +263,31 @@ void triangulation::serialize_parameter(std::string output_path, std::string par
 }
 void triangulation::from_json(pt::ptree &mesh)
 {
+    std::vector<char> buffer(mesh_arrays::packed_size(mesh));
+    mesh_arrays::pack(mesh, buffer.data(), buffer.size());
 
-    size_t nvertex_toread = mesh.get<size_t>("mesh.nvertex");
+    from_arrays(mesh_arrays(buffer.data(), buffer.size()));
+}
+
+void triangulation::from_arrays(const mesh_arrays& mesh)
+{
+
+    size_t nvertex_toread = mesh.nvertex();
     LOG_DEBUG << "Reading in #vertex=" << nvertex_toread;
     size_t i=0;
 
     //paraview struggles with lat/long as it doesn't seem to have the accuracy. So we need to scale up lat-long.
-    int is_geographic = mesh.get<int>("mesh.is_geographic");
-    if( is_geographic == 1)
+    bool is_geographic = mesh.is_geographic();
+    if( is_geographic )
     {
         _is_geographic = true;
     }
-    _srs_wkt = mesh.get<std::string>("mesh.proj4","");
-
-
-    if(_srs_wkt == "")
-    {
-        BOOST_THROW_EXCEPTION(config_error() << errstr_info("proj4 field in .mesh file is empty!"));
-    }
+    _srs_wkt = mesh.proj4();
 
-    for (auto &itr : mesh.get_child("mesh.vertex"))
+    _vertexes.reserve(nvertex_toread);
+    for (i = 0; i < nvertex_toread; i++)
     {
-        std::vector<double> items;
-        //iterate over the vertex triples
-        for(auto& jtr: itr.second)
-        {
-            items.push_back(jtr.second.get_value<double>());
-        }
+        const double* items = mesh.vertex(i);
         Point_3 pt( items[0], items[1], items[2]);
 
         _max_z = std::max(_max_z,items[2]);
@@ -264,19 +297,12 @@ void triangulation::from_json(pt::ptree &mesh)
         Vh->set_point(pt);
         Vh->set_id(i);
         _vertexes.push_back(Vh);
-        i++;
     }
     _num_vertex = this->number_of_vertices();
     LOG_DEBUG << "# nodes created = " << _num_vertex;
 
-    if( this->number_of_vertices() != nvertex_toread)
-    {
-        BOOST_THROW_EXCEPTION(config_error() << errstr_info(
-                "Expected: " + std::to_string(nvertex_toread) + " vertex, got: " + std::to_string(this->number_of_vertices())));
-    }
-
     //read in faces
-    size_t num_elem = mesh.get<int>("mesh.nelem");
+    size_t num_elem = mesh.nelem();
     LOG_DEBUG << "Reading in #elem = " << num_elem;
     //set our mesh dimensions
     this->set_dimension(2);
@@ -285,25 +311,20 @@ void triangulation::from_json(pt::ptree &mesh)
     //vectors to hold the center of a face to generate the spatial search tree
     std::vector<Point_2> center_points;
 
+    _faces.reserve(num_elem);
     i = 0;
-    size_t cid = 0;
-    for (auto &itr : mesh.get_child("mesh.elem"))
+    for (size_t cid = 0; cid < num_elem; cid++)
     {
-        std::vector<int> items;
-        //iterate over the vertex triples
-        for(auto& jtr: itr.second)
-        {
-            items.push_back(jtr.second.get_value<size_t>());
-        }
+        const int64_t* items = mesh.elem(cid);
         auto vert1 = _vertexes.at(items[0]); //0 indexing
         auto vert2 = _vertexes.at(items[1]);
         auto vert3 = _vertexes.at(items[2]);
 
         auto face = this->create_face(vert1,vert2,vert3);
-        face->cell_global_id = cid++;
+        face->cell_global_id = cid;
         face->cell_local_id = face->cell_global_id;
 
-        if( is_geographic == 1)
+        if( is_geographic )
         {
             face->_is_geographic = true;
         }
@@ -318,47 +339,17 @@ void triangulation::from_json(pt::ptree &mesh)
 
         _faces.push_back(face);
 
-// If we aren't using MPI, we can build the centre points here for efficiency.
-// these centre points will be used to build the spatial search tree. If we are using MPI,
-// we need to wait until we've figured out the per-node triangle partition so we can build
-// a per-node spatial search tree that only takes into account this node's elements.
-// If MPI, we do that at the end of this function
-
-#ifndef USE_MPI
-        Point_2 pt2(face->center().x(),face->center().y());
-        center_points.push_back(pt2);
-#endif
-
     }
 
-#ifndef USE_MPI
-    //make the search tree
-    dD_tree = boost::make_shared<Tree>(boost::make_zip_iterator(boost::make_tuple( center_points.begin(),_faces.begin() )),
-                                       boost::make_zip_iterator(boost::make_tuple( center_points.end(), _faces.end() ) )
-    );
-#endif
-
     _num_faces = this->number_of_faces();
 
     LOG_DEBUG << "Created a mesh with " << this->size_faces() << " triangles";
 
-    if( this->number_of_faces() != num_elem)
-    {
-        BOOST_THROW_EXCEPTION(config_error() << errstr_info(
-                "Expected: " + std::to_string(num_elem) + " elems, got: " + std::to_string(this->size_faces())));
-    }
-
     LOG_DEBUG << "Building face neighbours";
-    i=0;
-    int nelem = mesh.get<int>("mesh.nelem"); // what we are expecting to see, 0 indexed
-    for (auto &itr : mesh.get_child("mesh.neigh"))
+    int64_t nelem = num_elem; // what we are expecting to see, 0 indexed
+    for (i = 0; i < num_elem; i++)
     {
-        std::vector<int> items;
-        //iterate over the vertex triples
-        for(auto& jtr: itr.second)
-        {
-            items.push_back(jtr.second.get_value<int>());
-        }
+        const int64_t* items = mesh.neigh(i);
 
         auto face = _faces.at(i);
 
@@ -375,125 +366,74 @@ void triangulation::from_json(pt::ptree &mesh)
         Face_handle face2 =  items[2] != -1 ?_faces.at( items[2] ) : nullptr;
 
         face->set_neighbors(face0,face1,face2);
-
-        i++;
     }
-    //loop over parameter name
-
 
-    try
-    {
-        // build up the entire list of parameters so we can use this to init the per-face parameter
-        // storage later
+    // build up the entire list of parameters so we can use this to init the per-face parameter
+    // storage later. Zero length parameters have already been dropped
+    for (auto& p : mesh.parameters())
+        _parameters.insert(p.name);
 
-        std::set<std::string> blacklist; // holds any parameters that have 0 length, eg "area": [],
-        for (auto &itr : mesh.get_child("parameters"))
-        {
-            // we could have an item like this
-            // "area": [],
-            // and we need to ensure we *don't* load those
-            std::string name = itr.first.data();
-            size_t i=0;
-            for (auto &jtr : itr.second)
-            {
-                //just count the first couple items, make sure it's non zero
-                if(i > 1)
-                    break;
-                ++i;
-            }
-
-            if(i == 0)
-            {
-                blacklist.insert(name);
-                LOG_WARNING << "Parameter " + name + " is zero length and will be ignored.";
-            } else {
-                _parameters.insert(name);
-            }
-
-        }
-
-        // init the storage
+    // init the storage, which builds the mphf
+    // we still need to build up the face storage without any parameters as we may have parameters from a module
 #pragma omp parallel for
-        for (size_t i = 0; i < size_faces(); i++)
-        {
-             _faces.at(i)->init_parameters(_parameters);
-        }
-
-
-        for (auto &itr : mesh.get_child("parameters"))
-        {
-            i = 0; // reset evertime we get a new parameter set
-            auto name = itr.first.data();
-
-            if(blacklist.find(name) != blacklist.end())
-                continue; // skip blacklisted ones, as we don't want to use these
-
-            LOG_DEBUG << "Applying parameter: " << name;
+    for (size_t i = 0; i < size_faces(); i++)
+    {
+         _faces.at(i)->init_parameters(_parameters);
+    }
 
-            for (auto &jtr : itr.second)
-            {
-                auto face = _faces.at(i);
-                auto value = jtr.second.get_value<double>();
-                face->parameter(name) = value;
-                i++;
-            }
-        }
-    }catch(pt::ptree_bad_path& e)
+    for (auto& p : mesh.parameters())
     {
-        // we don't have this section, no worries
-        // but we still need to build up the face storage as we may have parameters from a module
-        // init the storage, which builds the mphf
-#pragma omp parallel for
-        for (size_t i = 0; i < size_faces(); i++)
-        {
-             _faces.at(i)->init_parameters(_parameters);
-        }
+        LOG_DEBUG << "Applying parameter: " << p.name;
 
+#pragma omp parallel for
+        for (size_t i = 0; i < p.size; i++)
+            _faces[i]->parameter(p.name) = p.values[i];
     }
 
-    std::set<std::string> ics;
-    try
+    for (auto& ic : mesh.initial_conditions())
     {
-        for (auto &itr : mesh.get_child("initial_conditions"))
+        LOG_DEBUG << "Applying IC: " << ic.name;
+        for (size_t i = 0; i < ic.size; i++)
         {
-            i=0; // reset evertime we get a new parameter set
-            auto name = itr.first.data();
-            LOG_DEBUG << "Applying IC: " << name;
-            for (auto &jtr : itr.second)
-            {
-                auto face = _faces.at(i);
-                double value = jtr.second.get_value<double>();
-    //            alue == -9999. ? value = nan("") : value;
-                face->set_initial_condition(name,value);
-                i++;
-            }
-
-            ics.insert(name);
+//            alue == -9999. ? value = nan("") : value;
+            _faces[i]->set_initial_condition(ic.name, ic.values[i]);
         }
-    }catch(pt::ptree_bad_path& e)
-    {
-        // we don't have this section, no worries
     }
     _num_faces = this->number_of_faces();
     _num_vertex = this->number_of_vertices();
 
     // Permute the faces if they have explicit IDs set in the mesh file
-    try
+    if (mesh.cell_global_id())
     {
-      std::vector<size_t> permutation;
-      for (auto itr : mesh.get_child("mesh.cell_global_id"))
-      {
-	    permutation.push_back(itr.second.get_value<size_t>());
-      }
-      reorder_faces(permutation);
-
-    }catch(pt::ptree_bad_path& e)
+        std::vector<size_t> permutation(mesh.cell_global_id(), mesh.cell_global_id() + num_elem);
+        reorder_faces(permutation);
+    }
+    else
     {
-        // If not, just ignore the exception
         LOG_DEBUG << "No face permutation.";
     }
 
     partition_mesh();
+
+    // needs the faces in their final order and to know which are ghosts
+    compute_geometry();
+
+// If we aren't using MPI, the search tree is over all the faces.
+// If we are using MPI, we need to wait until we've figured out the per-node triangle partition so we can build
+// a per-node spatial search tree that only takes into account this node's elements.
+#ifndef USE_MPI
+    for (auto& face : _faces)
+    {
+        Point_2 pt2(face->get_x(),face->get_y());
+        center_points.push_back(pt2);
+    }
+
+    //make the search tree
+    dD_tree = boost::make_shared<Tree>(boost::make_zip_iterator(boost::make_tuple( center_points.begin(),_faces.begin() )),
+                                       boost::make_zip_iterator(boost::make_tuple( center_points.end(), _faces.end() ) )
+    );
+#endif
+
 #ifdef USE_MPI
     _num_faces = _local_faces.size();
     size_t total_num_faces = _faces.size();
@@ -521,49 +461,185 @@ void triangulation::from_json(pt::ptree &mesh)
     // shrink the local mesh
     // shrink_local_mesh_to_owned_and_distance_neighbours();
 
-  std::vector<double> temp_slope(_num_faces);
+    // TODO need to re-setup dD_tree to only consider the _faces after shrinking
+    // -  Note this likely allows us to remove the the ifndef USE_MPI from earlier in this routine,
+    //    as we have to do a global pass and a local pass anyway
+
+}
+
+void triangulation::compute_geometry()
+{
+    LOG_DEBUG << "Computing face geometry";
+
+    size_t n = _faces.size();
+
+    _geometry_faces = _faces;
+
+    _geometry.x.resize(n);
+    _geometry.y.resize(n);
+    _geometry.z.resize(n);
+    _geometry.nx.resize(n);
+    _geometry.ny.resize(n);
+    _geometry.nz.resize(n);
+    _geometry.slope.resize(n);
+    _geometry.raw_slope.resize(n);
+    _geometry.aspect.resize(n);
+    _geometry.area.resize(n);
+    _geometry.edge_length.resize(3 * n);
 
 #pragma omp parallel for
-  for (size_t i = 0; i < _num_faces; i++)
-  {
+    for (size_t i = 0; i < n; i++)
+    {
+        compute_face_geometry(i);
+        _geometry.slope[i] = _geometry.raw_slope[i];
+    }
 
-    auto f = face(i);
-    std::vector<boost::tuple<double, double, double> > u;
-    for (size_t j = 0; j < 3; j++)
+    // the faces using each vertex, so only the faces of moved vertices need to be recomputed
+    _vertex_face_ptr.assign(_vertexes.size() + 1, 0);
+    for (auto& f : _geometry_faces)
     {
-      auto neigh = f->neighbor(j);
-      if (neigh != nullptr && !neigh->_is_ghost)
-        u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(), neigh->slope()));
+        for (int j = 0; j < 3; j++)
+            _vertex_face_ptr[f->vertex(j)->get_id() + 1]++;
     }
+    for (size_t i = 0; i < _vertexes.size(); i++)
+        _vertex_face_ptr[i + 1] += _vertex_face_ptr[i];
 
-    auto query = boost::make_tuple(f->get_x(), f->get_y(), f->get_z());
+    _vertex_faces.resize(_vertex_face_ptr.back());
+    std::vector<size_t> next(_vertex_face_ptr.begin(), _vertex_face_ptr.end() - 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (int j = 0; j < 3; j++)
+            _vertex_faces[next[_geometry_faces[i]->vertex(j)->get_id()]++] = i;
+    }
 
-    interpolation interp(interp_alg::tpspline);
-    double new_slope = f->slope();
+    // from here on the faces read their geometry from the arrays
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
+    {
+        _geometry_faces[i]->_geometry_id = i;
+    }
+
+    std::vector<size_t> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    smooth_slope(ids);
+}
 
-    if(u.size() > 0)
+void triangulation::update_geometry(const std::vector<size_t>& vertices)
+{
+    if (_geometry_faces.empty())
+        return;
+
+    std::vector<char> affected(_geometry_faces.size(), 0);
+    for (auto v : vertices)
     {
-      new_slope = interp(u, query);
+        for (size_t k = _vertex_face_ptr.at(v); k < _vertex_face_ptr.at(v + 1); k++)
+            affected[_vertex_faces[k]] = 1;
     }
 
-    temp_slope.at(i) = new_slope;
-  }
+    std::vector<size_t> ids;
+    for (size_t i = 0; i < affected.size(); i++)
+    {
+        if (affected[i])
+            ids.push_back(i);
+    }
 
 #pragma omp parallel for
-  for (size_t i = 0; i < size_faces(); i++)
-  {
-    auto f = face(i);
-    f->_slope = temp_slope.at(i);
-    //init these
-    f->aspect();
-    f->center();
-    f->normal();
-  }
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        compute_face_geometry(ids[i]);
+        _geometry.slope[ids[i]] = _geometry.raw_slope[ids[i]];
+    }
 
-    // TODO need to re-setup dD_tree to only consider the _faces after shrinking
-    // -  Note this likely allows us to remove the the ifndef USE_MPI from earlier in this routine,
-    //    as we have to do a global pass and a local pass anyway
+    // the smoothed slope of a face also depends on its neighbours' slopes
+    for (auto id : ids)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            auto neigh = _geometry_faces[id]->neighbor(j);
+            if (neigh != nullptr && neigh->_geometry_id < affected.size())
+                affected[neigh->_geometry_id] = 1;
+        }
+    }
+
+    ids.clear();
+    for (size_t i = 0; i < affected.size(); i++)
+    {
+        if (affected[i])
+            ids.push_back(i);
+    }
 
+    smooth_slope(ids);
+
+    std::lock_guard<std::mutex> lock(_operators_mutex);
+    _operators.reset();
+}
+
+const mesh_operators& triangulation::operators()
+{
+    std::lock_guard<std::mutex> lock(_operators_mutex);
+
+    if (!_operators)
+        _operators = std::make_shared<mesh_operators>(*this);
+
+    return *_operators;
+}
+
+void triangulation::compute_face_geometry(size_t id)
+{
+    auto f = _geometry_faces[id];
+
+    auto c = f->compute_center();
+    _geometry.x[id] = c.x();
+    _geometry.y[id] = c.y();
+    _geometry.z[id] = c.z();
+
+    auto n = f->compute_normal();
+    _geometry.nx[id] = n[0];
+    _geometry.ny[id] = n[1];
+    _geometry.nz[id] = n[2];
+
+    _geometry.raw_slope[id] = f->compute_slope(n);
+    _geometry.aspect[id] = f->compute_aspect(n);
+    _geometry.area[id] = f->compute_area();
+
+    for (int j = 0; j < 3; j++)
+        _geometry.edge_length[3 * id + j] = f->compute_edge_length(j);
+}
+
+void triangulation::smooth_slope(const std::vector<size_t>& ids)
+{
+    // smooth the locally owned faces, using only the neighbours that are locally owned
+#pragma omp parallel for
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        size_t id = ids[i];
+        auto f = _geometry_faces[id];
+        if (f->_is_ghost)
+            continue;
+
+        std::vector<boost::tuple<double, double, double> > u;
+        for (size_t j = 0; j < 3; j++)
+        {
+            auto neigh = f->neighbor(j);
+            if (neigh != nullptr && !neigh->_is_ghost)
+            {
+                size_t nid = neigh->_geometry_id;
+                u.push_back(boost::make_tuple(_geometry.x[nid], _geometry.y[nid], _geometry.raw_slope[nid]));
+            }
+        }
+
+        double new_slope = _geometry.raw_slope[id];
+
+        if(u.size() > 0)
+        {
+            auto query = boost::make_tuple(_geometry.x[id], _geometry.y[id], _geometry.z[id]);
+
+            interpolation interp(interp_alg::tpspline);
+            new_slope = interp(u, query);
+        }
+
+        _geometry.slope[id] = new_slope;
+    }
 }
 
 void triangulation::reorder_faces(std::vector<size_t> permutation)
@@ -616,24 +692,33 @@ void triangulation::partition_mesh()
 
   LOG_DEBUG << "Partitioning mesh";
 
-  // Set up so that all processors know how 'big' all other processors are
-  std::vector<int> num_faces_in_partition(_comm_world.size(),
-  					  total_num_faces/_comm_world.size());
-  for (unsigned int i=0;i<total_num_faces%_comm_world.size();++i) {
-    num_faces_in_partition[i]++;
-  }
+  apply_partition(mesh_partition(total_num_faces, _comm_world.size()));
 
-  // each processor only knows its own start and end indices
-  size_t face_start_idx = 0;
-  size_t face_end_idx = num_faces_in_partition[0]-1;
-  for (int i=1;i<=_comm_world.rank();++i) {
-    face_start_idx += num_faces_in_partition[i-1];
-    face_end_idx += num_faces_in_partition[i];
+#else // do not USE_MPI
+
+#pragma omp parallel for
+  for(size_t i=0;i<total_num_faces;++i)
+  {
+    _faces.at(i)->_is_ghost = false;
+    _faces.at(i)->cell_local_id = i; // Mesh has been (potentially) reordered before this point. Set the local_id correctly
   }
+  LOG_DEBUG << "Face numbering : start 0, end " << (total_num_faces-1) << ", number " << _local_faces.size();
 
+#endif // USE_MPI
+
+}
+
+#ifdef USE_MPI
+void triangulation::apply_partition(const mesh_partition& partition)
+{
+  _partition = std::make_shared<mesh_partition>(partition);
+
+  // each processor only knows its own start and end indices
+  size_t face_start_idx = partition.begin(_comm_world.rank());
+  size_t face_end_idx = partition.end(_comm_world.rank()) - 1;
 
   // Set size of vector containing locally owned faces
-  _local_faces.resize(num_faces_in_partition[_comm_world.rank()]);
+  _local_faces.resize(partition.size(_comm_world.rank()));
 
 #pragma omp parallel for
   for(int local_ind=0;local_ind<_local_faces.size();++local_ind)
@@ -648,22 +733,48 @@ void triangulation::partition_mesh()
 
 
   LOG_DEBUG << "MPI Process " << _comm_world.rank() << ": start " << face_start_idx << ", end " << face_end_idx << ", number " << _local_faces.size();
+}
+
+void triangulation::repartition(const mesh_partition& partition)
+{
+  if (partition.parts() != static_cast<size_t>(_comm_world.size()) || partition.faces() != _faces.size())
+    BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Partition of " + std::to_string(partition.faces()) + " faces into " +
+                                                       std::to_string(partition.parts()) + " parts doesn't match the mesh"));
 
+  LOG_DEBUG << "Repartitioning mesh";
 
-#else // do not USE_MPI
+  for (auto& face : _local_faces)
+    face->_is_ghost = true;
 
+  apply_partition(partition);
+  _num_faces = _local_faces.size();
+
+  _boundary_faces.clear();
+  _ghost_neighbours.clear();
+  determine_local_boundary_faces();
+  determine_process_ghost_faces_nearest_neighbours();
+
+  // the smoothed slope only uses the locally owned neighbours, so is redone as for a run started on this partition
+  std::vector<size_t> ids(_geometry_faces.size());
+  std::iota(ids.begin(), ids.end(), 0);
 #pragma omp parallel for
-  for(size_t i=0;i<total_num_faces;++i)
-  {
-    _faces.at(i)->_is_ghost = false;
-    _faces.at(i)->cell_local_id = i; // Mesh has been (potentially) reordered before this point. Set the local_id correctly
-  }
-  LOG_DEBUG << "Face numbering : start 0, end " << (total_num_faces-1) << ", number " << _local_faces.size();
+  for (size_t i = 0; i < ids.size(); i++)
+    _geometry.slope[i] = _geometry.raw_slope[i];
+  smooth_slope(ids);
 
-#endif // USE_MPI
+  // these are over the local faces and are rebuilt on their next use
+  _vtk_unstructuredGrid = nullptr;
 
+  std::lock_guard<std::mutex> lock(_operators_mutex);
+  _operators.reset();
 }
 
+const mesh_partition& triangulation::partition() const
+{
+  return *_partition;
+}
+#endif
+
 void triangulation::determine_local_boundary_faces()
 {
   /*
@@ -772,7 +883,7 @@ void triangulation::determine_process_ghost_faces_nearest_neighbours()
   std::unordered_set<mesh_elem> tmp_set(std::begin(ghosted_boundary_nearest_neighbours),
 					std::end(ghosted_boundary_nearest_neighbours));
   // Convert the set to a vector
-  _ghost_neighbours.insert(std::end(_ghost_faces),
+  _ghost_neighbours.insert(std::end(_ghost_neighbours),
 			   std::begin(tmp_set),std::end(tmp_set));
 #ifdef USE_MPI
   LOG_DEBUG << "MPI Process " << _comm_world.rank() << " has " << _ghost_neighbours.size() << " ghosted nearest neighbours.";
@@ -1013,6 +1124,8 @@ void triangulation::init_vtkUnstructured_Grid(std::vector<std::string> output_va
     }
 
     _vtk_unstructuredGrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    data.clear();
+    vectors.clear();
     _vtk_unstructuredGrid->SetPoints(points);
     _vtk_unstructuredGrid->SetCells(VTK_TRIANGLE, triangles);
     _vtk_unstructuredGrid->GetFieldData()->AddArray(proj4);
@@ -1100,6 +1213,30 @@ void triangulation::init_module_data(std::set< std::string > modules)
     }
 }
 
+void triangulation::copy_state(std::vector<face_state>& states)
+{
+    states.resize(size_faces());
+
+#pragma omp parallel for
+    for (size_t it = 0; it < size_faces(); it++)
+    {
+        face(it)->copy_state(states[it]);
+    }
+}
+
+void triangulation::swap_state(std::vector<face_state>& states)
+{
+    if (states.size() != size_faces())
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Face state is for " + std::to_string(states.size()) +
+                                                           " faces, the mesh has " + std::to_string(size_faces())));
+
+#pragma omp parallel for
+    for (size_t it = 0; it < size_faces(); it++)
+    {
+        face(it)->swap_state(states[it]);
+    }
+}
+
 void triangulation::init_face_data(std::set< std::string >& timeseries,
                     std::set< std::string >& vectors,
                     std::set< std::string >& module_data)
@@ -1116,10 +1253,11 @@ void triangulation::init_face_data(std::set< std::string >& timeseries,
 
 void triangulation::update_vtk_data(std::vector<std::string> output_variables)
 {
-    //if we haven't inited yet, do so.
-    if(!_vtk_unstructuredGrid || _terrain_deformed)
+    //if we haven't inited yet, do so. Outputs of different variables share the grid, so start over when they change
+    if(!_vtk_unstructuredGrid || _terrain_deformed || output_variables != _vtk_variables)
     {
         this->init_vtkUnstructured_Grid(output_variables);
+        _vtk_variables = output_variables;
     }
 
     auto variables = output_variables.size() == 0 ? this->face(0)->variables() : output_variables;
@@ -1214,6 +1352,30 @@ double triangulation::max_z()
     return _max_z;
 }
 
+K::Iso_rectangle_2 triangulation::bounding_box()
+{
+    double xmin = std::numeric_limits<double>::max();
+    double ymin = std::numeric_limits<double>::max();
+    double xmax = std::numeric_limits<double>::lowest();
+    double ymax = std::numeric_limits<double>::lowest();
+
+    for (size_t i = 0; i < size_faces(); i++)
+    {
+        auto f = face(i);
+        for (int j = 0; j < 3; j++)
+        {
+            auto& p = f->vertex(j)->point();
+            xmin = std::min(xmin, p.x());
+            ymin = std::min(ymin, p.y());
+            xmax = std::max(xmax, p.x());
+            ymax = std::max(ymax, p.y());
+        }
+    }
+
+    _bbox = K::Iso_rectangle_2(xmin, ymin, xmax, ymax);
+    return _bbox;
+}
+
 double triangulation::min_z()
 {
     return _min_z;
@@ -52,6 +52,8 @@ inline int omp_get_max_threads() { return 1;}
 #include <stack>
 #include <fstream>
 #include <utility>
+#include <limits>
+#include <mutex>
 //#define ARMA_DONT_USE_CXX11 //intel on linux breaks otherwise
 //#define ARMA_64BIT_WORD
 #include <armadillo>
@@ -123,6 +125,8 @@ namespace pt = boost::property_tree;
 #endif
 
 #include "vertex.hpp"
+#include "mesh_operators.hpp"
+#include "mesh_partition.hpp"
 #include "timeseries.hpp"
 #include "math/coordinates.hpp"
 #include "utility/xxh64.hpp"
@@ -145,6 +149,7 @@ struct face_info
 //fwd decl
 class segmented_AABB;
 class triangulation;
+class mesh_arrays;
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
 
@@ -157,6 +162,18 @@ typedef CGAL::Projection_traits_xy_3<K> Gt; //allows for using 2D algorithms on
 
 typedef ex_vertex<Gt> Vb; //custom vertex class
 
+/**
+ * The per-face values that the model changes, i.e., everything but the geometry and stations.
+ * Ensemble members each keep one per face and exchange it with the face's own when they are run.
+ */
+struct face_state
+{
+    variablestorage<double> variables;
+    variablestorage<double> parameters;
+    variablestorage<double> initial_conditions;
+    variablestorage<face_info*> module_data;
+    variablestorage<Vector_3> vectors;
+};
 
 
 
@@ -205,24 +222,24 @@ public:
     ~face();
 
     /**
-    * Aspect of the face. North = 0, CW . Calculated on first use, subsequent usages will not recalculate
+    * Aspect of the face. North = 0, CW . Read from the triangulation's geometry, see triangulation::geometry()
     * \return Face aspect [rad]
     */
     double aspect();
 
     /**
-    * Slope of the face. Calculated on first use, subsequent usages will not recalculate
+    * Slope of the face, smoothed with its neighbours' slopes when the mesh is loaded. Read from the triangulation's geometry
     * \return slope [rad]
     */
     double slope();
 
     /**
-    * Normalized face normal. Calculated on first use, subsequent usages will not recalculate
+    * Normalized face normal. Read from the triangulation's geometry
     */
     Vector_3 normal();
 
     /**
-    * Center of the face as defined by a centroid. Calculated on first use, subsequent usages will not recalculate
+    * Center of the face as defined by a centroid. Read from the triangulation's geometry
     */
     Point_3 center();
 
@@ -234,6 +251,22 @@ public:
      */
     const Face_handle find_closest_face(double azimuth, double distance);
 
+    /**
+     * find_closest_face using the mesh's geometry Geo, math::gis::UTM or math::gis::LatLong, see global::is_geographic()
+     */
+    template<typename Geo>
+    const Face_handle find_closest_face(double azimuth, double distance);
+
+    /**
+     * find_closest_face for n distances along one azimuth, e.g., the steps of a ray march.
+     * Geo is the mesh's geometry, math::gis::UTM or math::gis::LatLong, see global::is_geographic()
+     * @param azimuth
+     * @param distance n distances
+     * @param faces n closest faces
+     */
+    template<typename Geo>
+    void find_closest_faces(double azimuth, const double* distance, size_t n, Face_handle* faces);
+
     /**
      * Returns the ith edge's length. Refering to the docs here
      * http://doc.cgal.org/latest/Triangulation_2/classCGAL_1_1Triangulation__2.html
@@ -350,6 +383,23 @@ public:
 */
     void init_module_data(std::set<std::string>& modules);
 
+    /**
+    * Copies this face's variables, parameters, initial conditions and vectors into state.
+    * Module data isn't copied, state gets an empty slot for each module.
+    */
+    void copy_state(face_state& state);
+
+    /**
+    * Exchanges this face's variables, parameters, initial conditions, module data and vectors with those in state
+    */
+    void swap_state(face_state& state);
+
+    /**
+    * Frees this face's variables, vectors and module data, once another MPI process has taken the face over.
+    * The parameters and initial conditions are kept, as every process holds those for the whole mesh.
+    */
+    void release_state();
+
     /**
     * Obtains the timeseries associated with the given variable
     * \param ID variable
@@ -484,22 +534,23 @@ public:
 
 private:
 
+    // geometry computed from the vertices, used to fill the triangulation's geometry arrays and before those exist
+    Vector_3 compute_normal();
+    Point_3 compute_center();
+    double compute_area();
+    double compute_edge_length(int i);
+    static double compute_slope(const Vector_3& normal);
+    static double compute_aspect(const Vector_3& normal);
 
-    double _slope;
-    double _azimuth;
-    double _area;
-    double _x;
-    double _y;
-    double _z;
+    // index into the triangulation's geometry arrays, or no_geometry if they haven't been computed yet
+    static const size_t no_geometry = static_cast<size_t>(-1);
+    size_t _geometry_id;
 
     //hold a pointer *back* to the triangulation. This let's use query triangles at distance X, etc
     //that allows for using data::parallel modules w/o having to use domain parallel.
     //const so we can't modify the domain via this as thar be dragons
     triangulation* _domain;
 
-    boost::shared_ptr<Point_3> _center;
-    boost::shared_ptr<Vector_3> _normal;
-
 
     variablestorage<double> _variables;
     variablestorage<double> _parameters;
@@ -546,6 +597,33 @@ typedef CGAL::Orthogonal_k_neighbor_search <
 typedef CGAL::Fuzzy_sphere<Traits> Fuzzy_circle;
 
 
+/**
+ * Geometry of every face, a contiguous array per quantity indexed by the face's geometry id.
+ * Filled by triangulation::compute_geometry and kept current by triangulation::update_geometry.
+ */
+struct face_geometry
+{
+    // centroid
+    std::vector<double> x, y, z;
+
+    // unit normal
+    std::vector<double> nx, ny, nz;
+
+    // [rad], smoothed with the neighbours' slopes
+    std::vector<double> slope;
+
+    // [rad], slope from the face's own normal
+    std::vector<double> raw_slope;
+
+    // [rad] North = 0, CW
+    std::vector<double> aspect;
+
+    std::vector<double> area;
+
+    // 3 per face, the length of edge i is edge_length[3 * id + i]
+    std::vector<double> edge_length;
+};
+
 /**
 *
 */
@@ -576,17 +654,64 @@ public:
     */
 	void from_json(pt::ptree& mesh);
 
+    /**
+    * Builds the mesh from a packed .mesh file, e.g., one shared between the ranks on a node. See mesh_arrays.
+    * \param mesh View onto the packed mesh, only needed for the duration of the call
+    */
+    void from_arrays(const mesh_arrays& mesh);
+
     /**
     * Sets a new order to the face numbering.
     * \param permutation desired ordering
     */
   void reorder_faces(std::vector<size_t> permutation);
 
+    /**
+     * Computes the centroid, normal, slope, aspect, area and edge lengths of all the faces into contiguous arrays.
+     * The slope is smoothed over each face's neighbours. Done by from_json once the faces and their parameters are loaded.
+     */
+    void compute_geometry();
+
+    /**
+     * Recomputes the geometry of the faces that use any of these vertices, e.g., after the vertices have been moved.
+     * The smoothed slope of those faces' neighbours is updated as well.
+     * @param vertices Vertex indexes, as for vertex(i)
+     */
+    void update_geometry(const std::vector<size_t>& vertices);
+
+    /**
+     * Geometry of all the faces. Index with a face's geometry id, which face::center() etc. do
+     */
+    const face_geometry& geometry() const
+    {
+        return _geometry;
+    }
+
+    /**
+     * Fixed-stencil smoothing, gradient, divergence and Laplacian operators over the local faces.
+     * Built from the geometry on first use and rebuilt after update_geometry.
+     */
+    const mesh_operators& operators();
+
     /**
     * Sets the MPI process ownership of mesh faces and nodes
     */
   void partition_mesh();
 
+#ifdef USE_MPI
+    /**
+    * Hands the faces to the MPI processes by a new partition, e.g., one weighted by the measured cost of each face.
+    * Only the ownership changes, as every process holds the whole mesh; moving the faces' state is up to the caller.
+    * The boundary and ghost faces, the smoothed slope and the operators are redone for the new local faces.
+    */
+  void repartition(const mesh_partition& partition);
+
+    /**
+    * The partition of the faces, by global id, over the MPI processes
+    */
+  const mesh_partition& partition() const;
+#endif
+
     /**
     * Figures out which faces lie on the boundary of an MPI process' domain
     */
@@ -751,6 +876,16 @@ public:
     /// @param modules
     void init_module_data(std::set< std::string > modules);
 
+    /**
+     * Copies the state of every local face into states, see face::copy_state
+     */
+    void copy_state(std::vector<face_state>& states);
+
+    /**
+     * Exchanges the state of every local face i with states[i], see face::swap_state
+     */
+    void swap_state(std::vector<face_state>& states);
+
     /// Initalizes all the face-data data structures: variables, module data, vectors.
     /// Can be done individually but this only requires one pass over the triangulation and is thus faster
     /// @param timeseries
@@ -800,6 +935,12 @@ public:
      */
     std::set<std::string> parameters();
 
+    /**
+     * Hash of the mesh's geometry, and the local faces' global ids and parameters.
+     * Anything computed from only these can be reused by a later run on a mesh with the same hash.
+     */
+    uint64_t hash();
+
     bool _terrain_deformed;
 
     /**
@@ -814,6 +955,12 @@ public:
      */
     double max_z();
 
+    /**
+     * Axis aligned bounding box, in mesh coordinates, of the vertices of the faces on this process
+     * @return
+     */
+    K::Iso_rectangle_2 bounding_box();
+
     //Point to the global object that contains paramter information.
     boost::shared_ptr<global> _global;
 
@@ -834,6 +981,9 @@ private:
 	//holds the vtk ugrid if we are outputing to vtk formats
 	vtkSmartPointer<vtkUnstructuredGrid> _vtk_unstructuredGrid;
 
+	// variables the vtu grid was set up with
+	std::vector<std::string> _vtk_variables;
+
 	//holds the vectors we use to create the vtu file
 #ifdef USE_SPARSEHASH
     google::dense_hash_map< std::string, vtkSmartPointer<vtkFloatArray>  > data;
@@ -858,6 +1008,24 @@ private:
 
     std::vector< mesh_elem > _local_faces;
     std::vector< std::pair<mesh_elem,bool> > _boundary_faces;
+
+    face_geometry _geometry;
+
+    // the face with geometry id i
+    std::vector< mesh_elem > _geometry_faces;
+
+    // the geometry ids of the faces using vertex i are _vertex_faces[_vertex_face_ptr[i] .. _vertex_face_ptr[i+1]]
+    std::vector< size_t > _vertex_face_ptr;
+    std::vector< size_t > _vertex_faces;
+
+    // computes the geometry of face id from its vertices, except for the smoothed slope
+    void compute_face_geometry(size_t id);
+
+    // smooths the slope of these faces with their neighbours' slopes
+    void smooth_slope(const std::vector<size_t>& ids);
+
+    std::shared_ptr<mesh_operators> _operators;
+    std::mutex _operators_mutex;
     std::vector< mesh_elem > _ghost_neighbours;
     std::vector< mesh_elem > _ghost_faces;
 
@@ -870,6 +1038,11 @@ private:
 #ifdef USE_MPI
     boost::mpi::environment _mpi_env;
     boost::mpi::communicator _comm_world;
+
+    std::shared_ptr<mesh_partition> _partition;
+
+    // makes the faces in the partition's range for this process the local ones
+    void apply_partition(const mesh_partition& partition);
 #endif
 
 };
@@ -1062,12 +1235,9 @@ face<Gt, Fb>::~face()
 template < class Gt, class Fb >
 face<Gt, Fb>::face()
 {
-    _slope = -1;
-    _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
-    _area = -1.;
+    _geometry_id = no_geometry;
+    _domain = nullptr;
     _is_geographic = false;
 
 
@@ -1080,12 +1250,9 @@ face<Gt, Fb>::face(Vertex_handle v0,
                    Vertex_handle v2)
         : Fb(v0, v1, v2)
 {
-    _slope = -1;
-    _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
-    _area = -1.;
+    _geometry_id = no_geometry;
+    _domain = nullptr;
     _is_geographic = false;
 
 }
@@ -1099,12 +1266,9 @@ face<Gt, Fb>::face(Vertex_handle v0,
                    Face_handle n2)
         : Fb(v0, v1, v2, n0, n1, n2)
 {
-    _slope = -1;
-    _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
-    _area = -1.;
+    _geometry_id = no_geometry;
+    _domain = nullptr;
     _is_geographic = false;
 
 }
@@ -1121,12 +1285,9 @@ face<Gt, Fb>::face(Vertex_handle v0,
                    bool c2)
         : Fb(v0, v1, v2, n0, n1, n2)
 {
-    _slope = -1;
-    _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
-    _area = -1.;
+    _geometry_id = no_geometry;
+    _domain = nullptr;
     _is_geographic = false;
 
 
@@ -1135,16 +1296,16 @@ face<Gt, Fb>::face(Vertex_handle v0,
 template < class Gt, class Fb>
 double face<Gt, Fb>::aspect()
 {
-    if (_azimuth == -1)
-    {
-        if(!_normal)
-            this->normal();
-
-        _azimuth = math::gis::cartesian_to_bearing(Vector_2((*_normal)[0],(*_normal)[1])) * M_PI/180.; //need in radians
+    if (_geometry_id != no_geometry)
+        return _domain->geometry().aspect[_geometry_id];
 
-    }
+    return compute_aspect(compute_normal());
+}
 
-    return _azimuth;
+template < class Gt, class Fb>
+double face<Gt, Fb>::compute_aspect(const Vector_3& normal)
+{
+    return math::gis::cartesian_to_bearing(Vector_2(normal[0],normal[1])) * M_PI/180.; //need in radians
 }
 
 template < class Gt, class Fb>
@@ -1199,6 +1360,15 @@ Point_2 face<Gt, Fb>::edge_midpoint(int i)
 
 template < class Gt, class Fb>
 double face<Gt, Fb>::edge_length(int i)
+{
+    if (_geometry_id != no_geometry)
+        return _domain->geometry().edge_length[3 * _geometry_id + i];
+
+    return compute_edge_length(i);
+};
+
+template < class Gt, class Fb>
+double face<Gt, Fb>::compute_edge_length(int i)
 {
     auto e = edge(i);
 
@@ -1208,26 +1378,27 @@ double face<Gt, Fb>::edge_length(int i)
 template < class Gt, class Fb>
 double face<Gt, Fb>::slope()
 {
-    if (_slope == -1)
-    {
-        if(!_normal)
-            this->normal();
+    if (_geometry_id != no_geometry)
+        return _domain->geometry().slope[_geometry_id];
 
-        //z surface normal
-        arma::vec n(3);
-        n(0) = 0.0; //x
-        n(1) = 0.0; //y
-        n(2) = 1.0;
-
-        arma::vec normal(3);
-        normal(0) = (*_normal)[0];
-        normal(1) = (*_normal)[1];
-        normal(2) = (*_normal)[2];
-
-        _slope = acos(arma::norm_dot(normal, n));
-    }
+    return compute_slope(compute_normal());
+}
 
-    return _slope;
+template < class Gt, class Fb>
+double face<Gt, Fb>::compute_slope(const Vector_3& normal)
+{
+    //z surface normal
+    arma::vec n(3);
+    n(0) = 0.0; //x
+    n(1) = 0.0; //y
+    n(2) = 1.0;
+
+    arma::vec nv(3);
+    nv(0) = normal[0];
+    nv(1) = normal[1];
+    nv(2) = normal[2];
+
+    return acos(arma::norm_dot(nv, n));
 }
 
 template < class Gt, class Fb>
@@ -1253,31 +1424,62 @@ const typename face<Gt, Fb>::Face_handle face<Gt, Fb>::find_closest_face(double
     return _domain->find_closest_face(math::gis::point_from_bearing(center(), azimuth, distance));
 };
 
+template < class Gt, class Fb>
+template < typename Geo>
+const typename face<Gt, Fb>::Face_handle face<Gt, Fb>::find_closest_face(double azimuth, double distance)
+{
+    return _domain->find_closest_face(Geo::point_from_bearing(center(), azimuth, distance));
+}
+
+template < class Gt, class Fb>
+template < typename Geo>
+void face<Gt, Fb>::find_closest_faces(double azimuth, const double* distance, size_t n, Face_handle* faces)
+{
+    // per thread and only grows, as this is called for every face, every timestep
+    thread_local std::vector<double> x;
+    thread_local std::vector<double> y;
+    x.resize(n);
+    y.resize(n);
+    Geo::point_from_bearing(center(), azimuth, distance, x.data(), y.data(), n);
+
+    for (size_t i = 0; i < n; i++)
+        faces[i] = _domain->find_closest_face(x[i], y[i]);
+}
+
 template < class Gt, class Fb>
 Vector_3 face<Gt, Fb>::normal()
 {
-    if(!_normal)
+    if (_geometry_id != no_geometry)
+    {
+        auto& g = _domain->geometry();
+        return Vector_3(g.nx[_geometry_id], g.ny[_geometry_id], g.nz[_geometry_id]);
+    }
+
+    return compute_normal();
+}
+
+template < class Gt, class Fb>
+Vector_3 face<Gt, Fb>::compute_normal()
+{
+    if(_is_geographic)
     {
-        if(_is_geographic)
-        {
 
-//            OGRSpatialReference monUtm;
+//        OGRSpatialReference monUtm;
 //
-//            OGRSpatialReference monGeo;
-//            monGeo.SetWellKnownGeogCS("WGS84");
+//        OGRSpatialReference monGeo;
+//        monGeo.SetWellKnownGeogCS("WGS84");
 
 
-            CGAL::Point_3<K> v0(this->vertex(0)->point()[0]*100000., this->vertex(0)->point()[1]*100000.,this->vertex(0)->point()[2]);
-            CGAL::Point_3<K> v1(this->vertex(1)->point()[0]*100000., this->vertex(1)->point()[1]*100000.,this->vertex(1)->point()[2]);
-            CGAL::Point_3<K> v2(this->vertex(2)->point()[0]*100000., this->vertex(2)->point()[1]*100000.,this->vertex(2)->point()[2]);
+        CGAL::Point_3<K> v0(this->vertex(0)->point()[0]*100000., this->vertex(0)->point()[1]*100000.,this->vertex(0)->point()[2]);
+        CGAL::Point_3<K> v1(this->vertex(1)->point()[0]*100000., this->vertex(1)->point()[1]*100000.,this->vertex(1)->point()[2]);
+        CGAL::Point_3<K> v2(this->vertex(2)->point()[0]*100000., this->vertex(2)->point()[1]*100000.,this->vertex(2)->point()[2]);
 
-            _normal = boost::make_shared<Vector_3>(CGAL::unit_normal(v0, v1, v2));
+        return CGAL::unit_normal(v0, v1, v2);
 
-        }
-        else
-            _normal = boost::make_shared<Vector_3>(CGAL::unit_normal(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point()));
     }
 
+    return CGAL::unit_normal(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point());
+
 //    CGAL::Point_3<K> v0(this->vertex(0)->point()[0]*100000., this->vertex(0)->point()[1]*100000.,this->vertex(0)->point()[2]);
 //    CGAL::Point_3<K> v1(this->vertex(1)->point()[0]*100000., this->vertex(1)->point()[1]*100000.,this->vertex(1)->point()[2]);
 //    CGAL::Point_3<K> v2(this->vertex(2)->point()[0]*100000., this->vertex(2)->point()[1]*100000.,this->vertex(2)->point()[2]);
@@ -1288,22 +1490,24 @@ Vector_3 face<Gt, Fb>::normal()
 //
 //    CGAL::Exact_predicates_exact_constructions_kernel::Vector_3 un1 = CGAL::unit_normal(v0_noscale, v1_noscale, v2_noscale);
 //    Vector_3 un2 = CGAL::unit_normal(v0, v1, v2);
-    return *_normal;
 }
 
 template < class Gt, class Fb>
 Point_3 face<Gt, Fb>::center()
 {
-    if (!_center)
+    if (_geometry_id != no_geometry)
     {
-        _center = boost::make_shared<Point_3>(CGAL::centroid(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point()));
-        _x=_center->x();
-        _y=_center->y();
-        _z=_center->z();
+        auto& g = _domain->geometry();
+        return Point_3(g.x[_geometry_id], g.y[_geometry_id], g.z[_geometry_id]);
     }
-    //return CGAL::centroid(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point());
-    return *_center;
 
+    return compute_center();
+}
+
+template < class Gt, class Fb>
+Point_3 face<Gt, Fb>::compute_center()
+{
+    return CGAL::centroid(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point());
 }
 template < class Gt, class Fb>
 bool face<Gt, Fb>::contains(Point_3 p)
@@ -1437,6 +1641,43 @@ void face<Gt, Fb>::init_module_data(std::set<std::string>& modules)
     _module_face_data.init(modules);
 }
 
+template < class Gt, class Fb>
+void face<Gt, Fb>::copy_state(face_state& state)
+{
+    state.variables = _variables;
+    state.parameters = _parameters;
+    state.initial_conditions = _initial_conditions;
+    state.vectors = _module_face_vectors;
+
+    state.module_data = _module_face_data;
+    for (auto& m : state.module_data.variables())
+        state.module_data[m] = nullptr;
+}
+
+template < class Gt, class Fb>
+void face<Gt, Fb>::swap_state(face_state& state)
+{
+    _variables.swap(state.variables);
+    _parameters.swap(state.parameters);
+    _initial_conditions.swap(state.initial_conditions);
+    _module_face_data.swap(state.module_data);
+    _module_face_vectors.swap(state.vectors);
+}
+
+template < class Gt, class Fb>
+void face<Gt, Fb>::release_state()
+{
+    for (auto& m : _module_face_data.variables())
+    {
+        delete _module_face_data[m];
+        _module_face_data[m] = nullptr;
+    }
+
+    variablestorage<double>().swap(_variables);
+    variablestorage<face_info*>().swap(_module_face_data);
+    variablestorage<Vector_3>().swap(_module_face_vectors);
+}
+
 template < class Gt, class Fb>
 timeseries::variable_vec face<Gt, Fb>::face_time_series(std::string ID)
 {
@@ -1464,29 +1705,28 @@ void face<Gt, Fb>::to_file(std::string fname)
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_x()
 {
-    if(!_center)
-        this->center();
+    if (_geometry_id != no_geometry)
+        return _domain->geometry().x[_geometry_id];
 
-    return _x;
+    return compute_center().x();
 }
 
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_y()
 {
-    if(!_center)
-        this->center();
+    if (_geometry_id != no_geometry)
+        return _domain->geometry().y[_geometry_id];
 
-
-    return _y;
+    return compute_center().y();
 }
 
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_z()
 {
-    if(!_center)
-        this->center();
+    if (_geometry_id != no_geometry)
+        return _domain->geometry().z[_geometry_id];
 
-    return _z;
+    return compute_center().z();
 }
 template < class Gt, class Fb>
 boost::shared_ptr<timeseries> face<Gt, Fb>::get_underlying_timeseries()
@@ -1538,30 +1778,37 @@ void face<Gt, Fb>::set_module_data(const std::string &module, face_info *fi)
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_area()
 {
-    if(_area == -1)
+    if (_geometry_id != no_geometry)
+        return _domain->geometry().area[_geometry_id];
+
+    return compute_area();
+}
+
+template < class Gt, class Fb>
+double face<Gt, Fb>::compute_area()
+{
+    double area = 0;
+
+    // supports geographic
+    if(has_parameter("area"_s))
+    {
+        area = parameter("area"_s);
+    }
+    else
     {
-        // supports geographic
-        if(has_parameter("area"_s))
-        {
-            _area = parameter("area"_s);
-        }
-        else
-        {
 
-            auto& pa = this->vertex(0)->point();
-            auto& pb = this->vertex(1)->point();
-            auto& pc = this->vertex(2)->point();
+        auto& pa = this->vertex(0)->point();
+        auto& pb = this->vertex(1)->point();
+        auto& pc = this->vertex(2)->point();
 
 
-            //same way it's done in mesher for consistency
-            typename Fb::Geom_traits traits;
-            _area = CGAL::to_double(traits.compute_area_2_object()(pa, pb, pc));
+        //same way it's done in mesher for consistency
+        typename Fb::Geom_traits traits;
+        area = CGAL::to_double(traits.compute_area_2_object()(pa, pb, pc));
 
-        }
     }
 
-
-    return _area;
+    return area;
 }
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_subgrid_z(Point_2 query)
@@ -0,0 +1,426 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "ugrid_output.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ogr_spatialref.h>
+#include <cpl_conv.h>
+
+#include "exception.hpp"
+#include "logger.hpp"
+
+// faces per chunk
+static const size_t chunk_faces = 16384;
+
+// memory the buffered timesteps may take when choosing the timesteps per chunk
+static const size_t buffer_bytes = 64 * 1024 * 1024;
+static const size_t max_chunk_time = 32;
+
+static double missing_to_nan(double d)
+{
+    return d == -9999. ? std::numeric_limits<double>::quiet_NaN() : d;
+}
+
+ugrid_output::ugrid_output(boost::shared_ptr<triangulation> mesh, const std::string& fname,
+                           const std::set<std::string>& variables, bool write_parameters, size_t chunk_time)
+        : _mesh(mesh), _fname(fname), _variables(variables.begin(), variables.end()),
+          _write_parameters(write_parameters), _root(true), _created(false), _num_faces(0), _chunk_time(chunk_time),
+          _record(0), _buffered(0)
+{
+#ifdef USE_MPI
+    _root = _comm.rank() == 0;
+#endif
+}
+
+ugrid_output::~ugrid_output()
+{
+    try
+    {
+        finish();
+    }
+    catch (exception_base& e)
+    {
+        LOG_ERROR << "Mesh output " << _fname << " failed: " << boost::diagnostic_information(e);
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR << "Mesh output " << _fname << " failed: " << e.what();
+    }
+}
+
+template<typename T>
+std::vector<T> ugrid_output::gather(const std::vector<T>& local, size_t stride)
+{
+    std::vector<T> all;
+#ifdef USE_MPI
+    if (!_root)
+    {
+        boost::mpi::gatherv(_comm, local.data(), local.size(), 0);
+        return all;
+    }
+
+    std::vector<int> sizes(_sizes);
+    for (auto& s : sizes)
+        s *= stride;
+
+    all.resize(_num_faces * stride);
+    boost::mpi::gatherv(_comm, local.data(), local.size(), all.data(), sizes, 0);
+#else
+    all = local;
+#endif
+
+    std::vector<T> ordered(all.size());
+    for (size_t i = 0; i < _global_id.size(); i++)
+        for (size_t k = 0; k < stride; k++)
+            ordered[_global_id[i] * stride + k] = all[i * stride + k];
+
+    return ordered;
+}
+
+void ugrid_output::gather_layout()
+{
+    size_t n = _mesh->size_faces();
+
+    std::vector<size_t> ids(n);
+    for (size_t i = 0; i < n; i++)
+        ids[i] = _mesh->face(i)->cell_global_id;
+
+#ifdef USE_MPI
+    _sizes.clear();
+    boost::mpi::gather(_comm, static_cast<int>(n), _sizes, 0);
+    if (_root)
+    {
+        _num_faces = 0;
+        for (auto s : _sizes)
+            _num_faces += s;
+
+        _global_id.resize(_num_faces);
+        boost::mpi::gatherv(_comm, ids.data(), n, _global_id.data(), _sizes, 0);
+    }
+    else
+    {
+        boost::mpi::gatherv(_comm, ids.data(), n, 0);
+    }
+#else
+    _global_id = ids;
+    _num_faces = n;
+#endif
+
+    if (_root)
+    {
+        std::vector<bool> seen(_num_faces, false);
+        for (auto id : _global_id)
+        {
+            if (id >= _num_faces || seen[id])
+                BOOST_THROW_EXCEPTION(chm_error() << errstr_info(
+                        "Mesh output " + _fname + ": face global ids are not a numbering of the faces"));
+            seen[id] = true;
+        }
+    }
+}
+
+void ugrid_output::repartitioned()
+{
+    // before the first write the layout is gathered along with the topology
+    if (_created)
+        gather_layout();
+}
+
+void ugrid_output::create()
+{
+    gather_layout();
+
+    size_t n = _mesh->size_faces();
+
+    // static face data
+    std::vector<int> nodes(3 * n);
+    std::vector<double> centre(2 * n);
+    for (size_t i = 0; i < n; i++)
+    {
+        auto face = _mesh->face(i);
+        for (int k = 0; k < 3; k++)
+            nodes[3 * i + k] = static_cast<int>(face->vertex(k)->get_id());
+
+        auto c = face->center();
+        centre[2 * i] = c.x();
+        centre[2 * i + 1] = c.y();
+    }
+    nodes = gather(nodes, 3);
+    centre = gather(centre, 2);
+
+    std::vector<std::string> params, ics;
+    std::vector<std::string> geometry = {"Elevation", "Slope", "Aspect", "Area"};
+    std::vector<double> param_values;
+    size_t nparam = 0;
+    if (_write_parameters)
+    {
+        params = _mesh->face(0)->parameters();
+        ics = _mesh->face(0)->initial_conditions();
+        nparam = params.size() + ics.size() + geometry.size();
+
+        param_values.resize(nparam * n);
+        for (size_t i = 0; i < n; i++)
+        {
+            auto face = _mesh->face(i);
+            double* p = &param_values[nparam * i];
+
+            for (auto& v : params)
+                *p++ = missing_to_nan(face->parameter(v));
+            for (auto& v : ics)
+                *p++ = missing_to_nan(face->get_initial_condition(v));
+
+            *p++ = face->get_z();
+            *p++ = face->slope();
+            *p++ = face->aspect();
+            *p++ = face->get_area();
+        }
+        param_values = gather(param_values, nparam);
+    }
+
+    _created = true;
+
+    if (!_root)
+        return;
+
+    if (_chunk_time == 0)
+    {
+        size_t step_bytes = std::max<size_t>(1, _num_faces * _variables.size() * sizeof(double));
+        _chunk_time = std::min(max_chunk_time, std::max<size_t>(1, buffer_bytes / step_bytes));
+    }
+    _buffer.resize(_variables.size() * _chunk_time * _num_faces);
+
+    std::string wkt;
+    OGRSpatialReference srs;
+    if (srs.importFromProj4(_mesh->proj4().c_str()) == OGRERR_NONE)
+    {
+        char* w = nullptr;
+        srs.exportToWkt(&w);
+        wkt = w;
+        CPLFree(w);
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+
+    _nc = std::make_unique<netCDF::NcFile>(_fname, netCDF::NcFile::replace, netCDF::NcFile::nc4);
+    _nc->putAtt("Conventions", "CF-1.7 UGRID-1.0");
+
+    size_t num_nodes = _mesh->size_vertex();
+    auto node_dim = _nc->addDim("nMesh2_node", num_nodes);
+    auto face_dim = _nc->addDim("nMesh2_face", _num_faces);
+    auto face_nodes_dim = _nc->addDim("nMaxMesh2_face_nodes", 3);
+    auto time_dim = _nc->addDim("time");
+
+    auto topology = _nc->addVar("Mesh2", netCDF::ncInt);
+    topology.putAtt("cf_role", "mesh_topology");
+    topology.putAtt("long_name", "Topology data of 2D unstructured mesh");
+    topology.putAtt("topology_dimension", netCDF::ncInt, 2);
+    topology.putAtt("node_coordinates", "Mesh2_node_x Mesh2_node_y");
+    topology.putAtt("face_node_connectivity", "Mesh2_face_nodes");
+    topology.putAtt("face_dimension", "nMesh2_face");
+    topology.putAtt("face_coordinates", "Mesh2_face_x Mesh2_face_y");
+
+    auto crs = _nc->addVar("crs", netCDF::ncInt);
+    if (!wkt.empty())
+    {
+        crs.putAtt("crs_wkt", wkt);
+        crs.putAtt("spatial_ref", wkt);
+    }
+
+    bool geographic = _mesh->is_geographic();
+    auto coordinate = [&](const std::string& name, netCDF::NcDim dim, bool x)
+    {
+        auto v = _nc->addVar(name, netCDF::ncDouble, dim);
+        if (geographic)
+        {
+            v.putAtt("standard_name", x ? "longitude" : "latitude");
+            v.putAtt("units", x ? "degrees_east" : "degrees_north");
+        }
+        else
+        {
+            v.putAtt("standard_name", x ? "projection_x_coordinate" : "projection_y_coordinate");
+            v.putAtt("units", "m");
+        }
+        return v;
+    };
+
+    auto node_x = coordinate("Mesh2_node_x", node_dim, true);
+    auto node_y = coordinate("Mesh2_node_y", node_dim, false);
+    auto node_z = _nc->addVar("Mesh2_node_z", netCDF::ncDouble, node_dim);
+    node_z.putAtt("standard_name", "altitude");
+    node_z.putAtt("units", "m");
+
+    auto face_x = coordinate("Mesh2_face_x", face_dim, true);
+    auto face_y = coordinate("Mesh2_face_y", face_dim, false);
+
+    auto face_nodes = _nc->addVar("Mesh2_face_nodes", netCDF::ncInt, {face_dim, face_nodes_dim});
+    face_nodes.putAtt("cf_role", "face_node_connectivity");
+    face_nodes.putAtt("start_index", netCDF::ncInt, 0);
+
+    auto time = _nc->addVar("time", netCDF::ncInt64, time_dim);
+    time.putAtt("standard_name", "time");
+    time.putAtt("units", "seconds since 1970-01-01 00:00:00");
+    time.putAtt("calendar", "standard");
+
+    auto face_variable = [&](netCDF::NcVar& v)
+    {
+        v.setCompression(true, true, 4);
+        v.putAtt("mesh", "Mesh2");
+        v.putAtt("location", "face");
+        v.putAtt("coordinates", "Mesh2_face_x Mesh2_face_y");
+        v.putAtt("grid_mapping", "crs");
+    };
+
+    // a chunk holds _chunk_time steps of up to chunk_faces faces so that both a map and a face's time series only touch a few chunks
+    std::vector<size_t> chunks = {_chunk_time, std::min(_num_faces, chunk_faces)};
+    for (auto& name : _variables)
+    {
+        auto v = _nc->addVar(name, netCDF::ncDouble, {time_dim, face_dim});
+        v.setChunking(netCDF::NcVar::nc_CHUNKED, chunks);
+        face_variable(v);
+    }
+
+    std::vector<netCDF::NcVar> param_vars;
+    for (auto& name : params)
+        param_vars.push_back(_nc->addVar("param_" + name, netCDF::ncDouble, face_dim));
+    for (auto& name : ics)
+        param_vars.push_back(_nc->addVar("ic_" + name, netCDF::ncDouble, face_dim));
+    if (_write_parameters)
+    {
+        for (auto& name : geometry)
+            param_vars.push_back(_nc->addVar(name, netCDF::ncDouble, face_dim));
+    }
+    for (auto& v : param_vars)
+        face_variable(v);
+
+    std::vector<double> x(num_nodes), y(num_nodes), z(num_nodes);
+    for (size_t i = 0; i < num_nodes; i++)
+    {
+        auto& p = _mesh->vertex(i)->point();
+        x[i] = p.x();
+        y[i] = p.y();
+        z[i] = p.z();
+    }
+    node_x.putVar(x.data());
+    node_y.putVar(y.data());
+    node_z.putVar(z.data());
+
+    face_nodes.putVar(nodes.data());
+
+    x.resize(_num_faces);
+    y.resize(_num_faces);
+    for (size_t i = 0; i < _num_faces; i++)
+    {
+        x[i] = centre[2 * i];
+        y[i] = centre[2 * i + 1];
+    }
+    face_x.putVar(x.data());
+    face_y.putVar(y.data());
+
+    for (size_t k = 0; k < param_vars.size(); k++)
+    {
+        for (size_t i = 0; i < _num_faces; i++)
+            x[i] = param_values[nparam * i + k];
+        param_vars[k].putVar(x.data());
+    }
+
+    LOG_DEBUG << "Mesh output " << _fname << " has " << _num_faces << " faces, " << _chunk_time
+              << " timesteps per chunk";
+}
+
+void ugrid_output::write(uint64_t time)
+{
+    if (!_created)
+    {
+        if (_variables.empty())
+            _variables = _mesh->face(0)->variables();
+
+        create();
+    }
+
+    size_t n = _mesh->size_faces();
+    size_t nvar = _variables.size();
+
+    std::vector<double> local(n * nvar);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
+    {
+        auto face = _mesh->face(i);
+        for (size_t v = 0; v < nvar; v++)
+            local[i * nvar + v] = missing_to_nan((*face)[_variables[v]]);
+    }
+
+    auto all = gather(local, nvar);
+
+    if (!_root)
+        return;
+
+    for (size_t v = 0; v < nvar; v++)
+    {
+        double* row = &_buffer[(v * _chunk_time + _buffered) * _num_faces];
+        for (size_t f = 0; f < _num_faces; f++)
+            row[f] = all[f * nvar + v];
+    }
+
+    _times.push_back(static_cast<long long>(time));
+    _buffered++;
+
+    if (_buffered == _chunk_time)
+        flush();
+}
+
+void ugrid_output::flush()
+{
+    if (!_root || _buffered == 0)
+        return;
+
+    std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+
+    for (size_t v = 0; v < _variables.size(); v++)
+    {
+        _nc->getVar(_variables[v]).putVar({_record, 0}, {_buffered, _num_faces},
+                                          &_buffer[v * _chunk_time * _num_faces]);
+    }
+    _nc->getVar("time").putVar({_record}, {_buffered}, _times.data());
+    _nc->sync();
+
+    _record += _buffered;
+    _buffered = 0;
+    _times.clear();
+}
+
+void ugrid_output::finish()
+{
+    flush();
+
+    if (_nc)
+    {
+        std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+        _nc->close();
+        _nc.reset();
+    }
+}
@@ -0,0 +1,125 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef USE_MPI
+#include <boost/mpi.hpp>
+#endif
+
+#include "triangulation.hpp"
+#include "netcdf.hpp"
+
+/**
+ * Writes the mesh and its face variables to a single UGRID (CF) NetCDF-4 file.
+ *
+ * The topology (nodes, face-node connectivity, face centres) and, optionally, the parameters are written once.
+ * Each output step then appends a record along the time dimension to every variable, which are stored [time, face],
+ * chunked and deflated. Steps are buffered until a chunk's worth of time has been collected so that whole chunks are
+ * written at once and never re-read.
+ *
+ * Under MPI the faces of every rank are gathered, ordered by their global id, onto rank 0 which does the writing.
+ * write() must therefore be called on every rank.
+ */
+class ugrid_output
+{
+public:
+    /**
+     * @param mesh Triangulation to write
+     * @param fname Output file name
+     * @param variables Face variables to write. If empty, all the face variables found on the first write.
+     * @param write_parameters Also write the parameters, initial conditions, elevation, slope, aspect and area
+     * @param chunk_time Number of timesteps per chunk. If 0 it is chosen from the mesh size and number of variables.
+     */
+    ugrid_output(boost::shared_ptr<triangulation> mesh, const std::string& fname,
+                 const std::set<std::string>& variables, bool write_parameters = true, size_t chunk_time = 0);
+
+    /**
+     * Flushes and closes the file. Errors are logged, call finish() to have them thrown.
+     */
+    ~ugrid_output();
+
+    /**
+     * Appends the current face values
+     * @param time Seconds since the epoch
+     */
+    void write(uint64_t time);
+
+    /**
+     * Writes any buffered steps and closes the file
+     */
+    void finish();
+
+    /**
+     * Gathers which faces each rank owns again, after load balancing has moved faces between ranks.
+     * Must be called on every rank.
+     */
+    void repartitioned();
+
+    /**
+     * Timesteps per chunk, and so per write to the file
+     */
+    size_t chunk_time() const
+    {
+        return _chunk_time;
+    }
+
+private:
+    // gathers the stride values of each local face onto the root, ordered by global face id. Empty on the other ranks
+    template<typename T>
+    std::vector<T> gather(const std::vector<T>& local, size_t stride);
+
+    // gathers the number of faces and their global ids from every rank
+    void gather_layout();
+
+    void create();
+    void flush();
+
+    boost::shared_ptr<triangulation> _mesh;
+    std::string _fname;
+    std::vector<std::string> _variables;
+    bool _write_parameters;
+    bool _root;
+    bool _created; // topology written, done on the first write
+
+    size_t _num_faces; // over all ranks
+    size_t _chunk_time;
+
+    std::unique_ptr<netCDF::NcFile> _nc;
+    size_t _record; // next record in the file
+    size_t _buffered; // steps held in _buffer
+    std::vector<double> _buffer; // [variable][time][face]
+    std::vector<long long> _times;
+
+#ifdef USE_MPI
+    boost::mpi::communicator _comm;
+    std::vector<int> _sizes; // faces per rank
+#endif
+    std::vector<size_t> _global_id; // on the root, global id of the faces in the order they are gathered
+};
@@ -23,13 +23,27 @@
 
 #include "metdata.hpp"
 
+#include <glob.h>
+
+#include <boost/filesystem.hpp>
+
 metdata::metdata(std::string mesh_proj4)
 {
     _nc = nullptr;
     _use_netcdf = false;
     _n_timesteps = 0;
+    _nc_file_idx = 0;
+    _nc_next_idx = 0;
+    _resample = 1;
+    _utc_offset = 0;
     _mesh_proj4 = mesh_proj4;
     is_first_timestep = true;
+    _caching = false;
+    _replaying = false;
+    _replay_step = 0;
+
+    _table = std::make_shared<station_table>();
+    _table->set_stations(_stations);
 
     OGRSpatialReference srs;
     srs.importFromProj4(_mesh_proj4.c_str());
@@ -38,11 +52,21 @@ metdata::metdata(std::string mesh_proj4)
 
 metdata::~metdata()
 {
-
+    // don't leave a background open running against a file we no longer care about
+    if(_nc_next.valid())
+        _nc_next.wait();
 }
 
 void metdata::load_from_netcdf(const std::string& path,std::map<std::string, boost::shared_ptr<filter_base> > filters)
 {
+    load_from_netcdf(std::vector<std::string>{path}, filters);
+}
+
+void metdata::load_from_netcdf(const std::vector<std::string>& paths,std::map<std::string, boost::shared_ptr<filter_base> > filters)
+{
+    if(paths.empty())
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info( "No NetCDF files given" ));
+
     if(_mesh_proj4 == "")
         BOOST_THROW_EXCEPTION(forcing_error() << errstr_info( "Met loader not initialized with proj4 string" ));
 
@@ -76,25 +100,42 @@ void metdata::load_from_netcdf(const std::string& path,std::map<std::string, boo
 
     try
     {
-        _nc->open_GEM(path);
+        scan_netcdf_files(paths);
+
+        _nc_file_idx = 0;
+        _nc->open_GEM(_nc_files.front().path);
 
         _variables = _nc->get_variable_names();
 
         _variables.insert(_provides_from_nc_filters.begin(),_provides_from_nc_filters.end());
 
-        _start_time = _nc->get_start();
-        _end_time = _nc->get_end();
-        _n_timesteps = _nc->get_ntimesteps();
+        // the files form one continuous time axis
+        _start_time = _nc_files.front().start;
+        _end_time = _nc_files.back().end;
+        _n_timesteps = ( (_end_time + _nc->get_dt()) - _start_time).total_seconds() / _nc->get_dt().total_seconds();
+
+        LOG_DEBUG << "Loading lat/long grid...";
+
+        auto lat = _nc->get_lat();
+        auto lon = _nc->get_lon();
+
+        // offset of the (potentially subset) grid window into the full lat/long grids
+        size_t x0 = 0;
+        size_t y0 = 0;
+        if(_nc_extent)
+        {
+            subset_netcdf_grid(lat, lon);
+            x0 = _nc->get_xstart();
+            y0 = _nc->get_ystart();
+        }
 
         _nstations = _nc->get_xsize() * _nc->get_ysize();
         _stations.resize(_nstations);
+        _table->init(_variables, _nstations);
 
         LOG_DEBUG << "Grid is (y)" << _nc->get_ysize() << " by (x)" << _nc->get_xsize();
 
-        LOG_DEBUG << "Loading lat/long grid...";
-
-        auto lat = _nc->get_lat();
-        auto lon = _nc->get_lon();
+        // only reads the window
         auto e = _nc->get_z();
 
         LOG_DEBUG << "Initializing datastructure";
@@ -109,12 +150,14 @@ void metdata::load_from_netcdf(const std::string& path,std::map<std::string, boo
                 double longitude = 0 ;
                 double z = 0;
 
-                latitude = lat[y][x];;
-                longitude = lon[y][x];
+                latitude = lat[y + y0][x + x0];
+                longitude = lon[y + y0][x + x0];
                 z = e[y][x];
 
                 size_t index = x + y * _nc->get_xsize();
-                std::string station_name = std::to_string(index); // these don't really have names
+
+                // these don't really have names, so use the index into the full grid so the name is independent of any subsetting
+                std::string station_name = std::to_string( (x + x0) + (y + y0) * _nc->get_xsize_full() );
 
                 //need to convert the input lat/long into the coordinate system our mesh is in
                 if (!_is_geographic)
@@ -128,14 +171,14 @@ void metdata::load_from_netcdf(const std::string& path,std::map<std::string, boo
 
                 double elevation = z;
 
+                //index this linear array as if it were 2D to make the lazy load in the main run() loop easier.
+                //it will allow us to pull out the station for a specific x,y more easily.
                 std::shared_ptr<station> s = std::make_shared<station>(station_name,
-                    longitude, latitude, elevation, _variables);
+                    longitude, latitude, elevation, _table, index);
 
                 s->_nc_x = x;
                 s->_nc_y = y;
 
-                //index this linear array as if it were 2D to make the lazy load in the main run() loop easier.
-                //it will allow us to pull out the station for a specific x,y more easily.
                 _stations.at(index) = s;
 
                 _dD_tree.insert( boost::make_tuple(Kernel::Point_2(s->x(),s->y()),s) );
@@ -150,8 +193,336 @@ void metdata::load_from_netcdf(const std::string& path,std::map<std::string, boo
 
     delete coordTrans;
     _dt = _nc->get_dt();
+    _forcing_dt = _dt;
+    _forcing_start = _forcing_origin = _start_time;
+    _forcing_end = _end_time;
 
     _current_ts = _start_time;
+
+    prefetch_netcdf_file(_nc_file_idx + 1);
+}
+
+std::vector<std::string> metdata::expand_netcdf_files(const std::vector<std::string>& patterns)
+{
+    std::vector<std::string> files;
+
+    for(auto& pattern : patterns)
+    {
+        glob_t g;
+        int ret = glob(pattern.c_str(), 0, nullptr, &g);
+        if(ret == GLOB_NOMATCH)
+        {
+            globfree(&g);
+            CHM_THROW_EXCEPTION(config_error, "No NetCDF files match " + pattern);
+        }
+        else if(ret != 0)
+        {
+            globfree(&g);
+            CHM_THROW_EXCEPTION(config_error, "Unable to expand NetCDF file pattern " + pattern);
+        }
+
+        // glob sorts its matches
+        for(size_t i = 0; i < g.gl_pathc; i++)
+            files.push_back(g.gl_pathv[i]);
+
+        globfree(&g);
+    }
+
+    return files;
+}
+
+void metdata::scan_netcdf_files(const std::vector<std::string>& paths)
+{
+    _nc_files.clear();
+
+    // header information of the first file, that all the others need to match
+    boost::posix_time::time_duration dt;
+    size_t xsize = 0;
+    size_t ysize = 0;
+    std::set<std::string> variables;
+    double lat0 = 0, lon0 = 0, lat1 = 0, lon1 = 0;
+
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        // opening only reads the header and the coordinate variables, so this is cheap even for large files
+        netcdf nc;
+        nc.open_GEM(paths[i]);
+
+        nc_file_info info;
+        info.path = paths[i];
+        info.start = nc.get_start();
+        info.end = nc.get_end();
+
+        // a single file doesn't need anything else checked
+        if(paths.size() > 1)
+        {
+            // the grid corners are enough to catch a file from a different domain or grid
+            double clat0 = nc.get_lat(0, 0);
+            double clon0 = nc.get_lon(0, 0);
+            double clat1 = nc.get_lat(nc.get_xsize() - 1, nc.get_ysize() - 1);
+            double clon1 = nc.get_lon(nc.get_xsize() - 1, nc.get_ysize() - 1);
+
+            if(i == 0)
+            {
+                dt = nc.get_dt();
+                xsize = nc.get_xsize();
+                ysize = nc.get_ysize();
+                variables = nc.get_variable_names();
+                lat0 = clat0; lon0 = clon0;
+                lat1 = clat1; lon1 = clon1;
+            }
+            else
+            {
+                if(nc.get_dt() != dt)
+                {
+                    CHM_THROW_EXCEPTION(forcing_error, "NetCDF file " + paths[i] + " has a different timestep than " + paths[0]);
+                }
+
+                if(nc.get_xsize() != xsize || nc.get_ysize() != ysize)
+                {
+                    CHM_THROW_EXCEPTION(forcing_error, "NetCDF file " + paths[i] + " has a different grid size than " + paths[0]);
+                }
+
+                double tol = 1e-4;
+                if(std::fabs(clat0 - lat0) > tol || std::fabs(clon0 - lon0) > tol ||
+                   std::fabs(clat1 - lat1) > tol || std::fabs(clon1 - lon1) > tol)
+                {
+                    CHM_THROW_EXCEPTION(forcing_error, "NetCDF file " + paths[i] + " has different grid coordinates than " + paths[0]);
+                }
+
+                if(nc.get_variable_names() != variables)
+                {
+                    CHM_THROW_EXCEPTION(forcing_error, "NetCDF file " + paths[i] + " has different variables than " + paths[0]);
+                }
+            }
+        }
+
+        _nc_files.push_back(info);
+    }
+
+    std::sort(_nc_files.begin(), _nc_files.end(),
+              [](const nc_file_info& a, const nc_file_info& b)
+              {
+                  return a.start < b.start;
+              });
+
+    // the files need to form one continuous time axis, without gaps or overlaps
+    for(size_t i = 1; i < _nc_files.size(); i++)
+    {
+        if(_nc_files[i].start != _nc_files[i-1].end + dt)
+        {
+            CHM_THROW_EXCEPTION(forcing_error, "NetCDF file " + _nc_files[i].path + " starting at " +
+                                                   boost::posix_time::to_simple_string(_nc_files[i].start) +
+                                                   " does not directly follow " + _nc_files[i-1].path + " ending at " +
+                                                   boost::posix_time::to_simple_string(_nc_files[i-1].end));
+        }
+    }
+
+    if(_nc_files.size() > 1)
+    {
+        LOG_DEBUG << "Using " << _nc_files.size() << " NetCDF files from " << _nc_files.front().path << " to " << _nc_files.back().path;
+    }
+}
+
+std::unique_ptr<netcdf> metdata::open_netcdf_file(size_t idx, size_t xstart, size_t ystart, size_t nx, size_t ny)
+{
+    auto nc = std::make_unique<netcdf>();
+    nc->open_GEM(_nc_files[idx].path);
+
+    // cheap check that the file hasn't changed since we scanned it
+    if(nc->get_start() != _nc_files[idx].start || nc->get_end() != _nc_files[idx].end)
+    {
+        CHM_THROW_EXCEPTION(forcing_error, "NetCDF file " + _nc_files[idx].path + " changed while the model was running");
+    }
+
+    nc->subset_grid(xstart, ystart, nx, ny);
+
+    return nc;
+}
+
+void metdata::prefetch_netcdf_file(size_t idx)
+{
+    if(idx >= _nc_files.size())
+        return;
+
+    // the window is the same for every file, so take it from the current file now instead of racing on _nc in the thread
+    size_t xstart = _nc->get_xstart();
+    size_t ystart = _nc->get_ystart();
+    size_t nx = _nc->get_xsize();
+    size_t ny = _nc->get_ysize();
+    auto variables = _nc->get_variable_names();
+
+    _nc_next_idx = idx;
+    _nc_next = std::async(std::launch::async,
+                          [this, idx, xstart, ystart, nx, ny, variables]()
+                          {
+                              auto next = std::make_unique<nc_prefetch>();
+                              next->nc = open_netcdf_file(idx, xstart, ystart, nx, ny);
+
+                              for(auto& v : variables)
+                              {
+                                  next->first_timestep.emplace(v, next->nc->get_var(v, size_t(0)));
+                              }
+                              return next;
+                          });
+}
+
+void metdata::switch_netcdf_file(size_t idx)
+{
+    std::unique_ptr<nc_prefetch> next;
+
+    if(_nc_next.valid())
+    {
+        // rethrows anything that went wrong in the background
+        next = _nc_next.get();
+
+        if(_nc_next_idx != idx)
+            next = nullptr;
+    }
+
+    if(!next)
+    {
+        next = std::make_unique<nc_prefetch>();
+        next->nc = open_netcdf_file(idx, _nc->get_xstart(), _nc->get_ystart(), _nc->get_xsize(), _nc->get_ysize());
+    }
+
+    LOG_DEBUG << "Switching to NetCDF file " << _nc_files[idx].path;
+
+    _nc = std::move(next->nc);
+    _nc_prefetched = std::move(next->first_timestep);
+    _nc_file_idx = idx;
+
+    prefetch_netcdf_file(_nc_file_idx + 1);
+}
+
+void metdata::subset_netcdf_to_extent(double xmin, double ymin, double xmax, double ymax, double buffer)
+{
+    if(xmin > xmax || ymin > ymax || buffer < 0)
+    {
+        CHM_THROW_EXCEPTION(forcing_error, "Invalid extent for NetCDF subsetting.");
+    }
+
+    _nc_extent = std::make_unique<nc_extent>();
+    _nc_extent->xmin = xmin;
+    _nc_extent->ymin = ymin;
+    _nc_extent->xmax = xmax;
+    _nc_extent->ymax = ymax;
+    _nc_extent->buffer = buffer;
+}
+
+void metdata::subset_netcdf_grid(const netcdf::data& lat, const netcdf::data& lon)
+{
+    // find the lat/long envelope of the buffered extent
+    double lat_min = 90;
+    double lat_max = -90;
+    double lon_min = 180;
+    double lon_max = -180;
+
+    if(_is_geographic)
+    {
+        // buffer is in metres, convert to degrees using the worst case longitude convergence of the extent
+        double dlat = _nc_extent->buffer / 111000.0;
+        double max_abs_lat = std::min(89.0, std::max(std::fabs(_nc_extent->ymin), std::fabs(_nc_extent->ymax)) + dlat);
+        double dlon = dlat / std::cos(max_abs_lat * M_PI / 180.0);
+
+        lon_min = _nc_extent->xmin - dlon;
+        lon_max = _nc_extent->xmax + dlon;
+        lat_min = _nc_extent->ymin - dlat;
+        lat_max = _nc_extent->ymax + dlat;
+    }
+    else
+    {
+        OGRSpatialReference insrs, outsrs;
+        insrs.importFromProj4(_mesh_proj4.c_str());
+        outsrs.SetWellKnownGeogCS("WGS84");
+        OGRCoordinateTransformation* coordTrans = OGRCreateCoordinateTransformation(&insrs, &outsrs);
+
+        double xmin = _nc_extent->xmin - _nc_extent->buffer;
+        double xmax = _nc_extent->xmax + _nc_extent->buffer;
+        double ymin = _nc_extent->ymin - _nc_extent->buffer;
+        double ymax = _nc_extent->ymax + _nc_extent->buffer;
+
+        // a straight edge in the mesh projection is not straight in lat/long, so densify the
+        // edges of the extent before reprojecting them to find the envelope
+        const size_t nseg = 16;
+        std::vector<std::pair<double,double>> boundary;
+        for(size_t i = 0; i <= nseg; i++)
+        {
+            double fx = xmin + (xmax - xmin) * i / nseg;
+            double fy = ymin + (ymax - ymin) * i / nseg;
+            boundary.push_back(std::make_pair(fx, ymin));
+            boundary.push_back(std::make_pair(fx, ymax));
+            boundary.push_back(std::make_pair(xmin, fy));
+            boundary.push_back(std::make_pair(xmax, fy));
+        }
+
+        for(auto& pt : boundary)
+        {
+            double longitude = pt.first;
+            double latitude = pt.second;
+            if (!coordTrans->Transform(1, &longitude, &latitude))
+            {
+                delete coordTrans;
+                CHM_THROW_EXCEPTION(forcing_error, "Unable to convert mesh extent to lat/long for NetCDF subsetting.");
+            }
+
+            lon_min = std::min(lon_min, longitude);
+            lon_max = std::max(lon_max, longitude);
+            lat_min = std::min(lat_min, latitude);
+            lat_max = std::max(lat_max, latitude);
+        }
+
+        delete coordTrans;
+    }
+
+    size_t xsize = _nc->get_xsize();
+    size_t ysize = _nc->get_ysize();
+
+    size_t x0 = xsize;
+    size_t y0 = ysize;
+    size_t x1 = 0;
+    size_t y1 = 0;
+    bool found = false;
+
+    // the grid may be rotated, so check every cell and take the index envelope of all the cells within the lat/long envelope
+    for (size_t y = 0; y < ysize; y++)
+    {
+        for (size_t x = 0; x < xsize; x++)
+        {
+            double latitude = lat[y][x];
+            double longitude = lon[y][x];
+
+            if(longitude > 180)
+                longitude -= 360;
+
+            if(latitude >= lat_min && latitude <= lat_max &&
+               longitude >= lon_min && longitude <= lon_max)
+            {
+                x0 = std::min(x0, x);
+                x1 = std::max(x1, x);
+                y0 = std::min(y0, y);
+                y1 = std::max(y1, y);
+                found = true;
+            }
+        }
+    }
+
+    if(!found)
+    {
+        CHM_THROW_EXCEPTION(forcing_error, "The NetCDF grid does not overlap the mesh.");
+    }
+
+    // pad by a couple of cells so that N-nearest station selection near the edge of the mesh still sees the same
+    // stations it would without subsetting
+    const size_t pad = 2;
+    x0 = x0 > pad ? x0 - pad : 0;
+    y0 = y0 > pad ? y0 - pad : 0;
+    x1 = std::min(x1 + pad, xsize - 1);
+    y1 = std::min(y1 + pad, ysize - 1);
+
+    _nc->subset_grid(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+
+    LOG_DEBUG << "NetCDF subset to mesh extent uses " << (x1 - x0 + 1) * (y1 - y0 + 1) << " of " << xsize * ysize << " grid cells";
 }
 
 void metdata::load_from_ascii(std::vector<ascii_metdata> stations, int utc_offset)
@@ -193,11 +564,8 @@ void metdata::load_from_ascii(std::vector<ascii_metdata> stations, int utc_offse
             }
         }
 
-        std::shared_ptr<station> s = std::make_shared<station>();
-        s->ID(itr.id);
-        s->x(itr.longitude);
-        s->y(itr.latitude);
-        s->z(itr.elevation);
+        std::shared_ptr<station> s = std::make_shared<station>(itr.id, itr.longitude, itr.latitude, itr.elevation,
+                                                               _table, _table->add_row());
 
         if(loaded_ids.find(s->ID()) == loaded_ids.end())
             loaded_ids.insert(s->ID());
@@ -231,7 +599,7 @@ void metdata::load_from_ascii(std::vector<ascii_metdata> stations, int utc_offse
         }
 
         _variables.insert(provides.begin(),provides.end());
-        // init the datastore with timeseries variables + anything from the filters
+        // add the timeseries variables + anything from the filters to the table
         s->init(_variables);
         _stations.push_back(s);
 
@@ -255,8 +623,10 @@ void metdata::load_from_ascii(std::vector<ascii_metdata> stations, int utc_offse
     }
 
     _dt = dts.front();
+    _forcing_dt = _dt;
 
     std::tie(_start_time,_end_time) = find_unified_start_end();
+    _forcing_origin = _start_time;
     subset(_start_time,_end_time); //subset assumes we have a valid dt
 
     _current_ts = _start_time;
@@ -317,8 +687,8 @@ void metdata::check_ts_consistency()
 
     for (auto& itr : _ascii_stations)
     {
-        if (itr.second->_obs.get_date_timeseries().at(0) != _start_time ||
-            itr.second->_obs.get_date_timeseries().back() != _end_time)
+        if (itr.second->_obs.get_date_timeseries().at(0) != _forcing_start ||
+            itr.second->_obs.get_date_timeseries().back() != _forcing_end)
         {
             BOOST_THROW_EXCEPTION(forcing_timestep_mismatch()
                                       <<
@@ -332,19 +702,52 @@ void metdata::subset(boost::posix_time::ptime start, boost::posix_time::ptime en
     {
         CHM_THROW_EXCEPTION(forcing_error,"dt = 0");
     }
+    // when interpolating, we need the forcing records either side of start and end
+    auto fstart = start;
+    auto fend = end;
+    if(_resample > 1)
+    {
+        auto fdt = _forcing_dt.total_seconds();
+        auto offset = (start - _forcing_origin).total_seconds();
+        fstart = _forcing_origin + boost::posix_time::seconds( (offset / fdt) * fdt );
+
+        offset = (end - _forcing_origin).total_seconds();
+        fend = _forcing_origin + boost::posix_time::seconds( ((offset + fdt - 1) / fdt) * fdt );
+    }
+
     // the netcdf files are simple and don't need this subsetting
     if(!_use_netcdf)
     {
         for(auto& itr : _ascii_stations)
         {
-            itr.second->_obs.subset(start, end);
+            itr.second->_obs.subset(fstart, fend);
             itr.second->_itr = itr.second->_obs.begin();
         }
     }
+    else if(_nc_files.size() > 1)
+    {
+        // start from the file that holds the new start time
+        auto itr = std::find_if(_nc_files.begin(), _nc_files.end(),
+                                [&](const nc_file_info& f)
+                                {
+                                    return fstart >= f.start && fstart <= f.end;
+                                });
+        if(itr == _nc_files.end())
+        {
+            CHM_THROW_EXCEPTION(forcing_error, "Start time " + boost::posix_time::to_simple_string(fstart) + " is not in any of the NetCDF files");
+        }
+
+        size_t idx = std::distance(_nc_files.begin(), itr);
+        if(idx != _nc_file_idx)
+            switch_netcdf_file(idx);
+    }
 
     _start_time = start;
     _end_time = end;
+    _forcing_start = fstart;
+    _forcing_end = fend;
     _current_ts = _start_time;
+    is_first_timestep = true; // the next call to next() loads start
     _n_timesteps = ( (_end_time+_dt) - _start_time).total_seconds() / _dt.total_seconds(); // need to add +dt so that we are inclusive of the last timestep
 }
 std::pair<boost::posix_time::ptime,boost::posix_time::ptime> metdata::start_end_time()
@@ -374,8 +777,8 @@ std::pair<boost::posix_time::ptime,boost::posix_time::ptime> metdata::find_unifi
     }
     else
     {
-        _start_time = _nc->get_start();
-        _end_time = _nc->get_end();
+        _start_time = _nc_files.front().start;
+        _end_time = _nc_files.back().end;
     }
     return std::make_pair(_start_time,_end_time);
 }
@@ -423,24 +826,237 @@ bool metdata::next()
 {
     bool has_next = false;
 
+    if(_replaying)
+    {
+        if(++_replay_step < _cache_ts.size())
+        {
+            load_cache_record(_replay_step);
+            return true;
+        }
+
+        // pick up the forcing where it was left
+        _replaying = false;
+        _current_ts = _resume_ts;
+    }
+
     // allows for doing first timestep loading without incrementing the timestep
     if(!is_first_timestep)
         _current_ts = _current_ts + _dt;
 
-    if(_use_netcdf)
+    if(_resample > 1)
     {
-        has_next = next_nc();
+        has_next = next_interpolated();
     }
     else
     {
-        has_next = next_ascii();
+        has_next = load_forcing(_current_ts, is_first_timestep);
     }
 
     is_first_timestep = false;
+
+    if(has_next && _caching)
+        store_cache_record();
+
+    if(has_next && !_forcing_cache_path.empty())
+    {
+        if(!_forcing_cache_out)
+        {
+            std::vector<forcing_cache::station_info> stations;
+            for(auto& s : _stations)
+                stations.push_back({s->ID(), s->x(), s->y(), s->z()});
+
+            _forcing_cache_out = std::make_unique<forcing_cache>();
+            _forcing_cache_out->create(_forcing_cache_path, _table->variables(), stations, _current_ts, _dt);
+        }
+
+        std::vector<const double*> cols;
+        for(auto& v : _forcing_cache_out->variables())
+            cols.push_back(_table->get(v).data());
+
+        _forcing_cache_out->append(cols);
+    }
+
     return has_next;
 }
 
-bool metdata::next_ascii()
+bool metdata::load_from_cache(const std::string& path)
+{
+    if(!boost::filesystem::exists(path))
+        return false;
+
+    LOG_DEBUG << "Loading forcing from cache " << path;
+
+    _forcing_cache = std::make_unique<forcing_cache>();
+    _forcing_cache->open(path);
+
+    if(_forcing_cache->timesteps() == 0)
+        CHM_THROW_EXCEPTION(forcing_error, "Forcing cache " + path + " is empty");
+
+    _variables = std::set<std::string>(_forcing_cache->variables().begin(), _forcing_cache->variables().end());
+
+    _nstations = _forcing_cache->stations().size();
+    _table->init(_variables, _nstations);
+
+    for(size_t i = 0; i < _nstations; i++)
+    {
+        auto& info = _forcing_cache->stations()[i];
+        auto s = std::make_shared<station>(info.id, info.x, info.y, info.z, _table, i);
+        _stations.push_back(s);
+
+        _dD_tree.insert( boost::make_tuple(Kernel::Point_2(s->x(),s->y()),s) );
+    }
+    map_forcing_cache_rows();
+
+    // the cache is already at the model timestep, so is treated like a single forcing file
+    _dt = _forcing_dt = _forcing_cache->dt();
+    _start_time = _forcing_start = _forcing_origin = _forcing_cache->start_time();
+    _end_time = _forcing_end = _start_time + _dt * static_cast<int>(_forcing_cache->timesteps() - 1);
+    _n_timesteps = _forcing_cache->timesteps();
+    _current_ts = _start_time;
+
+    return true;
+}
+
+void metdata::write_cache(const std::string& path)
+{
+    _forcing_cache_path = path;
+}
+
+void metdata::finish_cache()
+{
+    if(_forcing_cache_out)
+    {
+        _forcing_cache_out->close(_forcing_cache_out->timesteps() == _n_timesteps &&
+                                  _forcing_cache_out->start_time() == _start_time);
+        _forcing_cache_out.reset();
+    }
+    _forcing_cache_path = "";
+}
+
+void metdata::map_forcing_cache_rows()
+{
+    std::map<std::string, size_t> rows;
+    for(size_t i = 0; i < _forcing_cache->stations().size(); i++)
+        rows[_forcing_cache->stations()[i].id] = i;
+
+    _forcing_cache_rows.resize(nstations());
+    for(size_t i = 0; i < nstations(); i++)
+        _forcing_cache_rows[i] = rows.at(_stations[i]->ID());
+}
+
+bool metdata::next_cached(const boost::posix_time::ptime& t)
+{
+    if(t > _end_time)
+        return false;
+
+    size_t step = (t - _forcing_cache->start_time()).total_seconds() / _dt.total_seconds();
+    const float* record = _forcing_cache->record(step);
+    const size_t n = _forcing_cache->stations().size();
+
+    for(size_t v = 0; v < _forcing_cache->variables().size(); v++)
+    {
+        auto col = _table->get(_forcing_cache->variables()[v]);
+        const float* values = record + v * n;
+
+        #pragma omp parallel for
+        for(size_t i = 0; i < nstations(); i++)
+            col[i] = values[_forcing_cache_rows[i]];
+    }
+
+    _table->set_posix(t);
+
+    return true;
+}
+
+void metdata::cache(bool enable)
+{
+    if(enable)
+    {
+        _cache.clear();
+        _cache_ts.clear();
+        _cache_vars.clear();
+    }
+    else if(_caching)
+    {
+        LOG_DEBUG << "Cached " << _cache_ts.size() << " timesteps of " << _cache_vars.size() << " variables ["
+                  << _cache.size() * sizeof(double) / (1024 * 1024) << " MB]";
+    }
+
+    _caching = enable;
+}
+
+size_t metdata::cached_timesteps()
+{
+    return _cache_ts.size();
+}
+
+void metdata::replay(size_t step)
+{
+    if(step >= _cache_ts.size())
+    {
+        CHM_THROW_EXCEPTION(forcing_error, "Cannot replay timestep " + std::to_string(step) + ", only " +
+                                           std::to_string(_cache_ts.size()) + " are cached");
+    }
+
+    if(!_replaying)
+        _resume_ts = _current_ts;
+
+    _replaying = true;
+    _replay_step = step;
+    load_cache_record(step);
+}
+
+void metdata::store_cache_record()
+{
+    if(_cache_vars.empty())
+        _cache_vars = _table->variables();
+
+    const size_t n = nstations();
+    size_t offset = _cache.size();
+    _cache.resize(offset + _cache_vars.size() * n);
+
+    for(auto& v : _cache_vars)
+    {
+        auto col = _table->get(v);
+        std::copy(col.data(), col.data() + n, _cache.begin() + offset);
+        offset += n;
+    }
+
+    _cache_ts.push_back(_current_ts);
+}
+
+void metdata::load_cache_record(size_t step)
+{
+    const size_t n = nstations();
+    size_t offset = step * _cache_vars.size() * n;
+
+    for(auto& v : _cache_vars)
+    {
+        auto col = _table->get(v);
+        std::copy(_cache.begin() + offset, _cache.begin() + offset + n, col.data());
+        offset += n;
+    }
+
+    _current_ts = _cache_ts[step];
+    _table->set_posix(_current_ts);
+}
+
+bool metdata::load_forcing(const boost::posix_time::ptime& t, bool first)
+{
+    if(_forcing_cache)
+    {
+        return next_cached(t);
+    }
+
+    if(_use_netcdf)
+    {
+        return next_nc(t);
+    }
+
+    return next_ascii(t, first);
+}
+
+bool metdata::next_ascii(const boost::posix_time::ptime& t, bool first)
 {
 
     for(size_t i = 0; i < nstations();i++)
@@ -449,7 +1065,7 @@ bool metdata::next_ascii()
         auto& proxy = _ascii_stations[s->ID()];
 
         //the very first timestep needs to handle loading the data without incrementing the internal iterators
-        if(!is_first_timestep)
+        if(!first)
         {
             ++proxy->_itr;
             if (proxy->_itr == proxy->_obs.end())
@@ -457,11 +1073,11 @@ bool metdata::next_ascii()
         }
 
 
-        if(proxy->_itr->get_posix() != _current_ts)
+        if(proxy->_itr->get_posix() != t)
         {
             CHM_THROW_EXCEPTION(forcing_error,
                 "Mismatch between model timestep and ascii file timestep. Current model = " +
-                boost::posix_time::to_simple_string(_current_ts) + ", ascii was:"+
+                boost::posix_time::to_simple_string(t) + ", ascii was:"+
                 boost::posix_time::to_simple_string(proxy->_itr->get_posix()) +" @station id="+s->ID());
         }
 
@@ -480,43 +1096,322 @@ bool metdata::next_ascii()
             filt->process(s);
         }
 
-        s->set_posix(_current_ts);
-
     }
 
+    _table->set_posix(t);
+
     return true;
 }
-bool metdata::next_nc()
+bool metdata::next_nc(const boost::posix_time::ptime& t)
 {
-    if(_current_ts > _end_time) //_current_ts is already ++ from the next() call
+    if(t > _forcing_end) // t is already ++ from the next() call
     {
         return false; // we've run out of data, we done
     }
 
+    // move on to the next file once the current one is exhausted
+    if(t > _nc_files[_nc_file_idx].end)
+    {
+        switch_netcdf_file(_nc_file_idx + 1);
+    }
+
 
-    //The call to netCDF isn't thread safe. It is protected by a critical section but it's costly, and not running this
-    // in parallel is about 2x faster  #pragma omp parallel for
-    for(size_t i = 0; i < nstations();i++)
+    // Read the entire (potentially subset) grid of each variable in one call. This is substantially faster than
+    // reading each station's grid cell individually.
+    // don't use the stations variable map as it'll contain anything inserted by a filter which won't exist in the nc file
+    for (auto &v: _nc->get_variable_names() )
     {
-        auto s = _stations.at(i);
+        double* col = (*_table)[v];
+        auto fill = [&](const netcdf::data& data)
+        {
+            #pragma omp parallel for
+            for(size_t i = 0; i < nstations();i++)
+            {
+                auto& s = _stations[i];
+                col[i] = data[s->_nc_y][s->_nc_x];
+            }
+        };
+
+        // the first timestep of a file may have already been read in the background
+        auto itr = _nc_prefetched.find(v);
+        if(itr != _nc_prefetched.end() && t == _nc_files[_nc_file_idx].start)
+            fill(itr->second);
+        else
+            fill(_nc->get_var(v, t));
+    }
+    _nc_prefetched.clear();
+
+    // filters are run once all the variables for this timestep are loaded, each over all the stations at once
+    for (auto& f : _netcdf_filters)
+    {
+        f.second->process(*_table);
+    }
+
+    _table->set_posix(t);
+
+    return true;
+
+
+}
+
+void metdata::set_model_dt(boost::posix_time::time_duration dt, int utc_offset, const std::map<std::string, std::string>& methods)
+{
+    if(dt.total_seconds() <= 0 || dt > _forcing_dt || _forcing_dt.total_seconds() % dt.total_seconds() != 0)
+    {
+        CHM_THROW_EXCEPTION(forcing_error, "Model timestep of " + std::to_string(dt.total_seconds()) +
+                                               " s must evenly divide the forcing timestep of " + std::to_string(_forcing_dt.total_seconds()) + " s");
+    }
+
+    _resample = _forcing_dt.total_seconds() / dt.total_seconds();
+    _dt = dt;
+    _utc_offset = utc_offset;
+    _n_timesteps = ( (_end_time+_dt) - _start_time).total_seconds() / _dt.total_seconds();
+
+    for(auto& itr : methods)
+    {
+        if(_variables.find(itr.first) == _variables.end())
+            LOG_WARNING << "Interpolation method given for " << itr.first << " but this variable is not in the forcing";
+    }
+
+    _interp_vars.clear();
+    _interp_var_method.clear();
+    for(auto& v : _variables)
+    {
+        // sensible defaults for the standard forcing variables
+        auto method = interp_method::linear;
+        if(v == "p")
+            method = interp_method::accumulated;
+        else if(v == "Qsi" || v == "iswr")
+            method = interp_method::shortwave;
+        else if(v == "vw_dir")
+            method = interp_method::direction;
+
+        auto itr = methods.find(v);
+        if(itr != methods.end())
+        {
+            if(itr->second == "linear")
+                method = interp_method::linear;
+            else if(itr->second == "accumulated")
+                method = interp_method::accumulated;
+            else if(itr->second == "shortwave")
+                method = interp_method::shortwave;
+            else if(itr->second == "direction")
+                method = interp_method::direction;
+            else
+                CHM_THROW_EXCEPTION(config_error, "Unknown forcing interpolation method " + itr->second + " for variable " + v);
+        }
+
+        _interp_vars.push_back(v);
+        _interp_var_method.push_back(method);
+    }
+
+    if(_resample > 1)
+    {
+        LOG_DEBUG << "Interpolating forcing from dt = " << _forcing_dt.total_seconds() << " s to model dt = " << _dt.total_seconds() << " s";
+    }
+}
+
+void metdata::store_interp_record(std::vector<double>& record)
+{
+    const size_t nvars = _interp_vars.size();
+
+    std::vector<station_table::column> cols;
+    for(auto& v : _interp_vars)
+        cols.push_back(_table->get(v));
 
-        // don't use the stations variable map as it'll contain anything inserted by a filter which won't exist in the nc file
-        for (auto &v: _nc->get_variable_names() )
+    #pragma omp parallel for
+    for(size_t i = 0; i < nstations(); i++)
+    {
+        for(size_t j = 0; j < nvars; j++)
         {
-            double d = _nc->get_var(v, _current_ts, s->_nc_x, s->_nc_y);
-            (*s)[v] = d;
-            s->set_posix(_current_ts);
+            record[i * nvars + j] = cols[j][i];
+        }
+    }
+}
+
+// Cosine of the solar zenith angle. Uses the NOAA declination and equation of time approximations,
+// which are more than enough to shape shortwave between forcing records.
+static double cos_solar_zenith(const boost::posix_time::ptime& t_utc, double lat, double lon)
+{
+    double doy = t_utc.date().day_of_year();
+    double hour = t_utc.time_of_day().total_seconds() / 3600.0;
+
+    // fractional year (radians)
+    double g = 2.0 * M_PI / 365.0 * (doy - 1.0 + (hour - 12.0) / 24.0);
+
+    double decl = 0.006918 - 0.399912 * cos(g) + 0.070257 * sin(g) - 0.006758 * cos(2 * g) + 0.000907 * sin(2 * g) -
+                  0.002697 * cos(3 * g) + 0.00148 * sin(3 * g);
+
+    // minutes
+    double eqtime = 229.18 * (0.000075 + 0.001868 * cos(g) - 0.032077 * sin(g) - 0.014615 * cos(2 * g) - 0.040849 * sin(2 * g));
+    double true_solar_time = hour * 60.0 + eqtime + 4.0 * lon;
+    double hour_angle = (true_solar_time / 4.0 - 180.0) * M_PI / 180.0;
+
+    double phi = lat * M_PI / 180.0;
 
-            for (auto& f : _netcdf_filters)
+    return sin(phi) * sin(decl) + cos(phi) * cos(decl) * cos(hour_angle);
+}
+
+static bool is_missing(double v)
+{
+    return v == -9999.0 || std::isnan(v);
+}
+
+bool metdata::next_interpolated()
+{
+    if(_current_ts > _end_time)
+    {
+        return false;
+    }
+
+    const size_t nvars = _interp_vars.size();
+
+    if(is_first_timestep)
+    {
+        // station lat/long is needed for the solar geometry
+        _interp_lat.resize(nstations());
+        _interp_lon.resize(nstations());
+
+        OGRSpatialReference insrs, outsrs;
+        insrs.importFromProj4(_mesh_proj4.c_str());
+        outsrs.SetWellKnownGeogCS("WGS84");
+        OGRCoordinateTransformation* coordTrans = nullptr;
+        if(!_is_geographic)
+            coordTrans = OGRCreateCoordinateTransformation(&insrs, &outsrs);
+
+        for(size_t i = 0; i < nstations(); i++)
+        {
+            double x = _stations.at(i)->x();
+            double y = _stations.at(i)->y();
+            if(coordTrans && !coordTrans->Transform(1, &x, &y))
             {
-                f.second->process(s);
+                delete coordTrans;
+                CHM_THROW_EXCEPTION(forcing_error, "Station=" + _stations.at(i)->ID() + ": unable to convert coordinates to lat/long.");
             }
+            _interp_lon[i] = x;
+            _interp_lat[i] = y;
+        }
+        delete coordTrans;
+
+        _interp_left.resize(nstations() * nvars);
+        _interp_right.resize(nstations() * nvars);
+
+        if(!load_forcing(_forcing_start, true))
+            return false;
+        store_interp_record(_interp_left);
+        _interp_left_ts = _forcing_start;
+
+        // only happens if the model is run for just the one forcing record
+        _interp_right = _interp_left;
+        _interp_right_ts = _interp_left_ts;
+
+        if(_forcing_start < _forcing_end)
+        {
+            _interp_right_ts = _forcing_start + _forcing_dt;
+            if(!load_forcing(_interp_right_ts, false))
+                return false;
+            store_interp_record(_interp_right);
         }
     }
 
-    return true;
+    // move the bracketing records forward once we step past the right one
+    if(_current_ts > _interp_right_ts)
+    {
+        std::swap(_interp_left, _interp_right);
+        _interp_left_ts = _interp_right_ts;
+
+        _interp_right_ts = _interp_left_ts + _forcing_dt;
+        if(!load_forcing(_interp_right_ts, false))
+            return false;
+        store_interp_record(_interp_right);
+    }
+
+    double w = 0;
+    if(_interp_right_ts > _interp_left_ts)
+        w = (_current_ts - _interp_left_ts).total_seconds() / static_cast<double>(_forcing_dt.total_seconds());
+
+    // accumulations at a record are over the forcing timestep ending at that record
+    bool at_left = _current_ts == _interp_left_ts;
+
+    bool has_shortwave = std::find(_interp_var_method.begin(), _interp_var_method.end(), interp_method::shortwave) !=
+                         _interp_var_method.end();
+
+    // positive offset going west, see solar.cpp
+    auto utc_offset = boost::posix_time::hours(_utc_offset);
+
+    const double S0 = 1361.0; // solar constant W/m^2
+    const double min_toa = 10.0; // W/m^2, below this the clear-sky index is meaningless
+
+    std::vector<station_table::column> cols;
+    for(auto& v : _interp_vars)
+        cols.push_back(_table->get(v));
 
+    #pragma omp parallel for
+    for(size_t i = 0; i < nstations(); i++)
+    {
+        double toa = 0, toa_l = 0, toa_r = 0;
+        if(has_shortwave)
+        {
+            toa = S0 * std::max(0.0, cos_solar_zenith(_current_ts + utc_offset, _interp_lat[i], _interp_lon[i]));
+            toa_l = S0 * std::max(0.0, cos_solar_zenith(_interp_left_ts + utc_offset, _interp_lat[i], _interp_lon[i]));
+            toa_r = S0 * std::max(0.0, cos_solar_zenith(_interp_right_ts + utc_offset, _interp_lat[i], _interp_lon[i]));
+        }
 
+        for(size_t j = 0; j < nvars; j++)
+        {
+            double l = _interp_left[i * nvars + j];
+            double r = _interp_right[i * nvars + j];
+            double value = 0;
+
+            if(_interp_var_method[j] == interp_method::accumulated)
+            {
+                value = at_left ? l : r;
+                if(!is_missing(value))
+                    value /= _resample;
+            }
+            else if(is_missing(l) || is_missing(r))
+            {
+                value = w < 0.5 ? l : r;
+            }
+            else if(_interp_var_method[j] == interp_method::direction)
+            {
+                double x = (1 - w) * cos(l * M_PI / 180.0) + w * cos(r * M_PI / 180.0);
+                double y = (1 - w) * sin(l * M_PI / 180.0) + w * sin(r * M_PI / 180.0);
+                value = atan2(y, x) * 180.0 / M_PI;
+                if(value < 0)
+                    value += 360.0;
+            }
+            else if(_interp_var_method[j] == interp_method::shortwave)
+            {
+                // clear-sky index at each record, if the sun is up
+                double k_l = toa_l > min_toa ? std::min(1.0, std::max(0.0, l / toa_l)) : -1;
+                double k_r = toa_r > min_toa ? std::min(1.0, std::max(0.0, r / toa_r)) : -1;
+
+                if(k_l < 0 && k_r < 0)
+                {
+                    value = std::max(0.0, l + w * (r - l));
+                }
+                else
+                {
+                    if(k_l < 0)
+                        k_l = k_r;
+                    if(k_r < 0)
+                        k_r = k_l;
+                    value = (k_l + w * (k_r - k_l)) * toa;
+                }
+            }
+            else
+            {
+                value = l + w * (r - l);
+            }
+
+            cols[j][i] = value;
+        }
+    }
+
+    _table->set_posix(_current_ts);
+
+    return true;
 }
 
 std::vector< std::shared_ptr<station> > metdata::get_stations_in_radius(double x, double y, double radius )
@@ -554,6 +1449,13 @@ std::vector< std::shared_ptr<station> > metdata::nearest_station(double x, doubl
 
 void metdata::prune_stations(std::unordered_set<std::string>& station_ids)
 {
+    // anything still holding a removed station keeps its last values, but it no longer takes up a row
+    for(auto& s : _stations)
+    {
+        if(station_ids.find(s->ID()) != std::end(station_ids))
+            s->detach();
+    }
+
     _stations.erase(
         std::remove_if(std::begin(_stations), std::end(_stations),
         [&](auto const& it)
@@ -563,9 +1465,23 @@ void metdata::prune_stations(std::unordered_set<std::string>& station_ids)
         std::end(_stations));
 
     _nstations = _stations.size();
+    _table->select(_stations);
+
+    if(_forcing_cache)
+        map_forcing_cache_rows();
+
+    // so that faces can't be given a removed station
+    _dD_tree.clear();
+    for(auto& s : _stations)
+        _dD_tree.insert( boost::make_tuple(Kernel::Point_2(s->x(),s->y()),s) );
 }
 
 std::vector< std::shared_ptr<station>>& metdata::stations()
 {
     return _stations;
+}
+
+std::shared_ptr<station_table> metdata::table()
+{
+    return _table;
 }
\ No newline at end of file
@@ -38,6 +38,7 @@
 #include <set>
 #include <unordered_set>
 #include <vector>
+#include <future>
 
 //boost includes
 #include <boost/function.hpp>
@@ -62,6 +63,7 @@
 #include "timeseries.hpp"
 #include "triangulation.hpp"
 #include "filter_base.hpp"
+#include "forcing_cache.hpp"
 /**
  * Main meteorological data coordinator. Opens from a variety of sources and ensures that each virtual station has this timestep's information
  * regardless of the source data type.
@@ -105,6 +107,29 @@ class metdata
     /// @param filters
     void load_from_netcdf(const std::string& path, std::map<std::string, boost::shared_ptr<filter_base> > filters = {});
 
+    /// Loads a sequence of netcdf files (e.g., daily or monthly NWP outputs) that together form one continuous timeseries.
+    /// The files are ordered by their start time and must share the same grid, variables and dt, with each file starting one dt
+    /// after the previous one ends. Only one file is open at a time; the next file is opened and its first timestep read in the background.
+    /// @param paths
+    /// @param filters
+    void load_from_netcdf(const std::vector<std::string>& paths, std::map<std::string, boost::shared_ptr<filter_base> > filters = {});
+
+    /// Expands a list of NetCDF file names and glob patterns into the files they match, for load_from_netcdf.
+    /// Each pattern's matches are sorted. Throws if a pattern matches nothing.
+    /// @param patterns
+    /// @return
+    static std::vector<std::string> expand_netcdf_files(const std::vector<std::string>& patterns);
+
+    /// Restricts NetCDF loading to the hyperslab of the grid that covers the given extent (in mesh coordinates) plus a
+    /// buffer distance. Only the grid cells in this window become stations and only this window is read every timestep.
+    /// Must be called prior to load_from_netcdf.
+    /// @param xmin
+    /// @param ymin
+    /// @param xmax
+    /// @param ymax
+    /// @param buffer Distance (m) to expand the extent by, e.g., the station search radius
+    void subset_netcdf_to_extent(double xmin, double ymin, double xmax, double ymax, double buffer);
+
     /// Loads the standard ascii timeseries. Needs to be in UTC+0
     /// @param path
     /// @param filters
@@ -166,6 +191,18 @@ class metdata
     /// @return
     void check_ts_consistency();
 
+    /// Runs the model at a finer timestep than the forcing by interpolating in time between the two forcing records that
+    /// bracket each model timestep. Must be called after the forcing is loaded and before subset.
+    /// Variables are interpolated as
+    ///     - linear: linear in time (default)
+    ///     - accumulated: the record is the total over the forcing timestep ending at the record's time and is split evenly (e.g., p)
+    ///     - shortwave: the clear-sky index is interpolated and rescaled by the sun's elevation at the model timestep (e.g., Qsi)
+    ///     - direction: circular interpolation of a direction in degrees (e.g., vw_dir)
+    /// @param dt Model timestep. Must evenly divide the forcing timestep
+    /// @param utc_offset Positive offset going west. So the normal UTC-6 would be UTC_offset:6
+    /// @param methods Variable -> method, overriding the defaults
+    void set_model_dt(boost::posix_time::time_duration dt, int utc_offset, const std::map<std::string, std::string>& methods = {});
+
     /// Timestep duration. Use .dt_seconds() to total seconds
     /// @return
     boost::posix_time::time_duration dt();
@@ -176,6 +213,33 @@ class metdata
     /// @return False if no more timesteps
     bool next();
 
+    /// Keeps a copy of each timestep's station values, after the filters, as they are loaded by next().
+    /// The cache is cleared when it is enabled.
+    /// @param enable
+    void cache(bool enable);
+
+    /// Number of cached timesteps
+    size_t cached_timesteps();
+
+    /// Loads a cached timestep into the stations. The following next() calls replay the rest of the cache in order
+    /// and then continue reading the forcing after the last timestep that was read from it, so a run can
+    /// go over the cached period any number of times without reading or filtering the forcing again.
+    /// @param step Index of the cached timestep
+    void replay(size_t step = 0);
+
+    /// Loads the stations and their forcing from a forcing cache written by an earlier run, instead of reading the forcing.
+    /// @param path Path of the cache
+    /// @return False if there is no cache at path
+    bool load_from_cache(const std::string& path);
+
+    /// Writes the stations' values each timestep, as next() loads them, to a forcing cache at path.
+    /// The cache is only kept if finish_cache() is called once every timestep has been loaded.
+    /// @param path
+    void write_cache(const std::string& path);
+
+    /// Finishes writing the forcing cache, see write_cache
+    void finish_cache();
+
     /// Removes a subset of stations from the  station list
     /// @param stations The set of station IDs to remove
     void prune_stations(std::unordered_set<std::string>& station_ids);
@@ -188,6 +252,10 @@ class metdata
 
     std::vector< std::shared_ptr<station>>& stations();
 
+    /// The current timestep of all the stations, with a column per variable. Row i is stations()[i].
+    /// Use column handles from this to loop over many stations without a variable lookup per station.
+    std::shared_ptr<station_table> table();
+
   private:
 
     struct ascii_data
@@ -202,13 +270,24 @@ class metdata
         timeseries::iterator _itr;
     };
 
-    /// Advances 1 timestep in the netcdf files
-    bool next_nc();
+    /// Loads the netcdf forcing record at t
+    bool next_nc(const boost::posix_time::ptime& t);
 
 
-    /// Advances 1 timestep from the ascii timeseries
+    /// Advances 1 timestep from the ascii timeseries, checking it is at t
+    /// @param t
+    /// @param first If true, loads the current record without advancing
     /// @return
-    bool next_ascii();
+    bool next_ascii(const boost::posix_time::ptime& t, bool first);
+
+    /// Loads the forcing record at t into the stations and runs the filters
+    bool load_forcing(const boost::posix_time::ptime& t, bool first);
+
+    /// Loads the record at t from the forcing cache
+    bool next_cached(const boost::posix_time::ptime& t);
+
+    /// Interpolates the current model timestep from the bracketing forcing records
+    bool next_interpolated();
 
     /// For all the stations loaded from ascii files, find the latest start time, and the earliest end time that is consistent across all stations
     /// @return
@@ -228,6 +307,54 @@ class metdata
         // if false, we are using ascii files
         bool _use_netcdf;
 
+        // if set, only the part of the grid that covers this extent (mesh coordinates) + buffer is loaded
+        struct nc_extent
+        {
+            double xmin, ymin, xmax, ymax;
+            double buffer;
+        };
+        std::unique_ptr<nc_extent> _nc_extent;
+
+        // Computes the [y0:y1, x0:x1] window of the NetCDF grid that covers _nc_extent
+        // and restricts the netcdf reads to that window
+        void subset_netcdf_grid(const netcdf::data& lat, const netcdf::data& lon);
+
+        // the files that make up the NetCDF forcing, sorted by start time
+        struct nc_file_info
+        {
+            std::string path;
+            boost::posix_time::ptime start;
+            boost::posix_time::ptime end;
+        };
+        std::vector<nc_file_info> _nc_files;
+
+        // index into _nc_files of the file currently held in _nc
+        size_t _nc_file_idx;
+
+        // the next file, opened and with the first timestep of each variable read in a background thread
+        struct nc_prefetch
+        {
+            std::unique_ptr<netcdf> nc;
+            std::map<std::string, netcdf::data> first_timestep;
+        };
+        std::future<std::unique_ptr<nc_prefetch>> _nc_next;
+        size_t _nc_next_idx;
+
+        // prefetched first timestep of the current file, consumed by next_nc
+        std::map<std::string, netcdf::data> _nc_prefetched;
+
+        // Reads the header of every file and checks that they can be stitched into one timeseries. Fills _nc_files.
+        void scan_netcdf_files(const std::vector<std::string>& paths);
+
+        // Opens _nc_files[idx] and restricts it to the same grid window as the current file
+        std::unique_ptr<netcdf> open_netcdf_file(size_t idx, size_t xstart, size_t ystart, size_t nx, size_t ny);
+
+        // Starts opening _nc_files[idx] in the background
+        void prefetch_netcdf_file(size_t idx);
+
+        // Makes _nc_files[idx] the current file, using the prefetched file if available
+        void switch_netcdf_file(size_t idx);
+
     // -----------------------------------
     // ASCII met data specific variables
 
@@ -243,6 +370,10 @@ class metdata
     // Our sources of data are netcdf, or ascii (or whatever in the future)
     std::vector< std::shared_ptr<station>> _stations;
 
+    // The current timestep of every station, a column per variable with row i being _stations[i].
+    // The stations are views onto this.
+    std::shared_ptr<station_table> _table;
+
 
     // Total number of stations
     size_t _nstations;
@@ -256,6 +387,79 @@ class metdata
     boost::posix_time::ptime _current_ts;
     boost::posix_time::time_duration _dt;
 
+    // Temporal interpolation of the forcing to the model timestep
+    // -----------------------------------
+        enum class interp_method
+        {
+            linear,
+            accumulated,
+            shortwave,
+            direction
+        };
+
+        // timestep of the forcing data. Is the same as _dt unless interpolating
+        boost::posix_time::time_duration _forcing_dt;
+
+        // number of model timesteps per forcing timestep, 1 = no interpolation
+        size_t _resample;
+
+        // the forcing records needed to cover [_start_time, _end_time]. Are the same as _start_time, _end_time unless interpolating
+        boost::posix_time::ptime _forcing_start, _forcing_end;
+
+        // time of a forcing record, used to align the model start/end to forcing records
+        boost::posix_time::ptime _forcing_origin;
+
+        int _utc_offset;
+
+        // the variables to interpolate, and how
+        std::vector<std::string> _interp_vars;
+        std::vector<interp_method> _interp_var_method;
+
+        // the forcing records that bracket the current timestep, as [station * _interp_vars.size() + var]
+        std::vector<double> _interp_left, _interp_right;
+        boost::posix_time::ptime _interp_left_ts, _interp_right_ts;
+
+        // station lat/long, for the solar geometry
+        std::vector<double> _interp_lat, _interp_lon;
+
+        // copies the current station values into one of the bracketing records
+        void store_interp_record(std::vector<double>& record);
+
+    // Replay of cached timesteps
+    // -----------------------------------
+        bool _caching;
+
+        // the station values of each cached timestep, as [step][variable][station]
+        std::vector<double> _cache;
+        std::vector<boost::posix_time::ptime> _cache_ts;
+
+        // the variables that are cached, those in the table when the first timestep was cached
+        std::vector<std::string> _cache_vars;
+
+        bool _replaying;
+        size_t _replay_step;
+
+        // time of the last timestep read from the forcing, to continue from once the replay ends
+        boost::posix_time::ptime _resume_ts;
+
+        void store_cache_record();
+        void load_cache_record(size_t step);
+
+    // Forcing cache
+    // -----------------------------------
+        // if set, the forcing is read from this instead of the forcing files
+        std::unique_ptr<forcing_cache> _forcing_cache;
+
+        // the forcing cache row of each station
+        std::vector<size_t> _forcing_cache_rows;
+
+        // the cache being written, created at the first timestep
+        std::unique_ptr<forcing_cache> _forcing_cache_out;
+        std::string _forcing_cache_path;
+
+        // maps the stations to their forcing cache row
+        void map_forcing_cache_rows();
+
     // computes the dt
     void compute_dt();
 
@@ -72,6 +72,32 @@ void Gray_inf::init(mesh& domain)
     }
 
 }
+
+bool Gray_inf::migrates()
+{
+    return true;
+}
+
+void Gray_inf::pack_face(mesh_elem& face, std::vector<double>& buf)
+{
+    auto d = face->get_module_data<Gray_inf::data>(ID);
+    buf.insert(buf.end(), {d->storage, d->max_storage, d->porosity, d->soil_depth,
+                           d->opportunity_time, d->last_ts_potential_inf, d->total_inf, d->total_excess});
+}
+
+void Gray_inf::unpack_face(mesh_elem& face, const double*& buf)
+{
+    auto d = face->make_module_data<Gray_inf::data>(ID);
+    d->storage = *buf++;
+    d->max_storage = *buf++;
+    d->porosity = *buf++;
+    d->soil_depth = *buf++;
+    d->opportunity_time = *buf++;
+    d->last_ts_potential_inf = *buf++;
+    d->total_inf = *buf++;
+    d->total_excess = *buf++;
+}
+
 void Gray_inf::run(mesh_elem &face)
 {
     if(is_water(face))
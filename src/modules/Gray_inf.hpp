@@ -41,6 +41,9 @@ public:
 
     void run(mesh_elem &face);
     void init(mesh& domain);
+    bool migrates();
+    void pack_face(mesh_elem& face, std::vector<double>& buf);
+    void unpack_face(mesh_elem& face, const double*& buf);
 
     class data : public face_info
     {
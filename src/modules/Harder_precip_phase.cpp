@@ -49,6 +49,9 @@ Harder_precip_phase::Harder_precip_phase(config_file cfg)
     b = cfg.get("const.b",2.630006);
     c = cfg.get("const.c",0.09336);
 
+    tabulate_Ti = cfg.get("tabulate_Ti",true);
+    Ti_table_tol = cfg.get("Ti_table_tol",1e-4);
+
 
 
     LOG_DEBUG << "Successfully instantiated module " << this->ID;
@@ -61,6 +64,19 @@ Harder_precip_phase::~Harder_precip_phase()
 }
 void Harder_precip_phase::init(mesh& domain)
 {
+    if(tabulate_Ti)
+    {
+        // the tables hold the converged solution, which is quadratic so half the digits is full precision
+        int digits = std::numeric_limits<double>::digits / 2;
+
+        Ti_ice = math::lookup_table_2d([=](double T, double RH) { return hydrometeor_temperature(T, RH, true, digits); },
+                                       -45.0, 0.0, 0.0, 100.0, Ti_table_tol);
+        Ti_water = math::lookup_table_2d([=](double T, double RH) { return hydrometeor_temperature(T, RH, false, digits); },
+                                         0.0, 50.0, 0.0, 100.0, Ti_table_tol);
+
+        LOG_DEBUG << "Ti tables have " << Ti_ice.size() + Ti_water.size() << " points, max error "
+                  << std::max(Ti_ice.max_error(), Ti_water.max_error());
+    }
 
 #pragma omp parallel for
     for (size_t i = 0; i < domain->size_faces(); i++)
@@ -75,11 +91,29 @@ void Harder_precip_phase::init(mesh& domain)
     }
 
 }
-void Harder_precip_phase::run(mesh_elem& face)
+
+bool Harder_precip_phase::migrates()
 {
-    double Ta = (*face)["t"_s]+273.15; //K
-    double T =  (*face)["t"_s];
-    double RH = (*face)["rh"_s];
+    return true;
+}
+
+void Harder_precip_phase::pack_face(mesh_elem& face, std::vector<double>& buf)
+{
+    auto d = face->get_module_data<data>(ID);
+    buf.insert(buf.end(), {d->hours_since_snowfall, d->acc_rain, d->acc_snow});
+}
+
+void Harder_precip_phase::unpack_face(mesh_elem& face, const double*& buf)
+{
+    auto d = face->make_module_data<data>(ID);
+    d->hours_since_snowfall = *buf++;
+    d->acc_rain = *buf++;
+    d->acc_snow = *buf++;
+}
+
+double Harder_precip_phase::hydrometeor_temperature(double T, double RH, bool ice, int digits)
+{
+    double Ta = T+273.15; //K
     double ea = RH/100 * 0.611*exp( (17.3*T) / (237.3+T));
 
     // (A.6)
@@ -90,7 +124,7 @@ void Harder_precip_phase::run(mesh_elem& face)
 
     // (A.10) (A.11)
     double L;
-    if(T < 0.0)
+    if(ice)
     {
         L = 1000.0 * (2834.1 - 0.29 *T - 0.004*T*T);
     }
@@ -117,9 +151,28 @@ void Harder_precip_phase::run(mesh_elem& face)
     double guess = T;
     double min = -50;
     double max = 50;
-    double digits = 6;
 
-    double Ti = boost::math::tools::newton_raphson_iterate(fx, guess, min, max, digits);
+    return boost::math::tools::newton_raphson_iterate(fx, guess, min, max, digits);
+}
+
+void Harder_precip_phase::run(mesh_elem& face)
+{
+    double T =  (*face)["t"_s];
+    double RH = (*face)["rh"_s];
+
+    double Ti;
+    if(tabulate_Ti && T < 0.0 && Ti_ice.in_range(T, RH))
+    {
+        Ti = Ti_ice(T, RH);
+    }
+    else if(tabulate_Ti && T >= 0.0 && Ti_water.in_range(T, RH))
+    {
+        Ti = Ti_water(T, RH);
+    }
+    else
+    {
+        Ti = hydrometeor_temperature(T, RH, T < 0.0, 6);
+    }
 
     double frTi = 1.0 / (1.0+b*pow(c,Ti));
 
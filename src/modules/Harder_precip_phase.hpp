@@ -29,6 +29,7 @@
 #include "TPSpline.hpp"
 
 #include <cstdlib>
+#include <limits>
 #include <string>
 #include <cmath>
 #include <armadillo>
@@ -37,6 +38,8 @@
 
 #include <boost/math/tools/roots.hpp>
 
+#include "math/lookup_table.hpp"
+
 //#include <meteoio/MeteoIO.h>
 /**
 * \addtogroup modules
@@ -67,9 +70,30 @@ public:
     ~Harder_precip_phase();
     virtual void run(mesh_elem& face);
     void init(mesh& domain);
+    bool migrates();
+    void pack_face(mesh_elem& face, std::vector<double>& buf);
+    void unpack_face(mesh_elem& face, const double*& buf);
     double b;
     double c;
 
+    /**
+     * Hydrometeor temperature from the falling hydrometeor energy balance, Harder and Pomeroy (2013) (A.5)
+     * @param T Air temperature [C]
+     * @param RH Relative humidity [%]
+     * @param ice Use the latent heat of sublimation (A.10) instead of vaporization (A.11)
+     * @param digits Binary digits of the Newton solve
+     * @return Ti [C]
+     */
+    static double hydrometeor_temperature(double T, double RH, bool ice, int digits);
+
+    // if true, Ti is interpolated from tables built at init instead of solved on every face
+    bool tabulate_Ti;
+    double Ti_table_tol;
+
+    // Ti over (t, rh). The latent heat jumps at 0 C, so sub-freezing and above-freezing air get their own table
+    math::lookup_table_2d Ti_ice;
+    math::lookup_table_2d Ti_water;
+
     class data : public face_info
     {
     public:
@@ -207,6 +207,7 @@ void Marsh_shading_iswr::run(mesh& domain)
 
 
     // here we need to 'undo' the rotation we applied.
+    // The faces' geometry was never recomputed for the rotated vertices, so it is still correct once they are restored.
 #pragma omp parallel for
     for (size_t i = 0; i < domain->size_vertex(); i++)
     {
@@ -269,6 +269,18 @@ void PBSM3D::init(mesh& domain)
 
     iterative_subl = cfg.get("iterative_subl", false);
 
+    use_active_region = cfg.get("active_region", false);
+    active_region_halo = cfg.get("active_region_halo", 2);
+
+    auto suspension_solver = cfg.get("suspension_solver", "ilut");
+    if (suspension_solver == "line")
+        use_line_solver = true;
+    else if (suspension_solver == "ilut")
+        use_line_solver = false;
+    else
+        BOOST_THROW_EXCEPTION(module_error() << errstr_info("PBSM3D: unknown suspension_solver " + suspension_solver +
+                                                           ", expected ilut or line"));
+
     if (rouault_diffusion_coeff)
     {
         LOG_WARNING << "rouault_diffusion_coef overrides const "
@@ -279,7 +291,10 @@ void PBSM3D::init(mesh& domain)
 
     // use this to build the sparsity pattern for suspension matrix
     size_t ntri = domain->size_faces();
-    std::vector<std::map<unsigned int, vcl_scalar_type>> C(ntri * nLayer);
+    std::vector<std::map<unsigned int, vcl_scalar_type>> C(use_line_solver ? 0 : ntri * nLayer);
+
+    if (use_line_solver)
+        susp_op = math::column_operator(ntri, nLayer);
 
     // sparsity pattern for drift
     std::vector<std::map<unsigned int, vcl_scalar_type>> A(ntri);
@@ -294,7 +309,7 @@ void PBSM3D::init(mesh& domain)
 
         if (!face->has_vegetation() && enable_veg)
         {
-            LOG_ERROR << "Vegetation is enabled, but no vegetation parameter was found.";
+            LOG_ERROR_LIMITED << "Vegetation is enabled, but no vegetation parameter was found.";
         }
         if (face->has_vegetation() && enable_veg)
         {
@@ -384,8 +399,16 @@ void PBSM3D::init(mesh& domain)
         d->csubl.resize(nLayer);
         (*face)["sum_drift"_s]=0;
 
+        if (use_line_solver)
+        {
+            std::array<int, 3> neighbours;
+            for (int f = 0; f < 3; f++)
+                neighbours[f] = d->face_neigh[f] ? face->neighbor(f)->cell_local_id : -1;
+            susp_op.set_neighbours(face->cell_local_id, neighbours);
+        }
+
         // iterate over the vertical layers
-        for (int z = 0; z < nLayer; ++z)
+        for (int z = 0; z < nLayer && !use_line_solver; ++z)
         {
             size_t idx = ntri * z + face->cell_local_id;
             for (int f = 0; f < 3; f++)
@@ -421,13 +444,245 @@ void PBSM3D::init(mesh& domain)
         }
     }
 
-    viennacl::copy(C, vl_C); // copy C -> vl_C, sets up the sparsity pattern
+    if (!use_line_solver)
+        viennacl::copy(C, vl_C); // copy C -> vl_C, sets up the sparsity pattern
     viennacl::copy(A, vl_A); // copy A -> vl_A, sets up the sparsity pattern
 
     b.resize(ntri * nLayer);
     bb.resize(ntri);
-    nnz = vl_C.nnz();
+    nnz = use_line_solver ? 0 : vl_C.nnz();
     nnz_drift = vl_A.nnz();
+
+    region_pos.assign(ntri, -1);
+}
+
+std::vector<unsigned int> PBSM3D::active_region(mesh& domain, const std::vector<char>& seed, size_t halo)
+{
+    std::vector<char> in_region(seed);
+    std::vector<unsigned int> front;
+    for (size_t i = 0; i < seed.size(); i++)
+    {
+        if (seed[i])
+            front.push_back(i);
+    }
+
+    // grow the region a ring of neighbours at a time
+    for (size_t ring = 0; ring < halo && !front.empty(); ring++)
+    {
+        std::vector<unsigned int> next;
+        for (auto i : front)
+        {
+            auto face = domain->face(i);
+            for (int j = 0; j < 3; j++)
+            {
+                // the same neighbours as data::face_neigh
+                auto neigh = face->neighbor(j);
+                if (neigh == nullptr || neigh->_is_ghost)
+                    continue;
+
+                auto id = neigh->cell_local_id;
+                if (!in_region[id])
+                {
+                    in_region[id] = 1;
+                    next.push_back(id);
+                }
+            }
+        }
+        front.swap(next);
+    }
+
+    std::vector<unsigned int> region;
+    for (size_t i = 0; i < in_region.size(); i++)
+    {
+        if (in_region[i])
+            region.push_back(i);
+    }
+    return region;
+}
+
+void PBSM3D::restrict_system(viennacl::compressed_matrix<vcl_scalar_type>& M, const std::vector<vcl_scalar_type>& rhs,
+                             const std::vector<unsigned int>& region, size_t nlayer, std::vector<int>& region_pos,
+                             viennacl::compressed_matrix<vcl_scalar_type>& sub_M,
+                             viennacl::vector<vcl_scalar_type>& sub_rhs)
+{
+    size_t ntri = region_pos.size();
+    size_t nreg = region.size();
+
+    for (size_t k = 0; k < nreg; k++)
+        region_pos[region[k]] = k;
+
+    unsigned int const* row_buffer =
+        viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(M.handle1());
+    unsigned int const* col_buffer =
+        viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(M.handle2());
+    vcl_scalar_type const* elements =
+        viennacl::linalg::host_based::detail::extract_raw_pointer<vcl_scalar_type>(M.handle());
+
+    std::vector<std::map<unsigned int, vcl_scalar_type>> S(nreg * nlayer);
+    std::vector<vcl_scalar_type> sub_b(nreg * nlayer);
+
+#pragma omp parallel for
+    for (size_t k = 0; k < nreg; k++)
+    {
+        for (size_t z = 0; z < nlayer; z++)
+        {
+            size_t row = ntri * z + region[k];
+            size_t sub_row = nreg * z + k;
+
+            sub_b[sub_row] = rhs[row];
+
+            // columns outside the region multiply a zero unknown and are dropped
+            for (unsigned int e = row_buffer[row]; e < row_buffer[row + 1]; e++)
+            {
+                unsigned int col = col_buffer[e];
+                int pos = region_pos[col % ntri];
+                if (pos >= 0)
+                    S[sub_row][nreg * (col / ntri) + pos] = elements[e];
+            }
+        }
+    }
+
+    for (auto i : region)
+        region_pos[i] = -1;
+
+    viennacl::copy(S, sub_M);
+    sub_rhs.resize(nreg * nlayer);
+    viennacl::copy(sub_b, sub_rhs);
+}
+
+void PBSM3D::solve_active_region(viennacl::compressed_matrix<vcl_scalar_type>& M, const std::vector<vcl_scalar_type>& rhs,
+                                 const std::vector<unsigned int>& region, size_t nlayer, std::vector<int>& region_pos,
+                                 system_solver solver, std::vector<vcl_scalar_type>& x)
+{
+    size_t ntri = region_pos.size();
+    x.assign(rhs.size(), 0.0);
+
+    if (region.empty())
+        return;
+
+    viennacl::compressed_matrix<vcl_scalar_type> sub_M;
+    viennacl::vector<vcl_scalar_type> sub_rhs;
+    restrict_system(M, rhs, region, nlayer, region_pos, sub_M, sub_rhs);
+
+    std::vector<vcl_scalar_type> sub_x(sub_rhs.size());
+    solver(sub_M, sub_rhs, sub_x);
+
+#pragma omp parallel for
+    for (size_t k = 0; k < region.size(); k++)
+    {
+        for (size_t z = 0; z < nlayer; ++z)
+            x[ntri * z + region[k]] = sub_x[region.size() * z + k];
+    }
+}
+
+void PBSM3D::solve_suspension(viennacl::compressed_matrix<vcl_scalar_type>& C, viennacl::vector<vcl_scalar_type>& rhs,
+                              std::vector<vcl_scalar_type>& x)
+{
+    // setup the compressed matrix on the compute device, if available
+#ifdef VIENNACL_WITH_OPENCL
+    viennacl::context gpu_ctx(viennacl::OPENCL_MEMORY);
+    C.switch_memory_context(gpu_ctx);
+    rhs.switch_memory_context(gpu_ctx);
+#endif
+
+    // This solves the steady-state suspension layer concentration
+
+    // configuration of preconditioner:
+    viennacl::linalg::ilut_tag ilut_config(20,1e-4); // defaults: 20 entries/row, 1e-4 drop tol
+    viennacl::linalg::ilut_precond<viennacl::compressed_matrix<vcl_scalar_type>> ilut(
+        C, ilut_config);
+
+    // Set up convergence tolerance to have an average value for each unknown
+    double suspension_gmres_tol = 1e-8;
+    // Set max iterations and maximum Krylov dimension before restart
+    size_t suspension_gmres_max_iterations = 1000;
+    size_t suspension_gmres_krylov_dimension = 30;
+
+    // compute result and copy back to CPU device (if an accelerator was used),
+    // otherwise access is slow
+    viennacl::linalg::gmres_tag suspension_custom_gmres(suspension_gmres_tol, suspension_gmres_max_iterations,
+                                                        suspension_gmres_krylov_dimension);
+    viennacl::vector<vcl_scalar_type> vl_x = viennacl::linalg::solve(C, rhs, suspension_custom_gmres, ilut);
+    viennacl::copy(vl_x, x);
+
+    // Log final state of the linear solve
+    LOG_DEBUG << "  Suspension_GMRES # of iterations: " << suspension_custom_gmres.iters();
+    LOG_DEBUG << "  Suspension_GMRES final residual : " << suspension_custom_gmres.error();
+
+    /*
+      Dump matrix to ASCII file
+    */
+    //    ofstream ofile;
+    //    ofile.open("C.out");
+    //    ofile << std::setprecision(12) << C;
+    //    ofile.close();
+    //
+    //    ofile.open("b.out");
+    //    ofile << std::setprecision(12) << rhs;
+    //    ofile.close();
+    //
+    //    ofile.open("x.out");
+    //    ofile << std::setprecision(12) << vl_x;
+    //    ofile.close();
+}
+
+void PBSM3D::solve_suspension_line(math::column_operator& op, const std::vector<double>& rhs,
+                                   std::vector<vcl_scalar_type>& x)
+{
+    // same tolerance and restart as the ILUT path. The line preconditioner takes up the strong vertical coupling,
+    // so far fewer iterations are needed
+    double suspension_gmres_tol = 1e-8;
+    size_t suspension_gmres_max_iterations = 1000;
+    size_t suspension_gmres_krylov_dimension = 30;
+
+    std::vector<double> sol;
+    size_t iters = op.solve(rhs, sol, suspension_gmres_tol, suspension_gmres_max_iterations,
+                            suspension_gmres_krylov_dimension);
+    x.assign(sol.begin(), sol.end());
+
+    LOG_DEBUG << "  Suspension_line_GMRES # of iterations: " << iters;
+    LOG_DEBUG << "  Suspension_line_GMRES final residual : " << op.error();
+}
+
+void PBSM3D::solve_drift(viennacl::compressed_matrix<vcl_scalar_type>& A, viennacl::vector<vcl_scalar_type>& rhs,
+                         std::vector<vcl_scalar_type>& x)
+{
+// setup the compressed matrix on the compute device, if available
+#ifdef VIENNACL_WITH_OPENCL
+    viennacl::context gpu_ctx(viennacl::OPENCL_MEMORY);
+    A.switch_memory_context(gpu_ctx);
+    rhs.switch_memory_context(gpu_ctx);
+#endif
+
+//     Solve the deposition flux --> how much drifting there is.
+
+//     configuration of preconditioner:
+    viennacl::linalg::chow_patel_tag deposition_flux_chow_patel_config;
+    deposition_flux_chow_patel_config.sweeps(3);       //  nonlinear sweeps
+    deposition_flux_chow_patel_config.jacobi_iters(2); //  Jacobi iterations per triangular 'solve' Rx=r
+    viennacl::linalg::chow_patel_icc_precond<viennacl::compressed_matrix<vcl_scalar_type>>
+        deposition_flux_chow_patel_icc(A, deposition_flux_chow_patel_config);
+
+    // Set up convergence tolerance to have an average value for each unknown
+    double deposition_flux_cg_tol = 1e-8;
+    // Set max iterations and maximum Krylov dimension before restart
+    size_t deposition_flux_cg_max_iterations = 500;
+
+    // compute result and copy back to CPU device (if an accelerator was used),
+    // otherwise access is slow
+    viennacl::linalg::cg_tag deposition_flux_custom_cg(deposition_flux_cg_tol, deposition_flux_cg_max_iterations);
+
+    // compute result and copy back to CPU device (if an accelerator was used),
+    // otherwise access is slow
+    viennacl::vector<vcl_scalar_type> vl_dSdt =
+        viennacl::linalg::solve(A, rhs, deposition_flux_custom_cg, deposition_flux_chow_patel_icc);
+    // viennacl::vector<vcl_scalar_type> vl_dSdt = viennacl::linalg::solve(vl_A,
+    // bb, deposition_flux_custom_cg);
+    viennacl::copy(vl_dSdt, x);
+
+    // Log final state of the linear solve
+    LOG_DEBUG << "  deposition_flux_CG # of iterations: " << deposition_flux_custom_cg.iters();
+    LOG_DEBUG << "  deposition_flux_CG final residual : " << deposition_flux_custom_cg.error();
 }
 
 void PBSM3D::run(mesh& domain)
@@ -451,12 +706,15 @@ void PBSM3D::run(mesh& domain)
     bb.switch_memory_context(host_ctx);
 #endif
 
-    // zero CSR vector in vl_C
-    viennacl::vector_base<vcl_scalar_type> init_temporary(
-        vl_C.handle(), viennacl::compressed_matrix<vcl_scalar_type>::size_type(nnz + 1), 0, 1);
-    // write:
-    init_temporary = viennacl::zero_vector<vcl_scalar_type>(
-        viennacl::compressed_matrix<vcl_scalar_type>::size_type(nnz + 1), viennacl::traits::context(vl_C));
+    // zero CSR vector in vl_C. The line solver's operator has every coefficient set below
+    if (!use_line_solver)
+    {
+        viennacl::vector_base<vcl_scalar_type> init_temporary(
+            vl_C.handle(), viennacl::compressed_matrix<vcl_scalar_type>::size_type(nnz + 1), 0, 1);
+        // write:
+        init_temporary = viennacl::zero_vector<vcl_scalar_type>(
+            viennacl::compressed_matrix<vcl_scalar_type>::size_type(nnz + 1), viennacl::traits::context(vl_C));
+    }
 
     // zero-fill RHS
     b.clear();
@@ -1280,8 +1538,12 @@ void PBSM3D::run(mesh& domain)
                 // lateral
                 size_t idx = ntri * z + face->cell_local_id;
 
-                //[idx][idx]
-                size_t idx_idx_off = offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, idx);
+                // this cell's row: its own coefficient, its lateral neighbours' in this layer, the cells above and below
+                double C_ii = 0;
+                double C_lat[3] = {0, 0, 0};
+                double C_up = 0;
+                double C_down = 0;
+
                 b[idx] = 0;
                 double V = face->get_area() * v_edge_height;
 
@@ -1304,41 +1566,32 @@ void PBSM3D::run(mesh& domain)
 
                         if (d->face_neigh[f])
                         {
-                            size_t nidx = ntri * z + face->neighbor(f)->cell_local_id;
-
-                            elements[idx_idx_off] += V * csubl - d->A[f] * udotm[f] - alpha[f];
-
-                            size_t idx_nidx_off = offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, nidx);
-
-                            elements[idx_nidx_off] += alpha[f];
+                            C_ii += V * csubl - d->A[f] * udotm[f] - alpha[f];
+                            C_lat[f] += alpha[f];
                         }
                         else // missing neighbour case
                         {
                             // no mass in
-//                            elements[ idx_idx_off ] += V*csubl-d->A[f]*udotm[f]-alpha[f];
+//                            C_ii += V*csubl-d->A[f]*udotm[f]-alpha[f];
 
                             // allow mass into the domain from ghost cell
-                            elements[idx_idx_off] += -0.1e-1 * alpha[f] - 1. * d->A[f] * udotm[f] + csubl * V;
+                            C_ii += -0.1e-1 * alpha[f] - 1. * d->A[f] * udotm[f] + csubl * V;
                         }
                     }
                     else
                     {
                         if (d->face_neigh[f])
                         {
-                            size_t nidx = ntri * z + face->neighbor(f)->cell_local_id;
-
-                            size_t idx_nidx_off = offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, nidx);
-
-                            elements[idx_idx_off] += V * csubl - alpha[f];
-                            elements[idx_nidx_off] += -d->A[f] * udotm[f] + alpha[f];
+                            C_ii += V * csubl - alpha[f];
+                            C_lat[f] += -d->A[f] * udotm[f] + alpha[f];
                         }
                         else
                         {
                             // No mass in
-//                            elements[ idx_idx_off ] +=  V*csubl-alpha[f];
+//                            C_ii +=  V*csubl-alpha[f];
 
                             // allow mass in
-                            elements[idx_idx_off] += -0.1e-1 * alpha[f] - .99 * d->A[f] * udotm[f] + csubl * V;
+                            C_ii += -0.1e-1 * alpha[f] - .99 * d->A[f] * udotm[f] + csubl * V;
                         }
                     }
                 }
@@ -1350,26 +1603,22 @@ void PBSM3D::run(mesh& domain)
                     double alpha4 = d->A[4] * K[4] / (hs / 2.0 + v_edge_height / 2.0);
 
                     // bottom face, only turbulent diffusion
-                    //              elements[idx_idx_off] += V * csubl - alpha4;
+                    //              C_ii += V * csubl - alpha4;
 
                     // includes advection term
-                    elements[idx_idx_off] += V * csubl - d->A[4] * udotm[4] - alpha4;
+                    C_ii += V * csubl - d->A[4] * udotm[4] - alpha4;
 
                     b[idx] += -alpha4 * c_salt;
 
-                    // ntri * (z + 1) + face->cell_local_id
-                    size_t idx_nidx_off =
-                        offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, ntri * (z + 1) + face->cell_local_id);
-
                     if (udotm[3] > 0)
                     {
-                        elements[idx_idx_off] += V * csubl - d->A[3] * udotm[3] - alpha[3];
-                        elements[idx_nidx_off] += alpha[3];
+                        C_ii += V * csubl - d->A[3] * udotm[3] - alpha[3];
+                        C_up += alpha[3];
                     }
                     else
                     {
-                        elements[idx_idx_off] += V * csubl - alpha[3];
-                        elements[idx_nidx_off] += -d->A[3] * udotm[3] + alpha[3];
+                        C_ii += V * csubl - alpha[3];
+                        C_up += -d->A[3] * udotm[3] + alpha[3];
                     }
                 }
                 else if (z == nLayer - 1) // top z layer
@@ -1382,58 +1631,76 @@ void PBSM3D::run(mesh& domain)
 
                     if (udotm[3] > 0)
                     {
-                        elements[idx_idx_off] += V * csubl - d->A[3] * udotm[3] - alpha[3];
+                        C_ii += V * csubl - d->A[3] * udotm[3] - alpha[3];
                         b[idx] += -alpha[3] * cprecip;
                     }
                     else
                     {
-                        elements[idx_idx_off] += V * csubl - alpha[3];
+                        C_ii += V * csubl - alpha[3];
                         b[idx] += d->A[3] * cprecip * udotm[3] - alpha[3] * cprecip;
                     }
 
-                    // ntri * (z - 1) + face->cell_local_id
-                    size_t idx_nidx_off =
-                        offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, ntri * (z - 1) + face->cell_local_id);
                     if (udotm[4] > 0)
                     {
-                        elements[idx_idx_off] += V * csubl - d->A[4] * udotm[4] - alpha[4];
-                        elements[idx_nidx_off] += alpha[4];
+                        C_ii += V * csubl - d->A[4] * udotm[4] - alpha[4];
+                        C_down += alpha[4];
                     }
                     else
                     {
-                        elements[idx_idx_off] += V * csubl - alpha[4];
-                        elements[idx_nidx_off] += -d->A[4] * udotm[4] + alpha[4];
+                        C_ii += V * csubl - alpha[4];
+                        C_down += -d->A[4] * udotm[4] + alpha[4];
                     }
                 }
                 else // middle layers
                 {
-                    // ntri * (z + 1) + face->cell_local_id
-                    size_t idx_nidx_off =
-                        offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, ntri * (z + 1) + face->cell_local_id);
-
                     if (udotm[3] > 0)
                     {
-                        elements[idx_idx_off] += V * csubl - d->A[3] * udotm[3] - alpha[3];
-                        elements[idx_nidx_off] += alpha[3];
+                        C_ii += V * csubl - d->A[3] * udotm[3] - alpha[3];
+                        C_up += alpha[3];
                     }
                     else
                     {
-                        elements[idx_idx_off] += V * csubl - alpha[3];
-                        elements[idx_nidx_off] += -d->A[3] * udotm[3] + alpha[3];
+                        C_ii += V * csubl - alpha[3];
+                        C_up += -d->A[3] * udotm[3] + alpha[3];
                     }
 
-                    idx_nidx_off =
-                        offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, ntri * (z - 1) + face->cell_local_id);
                     if (udotm[4] > 0)
                     {
-                        elements[idx_idx_off] += V * csubl - d->A[4] * udotm[4] - alpha[4];
-                        elements[idx_nidx_off] += alpha[4];
+                        C_ii += V * csubl - d->A[4] * udotm[4] - alpha[4];
+                        C_down += alpha[4];
                     }
                     else
                     {
-                        elements[idx_idx_off] += V * csubl - alpha[4];
-                        elements[idx_nidx_off] += -d->A[4] * udotm[4] + alpha[4];
+                        C_ii += V * csubl - alpha[4];
+                        C_down += -d->A[4] * udotm[4] + alpha[4];
+                    }
+                }
+
+                if (use_line_solver)
+                {
+                    susp_op.diag(id, z) = C_ii;
+                    susp_op.up(id, z) = C_up;
+                    susp_op.down(id, z) = C_down;
+                    for (int f = 0; f < 3; f++)
+                        susp_op.lateral(id, z, f) = C_lat[f];
+                }
+                else
+                {
+                    elements[offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, idx)] += C_ii;
+
+                    for (int f = 0; f < 3; f++)
+                    {
+                        if (d->face_neigh[f])
+                        {
+                            size_t nidx = ntri * z + face->neighbor(f)->cell_local_id;
+                            elements[offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, nidx)] += C_lat[f];
+                        }
                     }
+
+                    if (z < nLayer - 1)
+                        elements[offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, ntri * (z + 1) + id)] += C_up;
+                    if (z > 0)
+                        elements[offset(row_buffer[idx], row_buffer[idx + 1], col_buffer, ntri * (z - 1) + id)] += C_down;
                 }
 
 		// Set flag if RHS component is non-zero
@@ -1452,52 +1719,65 @@ void PBSM3D::run(mesh& domain)
 
 if (suspension_present) {
 
-    // setup the compressed matrix on the compute device, if available
-#ifdef VIENNACL_WITH_OPENCL
-    viennacl::context gpu_ctx(viennacl::OPENCL_MEMORY);
-    vl_C.switch_memory_context(gpu_ctx);
-    b.switch_memory_context(gpu_ctx);
-#endif
-
-    // This solves the steady-state suspension layer concentration
+    if (use_active_region)
+    {
+        std::vector<vcl_scalar_type> rhs(ntri * nLayer);
+        viennacl::copy(b, rhs);
 
-    // configuration of preconditioner:
-    viennacl::linalg::ilut_tag ilut_config(20,1e-4); // defaults: 20 entries/row, 1e-4 drop tol
-    viennacl::linalg::ilut_precond<viennacl::compressed_matrix<vcl_scalar_type>> ilut(
-        vl_C, ilut_config);
+        // faces with any suspension source
+        std::vector<char> seed(ntri, 0);
+#pragma omp parallel for
+        for (size_t i = 0; i < ntri; i++)
+        {
+            for (int z = 0; z < nLayer; ++z)
+            {
+                if (std::fabs(rhs[ntri * z + i]) > suspension_present_threshold)
+                    seed[i] = 1;
+            }
+        }
 
-    // Set up convergence tolerance to have an average value for each unknown
-    double suspension_gmres_tol = 1e-8;
-    // Set max iterations and maximum Krylov dimension before restart
-    size_t suspension_gmres_max_iterations = 1000;
-    size_t suspension_gmres_krylov_dimension = 30;
+        auto region = active_region(domain, seed, active_region_halo);
+        LOG_DEBUG << "  Suspension active region: " << region.size() << " of " << ntri << " faces";
 
-    // compute result and copy back to CPU device (if an accelerator was used),
-    // otherwise access is slow
-    viennacl::linalg::gmres_tag suspension_custom_gmres(suspension_gmres_tol, suspension_gmres_max_iterations,
-                                                        suspension_gmres_krylov_dimension);
-    viennacl::vector<vcl_scalar_type> vl_x = viennacl::linalg::solve(vl_C, b, suspension_custom_gmres, ilut);
-    viennacl::copy(vl_x, x);
+        if (use_line_solver)
+        {
+            if (!region.empty())
+            {
+                auto sub_op = susp_op.restrict_to(region);
+                std::vector<double> sub_b(sub_op.size());
+                for (size_t k = 0; k < region.size(); k++)
+                {
+                    for (int z = 0; z < nLayer; ++z)
+                        sub_b[region.size() * z + k] = rhs[ntri * z + region[k]];
+                }
 
-    // Log final state of the linear solve
-    LOG_DEBUG << "  Suspension_GMRES # of iterations: " << suspension_custom_gmres.iters();
-    LOG_DEBUG << "  Suspension_GMRES final residual : " << suspension_custom_gmres.error();
+                std::vector<vcl_scalar_type> sub_x;
+                solve_suspension_line(sub_op, sub_b, sub_x);
 
-    /*
-      Dump matrix to ASCII file
-    */
-    //    ofstream ofile;
-    //    ofile.open("C.out");
-    //    ofile << std::setprecision(12) << vl_C;
-    //    ofile.close();
-    //
-    //    ofile.open("b.out");
-    //    ofile << std::setprecision(12) << b;
-    //    ofile.close();
-    //
-    //    ofile.open("x.out");
-    //    ofile << std::setprecision(12) << vl_x;
-    //    ofile.close();
+#pragma omp parallel for
+                for (size_t k = 0; k < region.size(); k++)
+                {
+                    for (int z = 0; z < nLayer; ++z)
+                        x[ntri * z + region[k]] = sub_x[region.size() * z + k];
+                }
+            }
+        }
+        else
+        {
+            solve_active_region(vl_C, rhs, region, nLayer, region_pos, &PBSM3D::solve_suspension, x);
+        }
+    }
+    else if (use_line_solver)
+    {
+        std::vector<vcl_scalar_type> b_host(ntri * nLayer);
+        viennacl::copy(b, b_host);
+        std::vector<double> rhs(b_host.begin(), b_host.end());
+        solve_suspension_line(susp_op, rhs, x);
+    }
+    else
+    {
+        solve_suspension(vl_C, b, x);
+    }
 
     // Now we have the concentration, compute the suspension flux
  } else {
@@ -1648,43 +1928,26 @@ if (suspension_present) {
 
     if (saltation_present) {
 
-// setup the compressed matrix on the compute device, if available
-#ifdef VIENNACL_WITH_OPENCL
-    //    viennacl::context gpu_ctx(viennacl::OPENCL_MEMORY);  <--- already
-    //    defined above
-    vl_A.switch_memory_context(gpu_ctx);
-    bb.switch_memory_context(gpu_ctx);
-#endif
-
-//     Solve the deposition flux --> how much drifting there is.
-
-//     configuration of preconditioner:
-    viennacl::linalg::chow_patel_tag deposition_flux_chow_patel_config;
-    deposition_flux_chow_patel_config.sweeps(3);       //  nonlinear sweeps
-    deposition_flux_chow_patel_config.jacobi_iters(2); //  Jacobi iterations per triangular 'solve' Rx=r
-    viennacl::linalg::chow_patel_icc_precond<viennacl::compressed_matrix<vcl_scalar_type>>
-        deposition_flux_chow_patel_icc(vl_A, deposition_flux_chow_patel_config);
-
-    // Set up convergence tolerance to have an average value for each unknown
-    double deposition_flux_cg_tol = 1e-8;
-    // Set max iterations and maximum Krylov dimension before restart
-    size_t deposition_flux_cg_max_iterations = 500;
+    if (use_active_region)
+    {
+        std::vector<vcl_scalar_type> rhs(ntri);
+        viennacl::copy(bb, rhs);
 
-    // compute result and copy back to CPU device (if an accelerator was used),
-    // otherwise access is slow
-    viennacl::linalg::cg_tag deposition_flux_custom_cg(deposition_flux_cg_tol, deposition_flux_cg_max_iterations);
+        // faces with a net transport flux
+        std::vector<char> seed(ntri, 0);
+#pragma omp parallel for
+        for (size_t i = 0; i < ntri; i++)
+            seed[i] = std::fabs(rhs[i]) > saltation_present_threshold;
 
-    // compute result and copy back to CPU device (if an accelerator was used),
-    // otherwise access is slow
-    viennacl::vector<vcl_scalar_type> vl_dSdt =
-        viennacl::linalg::solve(vl_A, bb, deposition_flux_custom_cg, deposition_flux_chow_patel_icc);
-    // viennacl::vector<vcl_scalar_type> vl_dSdt = viennacl::linalg::solve(vl_A,
-    // bb, deposition_flux_custom_cg);
-    viennacl::copy(vl_dSdt, dSdt);
+        auto region = active_region(domain, seed, active_region_halo);
+        LOG_DEBUG << "  Drift active region: " << region.size() << " of " << ntri << " faces";
 
-    // Log final state of the linear solve
-    LOG_DEBUG << "  deposition_flux_CG # of iterations: " << deposition_flux_custom_cg.iters();
-    LOG_DEBUG << "  deposition_flux_CG final residual : " << deposition_flux_custom_cg.error();
+        solve_active_region(vl_A, rhs, region, 1, region_pos, &PBSM3D::solve_drift, dSdt);
+    }
+    else
+    {
+        solve_drift(vl_A, bb, dSdt);
+    }
 
     } // if saltation_present
     else {
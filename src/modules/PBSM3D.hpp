@@ -29,6 +29,7 @@
 #include "interpolation.hpp"
 
 #include "math/coordinates.hpp"
+#include "math/column_operator.hpp"
 
 #include <physics/PhysConst.h>
 #include "physics/Atmosphere.h"
@@ -129,6 +130,11 @@ public:
     double N; //vegetation number density
     double dv; //stalk diameter
 
+    // Solve the suspension layer matrix-free with vertical line preconditioned GMRES, instead of as a
+    // compressed_matrix with ILUT and GMRES
+    bool use_line_solver;
+    math::column_operator susp_op;
+
     // this is the suspension transport matrix
     double nnz; //number none zero
     viennacl::compressed_matrix<vcl_scalar_type>  vl_C;
@@ -139,6 +145,11 @@ public:
     viennacl::compressed_matrix<vcl_scalar_type>  vl_A;
     viennacl::vector<vcl_scalar_type> bb;
 
+    // Solve the suspension and drift systems only over the faces with a non-zero RHS plus active_region_halo rings
+    // of neighbours. Faces outside this region have zero concentration and deposition flux
+    bool use_active_region;
+    size_t active_region_halo;
+
     bool debug_output;
     double cutoff; // cutoff veg-snow diff (m) that we inhibit saltation entirely
     // don't allow transport if below this threshold.
@@ -192,8 +203,39 @@ public:
        // struct my_fill_topo_params params = { 1.1, 0.3, 0.6 , 0.4};
     };
 
+    typedef void (*system_solver)(viennacl::compressed_matrix<vcl_scalar_type>&, viennacl::vector<vcl_scalar_type>&,
+                                  std::vector<vcl_scalar_type>&);
+
+    // The seeded faces plus halo rings of their neighbours, not crossing ghost faces, as local ids in ascending order
+    static std::vector<unsigned int> active_region(mesh& domain, const std::vector<char>& seed, size_t halo);
+
+    // Restricts the rows and columns of the nlayer-layer system M x = rhs to the unknowns of the region's faces.
+    // region_pos is scratch holding -1 for each face, and is left that way
+    static void restrict_system(viennacl::compressed_matrix<vcl_scalar_type>& M, const std::vector<vcl_scalar_type>& rhs,
+                                const std::vector<unsigned int>& region, size_t nlayer, std::vector<int>& region_pos,
+                                viennacl::compressed_matrix<vcl_scalar_type>& sub_M,
+                                viennacl::vector<vcl_scalar_type>& sub_rhs);
+
+    // Solves the nlayer-layer system M x = rhs with solver over the region's faces only. x is zero outside the region,
+    // and everywhere if the region is empty
+    static void solve_active_region(viennacl::compressed_matrix<vcl_scalar_type>& M,
+                                    const std::vector<vcl_scalar_type>& rhs, const std::vector<unsigned int>& region,
+                                    size_t nlayer, std::vector<int>& region_pos, system_solver solver,
+                                    std::vector<vcl_scalar_type>& x);
+
+    static void solve_suspension(viennacl::compressed_matrix<vcl_scalar_type>& C, viennacl::vector<vcl_scalar_type>& rhs,
+                                 std::vector<vcl_scalar_type>& x);
+    static void solve_drift(viennacl::compressed_matrix<vcl_scalar_type>& A, viennacl::vector<vcl_scalar_type>& rhs,
+                            std::vector<vcl_scalar_type>& x);
+
 private:
 
+  void solve_suspension_line(math::column_operator& op, const std::vector<double>& rhs,
+                             std::vector<vcl_scalar_type>& x);
+
+  // position of each face in the current active region, -1 if it is outside
+  std::vector<int> region_pos;
+
   // For detecting if there is suspension and/or saltation
   bool suspension_present, saltation_present;
   constexpr static double suspension_present_threshold=1e-12;
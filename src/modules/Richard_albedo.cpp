@@ -62,6 +62,21 @@ void Richard_albedo::load_checkpoint(mesh& domain,  netcdf& chkpt)
     }
 }
 
+bool Richard_albedo::migrates()
+{
+    return true;
+}
+
+void Richard_albedo::pack_face(mesh_elem& face, std::vector<double>& buf)
+{
+    buf.push_back(face->get_module_data<Richard_albedo::data>(ID)->albedo);
+}
+
+void Richard_albedo::unpack_face(mesh_elem& face, const double*& buf)
+{
+    face->make_module_data<Richard_albedo::data>(ID)->albedo = *buf++;
+}
+
 void Richard_albedo::run(mesh_elem &face)
 {
     if(is_water(face))
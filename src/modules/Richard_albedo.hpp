@@ -49,6 +49,10 @@ public:
     void checkpoint(mesh& domain,  netcdf& chkpt);
     void load_checkpoint(mesh& domain,  netcdf& chkpt);
 
+    bool migrates();
+    void pack_face(mesh_elem& face, std::vector<double>& buf);
+    void unpack_face(mesh_elem& face, const double*& buf);
+
     double amin;
     double amax;
     double a1;
@@ -22,8 +22,44 @@
 //
 
 #include "Simple_Canopy.hpp"
+#include "lookup_table.hpp"
 REGISTER_MODULE_CPP(Simple_Canopy);
 
+namespace
+{
+    // Saturation vapour pressures (Pa) over ice of air temperature (C), as the sublimation and the canopy snow
+    // temperature use them. Tabulated as Atmosphere::saturatedVapourPressure is, to 1e-6 (relative)
+    double ice_vapour_pressure_exact(double ta)
+    {
+        return 611.15 * exp(22.452 * ta / (ta + 273.0));
+    }
+
+    double ice_vapour_pressure(double ta)
+    {
+        static const math::lookup_table_1d table(ice_vapour_pressure_exact, -100., 100., 1e-6);
+
+        if (table.in_range(ta))
+            return table(ta);
+
+        return ice_vapour_pressure_exact(ta);
+    }
+
+    double Qs_vapour_pressure_exact(double ta)
+    {
+        return 611.213 * exp(22.4422 * ta / (272.186 + ta));
+    }
+
+    double Qs_vapour_pressure(double ta)
+    {
+        static const math::lookup_table_1d table(Qs_vapour_pressure_exact, -100., 100., 1e-6);
+
+        if (table.in_range(ta))
+            return table(ta);
+
+        return Qs_vapour_pressure_exact(ta);
+    }
+}
+
 Simple_Canopy::Simple_Canopy(config_file cfg)
         : module_base("Simple_Canopy", parallel::data, cfg)
 {
@@ -370,7 +406,7 @@ void Simple_Canopy::run(mesh_elem &face)
 
                 double Alpha, A1, B1, C1, J, D, Lamb, Mpm, Nu, Nr, SStar, Sigma2;
 
-                double Es = 611.15 * exp(22.452 * ta / (ta + 273.0));  // {sat pressure}
+                double Es = ice_vapour_pressure(ta);  // {sat pressure}
 
                 double SvDens = Es * PhysConst::M / (PhysConst::R * (ta + 273.0)); // {sat density}
 
@@ -610,6 +646,33 @@ void Simple_Canopy::init(mesh& domain)
 
 }
 
+bool Simple_Canopy::migrates()
+{
+    return true;
+}
+
+void Simple_Canopy::pack_face(mesh_elem& face, std::vector<double>& buf)
+{
+    auto d = face->get_module_data<Simple_Canopy::data>(ID);
+    buf.insert(buf.end(), {d->LAI, d->CanopyHeight, double(d->canopyType), d->rain_load, d->Snow_load,
+                           d->cum_net_snow, d->cum_net_rain, d->cum_Subl_Cpy, d->cum_intcp_evap, d->cum_SUnload_H2O});
+}
+
+void Simple_Canopy::unpack_face(mesh_elem& face, const double*& buf)
+{
+    auto d = face->make_module_data<Simple_Canopy::data>(ID);
+    d->LAI = *buf++;
+    d->CanopyHeight = *buf++;
+    d->canopyType = static_cast<int>(*buf++);
+    d->rain_load = *buf++;
+    d->Snow_load = *buf++;
+    d->cum_net_snow = *buf++;
+    d->cum_net_rain = *buf++;
+    d->cum_Subl_Cpy = *buf++;
+    d->cum_intcp_evap = *buf++;
+    d->cum_SUnload_H2O = *buf++;
+}
+
 double Simple_Canopy::delta(double ta) // Slope of sat vap p vs t, kPa/°C
 {
     if (ta > 0.0)
@@ -636,6 +699,6 @@ double Simple_Canopy::Qs(double air_pressure, double T1) {
     Qs              - Saturated mixing ratio (kg/kg)
      */
     T1 = T1 - mio::Cst::t_water_freezing_pt; // K to C
-    double es = 611.213*exp(22.4422*T1/(272.186+T1)); // Pa
+    double es = Qs_vapour_pressure(T1); // Pa
     return(0.622 * ( es / (air_pressure - es) )); // kg/kg
 }
@@ -49,6 +49,9 @@ public:
     virtual void run(mesh_elem &elem);
 
     virtual void init(mesh& domain);
+    virtual bool migrates();
+    virtual void pack_face(mesh_elem& face, std::vector<double>& buf);
+    virtual void unpack_face(mesh_elem& face, const double*& buf);
 
     double delta(double ta);
 
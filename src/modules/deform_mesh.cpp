@@ -37,6 +37,7 @@ deform_mesh::~deform_mesh()
 
 void deform_mesh::run(mesh& domain)
 {
+    std::vector<char> moved(domain->size_vertex(), 0);
 
 #pragma omp parallel for
     for (size_t i = 0; i < domain->size_vertex(); i++)
@@ -50,6 +51,7 @@ void deform_mesh::run(mesh& domain)
 	       if(z > domain->min_z())
 	       {
 		   z -= (z-domain->min_z()) * 0.25;
+		   moved[i] = 1;
 	       }
 
 	       p = Point_3(vert->point().x(), vert->point().y(), z);
@@ -57,6 +59,15 @@ void deform_mesh::run(mesh& domain)
 
     }
 
+    std::vector<size_t> vertices;
+    for (size_t i = 0; i < moved.size(); i++)
+    {
+        if (moved[i])
+            vertices.push_back(i);
+    }
+
+    // the faces' slope, aspect, etc. have changed
+    domain->update_geometry(vertices);
 
     domain->_terrain_deformed = true;
 }
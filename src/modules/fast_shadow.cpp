@@ -39,6 +39,9 @@ fast_shadow::fast_shadow(config_file cfg)
 
     //size of the step to take
     size_of_step = max_distance / steps;
+
+    for (int j = 1; j <= steps; ++j)
+        distances.push_back(j * size_of_step);
 }
 
 fast_shadow::~fast_shadow()
@@ -48,6 +51,15 @@ fast_shadow::~fast_shadow()
 }
 
 void fast_shadow::run(mesh_elem& face)
+{
+    if (global_param->is_geographic())
+        shadow<math::gis::LatLong>(face);
+    else
+        shadow<math::gis::UTM>(face);
+}
+
+template<typename Geo>
+void fast_shadow::shadow(mesh_elem& face)
 {
 
     double solar_el = (*face)["solar_el"_s] *M_PI / 180.;
@@ -61,19 +73,30 @@ void fast_shadow::run(mesh_elem& face)
 
     Point_3 me = face->center();
 
+    // faces along the ray, and their distance, reused by each thread from face to face
+    thread_local std::vector<mesh_elem> f;
+    thread_local std::vector<double> x, y, dist;
+    f.resize(steps);
+    x.resize(steps);
+    y.resize(steps);
+    dist.resize(steps);
+
+    face->find_closest_faces<Geo>(solar_az, distances.data(), steps, f.data());
+    for (int j = 0; j < steps; ++j)
+    {
+        x[j] = f[j]->center().x();
+        y[j] = f[j]->center().y();
+    }
+    Geo::distance(me, x.data(), y.data(), dist.data(), steps);
+
     double phi = 0.;
     // search along each azimuth in j step increments to find horizon angle
-    for (int j = 1; j <= steps; ++j)
+    for (int j = 0; j < steps; ++j)
     {
-        double distance = j * size_of_step;
-
-        auto f = face->find_closest_face(solar_az, distance);
-
-        double z_diff = f->center().z() - me.z() ;
+        double z_diff = f[j]->center().z() - me.z() ;
         if (z_diff > 0)
         {
-            double dist = math::gis::distance(f->center(), me);
-            phi = std::max(atan(z_diff / dist), phi);
+            phi = std::max(atan(z_diff / dist[j]), phi);
         }
         //try to bail early if possible
         if (phi > solar_el )
@@ -42,6 +42,10 @@ public:
 
     virtual void run(mesh_elem& face);
 
+    // run for meshes with geometry Geo, math::gis::UTM or math::gis::LatLong
+    template<typename Geo>
+    void shadow(mesh_elem& face);
+
 //number of steps along the search vector to check for a higher point
     int steps;
     //max distance to search
@@ -50,4 +54,7 @@ public:
     //size of the step to take
     double size_of_step;
 
+    // distance of each step
+    std::vector<double> distances;
+
 };
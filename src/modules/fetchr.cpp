@@ -55,6 +55,15 @@ fetchr::~fetchr()
 }
 
 void fetchr::run(mesh_elem& face)
+{
+    if (global_param->is_geographic())
+        fetch<math::gis::LatLong>(face);
+    else
+        fetch<math::gis::UTM>(face);
+}
+
+template<typename Geo>
+void fetchr::fetch(mesh_elem& face)
 {
 
 
@@ -81,7 +90,7 @@ void fetchr::run(mesh_elem& face)
     {
         double distance = j * size_of_step;
 
-        auto f = face->find_closest_face(wind_dir, distance);
+        auto f = face->find_closest_face<Geo>(wind_dir, distance);
 
         double Z_CanTop = 0;
         if (incl_veg && f->has_vegetation())
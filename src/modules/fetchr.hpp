@@ -42,6 +42,10 @@ public:
 
     virtual void run(mesh_elem& face);
 
+    // run for meshes with geometry Geo, math::gis::UTM or math::gis::LatLong
+    template<typename Geo>
+    void fetch(mesh_elem& face);
+
 //number of steps along the search vector to check for a higher point
     int steps;
     //max distance to search
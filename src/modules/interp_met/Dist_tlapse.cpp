@@ -53,6 +53,17 @@ void Dist_tlapse::init(mesh& domain)
     }
 
 }
+
+bool Dist_tlapse::migrates()
+{
+    return true;
+}
+
+void Dist_tlapse::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void Dist_tlapse::run(mesh_elem& face)
 {
     // Distributed forcing lapse_rate to each face (changes per time step)
@@ -66,11 +77,12 @@ void Dist_tlapse::run(mesh_elem& face)
 
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_t = global_param->station_data()->get("t"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["t"_s]))
+        if( is_nan(station_t[s]))
             continue;
-        double v = (*s)["t"_s] - lapse_rate * (0.0 - s->z());
+        double v = station_t[s] - lapse_rate * (0.0 - s->z());
         lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
     }
 
@@ -50,6 +50,17 @@ void Dodson_NSA_ta::init(mesh& domain)
     }
 
 }
+
+bool Dodson_NSA_ta::migrates()
+{
+    return true;
+}
+
+void Dodson_NSA_ta::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void Dodson_NSA_ta::run(mesh_elem &face)
 {
 
@@ -65,15 +76,16 @@ void Dodson_NSA_ta::run(mesh_elem &face)
     std::vector< boost::tuple<double, double, double> > lowered_values;
 
 
+    auto station_t = global_param->station_data()->get("t"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["t"_s]))
+        if( is_nan(station_t[s]))
             continue;
 
         double elev = s->z(); //station elevation
         //pressure at station's elevation
         double Pz = Po * pow(Tb/(Tb+lapse*elev),(m*g)/(lapse*R));
-        double ta = (*s)["t"_s] + 273.15; //to K
+        double ta = station_t[s] + 273.15; //to K
 
         //calculate virtual temp (eqn 1)
         double ratio = (Po/Pz);
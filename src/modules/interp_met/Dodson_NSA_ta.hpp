@@ -38,6 +38,8 @@ public:
     ~Dodson_NSA_ta();
     void run(mesh_elem &face);
     virtual void init(mesh& domain);
+    virtual bool migrates();
+    virtual void unpack_face(mesh_elem& face, const double*& buf);
     struct data : public face_info
     {
         interpolation interp;
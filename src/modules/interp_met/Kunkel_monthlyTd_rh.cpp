@@ -56,6 +56,17 @@ void Kunkel_monthlyTd_rh::init(mesh& domain)
     }
 
 }
+
+bool Kunkel_monthlyTd_rh::migrates()
+{
+    return true;
+}
+
+void Kunkel_monthlyTd_rh::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void Kunkel_monthlyTd_rh::run(mesh_elem& face)
 {
 //    size_t ID = face->_debug_ID;
@@ -83,13 +94,15 @@ void Kunkel_monthlyTd_rh::run(mesh_elem& face)
 
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_t = global_param->station_data()->get("t"_s);
+    auto station_rh = global_param->station_data()->get("rh"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["t"_s]) || is_nan((*s)["rh"_s]))
+        if( is_nan(station_t[s]) || is_nan(station_rh[s]))
             continue;
 
-        double t = (*s)["t"_s]+273.15;
-        double rh = (*s)["rh"_s]/100.;
+        double t = station_t[s]+273.15;
+        double rh = station_rh[s]/100.;
 
         double Tdz0 = mio::Atmosphere::RhtoDewPoint(rh,t,false) - 273.15; // K
 
@@ -62,6 +62,8 @@ public:
     ~Kunkel_monthlyTd_rh();
     virtual void run(mesh_elem& face);
     virtual void init(mesh& domain);
+    virtual bool migrates();
+    virtual void unpack_face(mesh_elem& face, const double*& buf);
     struct data : public face_info
     {
         interpolation interp;
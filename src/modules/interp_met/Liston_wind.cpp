@@ -60,13 +60,29 @@ void Liston_wind::init(mesh& domain)
 	       auto face = domain->face(i);
 	       auto d = face->make_module_data<lwinddata>(ID);
 	       d->interp.init(global_param->interp_algorithm,face->stations().size() );
-	       d->interp_smoothing.init(interp_alg::tpspline,3,{ {"reuse_LU","true"}});
 
 	       face->coloured = false;
 
     }
 
 
+    // the curvature only depends on the terrain, so an earlier run on this mesh may have already stored it
+    std::vector<double> curvature;
+    pt::ptree curvature_cfg;
+    curvature_cfg.put("distance", distance);
+
+    if (global_param->artifacts().load(ID, "curvature", curvature_cfg, curvature, domain->size_faces()))
+    {
+        #pragma omp parallel for
+        for (size_t i = 0; i < domain->size_faces(); i++)
+        {
+            auto face = domain->face(i);
+            face->get_module_data<lwinddata>(ID)->curvature = curvature[i];
+            face->parameter("Liston_curvature"_s) = curvature[i];
+        }
+        return;
+    }
+
     double curmax = -9999.0;
 
     #pragma omp parallel for
@@ -147,6 +163,12 @@ void Liston_wind::init(mesh& domain)
 
     }
 
+    curvature.resize(domain->size_faces());
+    for (size_t i = 0; i < domain->size_faces(); i++)
+        curvature[i] = domain->face(i)->get_module_data<lwinddata>(ID)->curvature;
+
+    global_param->artifacts().save(ID, "curvature", curvature_cfg, curvature);
+
 
 
 //    if ( cfg.get("serialize",false) )
@@ -158,6 +180,23 @@ void Liston_wind::init(mesh& domain)
 
 }
 
+bool Liston_wind::migrates()
+{
+    return true;
+}
+
+void Liston_wind::pack_face(mesh_elem& face, std::vector<double>& buf)
+{
+    // corrected_theta and W are recomputed every timestep
+    buf.push_back(face->get_module_data<lwinddata>(ID)->curvature);
+}
+
+void Liston_wind::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<lwinddata>(face);
+    face->get_module_data<lwinddata>(ID)->curvature = *buf++;
+    face->coloured = false;
+}
 
 void Liston_wind::run(mesh& domain)
 {
@@ -166,6 +205,9 @@ void Liston_wind::run(mesh& domain)
     // omega_s needs to be scaled on [-0.5,0.5]
     double max_omega_s = -99999.0;
 
+    auto U_R = global_param->station_data()->get("U_R"_s);
+    auto vw_dir = global_param->station_data()->get("vw_dir"_s);
+
     #pragma omp parallel for
     for (size_t i = 0; i < domain->size_faces(); i++)
     {
@@ -176,14 +218,14 @@ void Liston_wind::run(mesh& domain)
 	       std::vector<boost::tuple<double, double, double> > v;
 	       for (auto &s : face->stations())
 	       {
-		   if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
+		   if (is_nan(U_R[s]) || is_nan(vw_dir[s]))
 		     continue;
 
-		   double W = (*s)["U_R"_s];
+		   double W = U_R[s];
 		   W = std::max(W, 0.1);
 
-		   double theta = (*s)["vw_dir"_s] * M_PI / 180.;
-		   double phi = math::gis::bearing_to_polar((*s)["vw_dir"_s] );
+		   double theta = vw_dir[s] * M_PI / 180.;
+		   double phi = math::gis::bearing_to_polar(vw_dir[s]);
 
 		   double zonal_u = -W * sin(theta);//negate as it needs to be the direction the wind is *going*
 		   double zonal_v = -W * cos(theta);
@@ -322,39 +364,20 @@ void Liston_wind::run(mesh& domain)
 //    std::vector<vcl_scalar_type> x(vl_x.size());
 //    viennacl::copy(vl_x,x);
 
-#pragma omp parallel for
-    for (size_t i = 0; i < domain->size_faces(); i++)
-    {
-
-	       auto face = domain->face(i);
-	       std::vector<boost::tuple<double, double, double> > u;
-	       for (size_t j = 0; j < 3; j++)
-	       {
-		   auto neigh = face->neighbor(j);
-		   if (neigh != nullptr && !neigh->_is_ghost)
-		     u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(), (*neigh)["U_R"_s]));
-	       }
-
-	       double new_u = (*face)["U_R"_s];
-	       if(u.size() > 0)
-	       {
-		   auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-		   new_u = face->get_module_data<lwinddata>(ID)->interp_smoothing(u, query);
-	       }
-
-	       face->get_module_data<lwinddata>(ID)->temp_u = new_u;
-
-    }
+    auto& smoothing = domain->operators().smoothing;
 
+    std::vector<double> u(domain->size_faces());
+    std::vector<double> smoothed;
 
 #pragma omp parallel for
     for (size_t i = 0; i < domain->size_faces(); i++)
-    {
+        u[i] = (*domain->face(i))["U_R"_s];
 
-	       auto face = domain->face(i);
-	       (*face)["U_R"_s]=face->get_module_data<lwinddata>(ID)->temp_u;
+    smoothing.apply(u, smoothed);
 
-    }
+#pragma omp parallel for
+    for (size_t i = 0; i < domain->size_faces(); i++)
+        (*domain->face(i))["U_R"_s] = smoothed[i];
 
 }
 
@@ -65,6 +65,9 @@ public:
     ~Liston_wind();
     virtual void run(mesh& domain);
     virtual void init(mesh& domain);
+    virtual bool migrates();
+    virtual void pack_face(mesh_elem& face, std::vector<double>& buf);
+    virtual void unpack_face(mesh_elem& face, const double*& buf);
     double ys;
     double yc;
     class lwinddata : public face_info
@@ -74,8 +77,6 @@ public:
         interpolation interp;
         double corrected_theta;
         double W;
-        double temp_u;
-        interpolation interp_smoothing;
     };
     double distance;
     double Ww_coeff;
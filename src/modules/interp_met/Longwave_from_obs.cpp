@@ -54,6 +54,17 @@ void Longwave_from_obs::init(mesh& domain)
     }
 
 }
+
+bool Longwave_from_obs::migrates()
+{
+    return true;
+}
+
+void Longwave_from_obs::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void Longwave_from_obs::run(mesh_elem& face)
 {
 
@@ -62,11 +73,12 @@ void Longwave_from_obs::run(mesh_elem& face)
 
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_Qli = global_param->station_data()->get("Qli"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["Qli"_s]))
+        if( is_nan(station_Qli[s]))
             continue;
-        double v = (*s)["Qli"_s] - lapse_rate * (0.0 - s->z());
+        double v = station_Qli[s] - lapse_rate * (0.0 - s->z());
         lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
     }
 
@@ -58,6 +58,8 @@ public:
     ~Longwave_from_obs();
     virtual void run(mesh_elem& face);
     virtual void init(mesh& domain);
+    virtual bool migrates();
+    virtual void unpack_face(mesh_elem& face, const double*& buf);
     struct data : public face_info
     {
         interpolation interp;
@@ -62,7 +62,6 @@ void MS_wind::init(mesh& domain)
 
 		 auto d = face->make_module_data<data>(ID);
 		 d->interp.init(global_param->interp_algorithm,face->stations().size() );
-		 d->interp_smoothing.init(interp_alg::tpspline,3,{ {"reuse_LU","true"}});
 
     }
 
@@ -73,6 +72,9 @@ void MS_wind::run(mesh& domain)
 {
 
 
+    auto U_R = global_param->station_data()->get("U_R"_s);
+    auto vw_dir = global_param->station_data()->get("vw_dir"_s);
+
     if(!use_ryan_dir)
     {
         #pragma omp parallel for
@@ -83,12 +85,12 @@ void MS_wind::run(mesh& domain)
 		     std::vector<boost::tuple<double, double, double> > v;
 		     for (auto &s : face->stations())
 		     {
-		       if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
+		       if (is_nan(U_R[s]) || is_nan(vw_dir[s]))
 			 continue;
 
-		       double theta = (*s)["vw_dir"_s] * M_PI / 180.;
+		       double theta = vw_dir[s] * M_PI / 180.;
 
-		       double W = (*s)["U_R"_s];
+		       double W = U_R[s];
 		       W = std::max(W, 0.1);
 
 		       W = Atmosphere::log_scale_wind(W,
@@ -169,41 +171,7 @@ void MS_wind::run(mesh& domain)
         }
 
 
-        #pragma omp parallel for
-        for (size_t i = 0; i < domain->size_faces(); i++)
-        {
-          auto face = domain->face(i);
-
-          std::vector<boost::tuple<double, double, double>> u;
-          for (size_t j = 0; j < 3; j++)
-          {
-            auto neigh = face->neighbor(j);
-            if (neigh != nullptr && !neigh->_is_ghost)
-              u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(),
-                                            (*neigh)["U_R"_s]));
-          }
-
-          double new_u = (*face)["U_R"_s];
-
-          if (u.size() > 0)
-          {
-            auto query =
-                boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-            new_u = face->get_module_data<data>(ID)->interp_smoothing(u, query);
-          }
-
-          face->get_module_data<data>(ID)->temp_u = new_u;
-        }
-
-
-
-        #pragma omp parallel for
-        for (size_t i = 0; i < domain->size_faces(); i++)
-        {
-            auto face = domain->face(i);
-
-		     (*face)["U_R"_s]= std::max(0.1, face->get_module_data<data>(ID)->temp_u);
-        }
+        smooth_U_R(domain);
 
     }else
     {
@@ -219,10 +187,10 @@ void MS_wind::run(mesh& domain)
              std::vector<boost::tuple<double, double, double> > v;
              for (auto &s : face->stations())
              {
-               if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
+               if (is_nan(U_R[s]) || is_nan(vw_dir[s]))
                  continue;
 
-               double theta = (*s)["vw_dir"_s] * M_PI / 180.;
+               double theta = vw_dir[s] * M_PI / 180.;
 
                auto f = domain->find_closest_face(s->x(),s->y());
                //figure out which lookup map we need
@@ -230,7 +198,7 @@ void MS_wind::run(mesh& domain)
                if (d == 0) d = 8;
                double speedup = f->parameter("MS"+std::to_string(d));
 
-               double W = (*s)["U_R"_s] / speedup;
+               double W = U_R[s] / speedup;
                W = std::max(W, 0.1);
                W = Atmosphere::log_scale_wind(W,
                                               Atmosphere::Z_U_R,  // UR is at our reference height
@@ -339,42 +307,26 @@ void MS_wind::run(mesh& domain)
         }
 
 
-    #pragma omp parallel for
-        for (size_t i = 0; i < domain->size_faces(); i++)
-        {
-
-            auto face = domain->face(i);
-
-		     std::vector<boost::tuple<double, double, double> > u;
-		     for (size_t j = 0; j < 3; j++)
-		     {
-		       auto neigh = face->neighbor(j);
-		       if (neigh != nullptr && !neigh->_is_ghost)
-			 u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(),(*neigh)["U_R"_s]));
-		     }
-
-
-		     double new_u = (*face)["U_R"_s];
-		     if (u.size() > 0)
-		     {
-		       auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-		       new_u = face->get_module_data<data>(ID)->interp_smoothing(u, query);
-		     }
+        smooth_U_R(domain);
+    }
+}
 
-		     face->get_module_data<data>(ID)->temp_u = new_u;
+void MS_wind::smooth_U_R(mesh& domain)
+{
+    auto& smoothing = domain->operators().smoothing;
 
-        }
+    std::vector<double> u(domain->size_faces());
+    std::vector<double> smoothed;
 
     #pragma omp parallel for
-        for (size_t i = 0; i < domain->size_faces(); i++)
-        {
-            auto face = domain->face(i);
-
-		     (*face)["U_R"_s]= std::max(0.1,face->get_module_data<data>(ID)->temp_u) ;
+    for (size_t i = 0; i < domain->size_faces(); i++)
+        u[i] = (*domain->face(i))["U_R"_s];
 
-        }
+    smoothing.apply(u, smoothed);
 
-    }
+    #pragma omp parallel for
+    for (size_t i = 0; i < domain->size_faces(); i++)
+        (*domain->face(i))["U_R"_s] = std::max(0.1, smoothed[i]);
 }
 
 //Old version, uses ryan. Deal with enabling this later, but for now use the version that gets dir off the u,v components of MS
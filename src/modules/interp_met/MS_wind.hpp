@@ -65,6 +65,10 @@ public:
     ~MS_wind();
     virtual void run(mesh& domain);
     virtual void init(mesh& domain);
+
+    // smooths U_R with the mesh's neighbour smoothing operator
+    void smooth_U_R(mesh& domain);
+
     double ys;
     double yc;
     class data : public face_info
@@ -74,8 +78,6 @@ public:
         interpolation interp;
         double corrected_theta;
         double W;
-        double temp_u;
-        interpolation interp_smoothing;
     };
     double distance;
     bool use_ryan_dir;
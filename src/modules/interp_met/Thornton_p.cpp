@@ -53,6 +53,17 @@ void Thornton_p::init(mesh& domain)
     }
 
 }
+
+bool Thornton_p::migrates()
+{
+    return true;
+}
+
+void Thornton_p::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void Thornton_p::run(mesh_elem& face)
 {
     //km^-1
@@ -63,11 +74,12 @@ void Thornton_p::run(mesh_elem& face)
     }
     std::vector< boost::tuple<double, double, double> > ppt;
     std::vector< boost::tuple<double, double, double> > staion_z;
+    auto station_p = global_param->station_data()->get("p"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["p"_s]))
+        if( is_nan(station_p[s]))
             continue;
-        double u = (*s)["p"_s];
+        double u = station_p[s];
         ppt.push_back( boost::make_tuple(s->x(), s->y(), u ) );
         staion_z.push_back( boost::make_tuple(s->x(), s->y(), s->z() ) );
     }
@@ -58,6 +58,17 @@ void Thornton_var_p::init(mesh& domain)
     }
 
 }
+
+bool Thornton_var_p::migrates()
+{
+    return true;
+}
+
+void Thornton_var_p::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void Thornton_var_p::run(mesh_elem& face)
 {
 
@@ -74,11 +85,12 @@ void Thornton_var_p::run(mesh_elem& face)
     //otherwise, just used the stored lapse rate
     if(last_update != global_param->posix_time() )
     {
+        auto station_p = global_param->station_data()->get("p"_s);
         for (auto& s : face->stations())
         {
-            if( is_nan((*s)["p"_s]))
+            if( is_nan(station_p[s]))
                 continue;
-            double u = (*s)["p"_s];
+            double u = station_p[s];
             sp.push_back( u  );
             sz.push_back( s->z());
         }
@@ -125,11 +137,13 @@ void Thornton_var_p::run(mesh_elem& face)
     //now do the full interpolation
     std::vector< boost::tuple<double, double, double> > ppt;
     std::vector< boost::tuple<double, double, double> > station_z;
+    auto station_t = global_param->station_data()->get("t"_s);
+    auto station_p = global_param->station_data()->get("p"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["t"_s]))
+        if( is_nan(station_t[s]))
             continue;
-        double u = (*s)["p"_s];
+        double u = station_p[s];
         ppt.push_back( boost::make_tuple(s->x(), s->y(), u ) );
         station_z.push_back( boost::make_tuple(s->x(), s->y(), s->z() ) );
     }
@@ -84,7 +84,6 @@ void WindNinja::init(mesh& domain)
         auto face = domain->face(i);
         auto d = face->make_module_data<data>(ID);
         d->interp.init(global_param->interp_algorithm,face->stations().size() );
-        d->interp_smoothing.init(interp_alg::tpspline,3,{ {"reuse_LU","true"}});
     }
 
     N_windfield = 0;
@@ -259,14 +258,16 @@ void WindNinja::run(mesh& domain)
 
             std::vector<boost::tuple<double, double, double> > u;
             std::vector<boost::tuple<double, double, double> > v;
+            auto station_U_R = global_param->station_data()->get("U_R"_s);
+            auto station_vw_dir = global_param->station_data()->get("vw_dir"_s);
             for (auto &s : face->stations())
             {
-                if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
+                if (is_nan(station_U_R[s]) || is_nan(station_vw_dir[s]))
                     continue;
 
-                double theta = (*s)["vw_dir"_s] * M_PI / 180.;
+                double theta = station_vw_dir[s] * M_PI / 180.;
 
-                double W = (*s)["U_R"_s];
+                double W = station_U_R[s];
                 W = std::max(W, 0.1);
 
                 W = Atmosphere::log_scale_wind(W,
@@ -469,37 +470,20 @@ void WindNinja::run(mesh& domain)
         }
 
 
+        auto& smoothing = domain->operators().smoothing;
+
+        std::vector<double> u(domain->size_faces());
+        std::vector<double> smoothed;
+
         #pragma omp parallel for
         for (size_t i = 0; i < domain->size_faces(); i++)
-        {
+            u[i] = (*domain->face(i))["U_R"_s];
 
-            auto face = domain->face(i);
-            std::vector<boost::tuple<double, double, double> > u;
-            for (size_t j = 0; j < 3; j++)
-            {
-                auto neigh = face->neighbor(j);
-                if (neigh != nullptr && !neigh->_is_ghost)
-                    u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(),(*neigh)["U_R"_s]));
-            }
+        smoothing.apply(u, smoothed);
 
-            auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-            if(u.size() > 0)
-            {
-                double new_u = face->get_module_data<data>(ID)->interp_smoothing(u, query);
-                face->get_module_data<data>(ID)->temp_u = new_u;
-            }
-            else
-            {
-                face->get_module_data<data>(ID)->temp_u = (*face)["U_R"_s];
-            }
-
-        }
         #pragma omp parallel for
         for (size_t i = 0; i < domain->size_faces(); i++)
-        {
-            auto face = domain->face(i);
-            (*face)["U_R"_s]= std::max(0.1, face->get_module_data<data>(ID)->temp_u);
-        }
+            (*domain->face(i))["U_R"_s] = std::max(0.1, smoothed[i]);
    }
 
 WindNinja::~WindNinja()
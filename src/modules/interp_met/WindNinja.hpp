@@ -75,8 +75,6 @@ public:
         interpolation interp;
         double corrected_theta;
         double W;
-        double temp_u;
-        interpolation interp_smoothing;
         double W_transf;
     };
     double distance;
@@ -43,6 +43,8 @@ Winstral_parameters::Winstral_parameters(config_file cfg)
     //number of steps along the search vector to check for a higher point
     //steps = cfg.get("steps",10);
     steps = dmax / size_of_step;
+    for (int j = 1; j <= steps; ++j)
+        distances.push_back(j * size_of_step);
 
     //height parameter to accound for instrument height or the impact of small terrain perturbation on Sx 
     // see Winstral et al. (2013) for me details
@@ -79,7 +81,7 @@ void Winstral_parameters::run(mesh& domain)
 	     auto face = domain->face(i);
 
 	     // Derive Sx averaged over the angular windows
-	     double sx_mean = Sx(domain,face);
+	     double sx_mean = domain->is_geographic() ? Sx<math::gis::LatLong>(domain,face) : Sx<math::gis::UTM>(domain,face);
 
 	     (*face)["Sx"_s]= sx_mean;
 
@@ -87,6 +89,7 @@ void Winstral_parameters::run(mesh& domain)
 
 }
 
+template<typename Geo>
 double Winstral_parameters::Sx(const mesh &domain, mesh_elem& face) const
 {
     // Reference point: center of the triangle
@@ -109,6 +112,13 @@ double Winstral_parameters::Sx(const mesh &domain, mesh_elem& face) const
     // Extract Wind direction
     double wind_dir = (*face)["vw_dir"_s] ;
 
+    // points along the search line, which is along wind_dir for every angular window.
+    // Scratch space is per thread and only grows, so faces don't allocate
+    thread_local std::vector<double> x, y;
+    x.resize(this->steps);
+    y.resize(this->steps);
+    Geo::point_from_bearing(face_centre, wind_dir, distances.data(), x.data(), y.data(), this->steps);
+
     for (int i = 1; i <= this->nangle; ++i)
     {
 
@@ -121,10 +131,10 @@ double Winstral_parameters::Sx(const mesh &domain, mesh_elem& face) const
        // search along wdir azimuth in j step increments
         for (int j = 1; j <= this->steps; ++j)
         {
-           double distance = j * this->size_of_step;
+           double distance = distances[j - 1];
 
            // Select point along the line
-           Point_2 pref =  math::gis::point_from_bearing(face_centre,wind_dir,distance);
+           Point_2 pref(x[j - 1], y[j - 1]);
            // Find corresponding triangle
            auto f = domain->find_closest_face (pref );
 
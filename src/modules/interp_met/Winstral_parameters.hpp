@@ -100,6 +100,10 @@ public:
     // Improve estimation of Sx when snow is accumulating during the snow season
     bool incl_snw;
 
-    // Calculates the Sx parameter
+    // distance of each search step
+    std::vector<double> distances;
+
+    // Calculates the Sx parameter, Geo is the mesh's geometry (math::gis::UTM or math::gis::LatLong)
+    template<typename Geo>
     double Sx(const mesh &domain, mesh_elem& face) const;
 };
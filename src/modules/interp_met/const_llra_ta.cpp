@@ -54,6 +54,17 @@ void const_llra_ta::init(mesh& domain)
     LOG_DEBUG << "Successfully init module " << this->ID;
 
 }
+
+bool const_llra_ta::migrates()
+{
+    return true;
+}
+
+void const_llra_ta::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void const_llra_ta::run(mesh_elem& face)
 {
 
@@ -62,11 +73,12 @@ void const_llra_ta::run(mesh_elem& face)
 
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_t = global_param->station_data()->get("t"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["t"_s]))
+        if( is_nan(station_t[s]))
             continue;
-        double v = (*s)["t"_s] - lapse_rate * (0.0 - s->z());
+        double v = station_t[s] - lapse_rate * (0.0 - s->z());
         lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
     }
 
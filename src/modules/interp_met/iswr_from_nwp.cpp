@@ -55,6 +55,17 @@ void iswr_from_nwp::init(mesh& domain)
     }
 
 }
+
+bool iswr_from_nwp::migrates()
+{
+    return true;
+}
+
+void iswr_from_nwp::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void iswr_from_nwp::run(mesh_elem &face)
 {
     //interpolate all the measured qsi and qsi_diff from the NWP model
@@ -62,13 +73,15 @@ void iswr_from_nwp::run(mesh_elem &face)
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
     std::vector< boost::tuple<double, double, double> > lowered_values2;
+    auto station_Qsi = global_param->station_data()->get("Qsi"_s);
+    auto station_Qsi_diff = global_param->station_data()->get("Qsi_diff"_s);
     for (auto& s : face->stations())
     {
-        if( (is_nan((*s)["Qsi"_s])) || (is_nan((*s)["Qsi_diff"_s])))
+        if( (is_nan(station_Qsi[s])) || (is_nan(station_Qsi_diff[s])))
             continue;
-        double v = (*s)["Qsi"_s];
+        double v = station_Qsi[s];
         lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
-        double vv = (*s)["Qsi_diff"_s];
+        double vv = station_Qsi_diff[s];
         lowered_values2.push_back( boost::make_tuple(s->x(), s->y(), vv ) );
     }
 
@@ -56,17 +56,29 @@ void iswr_from_obs::init(mesh& domain)
     }
 
 }
+
+bool iswr_from_obs::migrates()
+{
+    return true;
+}
+
+void iswr_from_obs::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void iswr_from_obs::run(mesh_elem &face)
 {
     //interpolate all the measured qsi
 
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_Qsi = global_param->station_data()->get("Qsi"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["Qsi"_s]))
+        if( is_nan(station_Qsi[s]))
             continue;
-        double v = (*s)["Qsi"_s];
+        double v = station_Qsi[s];
         lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
     }
 
@@ -52,6 +52,17 @@ void kunkel_rh::init(mesh& domain)
     }
 
 }
+
+bool kunkel_rh::migrates()
+{
+    return true;
+}
+
+void kunkel_rh::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void kunkel_rh::run(mesh_elem &face)
 {
     // 1/km
@@ -72,11 +83,12 @@ void kunkel_rh::run(mesh_elem &face)
 
     double lapse = lapse_rates[global_param->month() - 1] / 1000.0; // -> 1/m
     std::vector<boost::tuple<double, double, double> > lowered_values;
+    auto station_rh = global_param->station_data()->get("rh"_s);
     for (auto &s : face->stations())
     {
-        if( is_nan((*s)["rh"_s]))
+        if( is_nan(station_rh[s]))
             continue;
-        double rh = (*s)["rh"_s];
+        double rh = station_rh[s];
 
         double rh_z = rh * exp(lapse * (0.0 - s->z()));
 
@@ -56,16 +56,27 @@ void lw_no_lapse::init(mesh& domain)
 
 }
 
+bool lw_no_lapse::migrates()
+{
+    return true;
+}
+
+void lw_no_lapse::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void lw_no_lapse::run(mesh_elem& face)
 {
 
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_Qli = global_param->station_data()->get("Qli"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["Qli"_s]))
+        if( is_nan(station_Qli[s]))
             continue;
-        double v = (*s)["Qli"_s];
+        double v = station_Qli[s];
         lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
     }
 
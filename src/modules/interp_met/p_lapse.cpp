@@ -49,6 +49,17 @@ void p_lapse::init(mesh& domain)
         d->interp.init(global_param->interp_algorithm,face->stations().size() );
     }
 }
+
+bool p_lapse::migrates()
+{
+    return true;
+}
+
+void p_lapse::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void p_lapse::run(mesh_elem& face)
 {
 
@@ -69,11 +80,12 @@ void p_lapse::run(mesh_elem& face)
     }
     std::vector< boost::tuple<double, double, double> > ppt;
     std::vector< boost::tuple<double, double, double> > staion_z;
+    auto station_p = global_param->station_data()->get("p"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["p"_s]))
+        if( is_nan(station_p[s]))
             continue;
-        double p = (*s)["p"_s];
+        double p = station_p[s];
         ppt.push_back( boost::make_tuple(s->x(), s->y(), p ) );
         staion_z.push_back( boost::make_tuple(s->x(), s->y(), s->z() ) );
     }
@@ -51,16 +51,28 @@ void p_no_lapse::init(mesh& domain)
     }
 
 }
+
+bool p_no_lapse::migrates()
+{
+    return true;
+}
+
+void p_no_lapse::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void p_no_lapse::run(mesh_elem& face)
 {
 
     std::vector< boost::tuple<double, double, double> > ppt;
     std::vector< boost::tuple<double, double, double> > staion_z;
+    auto station_p = global_param->station_data()->get("p"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["p"_s]))
+        if( is_nan(station_p[s]))
             continue;
-        double u = (*s)["p"_s];
+        double u = station_p[s];
         ppt.push_back( boost::make_tuple(s->x(), s->y(), u ) );
         staion_z.push_back( boost::make_tuple(s->x(), s->y(), s->z() ) );
     }
@@ -52,6 +52,16 @@ void rh_from_obs::init(mesh& domain)
 
 }
 
+bool rh_from_obs::migrates()
+{
+    return true;
+}
+
+void rh_from_obs::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void rh_from_obs::run(mesh_elem& face)
 {
     //generate lapse rates
@@ -66,12 +76,14 @@ void rh_from_obs::run(mesh_elem& face)
     //otherwise, just used the stored lapse rate
     if(last_update != global_param->posix_time() )
     {
+        auto station_t = global_param->station_data()->get("t"_s);
+        auto station_rh = global_param->station_data()->get("rh"_s);
         for (auto& s : face->stations())
         {
-            if( is_nan((*s)["t"_s]) || is_nan((*s)["rh"_s]))
+            if( is_nan(station_t[s]) || is_nan(station_rh[s]))
                 continue;
-            double rh = (*s)["rh"_s]/100.;
-            double t = (*s)["t"_s];
+            double rh = station_rh[s]/100.;
+            double t = station_t[s];
             double es = mio::Atmosphere::vaporSaturationPressure(t+273.15);
             double ea = rh * es;
             sea.push_back( ea  );
@@ -90,13 +102,15 @@ void rh_from_obs::run(mesh_elem& face)
     }
 
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_t = global_param->station_data()->get("t"_s);
+    auto station_rh = global_param->station_data()->get("rh"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["t"_s]) || is_nan((*s)["rh"_s]))
+        if( is_nan(station_t[s]) || is_nan(station_rh[s]))
             continue;
 
-        double rh = (*s)["rh"_s]/100.;
-        double t = (*s)["t"_s];
+        double rh = station_rh[s]/100.;
+        double t = station_t[s];
         double es = mio::Atmosphere::vaporSaturationPressure(t+273.15);
         double ea = rh * es;
         double z = s->z();
@@ -52,15 +52,27 @@ void rh_no_lapse::init(mesh& domain)
     }
 
 }
+
+bool rh_no_lapse::migrates()
+{
+    return true;
+}
+
+void rh_no_lapse::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void rh_no_lapse::run(mesh_elem &face)
 {
 
     std::vector<boost::tuple<double, double, double> > lowered_values;
+    auto station_rh = global_param->station_data()->get("rh"_s);
     for (auto &s : face->stations())
     {
-        if( is_nan((*s)["rh"_s]))
+        if( is_nan(station_rh[s]))
             continue;
-        double rh = (*s)["rh"_s];
+        double rh = station_rh[s];
 
         lowered_values.push_back(boost::make_tuple(s->x(), s->y(), rh));
     }
@@ -67,6 +67,17 @@ void t_monthly_lapse::init(mesh& domain)
     MLR[11]=cfg.get("MLR_12",0.0049);
 
 }
+
+bool t_monthly_lapse::migrates()
+{
+    return true;
+}
+
+void t_monthly_lapse::unpack_face(mesh_elem& face, const double*& buf)
+{
+    make_interpolant<data>(face);
+}
+
 void t_monthly_lapse::run(mesh_elem& face)
 {
 
@@ -74,11 +85,12 @@ void t_monthly_lapse::run(mesh_elem& face)
 
     //lower all the station values to sea level prior to the interpolation
     std::vector< boost::tuple<double, double, double> > lowered_values;
+    auto station_t = global_param->station_data()->get("t"_s);
     for (auto& s : face->stations())
     {
-        if( is_nan((*s)["t"_s]))
+        if( is_nan(station_t[s]))
             continue;
-        double v = (*s)["t"_s] - lapse_rate * (0.0 - s->z());
+        double v = station_t[s] - lapse_rate * (0.0 - s->z());
         lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
     }
 
@@ -73,15 +73,17 @@ void uniform_wind::run(mesh& domain)
 
 	       std::vector<boost::tuple<double, double, double> > u;
 	       std::vector<boost::tuple<double, double, double> > v;
+	       auto station_U_R = global_param->station_data()->get("U_R"_s);
+	       auto station_vw_dir = global_param->station_data()->get("vw_dir"_s);
 	       for (auto &s : face->stations())
 	       {
-		   if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
+		   if (is_nan(station_U_R[s]) || is_nan(station_vw_dir[s]))
 		     continue;
 
-		   double W = (*s)["U_R"_s];
+		   double W = station_U_R[s];
 		   W = std::max(W, 0.1);
 
-		   double theta = (*s)["vw_dir"_s] * M_PI / 180.;
+		   double theta = station_vw_dir[s] * M_PI / 180.;
 		   double zonal_u = -W * sin(theta);
 		   double zonal_v = -W * cos(theta);
 		   u.push_back(boost::make_tuple(s->x(), s->y(), zonal_u));
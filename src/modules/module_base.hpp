@@ -214,6 +214,42 @@ public:
         //TODO: Add default check for the assumption that module does not support serialization
     };
 
+    /**
+     * Load balancing under MPI moves faces between processes. A module that keeps per-face state in its module data
+     * appends it to buf on the face's old process with pack_face. unpack_face makes the module data again on the new
+     * process, reading back as many values as were written. A module that keeps module data, or is domain parallel,
+     * has to return true here to be load balanced.
+     */
+    virtual bool migrates()
+    {
+        return false;
+    };
+
+    virtual void pack_face(mesh_elem& face, std::vector<double>& buf)
+    {
+    };
+
+    virtual void unpack_face(mesh_elem& face, const double*& buf)
+    {
+    };
+
+    /**
+     * unpack_face for modules whose module data is only the face's interpolant. It holds no state between timesteps, so
+     * nothing is packed and it is just made again for the face's stations
+     */
+    template<typename T>
+    void make_interpolant(mesh_elem& face)
+    {
+        face->make_module_data<T>(ID)->interp.init(global_param->interp_algorithm, face->stations().size());
+    }
+
+    /**
+     * Called on every process once load balancing has moved faces, for modules that size anything by the local faces
+     */
+    virtual void repartitioned(mesh& domain)
+    {
+    };
+
     /**
     * Needs to be implemented by each  data parallel module. This will be called and executed for each timestep
     * \param face The terrain element (triangle) to be worked upon for an element parallel domain
@@ -152,22 +152,15 @@ void scale_wind_vert::init(mesh& domain)
         _parallel_type =  parallel::domain;
 
 
-#pragma omp parallel for
-    for (size_t i = 0; i < domain->size_faces(); i++)
-    {
-      auto face = domain->face(i);
-      // Exception throwing from OpenMP needs to be here
-
-	       auto data = face->make_module_data<d>(ID);
-	       data->interp.init(interp_alg::tpspline,3,{{"reuse_LU","true"}});
-
-    }
-
-
     ignore_canopy = cfg.get("ignore_canopy",false);
 
 }
 
+bool scale_wind_vert::migrates()
+{
+    return true;
+}
+
 void scale_wind_vert::run(mesh_elem &face)
 {
     point_scale(face);
@@ -187,45 +180,20 @@ void scale_wind_vert::run(mesh& domain)
     }
 
 
-#pragma omp parallel for
-    for (size_t i = 0; i < domain->size_faces(); i++)
-    {
-        auto face = domain->face(i);
-      // Exception throwing from OpenMP needs to be here
-
-	       std::vector<boost::tuple<double, double, double> > u;
-	       for (size_t j = 0; j < 3; j++)
-	       {
-		 auto neigh = face->neighbor(j);
-
-		 if (neigh != nullptr && !neigh->_is_ghost)
-		   u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(), (*neigh)["U_2m_above_srf"_s]));
-	       }
-
-	       auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-
-	       if(u.size()>0)
-	       {
-		 double new_u =  face->get_module_data<d>(ID)->interp(u, query);
-		 face->get_module_data<d>(ID)->temp_u = std::max(0.1,new_u);
-	       }
-	       else
-	       {
-		 face->get_module_data<d>(ID)->temp_u = std::max(0.1,(*face)["U_2m_above_srf"_s]);
-	       }
-
-    }
+    auto& smoothing = domain->operators().smoothing;
 
+    std::vector<double> u(domain->size_faces());
+    std::vector<double> smoothed;
 
 #pragma omp parallel for
     for (size_t i = 0; i < domain->size_faces(); i++)
-    {
-      auto face = domain->face(i);
-      // Exception throwing from OpenMP needs to be here
+        u[i] = (*domain->face(i))["U_2m_above_srf"_s];
 
-	       (*face)["U_2m_above_srf"_s]=face->get_module_data<d>(ID)->temp_u ;
+    smoothing.apply(u, smoothed);
 
-    }
+#pragma omp parallel for
+    for (size_t i = 0; i < domain->size_faces(); i++)
+        (*domain->face(i))["U_2m_above_srf"_s] = std::max(0.1, smoothed[i]);
 
 
 }
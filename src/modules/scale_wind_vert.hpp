@@ -53,6 +53,9 @@ public:
     ~scale_wind_vert();
     virtual void init(mesh& domain);
 
+    // keeps no face data, so moving faces needs nothing from it
+    virtual bool migrates();
+
     //this module can swap between a domain parallel and a data parallel state
     ///domain parallel allows for blending through vegetation to avoid sharp gradietns that can complicate blowing snow, &c.
     virtual void run(mesh& domain);
@@ -63,9 +66,4 @@ public:
 
     bool ignore_canopy;
     //virtual void init(mesh& domain);
-    struct d: public face_info
-    {
-        double temp_u;
-        interpolation interp;
-    };
 };
@@ -323,48 +323,22 @@ double sno::psi(
 
 /* ----------------------------------------------------------------------- */
 
-int sno::hle1(
+/*
+ * Input checks of hle1. Throws on bad input, otherwise clamps the vapor
+ * pressures to saturation and returns 0.
+ */
+int sno::hle1_check(
         double press,    /* air pressure (Pa)			*/
         double ta,    /* air temperature (K) at height za	*/
         double ts,    /* surface temperature (K)		*/
         double za,    /* height of air temp measurement (m)	*/
-        double ea,    /* vapor pressure (Pa) at height zq	*/
-        double es,    /* vapor pressure (Pa) at surface	*/
+        double *ea,    /* vapor pressure (Pa) at height zq	*/
+        double *es,    /* vapor pressure (Pa) at surface	*/
         double zq,    /* height of spec hum measurement (m)	*/
-        double u,    /* wind speed (m/s) at height zu	*/
         double zu,    /* height of wind speed measurement (m)	*/
-        double z0,    /* roughness length (m)			*/
-
-        /* output variables */
-
-        double *h,    /* sens heat flux (+ to surf) (W/m^2)	*/
-        double *le,    /* latent heat flux (+ to surf) (W/m^2)	*/
-        double *e)    /* mass flux (+ to surf) (kg/m^2/s)	*/
+        double z0)    /* roughness length (m)			*/
 {
-    double ah = AH;
-    double av = AV;
-    double cp = CP_AIR;
-    double d0;    /* displacement height (eq. 5.3)	*/
-    double dens;    /* air density				*/
-    double diff;    /* difference between guesses		*/
-    double factor;
-    double g = GRAVITY;
-    double k = VON_KARMAN;
-    double last;    /* last guess at lo			*/
-    double lo;    /* Obukhov stability length (eq. 4.25)	*/
-    double ltsh;    /* log ((za-d0)/z0)			*/
-    double ltsm;    /* log ((zu-d0)/z0)			*/
-    double ltsv;    /* log ((zq-d0)/z0)			*/
-    double qa;    /* specific humidity at height zq	*/
-    double qs;    /* specific humidity at surface		*/
-    double ustar;    /* friction velocity (eq. 4.34')	*/
-    double xlh;    /* latent heat of vap/subl		*/
     int ier;    /* return error code			*/
-    int iter;    /* iteration counter			*/
-
-    /*
-     * check for bad input
-     */
 
     /* heights must be positive */
     if (z0 <= 0 || zq <= z0 || zu <= z0 || za <= z0)
@@ -391,7 +365,7 @@ int sno::hle1(
     }
 
     /* pressures must be positive */
-    if (ea <= 0 || es <= 0 || press <= 0 || ea >= press || es >= press)
+    if (*ea <= 0 || *es <= 0 || press <= 0 || *ea >= press || *es >= press)
     {
         BOOST_THROW_EXCEPTION(module_error() << errstr_info ("Press <0"));
 //		usrerr ("press < 0; ea=%f\tes=%f\tpress=%f", ea, es, press);
@@ -401,7 +375,7 @@ int sno::hle1(
 
     /* vapor pressures can't exceed saturation */
     /* if way off stop */
-    if ((es - 25.0) > sati(ts) || (ea - 25.0) > satw(ta))
+    if ((*es - 25.0) > sati(ts) || (*ea - 25.0) > satw(ta))
     {
         BOOST_THROW_EXCEPTION(module_error() << errstr_info ("vp > sat"));
 //		usrerr ("vp > sat; es=%f\tessat=%f\tea=%f\teasat=%f",
@@ -410,15 +384,67 @@ int sno::hle1(
         return (ier);
     }
     /* else fix them up */
-    if (es > sati(ts))
+    if (*es > sati(ts))
     {
-        es = sati(ts);
+        *es = sati(ts);
     }
-    if (ea > satw(ta))
+    if (*ea > satw(ta))
     {
-        ea = satw(ta);
+        *ea = satw(ta);
     }
 
+    ier = 0;
+    return (ier);
+}
+
+/* ----------------------------------------------------------------------- */
+
+int sno::hle1(
+        double press,    /* air pressure (Pa)			*/
+        double ta,    /* air temperature (K) at height za	*/
+        double ts,    /* surface temperature (K)		*/
+        double za,    /* height of air temp measurement (m)	*/
+        double ea,    /* vapor pressure (Pa) at height zq	*/
+        double es,    /* vapor pressure (Pa) at surface	*/
+        double zq,    /* height of spec hum measurement (m)	*/
+        double u,    /* wind speed (m/s) at height zu	*/
+        double zu,    /* height of wind speed measurement (m)	*/
+        double z0,    /* roughness length (m)			*/
+
+        /* output variables */
+
+        double *h,    /* sens heat flux (+ to surf) (W/m^2)	*/
+        double *le,    /* latent heat flux (+ to surf) (W/m^2)	*/
+        double *e)    /* mass flux (+ to surf) (kg/m^2/s)	*/
+{
+    double ah = AH;
+    double av = AV;
+    double cp = CP_AIR;
+    double d0;    /* displacement height (eq. 5.3)	*/
+    double dens;    /* air density				*/
+    double diff;    /* difference between guesses		*/
+    double factor;
+    double g = GRAVITY;
+    double k = VON_KARMAN;
+    double last;    /* last guess at lo			*/
+    double lo;    /* Obukhov stability length (eq. 4.25)	*/
+    double ltsh;    /* log ((za-d0)/z0)			*/
+    double ltsm;    /* log ((zu-d0)/z0)			*/
+    double ltsv;    /* log ((zq-d0)/z0)			*/
+    double qa;    /* specific humidity at height zq	*/
+    double qs;    /* specific humidity at surface		*/
+    double ustar;    /* friction velocity (eq. 4.34')	*/
+    double xlh;    /* latent heat of vap/subl		*/
+    int ier;    /* return error code			*/
+    int iter;    /* iteration counter			*/
+
+    /*
+     * check for bad input
+     */
+    ier = hle1_check(press, ta, ts, za, &ea, &es, zq, zu, z0);
+    if (ier != 0)
+        return (ier);
+
     /*
      * displacement plane height, eq. 5.3 & 5.4
      */
@@ -740,9 +766,22 @@ double sno::efcon(
 */
 
     int sno::do_data_tstep(void)
+    {
+        if (!_begin_data_tstep())
+            return 0;
+
+        /*
+         *  Divide the data timestep into normal run timesteps.
+         */
+        return _divide_tstep(tstep_info);
+    }
+
+/*
+ * do_data_tstep up to dividing the data timestep.
+ */
+    int sno::_begin_data_tstep(void)
     {
         PRECIP_REC *pp_info = precip_info; /* precip info for data timestep */
-        TSTEP_REC *data_tstep = tstep_info; /* timestep info for data timestep */
         int level;            /* loop index */
 
 /*
@@ -785,7 +824,7 @@ double sno::efcon(
                     pp_info->z_snow = pp_info->m_snow / rho_snow;
                 else
                 {
-                    LOG_ERROR <<  "rho_snow is <= 0.0 with %_snow > 0.0";
+                    LOG_ERROR_LIMITED <<  "rho_snow is <= 0.0 with %_snow > 0.0";
                     return 0;
                 }
             }
@@ -834,10 +873,7 @@ double sno::efcon(
         for (level = NORMAL_TSTEP; level <= SMALL_TSTEP; level++)
             computed[level] = 0;
 
-        /*
-         *  Divide the data timestep into normal run timesteps.
-         */
-        return _divide_tstep(data_tstep);
+        return 1;
     }
 
 /*
@@ -1633,15 +1669,39 @@ void sno::_layer_mass(void)
 int sno::_h_le(void)
 {
     double e_s;
-    double sat_vp;
     double rel_z_T;  /* relative z_T (temperature measurement
 			     height) above snow surface */
     double rel_z_u;  /* relative z_u (windspeed measurement
 			     height) above snow surface */
 
+    _h_le_inputs(&e_s, &rel_z_T, &rel_z_u);
+
+    /* calculate H & L_v_E */
+
+    if (hle1(P_a, T_a, T_s_0, rel_z_T, e_a, e_s, rel_z_T, u,
+             rel_z_u, z_0, &H, &L_v_E, &E) != 0)
+    {
+        LOG_DEBUG << "hle1 did not converge";// sprintf("hle1 did not converge\nP_a %f, T_a %f, T_s_0 %f\nrelative z_T %f, e_a %f, e_s %f\nu %f, relative z_u %f, z_0 %f\n", P_a, T_a, T_s_0, rel_z_T, e_a, e_s, u, rel_z_u, z_0);
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * Surface vapor pressure and measurement heights for hle1 (from _h_le).
+ * Clamps e_a to saturation.
+ */
+void sno::_h_le_inputs(
+        double *e_s,    /* saturation vapor pressure at the surface (Pa) */
+        double *rel_z_T,    /* z_T relative to the snow surface (m) */
+        double *rel_z_u)    /* z_u relative to the snow surface (m) */
+{
+    double sat_vp;
+
     /* calculate saturation vapor pressure */
 
-    e_s = sati(T_s_0);
+    *e_s = sati(T_s_0);
 
     /*** error check for bad vapor pressures ***/
 
@@ -1654,24 +1714,13 @@ int sno::_h_le(void)
     /* determine relative measurement heights */
     if (relative_hts)
     {
-        rel_z_T = z_T;
-        rel_z_u = z_u;
+        *rel_z_T = z_T;
+        *rel_z_u = z_u;
     } else
     {
-        rel_z_T = z_T - z_s;
-        rel_z_u = z_u - z_s;
+        *rel_z_T = z_T - z_s;
+        *rel_z_u = z_u - z_s;
     }
-
-    /* calculate H & L_v_E */
-
-    if (hle1(P_a, T_a, T_s_0, rel_z_T, e_a, e_s, rel_z_T, u,
-             rel_z_u, z_0, &H, &L_v_E, &E) != 0)
-    {
-        LOG_DEBUG << "hle1 did not converge";// sprintf("hle1 did not converge\nP_a %f, T_a %f, T_s_0 %f\nrelative z_T %f, e_a %f, e_s %f\nu %f, relative z_u %f, z_0 %f\n", P_a, T_a, T_s_0, rel_z_T, e_a, e_s, u, rel_z_u, z_0);
-        return 0;
-    }
-
-    return 1;
 }
 
 /*
@@ -1940,34 +1989,7 @@ int sno::_e_bal(void)
         if (!_h_le())
             return 0;
 
-        /*      calculate G & G_0(conduction/diffusion heat xfr)    */
-
-        if (layer_count == 1)
-        {
-            G = g_soil(rho, T_s_0, T_g, z_s_0, z_g, P_a);
-            G_0 = G;
-        }
-        else
-        {  /*  layer_count == 2  */
-            G = g_soil(rho, T_s_l, T_g, z_s_l, z_g, P_a);
-            G_0 = g_snow(rho, rho, T_s_0, T_s_l, z_s_0, z_s_l,
-                         P_a);
-        }
-
-        /*      calculate advection     */
-
-        _advec();
-
-        /*      sum E.B. terms  */
-
-        /* surface energy budget */
-        delta_Q_0 = R_n + H + L_v_E + G_0 + M;
-
-        /* total snowpack energy budget */
-        if (layer_count == 1)
-            delta_Q = delta_Q_0;
-        else  /* layer_count == 2 */
-            delta_Q = delta_Q_0 + G - G_0;
+        _e_bal_fluxes();
     }
     else
     {
@@ -1985,6 +2007,41 @@ int sno::_e_bal(void)
     return 1;
 }
 
+/*
+ * Remainder of _e_bal once R_n and H & L_v_E are known.
+ */
+void sno::_e_bal_fluxes(void)
+{
+    /*      calculate G & G_0(conduction/diffusion heat xfr)    */
+
+    if (layer_count == 1)
+    {
+        G = g_soil(rho, T_s_0, T_g, z_s_0, z_g, P_a);
+        G_0 = G;
+    }
+    else
+    {  /*  layer_count == 2  */
+        G = g_soil(rho, T_s_l, T_g, z_s_l, z_g, P_a);
+        G_0 = g_snow(rho, rho, T_s_0, T_s_l, z_s_0, z_s_l,
+                     P_a);
+    }
+
+    /*      calculate advection     */
+
+    _advec();
+
+    /*      sum E.B. terms  */
+
+    /* surface energy budget */
+    delta_Q_0 = R_n + H + L_v_E + G_0 + M;
+
+    /* total snowpack energy budget */
+    if (layer_count == 1)
+        delta_Q = delta_Q_0;
+    else  /* layer_count == 2 */
+        delta_Q = delta_Q_0 + G - G_0;
+}
+
 
 /*
 ** NAME
@@ -2090,6 +2147,23 @@ int sno::_do_tstep(
 #define TIME_AVG(avg, total_time, value, time_incr) \
         ( ((avg) * (total_time) + (value) * (time_incr)) \
         / ((total_time) + (time_incr)) )
+    _begin_tstep(tstep);
+
+    /*
+     *  Calculate energy transfer terms
+     */
+    if (!_e_bal())
+        return 0;
+
+    return _end_tstep(tstep);
+}
+
+/*
+ * First part of _do_tstep, up to the energy balance.
+ */
+void sno::_begin_tstep(
+        TSTEP_REC *tstep)  /* timestep's record */
+{
     time_step = tstep->time_step;
 
     if (precip_now)
@@ -2106,13 +2180,14 @@ int sno::_do_tstep(
      *  Is there a snowcover?
      */
     snowcover = (layer_count > 0);
+}
 
-    /*
-     *  Calculate energy transfer terms
-     */
-    if (!_e_bal())
-        return 0;
-
+/*
+ * Last part of _do_tstep, after the energy balance.
+ */
+int sno::_end_tstep(
+        TSTEP_REC *tstep)  /* timestep's record */
+{
     /*
      *  Adjust mass and calculate runoff
      */
@@ -2191,46 +2266,9 @@ int sno::_do_tstep(
 }
 
 /*
-** NAME
-**      _divide_tstep -- divide a timestep into smaller timesteps
-**
-** SYNOPSIS
-**	#include "_snobal.h"
-**
-**	int
-**	_divide_tstep(
-**	    TSTEP_REC *tstep;	|* record of timestep to be divided *|
-**
-** DESCRIPTION
-**	This routine divides a timestep into smaller timesteps.  For
-**	each of these smaller timestep, the routine either run the
-**	model for that timestep, or further subdivides that timestep
-**	into even smaller timesteps.
-**
-**	The routine will set the flag 'stop_no_snow' to TRUE if
-**
-**		a)  the output function pointed to by 'out_func' is called, and
-**		b)  the flag 'run_no_snow' is FALSE, and
-**		c)  there is no snow remaining on the ground at the end of
-**		    timestep
-**
-** RETURN VALUE
-**
-**	TRUE	The timestep was successfully divided into smaller timesteps.
-**
-**	FALSE	An error occured while running the model during one of the
-**		smaller timesteps.  An message explaining the error has
-**		been stored with the 'usrerr' routine.
-**
-** GLOBAL VARIABLES READ
-**	layer_count
-**	precip_now
-**	ro_data
-**	tstep_info
-**
-** GLOBAL VARIABLES MODIFIED
-*/
-int sno::_divide_tstep(
+ * Input deltas and precipitation for the level below tstep, the first part of _divide_tstep.
+ */
+void sno::_level_deltas(
         TSTEP_REC *tstep)    /* record of timestep to be divided */
 {
     int next_level;    /* # of next level of timestep */
@@ -2239,7 +2277,6 @@ int sno::_divide_tstep(
     INPUT_REC *next_lvl_deltas;    /* -> input-deltas of next level */
     PRECIP_REC *curr_lvl_precip;    /* -> precip data of current level */
     PRECIP_REC *next_lvl_precip;    /* -> precip data of next level */
-    int i;            /* loop index */
 
 
     /*
@@ -2291,6 +2328,57 @@ int sno::_divide_tstep(
 
         computed[next_level] = 1;
     }
+}
+
+/*
+** NAME
+**      _divide_tstep -- divide a timestep into smaller timesteps
+**
+** SYNOPSIS
+**	#include "_snobal.h"
+**
+**	int
+**	_divide_tstep(
+**	    TSTEP_REC *tstep;	|* record of timestep to be divided *|
+**
+** DESCRIPTION
+**	This routine divides a timestep into smaller timesteps.  For
+**	each of these smaller timestep, the routine either run the
+**	model for that timestep, or further subdivides that timestep
+**	into even smaller timesteps.
+**
+**	The routine will set the flag 'stop_no_snow' to TRUE if
+**
+**		a)  the output function pointed to by 'out_func' is called, and
+**		b)  the flag 'run_no_snow' is FALSE, and
+**		c)  there is no snow remaining on the ground at the end of
+**		    timestep
+**
+** RETURN VALUE
+**
+**	TRUE	The timestep was successfully divided into smaller timesteps.
+**
+**	FALSE	An error occured while running the model during one of the
+**		smaller timesteps.  An message explaining the error has
+**		been stored with the 'usrerr' routine.
+**
+** GLOBAL VARIABLES READ
+**	layer_count
+**	precip_now
+**	ro_data
+**	tstep_info
+**
+** GLOBAL VARIABLES MODIFIED
+*/
+int sno::_divide_tstep(
+        TSTEP_REC *tstep)    /* record of timestep to be divided */
+{
+    TSTEP_REC *next_lvl_tstep;    /* info of next level of timestep */
+    int i;            /* loop index */
+
+    next_lvl_tstep = tstep_info + tstep->level + 1;
+
+    _level_deltas(tstep);
 
 //    if(!_do_tstep(next_lvl_tstep))
 //        return 0;
@@ -2303,7 +2391,7 @@ int sno::_divide_tstep(
      */
     for (i = 0; (i < next_lvl_tstep->intervals) ; i++) //&& !stop_no_snow  <-- not used because we aren't using output funcs
     {
-        if ((next_level != SMALL_TSTEP) &&
+        if ((next_lvl_tstep->level != SMALL_TSTEP) &&
             _below_thold(next_lvl_tstep->threshold))
         {
             if (!_divide_tstep(next_lvl_tstep))
@@ -2330,6 +2418,65 @@ int sno::_divide_tstep(
     return 1;
 }
 
+/*
+ * Start dividing tstep for _next_tstep.
+ */
+void sno::_enter_divide(
+        TSTEP_REC *tstep)    /* record of timestep to be divided */
+{
+    _level_deltas(tstep);
+
+    _div_level = tstep->level;
+    _div_interval[_div_level] = 0;
+}
+
+/*
+ * The _divide_tstep recursion as an iterator. Returns the next timestep to run
+ * with _do_tstep (or its _begin_tstep/_e_bal/_end_tstep parts), or NULL once
+ * the timestep given to _enter_divide has been run. The mass thresholds are
+ * checked against the state left by the previous timestep, as _divide_tstep does.
+ */
+TSTEP_REC *sno::_next_tstep(void)
+{
+    TSTEP_REC *tstep;    /* timestep being divided */
+    TSTEP_REC *next_lvl_tstep;    /* info of next level of timestep */
+
+    while (_div_level >= 0)
+    {
+        tstep = tstep_info + _div_level;
+        next_lvl_tstep = tstep_info + _div_level + 1;
+
+        if (_div_interval[_div_level] >= next_lvl_tstep->intervals)
+        {
+            /*
+             *  Output if this timestep is divided?
+             */
+            if (tstep->output & DIVIDED_TSTEP)
+            {
+                (*out_func)();
+                if (!run_no_snow && (layer_count == 0))
+                    stop_no_snow = 1;
+            }
+
+            _div_level--;
+            continue;
+        }
+
+        _div_interval[_div_level]++;
+
+        if ((next_lvl_tstep->level != SMALL_TSTEP) &&
+            _below_thold(next_lvl_tstep->threshold))
+        {
+            _enter_divide(next_lvl_tstep);
+            continue;
+        }
+
+        return next_lvl_tstep;
+    }
+
+    return NULL;
+}
+
 /*
 ** NAME
 **      _cold_content -- calculates cold content for a layer
@@ -179,6 +179,44 @@ public:
             double zeta,        /* z/lo				*/
             int code);        /* which psi function? (see above) */
 
+    /*
+     *  Pieces of do_data_tstep, _divide_tstep, _do_tstep, _e_bal and _h_le
+     *  split out so that sno_batch can advance a block of faces in lock step.
+     *  The per-face routines above are built from these, so both paths run the same code.
+     */
+    int hle1_check(
+            double press,    /* air pressure (Pa)			*/
+            double ta,    /* air temperature (K) at height za	*/
+            double ts,    /* surface temperature (K)		*/
+            double za,    /* height of air temp measurement (m)	*/
+            double *ea,    /* vapor pressure (Pa) at height zq, clamped to saturation */
+            double *es,    /* vapor pressure (Pa) at surface, clamped to saturation */
+            double zq,    /* height of spec hum measurement (m)	*/
+            double zu,    /* height of wind speed measurement (m)	*/
+            double z0);    /* roughness length (m)			*/
+    void _h_le_inputs(
+            double *e_s,    /* saturation vapor pressure at the surface (Pa) */
+            double *rel_z_T,    /* z_T relative to the snow surface (m) */
+            double *rel_z_u);    /* z_u relative to the snow surface (m) */
+    void _e_bal_fluxes(void);
+    int _begin_data_tstep(void);
+    void _level_deltas(
+            TSTEP_REC *tstep);    /* record of timestep to be divided */
+    void _enter_divide(
+            TSTEP_REC *tstep);    /* record of timestep to be divided */
+    TSTEP_REC *_next_tstep(void);
+    void _begin_tstep(
+            TSTEP_REC *tstep);  /* timestep's record */
+    int _end_tstep(
+            TSTEP_REC *tstep);  /* timestep's record */
+
+    /*
+     *  State of the explicit sub-step iterator used by _next_tstep,
+     *  standing in for the call stack of the recursive _divide_tstep.
+     */
+    int _div_level;        /* level currently being divided, -1 when done */
+    int _div_interval[4];    /* # of intervals started at each level */
+
 
     /**
      * Debug
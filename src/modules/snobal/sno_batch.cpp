@@ -0,0 +1,292 @@
+/* * Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+ * modular unstructured mesh based approach for hydrological modelling
+ * Copyright (C) 2018 Christopher Marsh
+ *
+ * This file is part of Canadian Hydrological Model.
+ *
+ * Canadian Hydrological Model is free software: you can redistribute it and/or
+ * modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Canadian Hydrological Model is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Canadian Hydrological Model.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "sno_batch.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/exception/diagnostic_information.hpp>
+
+#include "logger.hpp"
+#include "exception.hpp"
+
+using namespace snobalMacros;
+
+/*
+ * sno::psi for the momentum (SM) and the sensible/latent heat (SH, SV) codes
+ */
+static inline double psi_m(double zeta)
+{
+    if (zeta > 0)
+        return -BETA_S * std::min(zeta, 1.0);
+
+    if (zeta < 0)
+    {
+        double x = sqrt(sqrt(1 - BETA_U * zeta));
+        return 2 * log((1 + x) / 2) + log((1 + x * x) / 2) - 2 * atan(x) + M_PI_2;
+    }
+
+    return 0;
+}
+
+static inline double psi_h(double zeta)
+{
+    if (zeta > 0)
+        return -BETA_S * std::min(zeta, 1.0);
+
+    if (zeta < 0)
+    {
+        double x = sqrt(sqrt(1 - BETA_U * zeta));
+        return 2 * log((1 + x * x) / 2);
+    }
+
+    return 0;
+}
+
+void sno_batch::resize(size_t n)
+{
+    for (auto* v : {&press, &ta, &ts, &za, &ea, &es, &zq, &u, &zu, &z0, &h, &le, &e,
+                    &_ltsm, &_ltsh, &_ltsv, &_qa, &_qs, &_dens, &_ustar, &_lo, &_diff})
+    {
+        if (v->size() < n)
+            v->resize(n);
+    }
+
+    if (_iter.size() < n)
+        _iter.resize(n);
+    if (_active.size() < n)
+        _active.resize(n);
+}
+
+void sno_batch::hle1(size_t n)
+{
+    const double k = VON_KARMAN;
+    const double g = GRAVITY;
+    const double cp = CP_AIR;
+
+    /*
+     * constant terms and the neutral starting values, see sno::hle1.
+     * ta becomes the potential temperature
+     */
+    for (size_t l = 0; l < n; l++)
+    {
+        double d0 = 2 * PAESCHKE * z0[l] / 3;
+
+        _ltsm[l] = log((zu[l] - d0) / z0[l]);
+        _ltsh[l] = log((za[l] - d0) / z0[l]);
+        _ltsv[l] = log((zq[l] - d0) / z0[l]);
+
+        _qa[l] = SPEC_HUM(ea[l], press[l]);
+        _qs[l] = SPEC_HUM(es[l], press[l]);
+
+        ta[l] += DALR * za[l];
+
+        _dens[l] = GAS_DEN(press[l], MOL_AIR,
+                           VIR_TEMP(sqrt(ta[l] * ts[l]), sqrt(ea[l] * es[l]), press[l]));
+
+        _ustar[l] = k * u[l] / _ltsm[l];
+        double factor = k * _ustar[l] * _dens[l];
+        e[l] = (_qa[l] - _qs[l]) * factor * AV / _ltsv[l];
+        h[l] = (ta[l] - ts[l]) * factor * cp * AH / _ltsh[l];
+
+        _lo[l] = HUGE_VAL;
+        _diff[l] = 0;
+        _iter[l] = 0;
+        _active[l] = ta[l] != ts[l];
+    }
+
+    /*
+     * iterate on the Obukhov length. Every round updates only the lanes that haven't converged
+     */
+    bool any = true;
+    while (any)
+    {
+        any = false;
+
+        for (size_t l = 0; l < n; l++)
+        {
+            bool active = _active[l];
+
+            double last = _lo[l];
+            double lo = _ustar[l] * _ustar[l] * _ustar[l] * _dens[l]
+                        / (k * g * (h[l] / (ta[l] * cp) + 0.61 * e[l]));
+
+            double ustar = k * u[l] / (_ltsm[l] - psi_m(zu[l] / lo));
+            double factor = k * ustar * _dens[l];
+            double el = (_qa[l] - _qs[l]) * factor * AV / (_ltsv[l] - psi_h(zq[l] / lo));
+            double hl = (ta[l] - ts[l]) * factor * AH * cp / (_ltsh[l] - psi_h(za[l] / lo));
+            double diff = last - lo;
+
+            _lo[l] = active ? lo : _lo[l];
+            _ustar[l] = active ? ustar : _ustar[l];
+            e[l] = active ? el : e[l];
+            h[l] = active ? hl : h[l];
+            _diff[l] = active ? diff : _diff[l];
+
+            bool more = active && fabs(diff) > THRESH && fabs(diff / lo) > THRESH;
+            _iter[l] += more;
+            _active[l] = more && _iter[l] < ITMAX;
+
+            any |= _active[l];
+        }
+    }
+
+    for (size_t l = 0; l < n; l++)
+    {
+        // failed to converge, likely low winds, assume neutral
+        if (_iter[l] >= ITMAX || std::isinf(_diff[l]))
+        {
+            double ustar = k * u[l] / _ltsm[l];
+            double factor = k * ustar * _dens[l];
+            e[l] = (_qa[l] - _qs[l]) * factor * AV / _ltsv[l];
+            h[l] = (ta[l] - ts[l]) * factor * cp * AH / _ltsh[l];
+        }
+
+        double xlh = LH_VAP(ts[l]);
+        if (ts[l] <= FREEZE)
+            xlh += LH_FUS(ts[l]);
+
+        le[l] = xlh * e[l];
+    }
+}
+
+void sno_batch::do_data_tstep(const std::vector<sno*>& block, std::vector<char>& failed)
+{
+    size_t n = block.size();
+
+    failed.assign(n, 0);
+    _running.assign(n, 0);
+    _tstep.assign(n, nullptr);
+    _lane.assign(n, -1);
+    resize(n);
+
+    auto fail = [&](size_t i, module_error& ex)
+    {
+        failed[i] = 1;
+        _running[i] = 0;
+        LOG_DEBUG << boost::diagnostic_information(ex);
+    };
+
+    for (size_t i = 0; i < n; i++)
+    {
+        try
+        {
+            if (block[i]->_begin_data_tstep())
+            {
+                block[i]->_enter_divide(block[i]->tstep_info);
+                _running[i] = 1;
+            }
+        } catch (module_error& ex)
+        {
+            fail(i, ex);
+        }
+    }
+
+    while (true)
+    {
+        bool any = false;
+        size_t lanes = 0;
+
+        // up to the turbulent fluxes
+        for (size_t i = 0; i < n; i++)
+        {
+            _lane[i] = -1;
+            if (!_running[i])
+                continue;
+
+            sno* s = block[i];
+            try
+            {
+                _tstep[i] = s->_next_tstep();
+                if (!_tstep[i])
+                {
+                    _running[i] = 0;
+                    continue;
+                }
+                any = true;
+
+                s->_begin_tstep(_tstep[i]);
+                if (!s->snowcover)
+                    continue;
+
+                s->_net_rad();
+
+                double e_s, rel_z_T, rel_z_u;
+                s->_h_le_inputs(&e_s, &rel_z_T, &rel_z_u);
+
+                double e_a = s->e_a;
+                s->hle1_check(s->P_a, s->T_a, s->T_s_0, rel_z_T, &e_a, &e_s, rel_z_T, rel_z_u, s->z_0);
+
+                press[lanes] = s->P_a;
+                ta[lanes] = s->T_a;
+                ts[lanes] = s->T_s_0;
+                za[lanes] = rel_z_T;
+                ea[lanes] = e_a;
+                es[lanes] = e_s;
+                zq[lanes] = rel_z_T;
+                u[lanes] = s->u;
+                zu[lanes] = rel_z_u;
+                z0[lanes] = s->z_0;
+
+                _lane[i] = lanes++;
+            } catch (module_error& ex)
+            {
+                fail(i, ex);
+            }
+        }
+
+        if (!any)
+            break;
+
+        hle1(lanes);
+
+        // remainder of the timestep
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!_running[i])
+                continue;
+
+            sno* s = block[i];
+            try
+            {
+                if (_lane[i] >= 0)
+                {
+                    s->H = h[_lane[i]];
+                    s->L_v_E = le[_lane[i]];
+                    s->E = e[_lane[i]];
+                    s->_e_bal_fluxes();
+                }
+                else
+                {
+                    s->_e_bal(); // no snowcover, zeros the fluxes
+                }
+
+                if (!s->_end_tstep(_tstep[i]))
+                    _running[i] = 0;
+            } catch (module_error& ex)
+            {
+                fail(i, ex);
+            }
+        }
+    }
+}
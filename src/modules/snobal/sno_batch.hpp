@@ -0,0 +1,75 @@
+/* * Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+ * modular unstructured mesh based approach for hydrological modelling
+ * Copyright (C) 2018 Christopher Marsh
+ *
+ * This file is part of Canadian Hydrological Model.
+ *
+ * Canadian Hydrological Model is free software: you can redistribute it and/or
+ * modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Canadian Hydrological Model is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Canadian Hydrological Model.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "sno.h"
+
+/**
+ * Advances a block of snobal points (faces) in lock step.
+ *
+ * Each point still owns its sno state, but every sub-step of the block is run in three phases:
+ * the per-point work up to the turbulent fluxes, the turbulent fluxes (hle1) for every point with a snowcover
+ * as one structure-of-arrays kernel, and the per-point remainder of the step. Points that need to divide the timestep
+ * into smaller timesteps (thin snowcovers) simply take more rounds; the others are masked off once done.
+ *
+ * The arithmetic is that of sno::hle1, so results match sno::do_data_tstep up to floating point contraction.
+ */
+class sno_batch
+{
+public:
+    /**
+     * Runs sno::do_data_tstep for each point in the block.
+     * @param block The points
+     * @param failed Set to 1 for points that threw a module_error. These stopped part way through the timestep, as with do_data_tstep.
+     */
+    void do_data_tstep(const std::vector<sno*>& block, std::vector<char>& failed);
+
+    /**
+     * Lane-wise hle1 over the first n lanes of the inputs below. Inputs must already have passed sno::hle1_check.
+     */
+    void hle1(size_t n);
+
+    /**
+     * Makes room for n lanes
+     */
+    void resize(size_t n);
+
+    // hle1 inputs, one lane per point. Names and units are those of sno::hle1
+    std::vector<double> press, ta, ts, za, ea, es, zq, u, zu, z0;
+
+    // hle1 outputs
+    std::vector<double> h, le, e;
+
+private:
+    // iteration state of the hle1 kernel
+    std::vector<double> _ltsm, _ltsh, _ltsv, _qa, _qs, _dens, _ustar, _lo, _diff;
+    std::vector<int> _iter;
+    std::vector<char> _active;
+
+    // lane of each point in the block, -1 if it doesn't need hle1 this round
+    std::vector<int> _lane;
+    std::vector<TSTEP_REC*> _tstep;
+    std::vector<char> _running;
+};
@@ -22,11 +22,16 @@
 //
 
 #include "snobal.hpp"
+
+#include <cstring>
+#include <type_traits>
 REGISTER_MODULE_CPP(snobal);
 
 snobal::snobal(config_file cfg)
-        : module_base("snobal", parallel::data, cfg)
+        : module_base("snobal", cfg.get("batch_size",0) > 0 ? parallel::domain : parallel::data, cfg)
 {
+    batch_size = cfg.get("batch_size",0);
+
     depends("frac_precip_snow");
     depends("iswr");
     depends("rh");
@@ -242,11 +247,79 @@ snobal::~snobal()
 }
 
 void snobal::run(mesh_elem &face)
+{
+    if(!prepare(face))
+        return;
+
+    snodata* g = face->get_module_data<snodata>(ID);
+    auto* sbal = &(g->data);
+
+    double prev_ts_swe = sbal->m_s;
+    try
+    {
+        sbal->do_data_tstep();
+    }catch(module_error& e)
+    {
+        g->dead=1;
+        LOG_DEBUG << boost::diagnostic_information(e);
+        auto details = "("+std::to_string(face->center().x()) + "," + std::to_string(face->center().y())+","+std::to_string(face->center().z())+") ID = " + std::to_string(face->cell_local_id);
+//        BOOST_THROW_EXCEPTION(module_error() << errstr_info ("Snobal died. Triangle center = "+details));
+    }
+
+    finish(face, prev_ts_swe);
+}
+
+void snobal::run(mesh& domain)
+{
+    size_t nblocks = (domain->size_faces() + batch_size - 1) / batch_size;
+
+    #pragma omp parallel
+    {
+        sno_batch batch;
+        std::vector<mesh_elem> faces;
+        std::vector<sno*> block;
+        std::vector<double> prev_ts_swe;
+        std::vector<char> failed;
+
+        #pragma omp for
+        for (size_t b = 0; b < nblocks; b++)
+        {
+            faces.clear();
+            block.clear();
+            prev_ts_swe.clear();
+
+            size_t end = std::min(domain->size_faces(), (b + 1) * batch_size);
+            for (size_t i = b * batch_size; i < end; i++)
+            {
+                auto face = domain->face(i);
+                if(!prepare(face))
+                    continue;
+
+                auto* sbal = &(face->get_module_data<snodata>(ID)->data);
+                faces.push_back(face);
+                block.push_back(sbal);
+                prev_ts_swe.push_back(sbal->m_s);
+            }
+
+            batch.do_data_tstep(block, failed);
+
+            for (size_t k = 0; k < faces.size(); k++)
+            {
+                if(failed[k])
+                    faces[k]->get_module_data<snodata>(ID)->dead = 1;
+
+                finish(faces[k], prev_ts_swe[k]);
+            }
+        }
+    }
+}
+
+bool snobal::prepare(mesh_elem &face)
 {
     if(is_water(face))
     {
         set_all_nan_on_skip(face);
-        return;
+        return false;
     }
 
     //debugging
@@ -413,17 +486,13 @@ void snobal::run(mesh_elem &face)
         g->dead = 0;
     }
 
-    double prev_ts_swe = sbal->m_s;
-    try
-    {
-        sbal->do_data_tstep();
-    }catch(module_error& e)
-    {
-        g->dead=1;
-        LOG_DEBUG << boost::diagnostic_information(e);
-        auto details = "("+std::to_string(face->center().x()) + "," + std::to_string(face->center().y())+","+std::to_string(face->center().z())+") ID = " + std::to_string(face->cell_local_id);
-//        BOOST_THROW_EXCEPTION(module_error() << errstr_info ("Snobal died. Triangle center = "+details));
-    }
+    return true;
+}
+
+void snobal::finish(mesh_elem &face, double prev_ts_swe)
+{
+    snodata* g = face->get_module_data<snodata>(ID);
+    auto* sbal = &(g->data);
 
     // something has gone very wrong with, likely, a thin snowcover
     if( std::isnan(sbal->m_s))
@@ -579,3 +648,41 @@ void snobal::load_checkpoint(mesh& domain, netcdf& chkpt)
         sbal->init_snow();
     }
 }
+
+// sno is moved as its bytes, so a face continues on its new process exactly where it left off, not just from the
+// checkpointed state
+static_assert(std::is_trivially_copyable<sno>::value, "snobal's state is moved between processes as raw bytes");
+static const size_t sno_doubles = (sizeof(sno) + sizeof(double) - 1) / sizeof(double);
+
+bool snobal::migrates()
+{
+    return true;
+}
+
+void snobal::pack_face(mesh_elem& face, std::vector<double>& buf)
+{
+    snodata* g = face->get_module_data<snodata>(ID);
+
+    size_t at = buf.size();
+    buf.resize(at + sno_doubles);
+    std::memcpy(&buf[at], &g->data, sizeof(sno));
+
+    buf.insert(buf.end(), {g->sum_runoff, g->sum_subl, g->sum_pcp_sno, g->sum_melt, double(g->dead),
+                           g->delta_avalanche_snowdepth, g->delta_avalanche_swe});
+}
+
+void snobal::unpack_face(mesh_elem& face, const double*& buf)
+{
+    snodata* g = face->make_module_data<snodata>(ID);
+
+    std::memcpy(&g->data, buf, sizeof(sno));
+    buf += sno_doubles;
+
+    g->sum_runoff = *buf++;
+    g->sum_subl = *buf++;
+    g->sum_pcp_sno = *buf++;
+    g->sum_melt = *buf++;
+    g->dead = static_cast<int>(*buf++);
+    g->delta_avalanche_snowdepth = *buf++;
+    g->delta_avalanche_swe = *buf++;
+}
@@ -30,6 +30,7 @@
 #include <meteoio/MeteoIO.h>
 
 #include "sno.h"
+#include "sno_batch.hpp"
 #include "snomacros.h"
 class snodata : public face_info
 {
@@ -57,9 +58,29 @@ public:
 
     bool use_slope_SWE; // use a slope corrected SWE for compaction eqn
 
+    // if > 0, the faces are run in blocks of this many faces by sno_batch and the module is domain parallel
+    size_t batch_size;
+
     virtual void run(mesh_elem &face);
+    virtual void run(mesh& domain);
+
+    /**
+     * Loads the face's forcing into its snobal state ahead of the data timestep
+     * @return false if the face is skipped
+     */
+    bool prepare(mesh_elem &face);
+
+    /**
+     * Accumulates and writes the face's outputs after the data timestep
+     * @param prev_ts_swe swe before the timestep
+     */
+    void finish(mesh_elem &face, double prev_ts_swe);
     virtual void init(mesh& domain);
     void checkpoint(mesh& domain, netcdf& chkpt);
     void load_checkpoint(mesh& domain, netcdf& chkpt);
 
+    bool migrates();
+    void pack_face(mesh_elem& face, std::vector<double>& buf);
+    void unpack_face(mesh_elem& face, const double*& buf);
+
 };
@@ -92,11 +92,13 @@ void Lehning_snowpack::run(mesh_elem &face)
         return;
     }
     auto data = face->get_module_data<Lehning_snowpack::data>(ID);
+    auto& td = _thread_data.at(omp_get_thread_num());
 
     /**
      * Builds this timestep's meteo data
      */
-    CurrentMeteo Mdata(data->config);
+    CurrentMeteo& Mdata = td.Mdata;
+    Mdata = Mdata_init;
     Mdata.date   =  mio::Date( global_param->year(), global_param->month(), global_param->day(),global_param->hour(),global_param->min(),-6 );
     // Optional inputs if there is a canopy or not
     if(has_optional("ta_subcanopy")) {
@@ -190,7 +192,7 @@ void Lehning_snowpack::run(mesh_elem &face)
     Mdata.elev      = (*face)["solar_el"_s]*mio::Cst::to_rad;
 
     data->cum_precip  += Mdata.psum; //running sum of the precip. snowpack removes the rain component for us.
-    data->meteo->compMeteo(Mdata,*(data->Xdata),false); // no canopy model
+    td.meteo->compMeteo(Mdata,*(data->Xdata),false); // no canopy model
 
     double mass_erode = 0;
 
@@ -225,10 +227,13 @@ void Lehning_snowpack::run(mesh_elem &face)
 
     try
     {
-        data->sp->runSnowpackModel(Mdata, *(data->Xdata), data->cum_precip, Bdata,surface_fluxes,mass_erode);
+        td.sp->runSnowpackModel(Mdata, *(data->Xdata), data->cum_precip, Bdata,surface_fluxes,mass_erode);
         surface_fluxes.collectSurfaceFluxes(Bdata, *(data->Xdata), Mdata);
     }catch(...)
     {
+        // a throw can leave the reduced sub-timestep set, don't let it leak into this thread's next face
+        td.sp = boost::make_shared<Snowpack>(*Spackconfig);
+
         if (data->Xdata->swe > 3)
         {
 
@@ -299,129 +304,132 @@ void Lehning_snowpack::init(mesh& domain)
 {
     const_T_g = cfg.get("const_T_g",-4.0);
 
-    for(size_t i=0;i<domain->size_faces();i++)
+    //setup critical keys.
+    //overwrite the user if a dangerous key is set
+    config.addKey("METEO_STEP_LENGTH", "Snowpack", std::to_string( 3600.0 / global_param->dt())); // Hz. Number of met per hour
+    config.addKey("MEAS_TSS", "Snowpack", "false");
+
+    //specified as minutes, snowpack will convert to s for us. CHM dt is in s
+    config.addKey("CALCULATION_STEP_LENGTH","Snowpack", std::to_string(global_param->dt()  / 60 ) );
+    //default values for
+    //	"Snowpack": { }
+
+    config.addKey("MEAS_TSS","Snowpack","false");
+    config.addKey("ENFORCE_MEASURED_SNOW_HEIGHTS","Snowpack","false");
+    config.addKey("SW_MODE","Snowpack","BOTH");
+    config.addKey("HEIGHT_OF_WIND_VALUE","Snowpack","2");
+    config.addKey("HEIGHT_OF_METEO_VALUES","Snowpack","2");
+    config.addKey("ATMOSPHERIC_STABILITY","Snowpack","MO_MICHLMAYR");
+    config.addKey("ROUGHNESS_LENGTH","Snowpack","0.001");
+    config.addKey("CHANGE_BC","Snowpack","false");
+    config.addKey("THRESH_CHANGE_BC","Snowpack","-1.0");
+    config.addKey("SNP_SOIL","Snowpack","false");
+    config.addKey("SOIL_FLUX","Snowpack","false");
+    config.addKey("GEO_HEAT","Snowpack","0.06");
+    config.addKey("CANOPY","Snowpack","false");
+
+    //default values for
+    //	"SnowpackAdvanced": { }
+    config.addKey("MAX_NUMBER_MEAS_TEMPERATURES","SnowpackAdvanced","1");
+    config.addKey("ALPINE3D","SnowpackAdvanced","true"); //must be true for any blowing snow module
+    config.addKey("SNOW_EROSION","SnowpackAdvanced","false");
+    config.addKey("MEAS_INCOMING_LONGWAVE","SnowpackAdvanced","true");
+    config.addKey("THRESH_RAIN","SnowpackAdvanced","2");
+    config.addKey("THRESH_RAIN_RANGE","SnowpackAdvanced","2");
+    config.addKey("WATERTRANSPORTMODEL_SNOW","SnowpackAdvanced","BUCKET");
+    config.addKey("VARIANT","SnowpackAdvanced","DEFAULT");
+    config.addKey("ADJUST_HEIGHT_OF_WIND_VALUE","SnowpackAdvanced","false"); // we always provide a 2m wind, even if there is snowcover
+    config.addKey("HN_DENSITY","SnowpackAdvanced","MEASURED"); //We can then set it in at run time. Do it this way so we can have temporally variable if we want.
+
+    config.addKey("COMBINE_ELEMENTS","SnowpackAdvanced","true"); //Defines whether joining elements will be considered at all
+    //Activates algorithm to reduce the number of elements deeper in the snowpack AND to split elements again when they come back to the surface
+    //Only works when COMBINE_ELEMENTS == TRUE.
+    config.addKey("REDUCE_N_ELEMENTS","SnowpackAdvanced","true");
+
+
+    // because we use our own config, we need to do the conversion
+    //format is same key-val pairs that snowpack expects, case sensitive
+    /**
+     * [Snowpack]
+     * [SnowpackAdvanced]
+     */
+    for(auto itr : cfg)
     {
-        auto face = domain->face(i);
-
-        auto d = face->make_module_data<Lehning_snowpack::data>(ID);
-
-
-        //setup critical keys.
-        //overwrite the user if a dangerous key is set
-        d->config.addKey("METEO_STEP_LENGTH", "Snowpack", std::to_string( 3600.0 / global_param->dt())); // Hz. Number of met per hour
-        d->config.addKey("MEAS_TSS", "Snowpack", "false");
-
-        //specified as minutes, snowpack will convert to s for us. CHM dt is in s
-        d->config.addKey("CALCULATION_STEP_LENGTH","Snowpack", std::to_string(global_param->dt()  / 60 ) );
-        //default values for
-        //	"Snowpack": { }
-
-        d->config.addKey("MEAS_TSS","Snowpack","false");
-        d->config.addKey("ENFORCE_MEASURED_SNOW_HEIGHTS","Snowpack","false");
-        d->config.addKey("SW_MODE","Snowpack","BOTH");
-        d->config.addKey("HEIGHT_OF_WIND_VALUE","Snowpack","2");
-        d->config.addKey("HEIGHT_OF_METEO_VALUES","Snowpack","2");
-        d->config.addKey("ATMOSPHERIC_STABILITY","Snowpack","MO_MICHLMAYR");
-        d->config.addKey("ROUGHNESS_LENGTH","Snowpack","0.001");
-        d->config.addKey("CHANGE_BC","Snowpack","false");
-        d->config.addKey("THRESH_CHANGE_BC","Snowpack","-1.0");
-        d->config.addKey("SNP_SOIL","Snowpack","false");
-        d->config.addKey("SOIL_FLUX","Snowpack","false");
-        d->config.addKey("GEO_HEAT","Snowpack","0.06");
-        d->config.addKey("CANOPY","Snowpack","false");
-
-        //default values for
-        //	"SnowpackAdvanced": { }
-        d->config.addKey("MAX_NUMBER_MEAS_TEMPERATURES","SnowpackAdvanced","1");
-        d->config.addKey("ALPINE3D","SnowpackAdvanced","true"); //must be true for any blowing snow module
-        d->config.addKey("SNOW_EROSION","SnowpackAdvanced","false");
-        d->config.addKey("MEAS_INCOMING_LONGWAVE","SnowpackAdvanced","true");
-        d->config.addKey("THRESH_RAIN","SnowpackAdvanced","2");
-        d->config.addKey("THRESH_RAIN_RANGE","SnowpackAdvanced","2");
-        d->config.addKey("WATERTRANSPORTMODEL_SNOW","SnowpackAdvanced","BUCKET");
-        d->config.addKey("VARIANT","SnowpackAdvanced","DEFAULT");
-        d->config.addKey("ADJUST_HEIGHT_OF_WIND_VALUE","SnowpackAdvanced","false"); // we always provide a 2m wind, even if there is snowcover
-        d->config.addKey("HN_DENSITY","SnowpackAdvanced","MEASURED"); //We can then set it in at run time. Do it this way so we can have temporally variable if we want.
-
-        d->config.addKey("COMBINE_ELEMENTS","SnowpackAdvanced","true"); //Defines whether joining elements will be considered at all
-        //Activates algorithm to reduce the number of elements deeper in the snowpack AND to split elements again when they come back to the surface
-        //Only works when COMBINE_ELEMENTS == TRUE.
-        d->config.addKey("REDUCE_N_ELEMENTS","SnowpackAdvanced","true");
-
-
-        // because we use our own config, we need to do the conversion
-        //format is same key-val pairs that snowpack expects, case sensitive
-        /**
-         * [Snowpack]
-         * [SnowpackAdvanced]
-         */
-        for(auto itr : cfg)
+        for(auto jtr : itr.second)
         {
-            for(auto jtr : itr.second)
-            {
-                d->config.addKey(jtr.first.data(),itr.first.data(),jtr.second.data());
-            }
+            config.addKey(jtr.first.data(),itr.first.data(),jtr.second.data());
         }
-        
-
-        d->Spackconfig = boost::make_shared<SnowpackConfig>(d->config);
-
-        d->cum_precip=0.;
-
-        //addSpecial keys goes here to deal with Antarctica, canopy, and detect grass
+    }
 
-        SN_SNOWSOIL_DATA SSdata;
-        SSdata.SoilAlb = cfg.get<double>("sno.SoilAlbedo",0.09);
-        SSdata.Albedo = SSdata.SoilAlb; // following snowpacks' no snow default.
-        SSdata.BareSoil_z0 = cfg.get<double>("sno.BareSoil_z0",0.2);
-        if (SSdata.BareSoil_z0 == 0.)
-        {
-            LOG_WARNING << "[snowpack] BareSoil_z0 == 0, set to 0.2";
-            SSdata.BareSoil_z0 = 0.2;
-        }
+    Spackconfig = boost::make_shared<SnowpackConfig>(config);
+    Mdata_init = CurrentMeteo(*Spackconfig);
 
-        SSdata.WindScalingFactor= cfg.get<double>("sno.WindScalingFactor",1);
-        SSdata.TimeCountDeltaHS = cfg.get<double>("sno.TimeCountDeltaHS",0.0);
+    // one set of physics objects per thread, built here as the constructors aren't thread safe
+    _thread_data.resize(omp_get_max_threads());
+    for(auto& td : _thread_data)
+    {
+        td.sp = boost::make_shared<Snowpack>(*Spackconfig);
+        td.meteo = boost::make_shared<Meteo>(*Spackconfig);
+        td.Mdata = Mdata_init;
+    }
 
+    //addSpecial keys goes here to deal with Antarctica, canopy, and detect grass
 
-        SSdata.meta.stationName = cfg.get<std::string>("sno.station_name","chm");
-        SSdata.meta.position.setAltitude(face->get_z());
+    // everything but the position is the same for every face
+    SN_SNOWSOIL_DATA SSdata;
+    SSdata.SoilAlb = cfg.get<double>("sno.SoilAlbedo",0.09);
+    SSdata.Albedo = SSdata.SoilAlb; // following snowpacks' no snow default.
+    SSdata.BareSoil_z0 = cfg.get<double>("sno.BareSoil_z0",0.2);
+    if (SSdata.BareSoil_z0 == 0.)
+    {
+        LOG_WARNING << "[snowpack] BareSoil_z0 == 0, set to 0.2";
+        SSdata.BareSoil_z0 = 0.2;
+    }
 
-        SSdata.meta.position.setXY(face->get_x(),face->get_y(),face->get_z());
-        SSdata.meta.setSlope(mio::IOUtils::nodata,mio::IOUtils::nodata);
-//        SSdata.meta.setSlope(face->slope() * ,face->aspect());
-//        SSdata.meta.setSlope(0,0);
+    SSdata.WindScalingFactor= cfg.get<double>("sno.WindScalingFactor",1);
+    SSdata.TimeCountDeltaHS = cfg.get<double>("sno.TimeCountDeltaHS",0.0);
 
-        SSdata.HS_last = 0.; //cfg.get<double>("sno.HS_Last");
+    SSdata.meta.stationName = cfg.get<std::string>("sno.station_name","chm");
+    SSdata.meta.setSlope(mio::IOUtils::nodata,mio::IOUtils::nodata);
+//    SSdata.meta.setSlope(face->slope() * ,face->aspect());
+//    SSdata.meta.setSlope(0,0);
 
-        //meta data in *sno files that we don't use
-//        cfg.get<std::string>("sno.station_id");
+    SSdata.HS_last = 0.; //cfg.get<double>("sno.HS_Last");
 
-//        cfg.get<double>("sno.latitude");
-//        cfg.get<double>("sno.longitude");
-//        cfg.get<double>("sno.altitude");
-//        cfg.get<double>("sno.nodata");
-//        cfg.get<double>("sno.tz");
-//        cfg.get<std::string>("sno.source");
-//        cfg.get<std::string>("sno.ProfileDate");
+    //meta data in *sno files that we don't use
+//    cfg.get<std::string>("sno.station_id");
 
+//    cfg.get<double>("sno.latitude");
+//    cfg.get<double>("sno.longitude");
+//    cfg.get<double>("sno.altitude");
+//    cfg.get<double>("sno.nodata");
+//    cfg.get<double>("sno.tz");
+//    cfg.get<std::string>("sno.source");
+//    cfg.get<std::string>("sno.ProfileDate");
 
+    //assumes no starting layers
+    SSdata.nN = 1;
+    SSdata.Height = 0.;
 
-        //assumes no starting layers
-        SSdata.nN = 1;
-        SSdata.Height = 0.;
+    SSdata.nLayers = 0;// cfg.get("sno.nSoilLayerData",0);
+//    SSdata.nLayers += cfg.get("sno.nSnowLayerData",0);
+//    SSdata.Ldata
 
-        SSdata.nLayers = 0;// cfg.get("sno.nSoilLayerData",0);
-//        SSdata.nLayers += cfg.get("sno.nSnowLayerData",0);
-//        SSdata.Ldata
+    SSdata.Canopy_Height = cfg.get<double>("sno.CanopyHeight",0);
+    SSdata.Canopy_LAI = cfg.get<double>("sno.CanopyLeafAreaIndex",0);
+    SSdata.Canopy_Direct_Throughfall = cfg.get<double>("sno.CanopyDirectThroughfall",1);
 
+    SSdata.ErosionLevel = cfg.get<double>("sno.ErosionLevel",0);
 
+#pragma omp parallel for firstprivate(SSdata)
+    for(size_t i=0;i<domain->size_faces();i++)
+    {
+        auto face = domain->face(i);
 
-        SSdata.Canopy_Height = cfg.get<double>("sno.CanopyHeight",0);
-        SSdata.Canopy_LAI = cfg.get<double>("sno.CanopyLeafAreaIndex",0);
-        SSdata.Canopy_Direct_Throughfall = cfg.get<double>("sno.CanopyDirectThroughfall",1);
+        auto d = face->make_module_data<Lehning_snowpack::data>(ID);
 
-        SSdata.ErosionLevel = cfg.get<double>("sno.ErosionLevel",0);
+        SSdata.meta.position.setAltitude(face->get_z());
+        SSdata.meta.position.setXY(face->get_x(),face->get_y(),face->get_z());
 
         d->Xdata = boost::make_shared<SnowStation>(false,false);
         d->Xdata->initialize(SSdata,0);
@@ -431,12 +439,7 @@ void Lehning_snowpack::init(mesh& domain)
 //        d->Xdata->hn = 0;
 //        d->Xdata->mH = 0;
 
-        d->sp = boost::make_shared<Snowpack>(*(d->Spackconfig));
-        d->meteo = boost::make_shared<Meteo>( (d->config));
-        d->stability = boost::make_shared<Stability> ( (d->config), false);
-
+        d->cum_precip=0.;
         d->sum_subl = 0;
-
-
     }
 }
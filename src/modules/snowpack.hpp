@@ -37,6 +37,8 @@
 #include <snowpack/libsnowpack.h>
 
 #include <string>
+#include <vector>
+
 class Lehning_snowpack : public module_base
 {
 REGISTER_MODULE_HPP(Lehning_snowpack);
@@ -50,26 +52,43 @@ public:
     virtual void init(mesh& domain);
 
 
+    /**
+     * Per-face state. Only the snowpack itself lives here; everything built from the configuration is shared.
+     */
     struct data : public face_info
     {
-        //main snowpack model
-        boost::shared_ptr<Snowpack> sp;
-
         /*
          * This is the PRIMARY data structure of the SNOWPACK program \n
          * It is used extensively not only during the finite element solution but also to control
          */
         boost::shared_ptr<SnowStation> Xdata;
 
-        boost::shared_ptr<SnowpackConfig> Spackconfig;
-        boost::shared_ptr<Meteo> meteo;
-        boost::shared_ptr<Stability> stability;
-        mio::Config config;
         double cum_precip;
 
         double sum_subl;
     };
 
+    /**
+     * Per-thread physics objects. Snowpack and Meteo keep scratch state (e.g., the adaptive sub-timestep)
+     * while a face is run, so they can't be shared between threads, but nothing in them carries over between faces.
+     */
+    struct thread_data
+    {
+        //main snowpack model
+        boost::shared_ptr<Snowpack> sp;
+        boost::shared_ptr<Meteo> meteo;
+
+        // this timestep's meteo data, reset from Mdata_init for each face
+        CurrentMeteo Mdata;
+    };
+
+    // read-only after init, shared by every face
+    mio::Config config;
+    boost::shared_ptr<SnowpackConfig> Spackconfig;
+    CurrentMeteo Mdata_init;
+
+    std::vector<thread_data> _thread_data;
+
     double sn_dt; // calculation step length
     double const_T_g; // constant ground temp, degC
 
@@ -1401,6 +1401,27 @@ SnowStation::SnowStation(const SnowStation& c) :
 	WindScalingFactor(c.WindScalingFactor), TimeCountDeltaHS(c.TimeCountDeltaHS),
 	nNodes(c.nNodes), nElems(c.nElems), useCanopyModel(c.useCanopyModel), useSoilLayers(c.useSoilLayers) {}
 
+/**
+ * @brief Releases the matrix kept in SnowStation::Kt, whatever state it is in, and resets the pointer
+ * @param Kt pointer to the opaque SD_MATRIX_DATA, may be NULL
+ */
+static void releaseKt(void*& Kt)
+{
+	SD_MATRIX_DATA* pMat = (SD_MATRIX_DATA*) Kt;
+
+	if (pMat != NULL) {
+		if ( pMat->State == ConMatrix ){
+			ReleaseConMatrix(&pMat->Mat.Con);
+		} else if ( pMat->State == BlockMatrix  ){
+			ReleaseBlockMatrix(&pMat->Mat.Block);
+		} else if ( pMat->State == TridiagMatrix  ){
+			ReleaseTridiagMatrix(&pMat->Mat.Tridiag);
+		}
+		free(pMat);
+	}
+	Kt = NULL;
+}
+
 SnowStation& SnowStation::operator=(const SnowStation& source) {
 	if(this != &source) {
 		meta = source.meta;
@@ -1436,7 +1457,8 @@ SnowStation& SnowStation::operator=(const SnowStation& source) {
 		z_S_5 = source.z_S_5;
 		Ndata = source.Ndata;
 		Edata = source.Edata;
-		Kt = source.Kt;
+		// Kt is owned and reused by each station, so it is not shared but rebuilt by the next compTemperatureProfile()
+		releaseKt(Kt);
 		tag_low = source.tag_low;
 		ColdContent = source.ColdContent;
 		ColdContentSoil = source.ColdContentSoil;
@@ -1458,16 +1480,7 @@ SnowStation& SnowStation::operator=(const SnowStation& source) {
 
 SnowStation::~SnowStation()
 {
-	SD_MATRIX_DATA* pMat = (SD_MATRIX_DATA*) Kt;
-
-	if (pMat != NULL) {
-		if ( pMat->State == ConMatrix ){
-			ReleaseConMatrix(&pMat->Mat.Con);
-		} else if ( pMat->State == BlockMatrix  ){
-			ReleaseBlockMatrix(&pMat->Mat.Block);
-		}
-		free(pMat);
-	}
+	releaseKt(Kt);
 }
 
 /**
@@ -820,32 +820,39 @@ bool Snowpack::compTemperatureProfile(const CurrentMeteo& Mdata, SnowStation& Xd
 		return true;
 	}
 
-	if (Kt != NULL)
-		ds_Solve(ReleaseMatrixData, (SD_MATRIX_DATA*)Kt, 0);
-	ds_Initialize(nN, (SD_MATRIX_DATA**)&Kt);
 	/*
-	 * Define the structure of the matrix, i.e. its connectivity. For each element
-	 * we compute the element incidences and pass the incidences to the solver.
-	 * The solver assumes that the element incidences build a crique, i.e. the
-	 * equations specified by the incidence set are all connected to each other.
-	 * Initialize element data.
-	*/
-	for (size_t e = 0; e < nE; e++) {
-		int Nodes[2] = {(int)e, (int)e+1};
-		ds_DefineConnectivity( (SD_MATRIX_DATA*)Kt, 2, Nodes , 1, 0 );
-	}
+	 * The elements form a chain, so the solver turns the matrix into a tridiagonal one at the
+	 * symbolic factorization below. From then on the matrix kept in Xdata.Kt is simply resized
+	 * to the current number of nodes and its storage reused, instead of being rebuilt every call.
+	 */
+	if (Kt == NULL || ds_ResizeTridiag(nN, (SD_MATRIX_DATA*)Kt)) {
+		if (Kt != NULL)
+			ds_Solve(ReleaseMatrixData, (SD_MATRIX_DATA*)Kt, 0);
+		ds_Initialize(nN, (SD_MATRIX_DATA**)&Kt);
+		/*
+		 * Define the structure of the matrix, i.e. its connectivity. For each element
+		 * we compute the element incidences and pass the incidences to the solver.
+		 * The solver assumes that the element incidences build a crique, i.e. the
+		 * equations specified by the incidence set are all connected to each other.
+		 * Initialize element data.
+		*/
+		for (size_t e = 0; e < nE; e++) {
+			int Nodes[2] = {(int)e, (int)e+1};
+			ds_DefineConnectivity( (SD_MATRIX_DATA*)Kt, 2, Nodes , 1, 0 );
+		}
 
-	/*
-	 * Perform the symbolic factorization. By specifying the element incidences, we
-	 * have simply declared which coefficients of the global matrix are not zero.
-	 * However, when we factorize the matrix in a LU form there is some fill-in.
-	 * Coefficients that were zero prior to start the factorization process will
-	 * have a value different from zero thereafter. At this step the solver compute
-	 * exactly how many memory is required to solve the problem and allocate this
-	 * memory in order to store the numerical matrix. Then reallocate all the
-	 * solution vectors.
-	*/
-	ds_Solve(SymbolicFactorize, (SD_MATRIX_DATA*)Kt, 0);
+		/*
+		 * Perform the symbolic factorization. By specifying the element incidences, we
+		 * have simply declared which coefficients of the global matrix are not zero.
+		 * However, when we factorize the matrix in a LU form there is some fill-in.
+		 * Coefficients that were zero prior to start the factorization process will
+		 * have a value different from zero thereafter. At this step the solver compute
+		 * exactly how many memory is required to solve the problem and allocate this
+		 * memory in order to store the numerical matrix. Then reallocate all the
+		 * solution vectors.
+		*/
+		ds_Solve(SymbolicFactorize, (SD_MATRIX_DATA*)Kt, 0);
+	}
 
 	// Make sure that these vectors are always available for use ....
 	errno=0;
@@ -439,6 +439,139 @@ int ReleaseConMatrix( SD_CON_MATRIX_DATA *pMat )
 
 }  // ReleaseConMatrix
 
+/**
+ * @brief Checks whether the connectivity is a chain, i.e. whether each equation is only connected
+ * to its direct neighbours, so that the matrix is tridiagonal without any reordering.
+ * @param pMat SD_CON_MATRIX_DATA
+ * @return bool
+ */
+inline bool IsChain( SD_CON_MATRIX_DATA *pMat )
+{
+	for (size_t Row = 0; Row < pMat->nRow; Row++) {
+		for (SD_COL_DATA *pCol = SD_ROW(Row, pMat).Col; pCol; pCol = pCol->Next) {
+			if ( SD_COL(pCol) + 1 != Row && SD_COL(pCol) != Row + 1 ) {
+				return false;
+			}
+		}
+	}
+	return true;
+
+}  // IsChain
+
+/**
+ * @brief Sets the dimension of a tridiagonal matrix, only reallocating if it exceeds the capacity.
+ * @param Dim size_t
+ * @param pMat SD_TRIDIAG_MATRIX_DATA
+ * @return int
+ */
+inline int AllocateTridiag( size_t Dim, SD_TRIDIAG_MATRIX_DATA *pMat )
+{
+	if ( Dim > pMat->Capacity ) {
+		ReleaseTridiagMatrix(pMat);
+		GD_MALLOC( pMat->pDiag,  double, Dim, "Tridiagonal Matrix");
+		GD_MALLOC( pMat->pUpper, double, Dim, "Tridiagonal Matrix");
+		GD_MALLOC( pMat->pLower, double, Dim, "Tridiagonal Matrix");
+		if ( gd_MemErr ) {
+			ERROR_SOLVER("Memory Error");
+		}
+		pMat->Capacity = Dim;
+	}
+	pMat->Dim = Dim;
+
+	return 0;
+
+}  // AllocateTridiag
+
+int ReleaseTridiagMatrix( SD_TRIDIAG_MATRIX_DATA *pMat )
+{
+	GD_FREE(pMat->pDiag);
+	GD_FREE(pMat->pUpper);
+	GD_FREE(pMat->pLower);
+	pMat->Capacity = 0;
+
+	return 0;
+
+}  // ReleaseTridiagMatrix
+
+/**
+ * @brief Assembles an element matrix into a tridiagonal matrix. As for the block matrix only the
+ * upper part of the element matrix is used.
+ * @param pMat SD_TRIDIAG_MATRIX_DATA
+ * @param nEq int
+ * @param Eq int
+ * @param Dim int
+ * @param ElMat double
+ * @return int
+ */
+inline int AssembleTridiag( SD_TRIDIAG_MATRIX_DATA *pMat, const int& nEq, int Eq[], const int& Dim, const double *ElMat )
+{
+	for (int Row = 0; Row < nEq; Row++) {
+		for (int Col = 0; Col < nEq; Col++) {
+			if ( Eq[Col] < Eq[Row] ) {
+				continue;
+			}
+			const double Value = ( Row<Col ) ? ElMat[ Row*Dim + Col ] : ElMat[ Col*Dim + Row ];
+			if ( Eq[Col] == Eq[Row] ) {
+				pMat->pDiag[ Eq[Row] ] += Value;
+			} else if ( Eq[Col] == Eq[Row] + 1 ) {
+				pMat->pUpper[ Eq[Row] ] += Value;
+			} else {
+				ERROR_SOLVER("Element not within the tridiagonal band");
+			}
+		}
+	}
+	return 0;
+
+}  // AssembleTridiag
+
+/**
+ * @brief LDL' factorization of a symmetric tridiagonal matrix, i.e. the forward elimination of the
+ * Thomas algorithm. The pivots overwrite the diagonal.
+ * @param pMat SD_TRIDIAG_MATRIX_DATA
+ * @return int
+ */
+inline int FactorizeTridiag( SD_TRIDIAG_MATRIX_DATA *pMat )
+{
+	double *d = pMat->pDiag, *u = pMat->pUpper, *l = pMat->pLower;
+
+	for (size_t i = 1; i < pMat->Dim; i++) {
+		if ( d[i-1] == 0. ) {
+			ERROR_SOLVER("Zero pivot");
+		}
+		l[i-1] = u[i-1] / d[i-1];
+		d[i] -= l[i-1] * u[i-1];
+	}
+	if ( pMat->Dim > 0 && d[pMat->Dim-1] == 0. ) {
+		ERROR_SOLVER("Zero pivot");
+	}
+	return 0;
+
+}  // FactorizeTridiag
+
+/**
+ * @brief Forward and back substitution with a factorized tridiagonal matrix. X holds the right hand
+ * side on input and the solution on output.
+ * @param pMat SD_TRIDIAG_MATRIX_DATA
+ * @param X double
+ */
+inline void SubstituteTridiag( SD_TRIDIAG_MATRIX_DATA *pMat, double *X )
+{
+	const double *d = pMat->pDiag, *u = pMat->pUpper, *l = pMat->pLower;
+	const size_t n = pMat->Dim;
+
+	if ( n == 0 ) {
+		return;
+	}
+	for (size_t i = 1; i < n; i++) {
+		X[i] -= l[i-1] * X[i-1];
+	}
+	X[n-1] /= d[n-1];
+	for (size_t i = n-1; i-- > 0; ) {
+		X[i] = ( X[i] - u[i] * X[i+1] ) / d[i];
+	}
+
+}  // SubstituteTridiag
+
 /*
  * INTERFACE FUNCITONS TO ACCESS THE SOLVER
  */
@@ -578,7 +711,42 @@ int ds_Solve( const SD_MATRIX_WHAT& Code, SD_MATRIX_DATA *pMat, double *X)
 			USER_ERROR("Bad Matrix Format for Symbolic Factorization");
 		}
 
-		SymbolicFact(pMat);
+		if ( IsChain(&pMat->Mat.Con) ) {
+			// No reordering nor fill-in needed, switch to the tridiagonal representation
+			SD_TRIDIAG_MATRIX_DATA Tridiag;
+			memset( &Tridiag, 0, sizeof(SD_TRIDIAG_MATRIX_DATA) );
+			if ( AllocateTridiag( pMat->Mat.Con.nRow, &Tridiag ) ) {
+				return 1;
+			}
+			ReleaseConMatrix(&pMat->Mat.Con);
+			pMat->State       = TridiagMatrix;
+			pMat->Mat.Tridiag = Tridiag;
+		} else {
+			SymbolicFact(pMat);
+		}
+	}
+
+	if ( pMat->State == TridiagMatrix ) {
+		if ( Code & ResetMatrixData ){
+			if ( Code != ResetMatrixData ){
+				USER_ERROR("You cannot reset the matrix together with other operations");
+			}
+			memset( pMat->Mat.Tridiag.pDiag,  0, pMat->Mat.Tridiag.Dim * sizeof(double) );
+			memset( pMat->Mat.Tridiag.pUpper, 0, pMat->Mat.Tridiag.Dim * sizeof(double) );
+		}
+		if ( Code & NumericFactorize ){
+			if ( FactorizeTridiag( &pMat->Mat.Tridiag ) ) {
+				return 1;
+			}
+		}
+		if ( Code & BackForwardSubst ){
+			SubstituteTridiag( &pMat->Mat.Tridiag, X );
+		}
+		if ( Code & ReleaseMatrixData ){
+			ReleaseTridiagMatrix(&pMat->Mat.Tridiag);
+			GD_FREE(pMat);
+		}
+		return 0;
 	}
 
 	// NumericFactoriz
@@ -656,6 +824,10 @@ int ds_AssembleMatrix(SD_MATRIX_DATA *pMat0, const int& nEq, int Eq[], const int
 	SD_ROW_BLOCK_DATA *pRow=NULL;
 	int Row, Col, PermRow, PermCol, Found, Index;
 
+	if ( pMat0->State == TridiagMatrix ) {
+		return AssembleTridiag( &pMat0->Mat.Tridiag, nEq, Eq, Dim, ElMat );
+	}
+
 	pMat = &pMat0->Mat.Block;
 
 	for (Row = 0; Row < nEq; Row++) {
@@ -680,6 +852,17 @@ int ds_AssembleMatrix(SD_MATRIX_DATA *pMat0, const int& nEq, int Eq[], const int
 
 }  /* ds_AssembleMatrix */
 
+int ds_ResizeTridiag(const size_t& MatDim, SD_MATRIX_DATA *pMat)
+{
+	if ( pMat->State != TridiagMatrix ) {
+		return 1;
+	}
+	pMat->nEq = MatDim;
+
+	return AllocateTridiag( MatDim, &pMat->Mat.Tridiag );
+
+}  /* ds_ResizeTridiag */
+
 
 /**
  * @brief This function permute a vector, for a given permutation vector and compute the inverse
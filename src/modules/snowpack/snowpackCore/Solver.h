@@ -147,6 +147,22 @@ typedef struct
 	SD_COL_BLOCK_DATA     *FreeColBlock;
 }  SD_TMP_CON_MATRIX_DATA;
 
+/**
+ * @struct SD_TRIDIAG_MATRIX_DATA
+ * @brief Symmetric tridiagonal matrix. This is the form of the matrix when the connectivity is a
+ * chain, i.e. equation i is only connected to i-1 and i+1, as for a 1D column of 2-node elements.
+ * It is factorized without reordering nor fill-in (Thomas algorithm). The storage is only
+ * reallocated when the matrix grows beyond its capacity.
+ */
+typedef struct
+{
+	size_t   Dim;
+	size_t   Capacity;
+	double  *pDiag;     ///< diagonal, holds the pivots once factorized
+	double  *pUpper;    ///< pUpper[i] couples equations i and i+1
+	double  *pLower;    ///< multipliers of the factorization
+}  SD_TRIDIAG_MATRIX_DATA;
+
 /**
  * @struct SD_MATRIX_DATA
 * @brief When the user define a matrix, the software return a pointer to an opaque type i.e. a
@@ -156,7 +172,7 @@ typedef struct
 * of the algorithn.
 */
 
-typedef enum StateType {ConMatrix, BlockConMatrix, BlockMatrix}  StateType;
+typedef enum StateType {ConMatrix, BlockConMatrix, BlockMatrix, TridiagMatrix}  StateType;
 
 typedef  struct
 {
@@ -168,6 +184,7 @@ typedef  struct
 	{  SD_CON_MATRIX_DATA      Con;
 	SD_TMP_CON_MATRIX_DATA  TmpCon;
 	SD_BLOCK_MATRIX_DATA    Block;
+	SD_TRIDIAG_MATRIX_DATA  Tridiag;
 	}  Mat;
 }  SD_MATRIX_DATA;
 
@@ -316,6 +333,18 @@ int ds_AssembleMatrix( SD_MATRIX_DATA *pMat0, const int& nEq, int Eq[], const in
  */
 int ds_Solve( const SD_MATRIX_WHAT& Code, SD_MATRIX_DATA *pMat, double *pX );
 
+/**
+ * @brief The symbolic factorization switches to a tridiagonal matrix when the connectivity is a chain.
+ * Such a matrix can be resized to another chain of MatDim equations and reused as is, skipping
+ * ds_Initialize(), ds_DefineConnectivity() and the symbolic factorization.
+ * The coefficients must be reset (ResetMatrixData) before assembling.
+ * @param [in] MatDim new dimension of the matrix [A]
+ * @param [in] pMat pointer to the matrix [A] opaque data
+ * @return 0 if resized, 1 if the matrix is not tridiagonal
+ */
+int ds_ResizeTridiag( const size_t& MatDim, SD_MATRIX_DATA *pMat );
+
 int ReleaseConMatrix( SD_CON_MATRIX_DATA * pMat );
 int ReleaseBlockMatrix( SD_BLOCK_MATRIX_DATA * pMat );
+int ReleaseTridiagMatrix( SD_TRIDIAG_MATRIX_DATA * pMat );
 #endif
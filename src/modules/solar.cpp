@@ -156,13 +156,14 @@ void solar::init(mesh& domain)
     //size of the step to take
     double size_of_step = max_distance / steps;
 
+    std::vector<double> distances;
+    for (int j = 1; j <= steps; ++j)
+        distances.push_back(j * size_of_step);
+
     //number of azimuthal sections
     int N = cfg.get("svf.nsectors", 12);
 
 
-    double azimuthal_width = 360./(double)N; // in degrees
-
-
     bool svf_compute = cfg.get("svf.compute",true);
 
     OGRSpatialReference monUtm;
@@ -179,6 +180,13 @@ void solar::init(mesh& domain)
         coordTrans = OGRCreateCoordinateTransformation(&monUtm, &monGeo);
     }
 
+    // the sky-view factor only depends on the terrain, so an earlier run on this mesh may have already stored it
+    std::vector<double> svf_values;
+    bool svf_stored = svf_compute &&
+                      global_param->artifacts().load(ID, "svf", cfg.get_child("svf", pt::ptree()), svf_values, domain->size_faces());
+    if (svf_compute && !svf_stored)
+        svf_values.resize(domain->size_faces());
+
     #pragma omp parallel for
     for (size_t i = 0; i < domain->size_faces(); i++)
     {
@@ -201,39 +209,14 @@ void solar::init(mesh& domain)
 
 	       if(svf_compute)
 	       {
-               Point_3 me = face->center();
-               auto cosSlope = cos(face->slope());
-               auto sinSlope = sin(face->slope());
-
-               //for each search azimuthal sector
-               for (int k = 0; k < N; k++)
+               if(!svf_stored)
                {
-                   double phi = 0.;
-                   // search along each azimuth in j step increments to find horizon angle
-                   for (int j = 1; j <= steps; ++j)
-                   {
-                   double distance = j * size_of_step;
-
-                   auto f = domain->find_closest_face(math::gis::point_from_bearing(me, k * azimuthal_width, distance));
-
-                   double z_diff = (f->center().z() - me.z());
-                   if (z_diff > 0)
-                   {
-                       double dist = math::gis::distance(f->center(), me);
-                       phi = std::max(atan(z_diff / dist), phi);
-                   }
-                   }
-
-                   auto cosPhi = cos(phi);
-                   auto sinPhi = sin(phi);
-                   auto azi_in_rad = (k * azimuthal_width * M_PI / 180.);
-
-                   svf += cosSlope * cosPhi * cosPhi +
-                 sinSlope * cos(azi_in_rad - face->aspect()) * (M_PI_2 - phi - sinPhi * cosPhi);
-
+                   if(domain->is_geographic())
+                       svf_values[i] = sky_view_factor<math::gis::LatLong>(face, N, distances);
+                   else
+                       svf_values[i] = sky_view_factor<math::gis::UTM>(face, N, distances);
                }
-
-               svf /= (double)N;
+               svf = svf_values[i];
 	       } else{
 		        svf = 1.;
 	       }
@@ -244,4 +227,85 @@ void solar::init(mesh& domain)
 
     delete coordTrans;
 
+    if (svf_compute && !svf_stored)
+        global_param->artifacts().save(ID, "svf", cfg.get_child("svf", pt::ptree()), svf_values);
+
+}
+
+bool solar::migrates()
+{
+    return true;
+}
+
+void solar::pack_face(mesh_elem& face, std::vector<double>& buf)
+{
+    // only UTM meshes keep the face's lat/long
+    if(global_param->is_geographic())
+        return;
+
+    auto d = face->get_module_data<solar::data>(ID);
+    buf.insert(buf.end(), {d->lat, d->lng});
+}
+
+void solar::unpack_face(mesh_elem& face, const double*& buf)
+{
+    if(global_param->is_geographic())
+        return;
+
+    auto d = face->make_module_data<solar::data>(ID);
+    d->lat = *buf++;
+    d->lng = *buf++;
+}
+
+template<typename Geo>
+double solar::sky_view_factor(mesh_elem& face, int N, const std::vector<double>& distances)
+{
+    double azimuthal_width = 360./(double)N; // in degrees
+    size_t steps = distances.size();
+
+    Point_3 me = face->center();
+    auto cosSlope = cos(face->slope());
+    auto sinSlope = sin(face->slope());
+
+    // faces along the ray, and their distance. Scratch space is per thread and only grows, so faces don't allocate
+    thread_local std::vector<mesh_elem> f;
+    thread_local std::vector<double> x, y, dist;
+    f.resize(steps);
+    x.resize(steps);
+    y.resize(steps);
+    dist.resize(steps);
+
+    double svf = 0.0;
+
+    //for each search azimuthal sector
+    for (int k = 0; k < N; k++)
+    {
+        face->find_closest_faces<Geo>(k * azimuthal_width, distances.data(), steps, f.data());
+        for (size_t j = 0; j < steps; ++j)
+        {
+            x[j] = f[j]->center().x();
+            y[j] = f[j]->center().y();
+        }
+        Geo::distance(me, x.data(), y.data(), dist.data(), steps);
+
+        double phi = 0.;
+        // search along each azimuth in j step increments to find horizon angle
+        for (size_t j = 0; j < steps; ++j)
+        {
+            double z_diff = (f[j]->center().z() - me.z());
+            if (z_diff > 0)
+            {
+                phi = std::max(atan(z_diff / dist[j]), phi);
+            }
+        }
+
+        auto cosPhi = cos(phi);
+        auto sinPhi = sin(phi);
+        auto azi_in_rad = (k * azimuthal_width * M_PI / 180.);
+
+        svf += cosSlope * cosPhi * cosPhi +
+               sinSlope * cos(azi_in_rad - face->aspect()) * (M_PI_2 - phi - sinPhi * cosPhi);
+    }
+
+    return svf / (double)N;
 }
@@ -25,6 +25,7 @@
 
 #include "module_base.hpp"
 #include <ogr_spatialref.h>
+#include <vector>
 
 
 /**
@@ -54,4 +55,14 @@ public:
     ~solar();
     void run(mesh_elem &face);
     void init(mesh& domain);
+    bool migrates();
+    void pack_face(mesh_elem& face, std::vector<double>& buf);
+    void unpack_face(mesh_elem& face, const double*& buf);
+
+    /**
+     * Sky view factor of the face from the horizon angle of N azimuthal sectors, found by stepping out the given distances.
+     * Geo is the mesh's geometry, math::gis::UTM or math::gis::LatLong
+     */
+    template<typename Geo>
+    double sky_view_factor(mesh_elem& face, int N, const std::vector<double>& distances);
 };
@@ -22,6 +22,7 @@
 //
 
 #include "physics/Atmosphere.h"
+#include "math/lookup_table.hpp"
 
 namespace Atmosphere
 {
@@ -59,7 +60,7 @@ namespace Atmosphere
     * @param T air temperature (K)
     * @return Saturated vapour pressure (Pa)
     */
-    double saturatedVapourPressure(const double& T)
+    double saturatedVapourPressure_exact(const double& T)
     {
         double TA = T - 273.15;
         double Es, E, Rhi, Rhw, Rh;                         //saturation and current water vapro pressure
@@ -79,4 +80,15 @@ namespace Atmosphere
         return Es;
     }
 
+    double saturatedVapourPressure(const double& T)
+    {
+        // air temperatures (K), 1e-6 relative
+        static const math::lookup_table_1d table(saturatedVapourPressure_exact, 173.15, 373.15, 1e-6);
+
+        if (table.in_range(T))
+            return table(T);
+
+        return saturatedVapourPressure_exact(T);
+    }
+
 }
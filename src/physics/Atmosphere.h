@@ -42,7 +42,12 @@ namespace Atmosphere {
    // See Fig 1 and 2 of Kienzle (2010, Hydrological Processes)
     double corr_precip_slope(double p, double slope);
 
+    /**
+     * Saturated vapour pressure (Pa) for air temperature T (K). Interpolated from a table for 173.15 K to 373.15 K,
+     * within 1e-6 (relative) of saturatedVapourPressure_exact
+     */
     double saturatedVapourPressure(const double& T);
+    double saturatedVapourPressure_exact(const double& T);
 }
 
 
@@ -37,6 +37,8 @@ station::station()
 
     _nc_x = _nc_y = -1;
 
+    _table = std::make_shared<station_table>();
+    _row = _table->add_row();
 }
 
 station::station(std::string ID, double x, double y, double elevation, std::set<std::string> variables )
@@ -47,16 +49,23 @@ station::station(std::string ID, double x, double y, double elevation, std::set<
     _z = elevation;
 
     _nc_x = _nc_y = -1;
-    init(std::move(variables));
-}
 
-double& station::operator[](const uint64_t& hash)
-{
-    return _timestep_data[hash];
+    _table = std::make_shared<station_table>();
+    _table->init(variables, 1);
+    _row = 0;
 }
-double& station::operator[](const std::string& variable)
+
+station::station(std::string ID, double x, double y, double elevation, std::shared_ptr<station_table> table, size_t row)
 {
-    return _timestep_data[variable];
+    _ID = ID;
+    _x = x;
+    _y = y;
+    _z = elevation;
+
+    _nc_x = _nc_y = -1;
+
+    _table = table;
+    _row = row;
 }
 
 
@@ -108,62 +117,77 @@ std::ostream &operator<<(std::ostream &strm, const station &s)
 
 void station::init(std::set<std::string> variables)
 {
-    _timestep_data.init(variables);
+    _table->add_variables(variables);
+}
+
+void station::detach()
+{
+    auto variables = _table->variables();
+
+    auto table = std::make_shared<station_table>();
+    table->init(std::set<std::string>(variables.begin(), variables.end()), 1);
+    table->set_posix(_table->get_posix());
+
+    for (auto& v : variables)
+        table->value(v, 0) = _table->value(v, _row);
+
+    _table = table;
+    _row = 0;
 }
 
 boost::gregorian::date station::get_gregorian()
 {
     boost::gregorian::date date;
 
-    date = boost::gregorian::from_string(boost::lexical_cast<std::string>(_current_ts.date()));
+    date = boost::gregorian::from_string(boost::lexical_cast<std::string>(get_posix().date()));
     return date;
 
 }
 boost::posix_time::ptime station::get_posix()
 {
-    return _current_ts;
+    return _table->get_posix();
 }
 
 void station::set_posix(boost::posix_time::ptime ts )
 {
-    _current_ts = ts;
+    _table->set_posix(ts);
 }
 
 
 bool station::has(const std::string &variable)
 {
-    return _timestep_data.has(variable);
+    return _table->has(variable);
 }
 
 
 int station::month()
 {
-    return _current_ts.date().month();
+    return get_posix().date().month();
 }
 
 
 int station::day()
 {
-    return _current_ts.date().day();
+    return get_posix().date().day();
 
 }
 
 int station::year()
 {
-    return _current_ts.date().year();
+    return get_posix().date().year();
 }
 
 int station::hour()
 {
-    return boost::posix_time::to_tm(_current_ts).tm_hour;
+    return boost::posix_time::to_tm(get_posix()).tm_hour;
 }
 int station::min()
 {
-    return boost::posix_time::to_tm(_current_ts).tm_min;
+    return boost::posix_time::to_tm(get_posix()).tm_min;
 }
 int station::sec()
 {
-    return boost::posix_time::to_tm(_current_ts).tm_sec;
+    return boost::posix_time::to_tm(get_posix()).tm_sec;
 }
 
 bool station::operator==(const station& s) const
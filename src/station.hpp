@@ -23,10 +23,12 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "variablestorage.hpp"
 #include "timeseries.hpp"
+#include "station_table.hpp"
 
 /**
 * \class station
@@ -34,6 +36,8 @@
 * \brief Concept of a met station.
 *
 * Allows the station to represent a timestep that has a location (x,y), an elevation, and a station ID.
+* The timestep values are held in one row of a station_table, which is shared with the other stations from the same forcing.
+* A station created on its own gets a private single row table.
 */
 class station
 {
@@ -54,6 +58,18 @@ public:
         */
     station(std::string ID, double x, double y, double elevation, std::set<std::string> variables = {});
 
+    /**
+        Creates a new station that is a view onto a row of a table
+
+        \param ID Station name
+        \param x UTM coord
+        \param y UTM coord
+        \param elevation station elevation
+        \param table Table holding the values
+        \param row Row of this station in the table
+        */
+    station(std::string ID, double x, double y, double elevation, std::shared_ptr<station_table> table, size_t row);
+
     /**
     * Default destructor
     */
@@ -108,11 +124,34 @@ public:
     std::string ID() const;
 
     /**
-     * Initializes the station to store the specified variables. This will destroy all data
+     * Adds the specified variables to the station's table, set to -9999.
+     * If the table is shared, the variables are added for all of its stations.
      * @param variables
      */
     void init(std::set<std::string> variables);
 
+    /**
+     * Table holding this station's values
+     */
+    std::shared_ptr<station_table> table()
+    {
+        return _table;
+    }
+
+    /**
+     * Row of this station in its table
+     */
+    size_t row() const
+    {
+        return _row;
+    }
+
+    /**
+     * Moves the current values into a private table so the station no longer changes with, or holds a row in, the shared table.
+     * Used when a station is removed from the forcing.
+     */
+    void detach();
+
     /**
     * Returns the current hour, 24-hour format
     */
@@ -156,7 +195,7 @@ public:
     boost::posix_time::ptime get_posix();
 
     /**
-    * Returns the boost::posix_time structure for time calculations
+    * Sets the time of the values. This is the time of the whole table, so all stations sharing it.
     */
     void set_posix(boost::posix_time::ptime ts );
 
@@ -165,8 +204,14 @@ public:
  */
     bool has(const std::string &variable);
 
-    double& operator[](const uint64_t& hash);
-    double& operator[](const std::string& variable);
+    double& operator[](const uint64_t& hash)
+    {
+        return _table->value(hash, _row);
+    }
+    double& operator[](const std::string& variable)
+    {
+        return _table->value(variable, _row);
+    }
 
     /// Stations are equal if they have the same id
     /// @param s
@@ -182,15 +227,25 @@ public:
     double _nc_y;
 
 private:
+    friend class station_table;
+
     std::string _ID;
     double _x;
     double _y;
     double _z;
 
+    std::shared_ptr<station_table> _table;
+    size_t _row;
+};
 
-    variablestorage<double> _timestep_data;
-    boost::posix_time::ptime _current_ts;
+double& station_table::column::operator[](const station& s) const
+{
+    return _data[s.row()];
+}
 
-};
+double& station_table::column::operator[](const std::shared_ptr<station>& s) const
+{
+    return _data[s->row()];
+}
 
 
@@ -0,0 +1,123 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include "station_table.hpp"
+
+station_table::station_table()
+{
+    _rows = 0;
+    _stations = nullptr;
+}
+
+void station_table::init(const std::set<std::string>& variables, size_t rows)
+{
+    _rows = rows;
+    _names.assign(variables.begin(), variables.end());
+    _columns.assign(_names.size(), std::vector<double>(_rows, -9999.));
+
+    build_index();
+}
+
+void station_table::add_variables(const std::set<std::string>& variables)
+{
+    bool added = false;
+    for (auto& v : variables)
+    {
+        if (std::find(_names.begin(), _names.end(), v) != _names.end())
+            continue;
+
+        _names.push_back(v);
+        _columns.emplace_back(_rows, -9999.);
+        added = true;
+    }
+
+    if (added)
+        build_index();
+}
+
+size_t station_table::add_row()
+{
+    for (auto& col : _columns)
+        col.push_back(-9999.);
+
+    return _rows++;
+}
+
+void station_table::select(std::vector<std::shared_ptr<station>>& stations)
+{
+    for (auto& s : stations)
+    {
+        if (s->_table.get() != this)
+            BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Station " + s->ID() + " is not in this station table"));
+    }
+
+    for (auto& col : _columns)
+    {
+        std::vector<double> selected(stations.size());
+        for (size_t i = 0; i < stations.size(); i++)
+            selected[i] = col[stations[i]->_row];
+
+        col.swap(selected);
+    }
+
+    for (size_t i = 0; i < stations.size(); i++)
+        stations[i]->_row = i;
+
+    _rows = stations.size();
+}
+
+double* station_table::operator[](const std::string& variable)
+{
+    if (!has(variable))
+        add_variables({variable});
+
+    return _columns[lookup(variable)].data();
+}
+
+const double* station_table::at(const std::string& variable) const
+{
+    auto itr = std::find(_names.begin(), _names.end(), variable);
+    if (itr == _names.end())
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("No station column for " + variable));
+
+    return _columns[itr - _names.begin()].data();
+}
+
+void station_table::build_index()
+{
+    if (_names.empty())
+    {
+        _index.reset();
+        return;
+    }
+
+    std::set<std::string> variables(_names.begin(), _names.end());
+    auto index = std::make_unique<variablestorage<size_t>>(variables);
+
+    for (size_t i = 0; i < _names.size(); i++)
+        (*index)[_names[i]] = i;
+
+    _index = std::move(index);
+}
@@ -0,0 +1,213 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "exception.hpp"
+#include "variablestorage.hpp"
+
+class station;
+
+/**
+ * The current timestep of a set of stations, held as a contiguous array (column) per variable, indexed by the station's row.
+ *
+ * The table owns the values and the stations are views onto one of its rows. There is one variable -> column lookup for the
+ * whole table instead of one per station.
+ */
+class station_table
+{
+public:
+
+    /**
+     * Handle to the column of one variable. Resolve it once, outside of any loops over stations.
+     * Only valid for the stations of the table it came from, until rows are added or removed.
+     */
+    class column
+    {
+    public:
+        column()
+                : _data(nullptr)
+        {
+        }
+
+        explicit column(double* data)
+                : _data(data)
+        {
+        }
+
+        double& operator[](size_t row) const
+        {
+            return _data[row];
+        }
+
+        // defined in station.hpp
+        inline double& operator[](const station& s) const;
+        inline double& operator[](const std::shared_ptr<station>& s) const;
+
+        double* data() const
+        {
+            return _data;
+        }
+
+    private:
+        double* _data;
+    };
+
+    station_table();
+
+    station_table(const station_table&) = delete;
+    station_table& operator=(const station_table&) = delete;
+
+    /**
+     * Creates the table with these variables and number of rows. Values are set to -9999
+     */
+    void init(const std::set<std::string>& variables, size_t rows);
+
+    /**
+     * Adds any of these variables that don't exist yet, filled with -9999
+     */
+    void add_variables(const std::set<std::string>& variables);
+
+    /**
+     * Appends a row of -9999
+     * @return Index of the new row
+     */
+    size_t add_row();
+
+    /**
+     * Keeps only the rows of these stations, in this order, and updates the stations to point to their new row.
+     * The stations must belong to this table.
+     */
+    void select(std::vector<std::shared_ptr<station>>& stations);
+
+    /**
+     * The stations that are views onto this table, with stations()[i] being row i.
+     * Used to run the per-station filters over the table.
+     */
+    void set_stations(std::vector<std::shared_ptr<station>>& stations)
+    {
+        _stations = &stations;
+    }
+
+    std::vector<std::shared_ptr<station>>& stations()
+    {
+        if (!_stations)
+            BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Station table has no stations set"));
+        return *_stations;
+    }
+
+    /**
+     * Number of rows
+     */
+    size_t size() const
+    {
+        return _rows;
+    }
+
+    /**
+     * Column of a variable. It is added, filled with -9999, if it doesn't exist.
+     * The pointer is valid until rows are added or removed.
+     */
+    double* operator[](const std::string& variable);
+
+    /**
+     * Column of an existing variable, throws if it doesn't exist
+     */
+    column get(const uint64_t& hash)
+    {
+        return column(_columns[lookup(hash)].data());
+    }
+    column get(const std::string& variable)
+    {
+        return column(_columns[lookup(variable)].data());
+    }
+
+    const double* at(const std::string& variable) const;
+
+    bool has(const uint64_t& hash)
+    {
+        return _index && _index->has(hash);
+    }
+    bool has(const std::string& variable)
+    {
+        return _index && _index->has(variable);
+    }
+
+    /**
+     * Value of a variable for a row. Prefer a column handle when looping over many rows.
+     */
+    double& value(const uint64_t& hash, size_t row)
+    {
+        return _columns[lookup(hash)][row];
+    }
+    double& value(const std::string& variable, size_t row)
+    {
+        return _columns[lookup(variable)][row];
+    }
+
+    std::vector<std::string> variables() const
+    {
+        return _names;
+    }
+
+    /**
+     * Time of the values currently held
+     */
+    boost::posix_time::ptime get_posix() const
+    {
+        return _current_ts;
+    }
+    void set_posix(boost::posix_time::ptime ts)
+    {
+        _current_ts = ts;
+    }
+
+private:
+    // rebuilds the variable -> column lookup from _names
+    void build_index();
+
+    template<typename Key>
+    size_t lookup(const Key& variable)
+    {
+        if (!_index)
+            BOOST_THROW_EXCEPTION(module_error() << errstr_info("Station table has no variables"));
+        return (*_index)[variable];
+    }
+
+    std::unique_ptr<variablestorage<size_t>> _index;
+    std::vector<std::string> _names;
+    std::vector<std::vector<double>> _columns;
+    size_t _rows;
+
+    boost::posix_time::ptime _current_ts;
+    std::vector<std::shared_ptr<station>>* _stations;
+};
+
+#include "station.hpp"
@@ -0,0 +1,96 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/filesystem.hpp>
+
+#include "artifact_store.hpp"
+#include "logger.hpp"
+#include "gtest/gtest.h"
+
+class ArtifactStoreTest : public testing::Test
+{
+  protected:
+
+    virtual void SetUp()
+    {
+        logging::core::get()->set_logging_enabled(false);
+
+        dir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        cfg.put("distance", 300);
+    }
+
+    virtual void TearDown()
+    {
+        boost::filesystem::remove_all(dir);
+    }
+
+    std::string dir;
+    pt::ptree cfg;
+};
+
+TEST_F(ArtifactStoreTest, Disabled)
+{
+    artifact_store store;
+    std::vector<double> values = {1, 2, 3};
+
+    ASSERT_FALSE(store.enabled());
+    store.save("Liston_wind", "curvature", cfg, values);
+    ASSERT_FALSE(store.load("Liston_wind", "curvature", cfg, values, 3));
+    ASSERT_EQ(store.hits() + store.misses(), 0);
+}
+
+TEST_F(ArtifactStoreTest, SaveLoad)
+{
+    std::vector<double> values = {1, -2.5, 3e10};
+    std::vector<double> loaded;
+
+    {
+        artifact_store store;
+        store.open(dir, 42);
+
+        ASSERT_FALSE(store.load("Liston_wind", "curvature", cfg, loaded, 3));
+        store.save("Liston_wind", "curvature", cfg, values);
+        ASSERT_EQ(store.misses(), 1);
+    }
+
+    artifact_store store;
+    store.open(dir, 42);
+    ASSERT_TRUE(store.load("Liston_wind", "curvature", cfg, loaded, 3));
+    ASSERT_EQ(loaded, values);
+
+    // anything in the key changing is a miss
+    ASSERT_FALSE(store.load("Liston_wind", "curvature", cfg, loaded, 4));
+    ASSERT_FALSE(store.load("Liston_wind", "svf", cfg, loaded, 3));
+    ASSERT_FALSE(store.load("solar", "curvature", cfg, loaded, 3));
+
+    pt::ptree other;
+    other.put("distance", 200);
+    ASSERT_FALSE(store.load("Liston_wind", "curvature", other, loaded, 3));
+
+    artifact_store other_mesh;
+    other_mesh.open(dir, 43);
+    ASSERT_FALSE(other_mesh.load("Liston_wind", "curvature", cfg, loaded, 3));
+
+    ASSERT_EQ(store.hits(), 1);
+    ASSERT_EQ(store.misses(), 4);
+}
@@ -0,0 +1,205 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "math/column_operator.hpp"
+#include "gtest/gtest.h"
+
+// columns on a ring, each coupled to the previous and next, with suspension-like coefficients: a diagonally dominant,
+// non-symmetric vertical advection-diffusion with weak lateral coupling
+static math::column_operator make_operator(size_t ncol, size_t nlayer, unsigned int seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coeff(0.1, 1.0);
+
+    math::column_operator op(ncol, nlayer);
+    for (size_t i = 0; i < ncol; i++)
+    {
+        op.set_neighbours(i, {static_cast<int>((i + 1) % ncol), static_cast<int>((i + ncol - 1) % ncol), -1});
+
+        for (size_t z = 0; z < nlayer; z++)
+        {
+            double sum = 0;
+            for (size_t j = 0; j < 2; j++)
+            {
+                op.lateral(i, z, j) = 0.1 * coeff(gen);
+                sum += op.lateral(i, z, j);
+            }
+            if (z > 0)
+            {
+                op.down(i, z) = 5 * coeff(gen);
+                sum += op.down(i, z);
+            }
+            if (z + 1 < nlayer)
+            {
+                op.up(i, z) = 5 * coeff(gen);
+                sum += op.up(i, z);
+            }
+            op.diag(i, z) = -sum - coeff(gen);
+        }
+    }
+    return op;
+}
+
+// A x with the operator expanded to a dense matrix
+static std::vector<double> dense_apply(math::column_operator& op, const std::vector<double>& x, size_t ncol,
+                                       const std::vector<std::array<int, 3>>& neighbours)
+{
+    size_t n = op.size();
+    std::vector<double> y(n, 0.);
+    for (size_t i = 0; i < ncol; i++)
+    {
+        for (size_t z = 0; z < op.layers(); z++)
+        {
+            size_t c = ncol * z + i;
+            y[c] += op.diag(i, z) * x[c];
+            if (z > 0)
+                y[c] += op.down(i, z) * x[c - ncol];
+            if (z + 1 < op.layers())
+                y[c] += op.up(i, z) * x[c + ncol];
+            for (size_t j = 0; j < 3; j++)
+            {
+                if (neighbours[i][j] >= 0)
+                    y[c] += op.lateral(i, z, j) * x[ncol * z + neighbours[i][j]];
+            }
+        }
+    }
+    return y;
+}
+
+TEST(ColumnOperator, Apply)
+{
+    size_t ncol = 50, nlayer = 5;
+    auto op = make_operator(ncol, nlayer, 1);
+
+    std::vector<std::array<int, 3>> neighbours(ncol);
+    for (size_t i = 0; i < ncol; i++)
+        neighbours[i] = {static_cast<int>((i + 1) % ncol), static_cast<int>((i + ncol - 1) % ncol), -1};
+
+    std::vector<double> x(op.size());
+    for (size_t k = 0; k < x.size(); k++)
+        x[k] = std::sin(0.1 * k);
+
+    std::vector<double> y(op.size());
+    op.apply(x.data(), y.data());
+
+    auto expected = dense_apply(op, x, ncol, neighbours);
+    for (size_t k = 0; k < y.size(); k++)
+        EXPECT_NEAR(expected[k], y[k], 1e-12);
+}
+
+TEST(ColumnOperator, LineSolveIsExactWithoutLateralCoupling)
+{
+    size_t ncol = 20, nlayer = 7;
+    math::column_operator op(ncol, nlayer);
+    for (size_t i = 0; i < ncol; i++)
+    {
+        for (size_t z = 0; z < nlayer; z++)
+        {
+            op.diag(i, z) = -4. - 0.1 * i;
+            op.up(i, z) = 1.5;
+            op.down(i, z) = 1.;
+        }
+    }
+
+    std::vector<double> x(op.size()), b(op.size()), y(op.size());
+    for (size_t k = 0; k < x.size(); k++)
+        x[k] = std::cos(0.3 * k);
+    op.apply(x.data(), b.data());
+
+    op.factor();
+    op.line_solve(b.data(), y.data());
+    for (size_t k = 0; k < x.size(); k++)
+        EXPECT_NEAR(x[k], y[k], 1e-12);
+}
+
+TEST(ColumnOperator, Solve)
+{
+    size_t ncol = 500, nlayer = 5;
+    auto op = make_operator(ncol, nlayer, 2);
+
+    std::vector<double> b(op.size(), 0.);
+    for (size_t i = 0; i < ncol; i += 7)
+        b[i] = -1.; // sources in the bottom layer, as saltation gives
+
+    std::vector<double> x;
+    double tol = 1e-10;
+    size_t iterations = op.solve(b, x, tol, 1000, 30);
+
+    EXPECT_GT(iterations, 0);
+    EXPECT_LE(op.error(), tol);
+
+    std::vector<double> r(op.size());
+    op.apply(x.data(), r.data());
+    double norm = 0, b_norm = 0;
+    for (size_t k = 0; k < r.size(); k++)
+    {
+        norm += (b[k] - r[k]) * (b[k] - r[k]);
+        b_norm += b[k] * b[k];
+    }
+    EXPECT_LE(std::sqrt(norm / b_norm), tol);
+
+    // a zero RHS is solved without iterating
+    std::vector<double> zero(op.size(), 0.);
+    EXPECT_EQ(0, op.solve(zero, x, tol, 1000, 30));
+    for (auto v : x)
+        EXPECT_EQ(0, v);
+}
+
+TEST(ColumnOperator, RestrictTo)
+{
+    size_t ncol = 10, nlayer = 3;
+    auto op = make_operator(ncol, nlayer, 3);
+
+    // columns 2, 3, 4: 3 keeps both its neighbours, 2 and 4 lose one each
+    std::vector<unsigned int> columns = {2, 3, 4};
+    auto sub = op.restrict_to(columns);
+
+    ASSERT_EQ(3, sub.columns());
+    ASSERT_EQ(nlayer, sub.layers());
+
+    // with zeros outside the region the restricted operator agrees with the full one inside it
+    std::vector<double> x(op.size(), 0.), sub_x(sub.size());
+    for (size_t k = 0; k < columns.size(); k++)
+    {
+        for (size_t z = 0; z < nlayer; z++)
+        {
+            x[ncol * z + columns[k]] = 1. + k + z;
+            sub_x[columns.size() * z + k] = 1. + k + z;
+        }
+    }
+
+    std::vector<double> y(op.size()), sub_y(sub.size());
+    op.apply(x.data(), y.data());
+    sub.apply(sub_x.data(), sub_y.data());
+
+    for (size_t k = 0; k < columns.size(); k++)
+    {
+        for (size_t z = 0; z < nlayer; z++)
+            EXPECT_NEAR(y[ncol * z + columns[k]], sub_y[columns.size() * z + k], 1e-12);
+    }
+}
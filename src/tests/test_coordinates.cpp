@@ -0,0 +1,90 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <vector>
+
+#include "math/coordinates.hpp"
+#include "gtest/gtest.h"
+
+using namespace math::gis;
+
+template<typename Geo>
+static void check_policy(Point_3 src)
+{
+    std::vector<double> d;
+    for (int j = 1; j <= 50; j++)
+        d.push_back(j * 37.3);
+
+    std::vector<double> x(d.size()), y(d.size()), dist(d.size());
+
+    for (double bearing = 0; bearing < 360; bearing += 7.3)
+    {
+        Geo::point_from_bearing(src, bearing, d.data(), x.data(), y.data(), d.size());
+        Geo::distance(src, x.data(), y.data(), dist.data(), d.size());
+
+        for (size_t j = 0; j < d.size(); j++)
+        {
+            // batched is the scalar computation with the loop invariants hoisted
+            Point_2 p = Geo::point_from_bearing(src, bearing, d[j]);
+            EXPECT_EQ(p.x(), x[j]);
+            EXPECT_EQ(p.y(), y[j]);
+            EXPECT_EQ(Geo::distance(src, Point_3(x[j], y[j], 0)), dist[j]);
+
+            // and the point is the distance away
+            EXPECT_NEAR(d[j], dist[j], 1e-6 * d[j]);
+        }
+    }
+}
+
+TEST(Coordinates, UTM)
+{
+    Point_3 src(500000, 5650000, 1000);
+    check_policy<UTM>(src);
+
+    // same as the runtime selected functions
+    Point_3 dst(500300, 5650400, 0);
+    EXPECT_EQ(distance_UTM(src, dst), UTM::distance(src, dst));
+    EXPECT_DOUBLE_EQ(500.0, UTM::distance(src, dst));
+
+    Point_2 north = UTM::point_from_bearing(src, 0, 100);
+    EXPECT_DOUBLE_EQ(500000, north.x());
+    EXPECT_DOUBLE_EQ(5650100, north.y());
+}
+
+TEST(Coordinates, LatLong)
+{
+    Point_3 src(-115.3, 51.1, 1000);
+    check_policy<LatLong>(src);
+
+    // x is longitude, y latitude
+    Point_2 east = LatLong::point_from_bearing(src, 90, 1000);
+    EXPECT_GT(east.x(), src.x());
+    EXPECT_NEAR(src.y(), east.y(), 1e-3);
+
+    Point_2 north = LatLong::point_from_bearing(src, 0, 1000);
+    EXPECT_NEAR(src.x(), north.x(), 1e-12);
+    EXPECT_GT(north.y(), src.y());
+
+    Point_3 dst(-115.2, 51.2, 0);
+    EXPECT_EQ(distance_latlong(src, dst), LatLong::distance(src, dst));
+}
@@ -25,6 +25,7 @@
 #include "core.hpp"
 #include "gtest/gtest.h"
 #include <stdlib.h>
+#include <sstream>
 #include <string>
 #include <utility>
 /**
@@ -45,6 +46,14 @@ protected:
 
 //        ASSERT_NO_THROW(c0.init(argc,argv));
     }
+
+    // the forcing cache file core would use for this forcing section and files, on an empty mesh
+    std::string forcing_cache_file(core& c, const pt::ptree& forcing, const std::vector<std::string>& files)
+    {
+        if (!c._mesh)
+            c._mesh = boost::make_shared<triangulation>();
+        return c.forcing_cache_file(forcing, files);
+    }
    // core c0;
 
 };
@@ -281,3 +290,39 @@ TEST_F(CoreTest,CmdlOptionsErase)
     ASSERT_ANY_THROW(c1._cfg.get_child("output"));  //confirms the entire section got nuked
 }
 
+
+TEST_F(CoreTest,ForcingCacheMissesOnChangedForcing)
+{
+    core c1;
+
+    auto file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    {
+        std::ofstream out(file.string());
+        out << "datetime,t\n";
+    }
+    std::vector<std::string> files = {file.string()};
+
+    std::stringstream json(R"({
+        "use_netcdf": true,
+        "file": "gem.nc",
+        "cache": "forcing_cache",
+        "UTC_offset": 6,
+        "filter": { "debias_lw": { "variable": "ilwr", "factor": 15 } }
+    })");
+    pt::ptree forcing;
+    pt::read_json(json, forcing);
+
+    auto cached = forcing_cache_file(c1, forcing, files);
+    ASSERT_EQ(cached, forcing_cache_file(c1, forcing, files));
+
+    // a different filter parameter filters the forcing differently, so it mustn't load the old cache
+    pt::ptree refiltered = forcing;
+    refiltered.put("filter.debias_lw.factor", 20);
+    ASSERT_NE(cached, forcing_cache_file(c1, refiltered, files));
+
+    pt::ptree shifted = forcing;
+    shifted.put("UTC_offset", 7);
+    ASSERT_NE(cached, forcing_cache_file(c1, shifted, files));
+
+    boost::filesystem::remove(file);
+}
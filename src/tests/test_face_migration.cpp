@@ -0,0 +1,189 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "logger.hpp"
+#include "readjson.hpp"
+#include "triangulation.hpp"
+#include "snobal.hpp"
+#include "Simple_Canopy.hpp"
+#include "Harder_precip_phase.hpp"
+#include "Gray_inf.hpp"
+#include "solar.hpp"
+#include "Liston_wind.hpp"
+#include "scale_wind_vert.hpp"
+#include "p_no_lapse.hpp"
+#include "t_no_lapse.hpp"
+#include "gtest/gtest.h"
+
+// Load balancing moves a face's module data to another MPI process with pack_face and unpack_face. Whatever a module
+// unpacks it has to pack again, value for value, and it has to read back exactly as many values as it wrote
+class FaceMigrationTest : public testing::Test
+{
+  protected:
+
+    virtual void SetUp()
+    {
+        logging::core::get()->set_logging_enabled(false);
+
+        pt::ptree mesh_json = read_json("meshes/granger1m.mesh");
+        domain = boost::make_shared<triangulation>();
+        domain->from_json(mesh_json);
+
+        param = boost::make_shared<global>();
+        param->interp_algorithm = interp_alg::idw;
+    }
+
+    // distinct, whole values, so they survive the modules' int fields
+    static std::vector<double> values(size_t n)
+    {
+        std::vector<double> v(n);
+        for (size_t i = 0; i < n; i++)
+            v[i] = i + 1;
+        return v;
+    }
+
+    static void expect_same(const std::vector<double>& expected, const std::vector<double>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+
+        // as bytes, since snobal moves its state as raw bytes
+        EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(double)));
+    }
+
+    // unpacks the values onto face 0, moves face 0 to face 1 as a process would, and checks both pack to the values
+    void round_trip(module_base& m, const std::vector<double>& state)
+    {
+        m.global_param = param;
+        ASSERT_TRUE(m.migrates());
+
+        std::set<std::string> modules = {m.ID};
+        domain->init_module_data(modules);
+
+        auto from = domain->face(0);
+        auto to = domain->face(1);
+
+        const double* p = state.data();
+        m.unpack_face(from, p);
+        ASSERT_EQ(p, state.data() + state.size());
+
+        std::vector<double> sent;
+        m.pack_face(from, sent);
+        expect_same(state, sent);
+
+        p = sent.data();
+        m.unpack_face(to, p);
+        ASSERT_EQ(p, sent.data() + sent.size());
+
+        std::vector<double> moved;
+        m.pack_face(to, moved);
+        expect_same(state, moved);
+    }
+
+    mesh domain;
+    boost::shared_ptr<global> param;
+};
+
+TEST_F(FaceMigrationTest, Snobal)
+{
+    snobal m(config_file());
+
+    size_t n_sno = sizeof(sno) / sizeof(double);
+    ASSERT_EQ(0u, sizeof(sno) % sizeof(double));
+
+    auto state = values(n_sno + 7);
+    round_trip(m, state);
+
+    auto g = domain->face(1)->get_module_data<snodata>(m.ID);
+    ASSERT_NE(g, nullptr);
+    EXPECT_EQ(g->sum_runoff, state[n_sno]);
+    EXPECT_EQ(g->dead, int(state[n_sno + 4]));
+    EXPECT_EQ(g->delta_avalanche_swe, state[n_sno + 6]);
+}
+
+TEST_F(FaceMigrationTest, SimpleCanopy)
+{
+    Simple_Canopy m(config_file());
+    auto state = values(10);
+    round_trip(m, state);
+
+    auto d = domain->face(1)->get_module_data<Simple_Canopy::data>(m.ID);
+    EXPECT_EQ(d->canopyType, 3);
+    EXPECT_EQ(d->Snow_load, state[4]);
+    EXPECT_EQ(d->cum_SUnload_H2O, state[9]);
+}
+
+TEST_F(FaceMigrationTest, HarderPrecipPhase)
+{
+    Harder_precip_phase m(config_file());
+    round_trip(m, values(3));
+
+    EXPECT_EQ(domain->face(1)->get_module_data<Harder_precip_phase::data>(m.ID)->acc_snow, 3);
+}
+
+TEST_F(FaceMigrationTest, GrayInf)
+{
+    Gray_inf m(config_file());
+    round_trip(m, values(8));
+
+    EXPECT_EQ(domain->face(1)->get_module_data<Gray_inf::data>(m.ID)->total_excess, 8);
+}
+
+TEST_F(FaceMigrationTest, Solar)
+{
+    solar m(config_file());
+    round_trip(m, values(2));
+
+    auto d = domain->face(1)->get_module_data<solar::data>(m.ID);
+    EXPECT_EQ(d->lat, 1);
+    EXPECT_EQ(d->lng, 2);
+}
+
+TEST_F(FaceMigrationTest, ListonWind)
+{
+    Liston_wind m(config_file());
+    round_trip(m, values(1));
+
+    auto d = domain->face(1)->get_module_data<Liston_wind::lwinddata>(m.ID);
+    EXPECT_EQ(d->curvature, 1);
+}
+
+TEST_F(FaceMigrationTest, Interpolants)
+{
+    // nothing is sent, the interpolant is made again on the new process
+    p_no_lapse p(config_file());
+    round_trip(p, {});
+    EXPECT_NE(domain->face(1)->get_module_data<p_no_lapse::data>(p.ID), nullptr);
+
+    t_no_lapse t(config_file());
+    round_trip(t, {});
+    EXPECT_NE(domain->face(1)->get_module_data<t_no_lapse::data>(t.ID), nullptr);
+
+    // keeps no face data at all
+    scale_wind_vert s(config_file());
+    round_trip(s, {});
+}
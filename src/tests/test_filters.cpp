@@ -0,0 +1,163 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include <cmath>
+
+#include "station.hpp"
+#include "debias_lw.hpp"
+#include "goodison_undercatch.hpp"
+#include "macdonald_undercatch.hpp"
+#include "scale_wind_speed.hpp"
+#include "gtest/gtest.h"
+
+// Runs a filter over one table station by station, and over an identical table with the column process(), and checks the
+// two agree for every station and variable
+class FilterTest : public testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        logging::core::get()->set_logging_enabled(false);
+
+        cfg.put("variable", "p");
+        cfg.put("factor", 15.0);
+        cfg.put("Z_F", 40.0);
+
+        make_table(per_station, per_station_stations);
+        make_table(columns, column_stations);
+    }
+
+    // wind speeds and precip chosen to cover calm, windy, zero precip and every flavour of missing value
+    void make_table(std::shared_ptr<station_table>& table, std::vector<std::shared_ptr<station>>& stations)
+    {
+        const double nan = std::nan("");
+        std::vector<double> u = {0, 0.5, 2, 4.5, 7, 12, -9999, nan, 3, -9999, 1};
+        std::vector<double> p = {1.2, 0, 0.3, 5, 2.5, 0.1, 1, 0.4, -9999, 0, nan};
+        std::vector<double> ilwr = {250, 301.5, -9999, 180, nan, 320, 275, 260, 240, 230, 290};
+
+        table = std::make_shared<station_table>();
+        table->init({"u", "p", "ilwr"}, u.size());
+        for (size_t i = 0; i < u.size(); i++)
+        {
+            stations.push_back(std::make_shared<station>(std::to_string(i), 0, 0, 1000, table, i));
+            table->value("u", i) = u[i];
+            table->value("p", i) = p[i];
+            table->value("ilwr", i) = ilwr[i];
+        }
+        table->set_stations(stations);
+    }
+
+    void run(filter_base& f)
+    {
+        f.init();
+
+        for (auto& s : per_station_stations)
+            f.process(s);
+
+        f.process(*columns);
+
+        ASSERT_EQ(per_station->variables(), columns->variables());
+        for (auto& v : columns->variables())
+        {
+            for (size_t i = 0; i < columns->size(); i++)
+            {
+                double expected = per_station->value(v, i);
+                double actual = columns->value(v, i);
+
+                if (std::isnan(expected))
+                    EXPECT_TRUE(std::isnan(actual)) << v << " at station " << i;
+                else
+                    EXPECT_DOUBLE_EQ(expected, actual) << v << " at station " << i;
+            }
+        }
+    }
+
+    config_file cfg;
+
+    std::shared_ptr<station_table> per_station;
+    std::shared_ptr<station_table> columns;
+    std::vector<std::shared_ptr<station>> per_station_stations;
+    std::vector<std::shared_ptr<station>> column_stations;
+};
+
+TEST_F(FilterTest, DebiasLwColumnMatchesStation)
+{
+    cfg.put("variable", "ilwr");
+    debias_lw f(cfg);
+    run(f);
+
+    EXPECT_DOUBLE_EQ(265, columns->value("ilwr", 0));
+}
+
+TEST_F(FilterTest, GoodisonColumnMatchesStation)
+{
+    goodison_undercatch f(cfg);
+    run(f);
+
+    // zero precip stays zero even without a wind speed, missing values become -9999
+    EXPECT_EQ(0, columns->value("p", 9));
+    EXPECT_EQ(-9999, columns->value("p", 6));
+    EXPECT_EQ(-9999, columns->value("p", 10));
+}
+
+TEST_F(FilterTest, MacdonaldColumnMatchesStation)
+{
+    macdonald_undercatch f(cfg);
+    run(f);
+
+    EXPECT_EQ(-9999, columns->value("p", 7));
+}
+
+TEST_F(FilterTest, ScaleWindSpeedColumnMatchesStation)
+{
+    cfg.put("variable", "u");
+    scale_wind_speed f(cfg);
+
+    // U_R is a new variable the filter provides, as metdata would add it before filtering
+    per_station->add_variables({"U_R"});
+    columns->add_variables({"U_R"});
+
+    run(f);
+
+    EXPECT_EQ(-9999, columns->value("U_R", 6));
+}
+
+TEST_F(FilterTest, DefaultColumnProcessCallsStation)
+{
+    // a filter without a column version falls back to the per-station one through the table's stations
+    struct add_one : public filter_base
+    {
+        void process(std::shared_ptr<station>& s)
+        {
+            (*s)["p"_s] += 1;
+        }
+    } add;
+
+    filter_base& f = add;
+    f.process(*columns);
+
+    EXPECT_DOUBLE_EQ(2.2, columns->value("p", 0));
+    EXPECT_DOUBLE_EQ(1, columns->value("p", 1));
+}
@@ -0,0 +1,140 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+
+#include "logger.hpp"
+#include "gtest/gtest.h"
+
+class LogLimiterTest : public testing::Test
+{
+  protected:
+    typedef sinks::synchronous_sink<sinks::text_ostream_backend> capture_sink;
+
+    virtual void SetUp()
+    {
+        // drop anything counted by earlier tests so report() only shows this test's sites
+        logging::core::get()->set_logging_enabled(false);
+        log_limiter::report();
+
+        out = boost::make_shared<std::stringstream>();
+        sink = boost::make_shared<capture_sink>();
+        sink->locked_backend()->add_stream(out);
+        sink->set_formatter(expr::stream << expr::smessage);
+        logging::core::get()->add_sink(sink);
+        logging::core::get()->set_logging_enabled(true);
+    }
+
+    virtual void TearDown()
+    {
+        logging::core::get()->remove_sink(sink);
+        logging::core::get()->set_logging_enabled(false);
+    }
+
+    // the captured records, one per line
+    std::vector<std::string> lines()
+    {
+        std::vector<std::string> l;
+        std::string s = out->str();
+        boost::split(l, s, boost::is_any_of("\n"), boost::token_compress_on);
+        l.erase(std::remove(l.begin(), l.end(), ""), l.end());
+        out->str("");
+        return l;
+    }
+
+    boost::shared_ptr<std::stringstream> out;
+    boost::shared_ptr<capture_sink> sink;
+};
+
+// one call site, hit n times
+static int log_n(size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        LOG_WARNING_LIMITED << "face " << i;
+    return __LINE__ - 1;
+}
+
+TEST_F(LogLimiterTest, SuppressesAfterMaxRecords)
+{
+    int line = log_n(25);
+
+    auto logged = lines();
+    ASSERT_EQ(logged.size(), size_t(log_limiter::max_records));
+    for (size_t i = 0; i < logged.size(); i++)
+        EXPECT_EQ(logged[i], "face " + std::to_string(i));
+
+    log_limiter::report();
+    auto report = lines();
+    ASSERT_EQ(report.size(), 1);
+    EXPECT_EQ(report[0], "The previous message from test_log_limiter.cpp:" + std::to_string(line) +
+                         " was repeated 15 more times (25 in total)");
+}
+
+TEST_F(LogLimiterTest, ReportRestartsTheCount)
+{
+    log_n(12);
+    log_limiter::report();
+    lines();
+
+    // nothing was hit since, so nothing to report
+    log_limiter::report();
+    EXPECT_TRUE(lines().empty());
+
+    // and the site logs again
+    log_n(3);
+    EXPECT_EQ(lines().size(), 3);
+    log_limiter::report();
+    EXPECT_TRUE(lines().empty());
+}
+
+TEST_F(LogLimiterTest, CountsHitsFromAllThreads)
+{
+    int line = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++)
+        threads.emplace_back([&line, t]
+                             {
+                                 int l = log_n(100);
+                                 if (t == 0)
+                                     line = l;
+                             });
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT_EQ(lines().size(), size_t(log_limiter::max_records));
+
+    log_limiter::report();
+    auto report = lines();
+    ASSERT_EQ(report.size(), 1);
+    EXPECT_EQ(report[0], "The previous message from test_log_limiter.cpp:" + std::to_string(line) +
+                         " was repeated 790 more times (800 in total)");
+}
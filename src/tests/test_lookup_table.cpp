@@ -0,0 +1,137 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "exception.hpp"
+#include "math/lookup_table.hpp"
+#include "physics/Atmosphere.h"
+#include "Harder_precip_phase.hpp"
+#include "gtest/gtest.h"
+
+// |exact - approx| within tol * max(1, |exact|), with a little slack as the tables only check the midpoints
+static void expect_within(double exact, double approx, double tol)
+{
+    EXPECT_LE(std::fabs(exact - approx), 1.5 * tol * std::max(1.0, std::fabs(exact))) << exact << " " << approx;
+}
+
+TEST(LookupTable, OneD)
+{
+    auto f = [](double x) { return std::exp(std::sin(x)) * 100.0; };
+    double tol = 1e-7;
+    math::lookup_table_1d table(f, -3.0, 5.0, tol);
+
+    EXPECT_LE(table.max_error(), tol);
+
+    for(double x = -3.0; x <= 5.0; x += 0.000913)
+        expect_within(f(x), table(x), tol);
+
+    // nodes are exact, including the ends
+    EXPECT_DOUBLE_EQ(f(-3.0), table(-3.0));
+    EXPECT_DOUBLE_EQ(f(5.0), table(5.0));
+
+    EXPECT_TRUE(table.in_range(-3.0));
+    EXPECT_FALSE(table.in_range(5.1));
+    EXPECT_FALSE(table.in_range(std::numeric_limits<double>::quiet_NaN()));
+}
+
+TEST(LookupTable, TwoD)
+{
+    auto f = [](double x, double y) { return std::exp(0.05 * x) * (1.0 + y * y) + x * y; };
+    double tol = 1e-6;
+    math::lookup_table_2d table(f, -20.0, 30.0, 0.0, 1.0, tol);
+
+    EXPECT_LE(table.max_error(), tol);
+
+    for(double x = -20.0; x <= 30.0; x += 0.0731)
+        for(double y = 0.0; y <= 1.0; y += 0.0137)
+            expect_within(f(x, y), table(x, y), tol);
+
+    EXPECT_DOUBLE_EQ(f(30.0, 1.0), table(30.0, 1.0));
+}
+
+TEST(LookupTable, Batch)
+{
+    math::lookup_table_1d t1([](double x) { return std::log(x); }, 1.0, 10.0, 1e-8);
+    math::lookup_table_2d t2([](double x, double y) { return std::log(x) * y; }, 1.0, 10.0, -1.0, 1.0, 1e-8);
+
+    std::vector<double> x, y;
+    for(double v = 1.0; v <= 10.0; v += 0.01)
+    {
+        x.push_back(v);
+        y.push_back(std::cos(v));
+    }
+
+    std::vector<double> z1(x.size()), z2(x.size());
+    t1(x.data(), z1.data(), x.size());
+    t2(x.data(), y.data(), z2.data(), x.size());
+
+    for(size_t i = 0; i < x.size(); i++)
+    {
+        EXPECT_EQ(t1(x[i]), z1[i]);
+        EXPECT_EQ(t2(x[i], y[i]), z2[i]);
+    }
+}
+
+TEST(LookupTable, Unreachable)
+{
+    // a jump can't be interpolated to any tolerance
+    auto step = [](double x) { return x < 0.3 ? 0.0 : 10.0; };
+    EXPECT_THROW(math::lookup_table_1d(step, 0.0, 1.0, 1e-6, 1024), chm_error);
+}
+
+TEST(LookupTable, SaturatedVapourPressure)
+{
+    for(double T = 173.15; T <= 373.15; T += 0.0173)
+        expect_within(Atmosphere::saturatedVapourPressure_exact(T), Atmosphere::saturatedVapourPressure(T), 1e-6);
+
+    // out of the table
+    EXPECT_EQ(Atmosphere::saturatedVapourPressure_exact(400.0), Atmosphere::saturatedVapourPressure(400.0));
+}
+
+TEST(LookupTable, HarderTi)
+{
+    double tol = 1e-4;
+    int digits = std::numeric_limits<double>::digits / 2;
+
+    // as built in Harder_precip_phase::init
+    math::lookup_table_2d ice([=](double T, double RH) { return Harder_precip_phase::hydrometeor_temperature(T, RH, true, digits); },
+                              -45.0, 0.0, 0.0, 100.0, tol);
+    math::lookup_table_2d water([=](double T, double RH) { return Harder_precip_phase::hydrometeor_temperature(T, RH, false, digits); },
+                                0.0, 50.0, 0.0, 100.0, tol);
+
+    for(double T = -45.0; T <= 50.0; T += 0.137)
+    {
+        for(double RH = 0.0; RH <= 100.0; RH += 1.3)
+        {
+            double exact = Harder_precip_phase::hydrometeor_temperature(T, RH, T < 0.0, digits);
+            expect_within(exact, T < 0.0 ? ice(T, RH) : water(T, RH), tol);
+
+            // closer than the per-face solve ever was
+            double solve = Harder_precip_phase::hydrometeor_temperature(T, RH, T < 0.0, 6);
+            EXPECT_NEAR(exact, solve, 0.05);
+        }
+    }
+}
@@ -0,0 +1,139 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include <cmath>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "exception.hpp"
+#include "logger.hpp"
+#include "mesh_arrays.hpp"
+#include "readjson.hpp"
+#include "gtest/gtest.h"
+
+class MeshArraysTest : public testing::Test
+{
+  protected:
+
+    virtual void SetUp()
+    {
+        logging::core::get()->set_logging_enabled(false);
+        mesh_json = read_json("meshes/granger1m.mesh");
+
+        for(auto& ktr : read_json("meshes/granger1m.param"))
+            mesh_json.put_child("parameters." + ktr.first, ktr.second);
+
+        for(auto& ktr : read_json("meshes/granger1m.ic"))
+            mesh_json.put_child("initial_conditions." + ktr.first, ktr.second);
+    }
+
+    std::vector<char> pack()
+    {
+        std::vector<char> buffer(mesh_arrays::packed_size(mesh_json));
+        mesh_arrays::pack(mesh_json, buffer.data(), buffer.size());
+        return buffer;
+    }
+
+    pt::ptree mesh_json;
+};
+
+TEST_F(MeshArraysTest, RoundTrip)
+{
+    auto buffer = pack();
+    mesh_arrays arrays(buffer.data(), buffer.size());
+
+    EXPECT_EQ(mesh_json.get<size_t>("mesh.nvertex"), arrays.nvertex());
+    EXPECT_EQ(mesh_json.get<size_t>("mesh.nelem"), arrays.nelem());
+    EXPECT_EQ(mesh_json.get<std::string>("mesh.proj4"), arrays.proj4());
+    EXPECT_EQ(mesh_json.get<int>("mesh.is_geographic") == 1, arrays.is_geographic());
+
+    size_t i = 0;
+    for (auto& itr : mesh_json.get_child("mesh.vertex"))
+    {
+        size_t j = 0;
+        for (auto& jtr : itr.second)
+            EXPECT_EQ(jtr.second.get_value<double>(), arrays.vertex(i)[j++]);
+        i++;
+    }
+
+    i = 0;
+    for (auto& itr : mesh_json.get_child("mesh.neigh"))
+    {
+        size_t j = 0;
+        for (auto& jtr : itr.second)
+            EXPECT_EQ(jtr.second.get_value<int>(), arrays.neigh(i)[j++]);
+        i++;
+    }
+
+    ASSERT_EQ(mesh_json.get_child("parameters").size(), arrays.parameters().size());
+    for (auto& p : arrays.parameters())
+    {
+        auto& column = mesh_json.get_child("parameters." + p.name);
+        ASSERT_EQ(column.size(), p.size);
+
+        i = 0;
+        for (auto& jtr : column)
+        {
+            double v = jtr.second.get_value<double>();
+            if (std::isnan(v))
+                EXPECT_TRUE(std::isnan(p.values[i]));
+            else
+                EXPECT_EQ(v, p.values[i]);
+            i++;
+        }
+    }
+
+    auto ics = mesh_json.get_child_optional("initial_conditions");
+    EXPECT_EQ(ics ? ics->size() : 0, arrays.initial_conditions().size());
+    EXPECT_EQ(nullptr, arrays.cell_global_id());
+}
+
+TEST_F(MeshArraysTest, DropsEmptyParameters)
+{
+    mesh_json.put_child("parameters.empty", pt::ptree());
+    size_t nparam = mesh_json.get_child("parameters").size();
+
+    auto buffer = pack();
+    mesh_arrays arrays(buffer.data(), buffer.size());
+
+    EXPECT_EQ(nparam - 1, arrays.parameters().size());
+    for (auto& p : arrays.parameters())
+        EXPECT_NE("empty", p.name);
+}
+
+TEST_F(MeshArraysTest, Inconsistent)
+{
+    mesh_json.put("mesh.nelem", mesh_json.get<size_t>("mesh.nelem") + 1);
+    EXPECT_THROW(mesh_arrays::packed_size(mesh_json), config_error);
+}
+
+TEST_F(MeshArraysTest, Truncated)
+{
+    auto buffer = pack();
+    EXPECT_THROW(mesh_arrays(buffer.data(), buffer.size() / 2), mesh_error);
+
+    buffer[0] = 'x';
+    EXPECT_THROW(mesh_arrays(buffer.data(), buffer.size()), mesh_error);
+}
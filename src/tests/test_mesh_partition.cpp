@@ -0,0 +1,96 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <vector>
+
+#include "exception.hpp"
+#include "mesh_partition.hpp"
+#include "gtest/gtest.h"
+
+TEST(MeshPartitionTest, EvenSplit)
+{
+    mesh_partition p(10, 3);
+
+    ASSERT_EQ(p.parts(), 3);
+    EXPECT_EQ(p.size(0), 4);
+    EXPECT_EQ(p.size(1), 3);
+    EXPECT_EQ(p.size(2), 3);
+    EXPECT_EQ(p.begin(1), 4);
+    EXPECT_EQ(p.end(2), 10);
+
+    EXPECT_EQ(p.owner(0), 0);
+    EXPECT_EQ(p.owner(3), 0);
+    EXPECT_EQ(p.owner(4), 1);
+    EXPECT_EQ(p.owner(9), 2);
+    EXPECT_THROW(p.owner(10), mesh_error);
+
+    EXPECT_THROW(mesh_partition(2, 3), mesh_error);
+}
+
+TEST(MeshPartitionTest, UniformCostIsEven)
+{
+    std::vector<double> cost(100, 2.);
+    auto p = mesh_partition::weighted(cost, 4);
+
+    for (size_t k = 0; k < 4; k++)
+        EXPECT_EQ(p.size(k), 25);
+
+    EXPECT_DOUBLE_EQ(mesh_partition::imbalance(p.cost(cost)), 1.);
+}
+
+TEST(MeshPartitionTest, BalancesCost)
+{
+    // the first quarter of the faces is ten times as expensive, e.g., snow covered
+    std::vector<double> cost(1000, 1.);
+    for (size_t i = 0; i < 250; i++)
+        cost[i] = 10.;
+
+    mesh_partition even(cost.size(), 4);
+    auto weighted = mesh_partition::weighted(cost, 4);
+
+    EXPECT_GT(mesh_partition::imbalance(even.cost(cost)), 2.);
+    EXPECT_LT(mesh_partition::imbalance(weighted.cost(cost)), 1.01);
+
+    EXPECT_LT(weighted.size(0), even.size(0));
+    EXPECT_EQ(weighted.faces(), cost.size());
+}
+
+TEST(MeshPartitionTest, KeepsAFacePerPart)
+{
+    // all the cost on one face
+    std::vector<double> cost(10, 0.);
+    cost[0] = 1000.;
+
+    auto p = mesh_partition::weighted(cost, 4);
+
+    size_t total = 0;
+    for (size_t k = 0; k < p.parts(); k++)
+    {
+        EXPECT_GE(p.size(k), 1);
+        total += p.size(k);
+    }
+    EXPECT_EQ(total, cost.size());
+    EXPECT_EQ(p.size(0), 1);
+
+    EXPECT_THROW(mesh_partition::weighted(std::vector<double>(3, 1.), 4), mesh_error);
+}
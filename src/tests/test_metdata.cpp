@@ -26,6 +26,9 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cmath>
+#include <set>
+#include <boost/filesystem.hpp>
 
 class MetdataTest : public testing::Test
 {
@@ -240,6 +243,113 @@ TEST_F(MetdataTest, ASCII_TestNext)
     ASSERT_EQ(cur_time,"20101001T120000");
 }
 
+TEST_F(MetdataTest, ASCII_TestReplay)
+{
+    metdata md(proj4str);
+
+    metdata::ascii_metdata station;
+    station.path = "test_met_data_longer1.txt";
+    station.latitude = 60.56726;
+    station.longitude = -135.184652;
+    station.elevation = 1559;
+    station.id = "station1";
+
+    std::vector<metdata::ascii_metdata> s;
+    s.push_back(station);
+
+    ASSERT_NO_THROW(md.load_from_ascii(s, -8));
+
+    md.cache(true);
+    md.next();
+    double first = md.at(0)->operator[]("Qsi"_s);
+    md.next();
+    double second = md.at(0)->operator[]("Qsi"_s);
+    md.cache(false);
+    ASSERT_EQ(md.cached_timesteps(), 2);
+
+    // replaying twice doesn't move the forcing on
+    for (int cycle = 0; cycle < 2; cycle++)
+    {
+        md.replay(0);
+        ASSERT_EQ(md.current_time_str(), "20101001T100000");
+        ASSERT_DOUBLE_EQ(md.at(0)->operator[]("Qsi"_s), first);
+
+        ASSERT_TRUE(md.next());
+        ASSERT_EQ(md.current_time_str(), "20101001T110000");
+        ASSERT_DOUBLE_EQ(md.at(0)->operator[]("Qsi"_s), second);
+    }
+
+    // then continues reading after the cached timesteps
+    ASSERT_TRUE(md.next());
+    ASSERT_EQ(md.current_time_str(), "20101001T120000");
+
+    ASSERT_ANY_THROW(md.replay(2));
+}
+
+TEST_F(MetdataTest, ASCII_TestForcingCache)
+{
+    std::vector<metdata::ascii_metdata> s;
+    for (auto id : {"station1", "station2"})
+    {
+        metdata::ascii_metdata station;
+        station.path = std::string("test_met_data_longer") + id[7] + ".txt";
+        station.latitude = 60.56726;
+        station.longitude = -135.184652;
+        station.elevation = 1559;
+        station.id = id;
+        s.push_back(station);
+    }
+
+    auto path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+
+    boost::posix_time::ptime start = boost::posix_time::from_iso_string("20101001T100000");
+    boost::posix_time::ptime end = boost::posix_time::from_iso_string("20101001T120000");
+
+    std::vector<double> values;
+    {
+        metdata md(proj4str);
+        ASSERT_NO_THROW(md.load_from_ascii(s, -8));
+        md.subset(start, end);
+
+        // a cache that doesn't cover the whole period isn't kept
+        md.write_cache(path);
+        md.next();
+        md.finish_cache();
+        ASSERT_FALSE(boost::filesystem::exists(path));
+    }
+    {
+        metdata md(proj4str);
+        ASSERT_NO_THROW(md.load_from_ascii(s, -8));
+        md.subset(start, end);
+
+        md.write_cache(path);
+        while (md.next())
+            values.push_back(md.at(1)->operator[]("t"_s));
+        md.finish_cache();
+        ASSERT_TRUE(boost::filesystem::exists(path));
+    }
+
+    metdata md(proj4str);
+    ASSERT_FALSE(md.load_from_cache(path + ".missing"));
+    ASSERT_TRUE(md.load_from_cache(path));
+
+    ASSERT_EQ(md.nstations(), 2);
+    ASSERT_EQ(md.at(1)->ID(), "station2");
+    ASSERT_EQ(md.start_time_str(), "20101001T100000");
+    ASSERT_EQ(md.end_time_str(), "20101001T120000");
+    ASSERT_EQ(md.n_timestep(), 3);
+
+    // the cached values are floats
+    for (auto v : values)
+    {
+        ASSERT_TRUE(md.next());
+        ASSERT_NEAR(md.at(1)->operator[]("t"_s), v, 1e-4 * std::fabs(v));
+    }
+    ASSERT_FALSE(md.next());
+
+    boost::filesystem::remove(path);
+}
+
 TEST_F(MetdataTest, ASCII_TestAccessData)
 {
     metdata md(proj4str);
@@ -562,4 +672,184 @@ TEST_F(MetdataTest, NC_TestPrune)
 
     ASSERT_EQ((151*151)-(151*150),md.nstations());
     ASSERT_EQ(md.stations().at(0)->ID(),"0");
-}
\ No newline at end of file
+}
+// Writes a small GEM-like forcing file: nt hourly timesteps starting offset hours after 2018-01-15 06:00 on an nx by ny grid.
+// Every variable at station k and hour h is 100 * h + k, so a value shows which file and timestep it was read from
+static void write_gem_file(const std::string& path, int offset, size_t nt, size_t nx = 3, size_t ny = 2,
+                           const std::vector<std::string>& variables = {"t", "rh"})
+{
+    netCDF::NcFile f(path, netCDF::NcFile::replace);
+    auto time_dim = f.addDim("datetime", nt);
+    auto y_dim = f.addDim("ygrid_0", ny);
+    auto x_dim = f.addDim("xgrid_0", nx);
+
+    auto time = f.addVar("datetime", netCDF::ncInt64, time_dim);
+    time.putAtt("units", "hours since 2018-01-15 06:00:00");
+    std::vector<long long> hours(nt);
+    for (size_t i = 0; i < nt; i++)
+        hours[i] = offset + i;
+    time.putVar(hours.data());
+
+    std::vector<netCDF::NcDim> grid = {y_dim, x_dim};
+    std::vector<double> lat(ny * nx), lon(ny * nx);
+    for (size_t y = 0; y < ny; y++)
+    {
+        for (size_t x = 0; x < nx; x++)
+        {
+            lat[y * nx + x] = 60.5 + 0.01 * y;
+            lon[y * nx + x] = -135.2 + 0.01 * x;
+        }
+    }
+    f.addVar("gridlat_0", netCDF::ncDouble, grid).putVar(lat.data());
+    f.addVar("gridlon_0", netCDF::ncDouble, grid).putVar(lon.data());
+
+    std::vector<netCDF::NcDim> field = {time_dim, y_dim, x_dim};
+    std::vector<double> z(nt * ny * nx, 1000.);
+    f.addVar("HGT_P0_L1_GST", netCDF::ncDouble, field).putVar(z.data());
+
+    std::vector<double> values(nt * ny * nx);
+    for (size_t i = 0; i < nt; i++)
+    {
+        for (size_t k = 0; k < ny * nx; k++)
+            values[i * ny * nx + k] = 100. * (offset + i) + k;
+    }
+    for (auto& v : variables)
+        f.addVar(v, netCDF::ncDouble, field).putVar(values.data());
+}
+
+class MetdataMultiFileTest : public MetdataTest
+{
+  protected:
+
+    virtual void SetUp()
+    {
+        MetdataTest::SetUp();
+        dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        boost::filesystem::create_directories(dir);
+
+        // two consecutive files of 4 hours, 06:00-09:00 and 10:00-13:00
+        write_gem_file(file("gem_1.nc"), 0, 4);
+        write_gem_file(file("gem_2.nc"), 4, 4);
+    }
+
+    virtual void TearDown()
+    {
+        boost::filesystem::remove_all(dir);
+    }
+
+    std::string file(const std::string& name)
+    {
+        return (dir / name).string();
+    }
+
+    boost::filesystem::path dir;
+};
+
+TEST_F(MetdataMultiFileTest, Glob)
+{
+    auto files = metdata::expand_netcdf_files({file("gem_*.nc")});
+    ASSERT_EQ(files.size(), 2);
+    ASSERT_EQ(files[0], file("gem_1.nc"));
+    ASSERT_EQ(files[1], file("gem_2.nc"));
+
+    ASSERT_THROW(metdata::expand_netcdf_files({file("missing_*.nc")}), config_error);
+
+    metdata md(proj4str);
+    ASSERT_NO_THROW(md.load_from_netcdf(files));
+
+    ASSERT_EQ(md.nstations(), 6);
+    ASSERT_EQ(md.n_timestep(), 8);
+    ASSERT_EQ(md.start_time_str(), "20180115T060000");
+    ASSERT_EQ(md.end_time_str(), "20180115T130000");
+
+    std::set<std::string> variable_list = {"rh", "t"};
+    ASSERT_TRUE(md.list_variables() == variable_list);
+}
+
+TEST_F(MetdataMultiFileTest, StepAcrossFileBoundary)
+{
+    // the files are ordered by time, not by how they are given
+    metdata md(proj4str);
+    ASSERT_NO_THROW(md.load_from_netcdf(std::vector<std::string>{file("gem_2.nc"), file("gem_1.nc")}));
+
+    const char* times[] = {"20180115T060000", "20180115T070000", "20180115T080000", "20180115T090000",
+                           "20180115T100000", "20180115T110000", "20180115T120000", "20180115T130000"};
+    for (int h = 0; h < 8; h++)
+    {
+        ASSERT_TRUE(md.next());
+        ASSERT_EQ(md.current_time_str(), times[h]);
+
+        for (size_t k = 0; k < md.nstations(); k++)
+        {
+            ASSERT_DOUBLE_EQ((*md.at(k))["t"], 100. * h + k) << "hour " << h << " station " << k;
+            ASSERT_DOUBLE_EQ((*md.at(k))["rh"], 100. * h + k) << "hour " << h << " station " << k;
+        }
+    }
+    ASSERT_FALSE(md.next());
+}
+
+TEST_F(MetdataMultiFileTest, HeaderMismatch)
+{
+    // each of these would follow gem_1.nc, but can't be stitched to it
+    write_gem_file(file("grid.nc"), 4, 4, 4, 2);
+    write_gem_file(file("variables.nc"), 4, 4, 3, 2, {"t"});
+    write_gem_file(file("gap.nc"), 5, 4);
+    write_gem_file(file("overlap.nc"), 3, 4);
+
+    for (auto name : {"grid.nc", "variables.nc", "gap.nc", "overlap.nc"})
+    {
+        metdata md(proj4str);
+        EXPECT_THROW(md.load_from_netcdf(std::vector<std::string>{file("gem_1.nc"), file(name)}), forcing_error) << name;
+    }
+}
+
+TEST_F(MetdataTest, ASCII_InterpolateToModelDt)
+{
+    metdata md(proj4str);
+
+    metdata::ascii_metdata station;
+    station.path = "test_met_data_longer3_3hr_dt.txt";
+    station.latitude = 60.56726;
+    station.longitude = -135.184652;
+    station.elevation = 1559;
+    station.id = "station1";
+
+    std::vector<metdata::ascii_metdata> s;
+    s.push_back(station);
+
+    ASSERT_NO_THROW(md.load_from_ascii(s, -8));
+
+    // must evenly divide the 3 h forcing
+    ASSERT_ANY_THROW(md.set_model_dt(boost::posix_time::minutes(100), -8));
+    ASSERT_NO_THROW(md.set_model_dt(boost::posix_time::hours(1), -8));
+
+    ASSERT_EQ(md.dt_seconds(), 3600);
+    ASSERT_EQ(md.n_timestep(), 10);
+
+    md.subset(md.start_time(), md.end_time());
+    md.check_ts_consistency();
+
+    md.next(); // 10:00, on a forcing record
+    ASSERT_DOUBLE_EQ(md.at(0)->operator[]("t"_s), 14.268);
+
+    md.next(); // 11:00
+    ASSERT_EQ(md.current_time_str(), "20101001T110000");
+    ASSERT_DOUBLE_EQ(md.at(0)->operator[]("t"_s), 14.268 + (-6.1 - 14.268) / 3.0);
+
+    // the 13:00 precipitation record is split across 11:00, 12:00, 13:00
+    ASSERT_DOUBLE_EQ(md.at(0)->operator[]("p"_s), 0.1031 / 3.0);
+
+    md.next(); // 12:00
+    md.next(); // 13:00
+    ASSERT_DOUBLE_EQ(md.at(0)->operator[]("t"_s), -6.1);
+    ASSERT_DOUBLE_EQ(md.at(0)->operator[]("p"_s), 0.1031 / 3.0);
+
+    md.next(); // 14:00
+    ASSERT_DOUBLE_EQ(md.at(0)->operator[]("p"_s), 0);
+
+    size_t n = 5;
+    while(md.next())
+        n++;
+    ASSERT_EQ(n, 10);
+    ASSERT_EQ(md.current_time_str(), "20101001T200000");
+}
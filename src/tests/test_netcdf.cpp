@@ -117,4 +117,25 @@ TEST_F(NetCDFTest, access_time_offset)
     value = nc.get_var("t",time,150,150);
     ASSERT_DOUBLE_EQ(value, -11.3069305419921875);
 
-}
\ No newline at end of file
+}
+
+TEST_F(NetCDFTest, subset_grid)
+{
+    auto time = boost::posix_time::from_iso_string("20180115T060000");
+    auto full_value = nc.get_var("t",time,150,150);
+
+    nc.subset_grid(100,100,100,100);
+
+    ASSERT_EQ(100, nc.get_xsize());
+    ASSERT_EQ(100, nc.get_ysize());
+    ASSERT_EQ(100, nc.get_xstart());
+    ASSERT_EQ(100, nc.get_ystart());
+
+    // indexes are relative to the window
+    ASSERT_DOUBLE_EQ(nc.get_var("t",time,50,50), full_value);
+
+    auto slab = nc.get_var("t",time);
+    ASSERT_DOUBLE_EQ(slab[50][50], full_value);
+
+    ASSERT_ANY_THROW(nc.subset_grid(0,0,nc.get_xsize_full()+1,1));
+}
@@ -0,0 +1,216 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "logger.hpp"
+#include "readjson.hpp"
+#include "triangulation.hpp"
+#include "PBSM3D.hpp"
+#include "gtest/gtest.h"
+
+// The active-region solves against the full ones, on a diagonally dominant system built on a real mesh. Like the drift
+// and suspension systems, it couples each face to its neighbours and, with layers, each layer to the ones above and below
+class PBSM3DActiveRegionTest : public testing::Test
+{
+  protected:
+
+    virtual void SetUp()
+    {
+        logging::core::get()->set_logging_enabled(false);
+
+        pt::ptree mesh_json = read_json("meshes/granger1m.mesh");
+        domain = boost::make_shared<triangulation>();
+        domain->from_json(mesh_json);
+        ntri = domain->size_faces();
+        region_pos.assign(ntri, -1);
+    }
+
+    void assemble(size_t nlayer, viennacl::compressed_matrix<vcl_scalar_type>& M)
+    {
+        std::vector<std::map<unsigned int, vcl_scalar_type>> S(ntri * nlayer);
+        for (size_t z = 0; z < nlayer; z++)
+        {
+            for (size_t i = 0; i < ntri; i++)
+            {
+                auto face = domain->face(i);
+                size_t row = ntri * z + face->cell_local_id;
+                double diag = 1.;
+
+                for (int j = 0; j < 3; j++)
+                {
+                    auto neigh = face->neighbor(j);
+                    if (neigh == nullptr || neigh->_is_ghost)
+                        continue;
+                    S[row][ntri * z + neigh->cell_local_id] = -coupling;
+                    diag += coupling;
+                }
+                if (z > 0)
+                {
+                    S[row][row - ntri] = -coupling;
+                    diag += coupling;
+                }
+                if (z + 1 < nlayer)
+                {
+                    S[row][row + ntri] = -coupling;
+                    diag += coupling;
+                }
+                S[row][row] = diag;
+            }
+        }
+        viennacl::copy(S, M);
+    }
+
+    // a unit source in every layer of the seed faces
+    std::vector<vcl_scalar_type> source(size_t nlayer, const std::vector<char>& seed)
+    {
+        std::vector<vcl_scalar_type> rhs(ntri * nlayer, 0.);
+        for (size_t z = 0; z < nlayer; z++)
+        {
+            for (size_t i = 0; i < ntri; i++)
+            {
+                if (seed[i])
+                    rhs[ntri * z + i] = 1.;
+            }
+        }
+        return rhs;
+    }
+
+    std::vector<vcl_scalar_type> solve_full(viennacl::compressed_matrix<vcl_scalar_type>& M,
+                                            const std::vector<vcl_scalar_type>& rhs, PBSM3D::system_solver solver)
+    {
+        viennacl::vector<vcl_scalar_type> b(rhs.size());
+        viennacl::copy(rhs, b);
+        std::vector<vcl_scalar_type> x(rhs.size());
+        solver(M, b, x);
+        return x;
+    }
+
+    void expect_matches_full(size_t nlayer, PBSM3D::system_solver solver)
+    {
+        std::vector<char> seed(ntri, 0);
+        seed[100] = seed[500] = 1;
+
+        viennacl::compressed_matrix<vcl_scalar_type> M;
+        assemble(nlayer, M);
+        auto rhs = source(nlayer, seed);
+
+        auto region = PBSM3D::active_region(domain, seed, 2);
+        ASSERT_LT(region.size(), ntri);
+
+        std::vector<vcl_scalar_type> x;
+        PBSM3D::solve_active_region(M, rhs, region, nlayer, region_pos, solver, x);
+        auto full = solve_full(M, rhs, solver);
+
+        ASSERT_EQ(x.size(), full.size());
+        EXPECT_TRUE(std::all_of(region_pos.begin(), region_pos.end(), [](int p) { return p == -1; }));
+
+        double scale = *std::max_element(full.begin(), full.end());
+        ASSERT_GT(scale, 0.);
+
+        std::vector<char> in_region(ntri, 0);
+        for (auto i : region)
+            in_region[i] = 1;
+
+        for (size_t z = 0; z < nlayer; z++)
+        {
+            for (size_t i = 0; i < ntri; i++)
+            {
+                size_t idx = ntri * z + i;
+                if (in_region[i])
+                    EXPECT_NEAR(x[idx], full[idx], 1e-4 * scale) << "face " << i << " layer " << z;
+                else
+                    EXPECT_EQ(x[idx], 0.) << "face " << i << " layer " << z;
+            }
+        }
+    }
+
+    // each ring of neighbours away from a source sees about coupling times less
+    const double coupling = 0.01;
+
+    mesh domain;
+    size_t ntri;
+    std::vector<int> region_pos;
+};
+
+TEST_F(PBSM3DActiveRegionTest, RegionIsSeedPlusHalo)
+{
+    std::vector<char> seed(ntri, 0);
+    seed[100] = 1;
+
+    auto none = PBSM3D::active_region(domain, seed, 0);
+    ASSERT_EQ(none.size(), 1);
+    EXPECT_EQ(none[0], 100);
+
+    auto region = PBSM3D::active_region(domain, seed, 1);
+    EXPECT_TRUE(std::is_sorted(region.begin(), region.end()));
+    EXPECT_TRUE(std::binary_search(region.begin(), region.end(), 100));
+
+    size_t neighbours = 0;
+    auto face = domain->face(100);
+    for (int j = 0; j < 3; j++)
+    {
+        auto neigh = face->neighbor(j);
+        if (neigh == nullptr)
+            continue;
+        neighbours++;
+        EXPECT_TRUE(std::binary_search(region.begin(), region.end(), neigh->cell_local_id));
+    }
+    EXPECT_EQ(region.size(), neighbours + 1);
+
+    EXPECT_GT(PBSM3D::active_region(domain, seed, 2).size(), region.size());
+}
+
+TEST_F(PBSM3DActiveRegionTest, DriftMatchesFullSolve)
+{
+    expect_matches_full(1, &PBSM3D::solve_drift);
+}
+
+TEST_F(PBSM3DActiveRegionTest, SuspensionMatchesFullSolve)
+{
+    expect_matches_full(5, &PBSM3D::solve_suspension);
+}
+
+TEST_F(PBSM3DActiveRegionTest, EmptyRegion)
+{
+    std::vector<char> seed(ntri, 0);
+    auto region = PBSM3D::active_region(domain, seed, 2);
+    EXPECT_TRUE(region.empty());
+
+    viennacl::compressed_matrix<vcl_scalar_type> M;
+    assemble(1, M);
+    std::vector<vcl_scalar_type> rhs(ntri, 0.);
+
+    // nothing to solve, so the solver isn't called and everything is zero
+    std::vector<vcl_scalar_type> x(ntri, 1.);
+    PBSM3D::solve_active_region(M, rhs, region, 1, region_pos,
+                                [](viennacl::compressed_matrix<vcl_scalar_type>&, viennacl::vector<vcl_scalar_type>&,
+                                   std::vector<vcl_scalar_type>&) { ADD_FAILURE() << "solver called on an empty region"; },
+                                x);
+    ASSERT_EQ(x.size(), ntri);
+    EXPECT_TRUE(std::all_of(x.begin(), x.end(), [](vcl_scalar_type v) { return v == 0.; }));
+}
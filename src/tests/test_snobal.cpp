@@ -0,0 +1,226 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <cmath>
+#include <vector>
+
+#include "logger.hpp"
+#include "sno_batch.hpp"
+#include "gtest/gtest.h"
+
+using namespace snobalMacros;
+
+class SnobalTest : public testing::Test
+{
+  protected:
+
+    virtual void SetUp()
+    {
+        logging::core::get()->set_logging_enabled(false);
+
+        // from deep to no snow, the thin ones divide the timestep
+        double depths[] = {2.0, 0.8, 0.3, 0.1, 0.05, 0.02, 0.005, 0.0};
+        for(int i = 0; i < 32; i++)
+        {
+            points.push_back(make_point(depths[i % 8], 200. + 10. * i));
+        }
+    }
+
+    // same set up as snobal::init
+    sno make_point(double z_s, double rho)
+    {
+        sno s;
+        double dt = 3600.;
+
+        s.param_snow_compaction = 1;
+        s.h2o_sat = .3;
+        s.layer_count = 0;
+        s.m_s = s.m_s_0 = s.m_s_l = 0.;
+        s.max_h2o_vol = .0001;
+        s.rho = rho;
+        s.T_s = -5. + FREEZE;
+        s.T_s_0 = -8. + FREEZE;
+        s.T_s_l = -4. + FREEZE;
+        s.z_s = z_s;
+        s.KT_WETSAND = 0.08;
+        s.ro_data = 0;
+        s.max_z_s_0 = .1;
+        s.h2o_total = 0;
+        s.isothermal = 0;
+        s.z_0 = 0.001;
+        s.z_T = 2.6;
+        s.z_u = 2.96;
+        s.z_g = 0.1;
+        s.relative_hts = 1;
+        s.slope = -1;
+        s.P_a = 80000.;
+
+        s.R_n_bar = s.H_bar = s.L_v_E_bar = s.G_bar = s.M_bar = s.delta_Q_bar = 0.;
+        s.E_s_sum = s.melt_sum = s.ro_pred_sum = 0.;
+        s.time_since_out = 0;
+        s.current_time = 0;
+        s.run_no_snow = 1;
+        s.stop_no_snow = 1;
+        s.snowcover = 0;
+        s.precip_now = 0;
+
+        double time_step[] = {dt, dt, dt / 4, dt / 100};
+        double threshold[] = {20, 20, 10, 0.2};
+        for(int level = DATA_TSTEP; level <= SMALL_TSTEP; level++)
+        {
+            s.tstep_info[level].level = level;
+            s.tstep_info[level].time_step = time_step[level];
+            s.tstep_info[level].intervals = level == DATA_TSTEP ? 0 : time_step[level - 1] / time_step[level];
+            s.tstep_info[level].threshold = threshold[level];
+            s.tstep_info[level].output = 0;
+        }
+
+        s.input_rec1.T_a = -5. + FREEZE;
+        s.init_snow();
+
+        return s;
+    }
+
+    // diurnal forcing with a snowfall and a warm spell
+    void force(sno& s, int step, int point)
+    {
+        INPUT_REC in;
+        double day = std::sin(2. * M_PI * (step % 24 - 9) / 24.);
+        double t = -6. + 0.25 * point + 8. * day + (step > 30 ? 6. : 0.);
+
+        in.S_n = std::max(0., 500. * day) * 0.2;
+        in.I_lw = 240. + 2. * point;
+        in.T_a = t + FREEZE;
+        in.e_a = 611. * std::exp(17.27 * t / (t + 237.3)) * 0.7;
+        in.u = 1.0 + 0.2 * point + 2. * std::fabs(day);
+        in.T_g = -4. + FREEZE;
+        in.ro = 0.;
+
+        if(step == 0)
+            s.input_rec1 = in;
+        s.input_rec2 = in;
+
+        s.precip_now = step >= 10 && step < 14;
+        s.m_pp = s.precip_now ? 1.5 : 0.;
+        s.percent_snow = 1.;
+        s.rho_snow = 100.;
+        s.T_pp = t;
+        s.stop_no_snow = 0;
+    }
+
+    std::vector<sno> points;
+};
+
+// the batched engine has to step the points exactly as the per-point do_data_tstep does
+TEST_F(SnobalTest, BatchMatchesPerPoint)
+{
+    auto scalar = points;
+    auto batched = points;
+
+    std::vector<sno*> block;
+    for(auto& s : batched)
+        block.push_back(&s);
+
+    sno_batch batch;
+    std::vector<char> failed;
+
+    for(int step = 0; step < 48; step++)
+    {
+        for(size_t i = 0; i < points.size(); i++)
+        {
+            force(scalar[i], step, i);
+            force(batched[i], step, i);
+
+            ASSERT_NO_THROW(scalar[i].do_data_tstep());
+        }
+
+        batch.do_data_tstep(block, failed);
+
+        for(size_t i = 0; i < points.size(); i++)
+        {
+            ASSERT_FALSE(failed[i]);
+
+            auto& a = scalar[i];
+            auto& b = batched[i];
+
+            ASSERT_EQ(a.layer_count, b.layer_count) << "point " << i << " step " << step;
+            ASSERT_NEAR(a.m_s, b.m_s, 1e-9 * std::max(1., std::fabs(a.m_s)));
+            ASSERT_NEAR(a.z_s, b.z_s, 1e-9 * std::max(1., std::fabs(a.z_s)));
+            ASSERT_NEAR(a.T_s_0, b.T_s_0, 1e-9 * a.T_s_0);
+            ASSERT_NEAR(a.H, b.H, 1e-9 * std::max(1., std::fabs(a.H)));
+            ASSERT_NEAR(a.L_v_E, b.L_v_E, 1e-9 * std::max(1., std::fabs(a.L_v_E)));
+            ASSERT_NEAR(a.ro_predict, b.ro_predict, 1e-9 * std::max(1., std::fabs(a.ro_predict)));
+            ASSERT_NEAR(a.current_time, b.current_time, 1e-6);
+
+            a.input_rec1 = a.input_rec2;
+            b.input_rec1 = b.input_rec2;
+        }
+    }
+}
+
+// lane-wise hle1 against sno::hle1 over stable, neutral and unstable conditions
+TEST_F(SnobalTest, BatchHle1)
+{
+    sno& s = points[0];
+    sno_batch batch;
+
+    std::vector<double> ta, ts, u;
+    for(double t = -20; t <= 10; t += 2.5)
+        for(double dts = -10; dts <= 10; dts += 2.5)
+            for(double w = 0.2; w < 10; w *= 2)
+            {
+                ta.push_back(t + FREEZE);
+                ts.push_back(std::min(t + dts, 0.) + FREEZE);
+                u.push_back(w);
+            }
+
+    size_t n = ta.size();
+    batch.resize(n);
+    for(size_t l = 0; l < n; l++)
+    {
+        batch.press[l] = 80000.;
+        batch.ta[l] = ta[l];
+        batch.ts[l] = ts[l];
+        batch.za[l] = 2.;
+        batch.ea[l] = s.sati(ta[l]) * 0.6;
+        batch.es[l] = s.sati(ts[l]);
+        batch.zq[l] = 2.;
+        batch.u[l] = u[l];
+        batch.zu[l] = 3.;
+        batch.z0[l] = 0.001;
+    }
+    auto ea = batch.ea;
+    auto es = batch.es;
+
+    batch.hle1(n);
+
+    for(size_t l = 0; l < n; l++)
+    {
+        double h, le, e;
+        ASSERT_EQ(s.hle1(80000., ta[l], ts[l], 2., ea[l], es[l], 2., u[l], 3., 0.001, &h, &le, &e), 0);
+
+        ASSERT_NEAR(h, batch.h[l], 1e-9 * std::max(1., std::fabs(h)));
+        ASSERT_NEAR(le, batch.le[l], 1e-9 * std::max(1., std::fabs(le)));
+        ASSERT_NEAR(e, batch.e[l], 1e-12);
+    }
+}
@@ -0,0 +1,203 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <snowpack/DataClasses.h>
+#include <snowpack/snowpackCore/Solver.h>
+#include "gtest/gtest.h"
+
+// the 1e200 Snowpack adds to the diagonal to fix the temperature of a Dirichlet node
+static const double Big = 1e200;
+
+// A column of nN nodes and nN-1 two-node elements with symmetric heat-equation-like element matrices, as assembled by
+// Snowpack::compTemperatureProfile, and a Dirichlet condition on the first node
+struct column
+{
+    size_t nN;
+    std::vector<double> Se; // 2x2 per element
+    std::vector<double> rhs;
+
+    column(size_t n, unsigned int seed) : nN(n), Se(4 * (n - 1)), rhs(n)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> U(0.1, 1.0);
+        for (size_t e = 0; e < nN - 1; e++)
+        {
+            double k = U(gen), c = U(gen);
+            Se[4 * e] = k + c;
+            Se[4 * e + 1] = -k;
+            Se[4 * e + 2] = -k;
+            Se[4 * e + 3] = k + c;
+        }
+        for (auto& b : rhs)
+            b = U(gen);
+    }
+
+    void assemble(SD_MATRIX_DATA* K) const
+    {
+        ASSERT_EQ(ds_Solve(ResetMatrixData, K, 0), 0);
+        for (size_t e = 0; e < nN - 1; e++)
+        {
+            int Nodes[2] = {(int)e, (int)e + 1};
+            ASSERT_EQ(ds_AssembleMatrix(K, 2, Nodes, 2, &Se[4 * e]), 0);
+        }
+        int Dirichlet[1] = {0};
+        ASSERT_EQ(ds_AssembleMatrix(K, 1, Dirichlet, 1, &Big), 0);
+    }
+};
+
+// The tridiagonal path, with the same connectivity Snowpack defines
+static std::vector<double> solve_tridiag(const column& c)
+{
+    SD_MATRIX_DATA* K = NULL;
+    ds_Initialize(c.nN, &K);
+    for (size_t e = 0; e < c.nN - 1; e++)
+    {
+        int Nodes[2] = {(int)e, (int)e + 1};
+        ds_DefineConnectivity(K, 2, Nodes, 1, 0);
+    }
+    ds_Solve(SymbolicFactorize, K, 0);
+    EXPECT_EQ(K->State, TridiagMatrix);
+
+    c.assemble(K);
+    std::vector<double> x = c.rhs;
+    EXPECT_EQ(ds_Solve(ComputeSolution, K, x.data()), 0);
+    ds_Solve(ReleaseMatrixData, K, 0);
+    return x;
+}
+
+// The generic block solver on the same system. An extra, decoupled node connected to the first one breaks the chain so
+// the symbolic factorization keeps the block matrix; it only gets a unit diagonal and zero right hand side.
+static std::vector<double> solve_block(const column& c)
+{
+    const size_t nEq = c.nN + 1;
+    SD_MATRIX_DATA* K = NULL;
+    ds_Initialize(nEq, &K);
+    for (size_t e = 0; e < c.nN - 1; e++)
+    {
+        int Nodes[2] = {(int)e, (int)e + 1};
+        ds_DefineConnectivity(K, 2, Nodes, 1, 0);
+    }
+    int Extra[2] = {0, (int)c.nN};
+    ds_DefineConnectivity(K, 2, Extra, 1, 0);
+    ds_Solve(SymbolicFactorize, K, 0);
+    EXPECT_EQ(K->State, BlockMatrix);
+
+    c.assemble(K);
+    double one = 1.;
+    int Dummy[1] = {(int)c.nN};
+    ds_AssembleMatrix(K, 1, Dummy, 1, &one);
+
+    std::vector<double> x = c.rhs;
+    x.push_back(0.);
+    EXPECT_EQ(ds_Solve(ComputeSolution, K, x.data()), 0);
+    ds_Solve(ReleaseMatrixData, K, 0);
+
+    EXPECT_DOUBLE_EQ(x.back(), 0.);
+    x.pop_back();
+    return x;
+}
+
+static void expect_same(const std::vector<double>& x, const std::vector<double>& ref)
+{
+    ASSERT_EQ(x.size(), ref.size());
+    for (size_t i = 0; i < x.size(); i++)
+        EXPECT_NEAR(x[i], ref[i], 1e-12 * std::max(1.0, std::fabs(ref[i]))) << "node " << i;
+}
+
+TEST(SnowpackSolver, TridiagonalMatchesBlockSolver)
+{
+    for (size_t n = 2; n <= 41; n++)
+    {
+        column c(n, n);
+        expect_same(solve_tridiag(c), solve_block(c));
+    }
+}
+
+TEST(SnowpackSolver, OneLayerColumn)
+{
+    // two nodes, a single element
+    column c(2, 7);
+    auto x = solve_tridiag(c);
+    expect_same(x, solve_block(c));
+
+    // and by hand: the Dirichlet node keeps rhs/Big, the other follows from the second row
+    const double a = c.Se[0] + Big, b = c.Se[1], d = c.Se[3];
+    const double x1 = (c.rhs[1] - b * c.rhs[0] / a) / (d - b * b / a);
+    EXPECT_NEAR(x[1], x1, 1e-12 * std::fabs(x1));
+}
+
+TEST(SnowpackSolver, ResizedTridiagonalMatchesFreshSolve)
+{
+    // Snowpack keeps its matrix in SnowStation::Kt and resizes it as layers are added and removed
+    column first(20, 1);
+    SD_MATRIX_DATA* K = NULL;
+    ds_Initialize(first.nN, &K);
+    for (size_t e = 0; e < first.nN - 1; e++)
+    {
+        int Nodes[2] = {(int)e, (int)e + 1};
+        ds_DefineConnectivity(K, 2, Nodes, 1, 0);
+    }
+    ds_Solve(SymbolicFactorize, K, 0);
+
+    for (size_t n : {20, 5, 2, 33, 11})
+    {
+        column c(n, 100 + n);
+        ASSERT_EQ(ds_ResizeTridiag(n, K), 0);
+        c.assemble(K);
+        std::vector<double> x = c.rhs;
+        ASSERT_EQ(ds_Solve(ComputeSolution, K, x.data()), 0);
+        expect_same(x, solve_block(c));
+    }
+    ds_Solve(ReleaseMatrixData, K, 0);
+}
+
+TEST(SnowpackSolver, BlockMatrixIsNotResized)
+{
+    column c(5, 3);
+    SD_MATRIX_DATA* K = NULL;
+    ds_Initialize(c.nN + 1, &K);
+    int Nodes[2] = {0, 2};
+    ds_DefineConnectivity(K, 2, Nodes, 1, 0);
+    ds_Solve(SymbolicFactorize, K, 0);
+    EXPECT_EQ(ds_ResizeTridiag(c.nN, K), 1);
+    ds_Solve(ReleaseMatrixData, K, 0);
+}
+
+TEST(SnowpackSolver, AssignedStationDoesNotShareMatrix)
+{
+    SnowStation a(false, false), b(false, false);
+    ds_Initialize(3, (SD_MATRIX_DATA**)&a.Kt);
+    ds_Initialize(3, (SD_MATRIX_DATA**)&b.Kt);
+
+    // b's own matrix is released and a's is not shared, so each is freed exactly once when they go out of scope
+    b = a;
+    EXPECT_EQ(b.Kt, nullptr);
+    EXPECT_NE(a.Kt, nullptr);
+
+    SnowStation c(a);
+    EXPECT_EQ(c.Kt, nullptr);
+}
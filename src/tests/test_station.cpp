@@ -63,4 +63,85 @@ TEST_F(StationTest, Equal)
     EXPECT_TRUE(s1==s3);
 
 
-}
\ No newline at end of file
+}
+TEST_F(StationTest, OwnTable)
+{
+    station s("upper clearing", 60.52163, -135.197151, -1305, vars);
+
+    EXPECT_TRUE(s.has("t"));
+    EXPECT_FALSE(s.has("p"));
+    EXPECT_EQ(-9999, s["t"]);
+
+    s["t"_s] = 5;
+    EXPECT_EQ(5, s["t"]);
+    EXPECT_EQ(1, s.table()->size());
+
+    s.init({"p"});
+    EXPECT_TRUE(s.has("p"));
+    EXPECT_EQ(5, s["t"]);
+}
+
+TEST_F(StationTest, SharedTable)
+{
+    auto table = std::make_shared<station_table>();
+    table->init(vars, 3);
+
+    std::vector<std::shared_ptr<station>> stations;
+    for (size_t i = 0; i < 3; i++)
+        stations.push_back(std::make_shared<station>(std::to_string(i), i, i, 0, table, i));
+
+    for (size_t i = 0; i < 3; i++)
+        (*stations[i])["t"_s] = i;
+
+    // the stations are views onto the table's rows
+    auto t = table->get("t"_s);
+    for (size_t i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(i, t[i]);
+        EXPECT_EQ(i, t[stations[i]]);
+        EXPECT_EQ(-9999, table->get("rh")[*stations[i]]);
+    }
+
+    table->set_posix(boost::posix_time::time_from_string("2001-10-09 12:00:00"));
+    EXPECT_EQ(12, stations[2]->hour());
+
+    EXPECT_THROW(table->get("p"_s), module_error);
+    EXPECT_THROW(table->at("p"), forcing_error);
+
+    // adds the column
+    double* p = (*table)["p"];
+    p[1] = 2;
+    EXPECT_EQ(2, (*stations[1])["p"]);
+}
+
+TEST_F(StationTest, SelectAndDetach)
+{
+    auto table = std::make_shared<station_table>();
+    table->init(vars, 3);
+
+    std::vector<std::shared_ptr<station>> stations;
+    for (size_t i = 0; i < 3; i++)
+    {
+        stations.push_back(std::make_shared<station>(std::to_string(i), i, i, 0, table, i));
+        (*stations[i])["u"_s] = 10 + i;
+    }
+
+    auto removed = stations[1];
+    removed->detach();
+    stations.erase(stations.begin() + 1);
+    table->select(stations);
+
+    EXPECT_EQ(2, table->size());
+    EXPECT_EQ(1, stations[1]->row());
+    EXPECT_EQ(10, (*stations[0])["u"]);
+    EXPECT_EQ(12, (*stations[1])["u"]);
+
+    // keeps its values, but no longer changes with the table
+    EXPECT_EQ(11, (*removed)["u"]);
+    table->get("u")[0] = 0;
+    table->get("u")[1] = 0;
+    EXPECT_EQ(11, (*removed)["u"]);
+
+    std::vector<std::shared_ptr<station>> other{removed};
+    EXPECT_THROW(table->select(other), forcing_error);
+}
@@ -24,9 +24,13 @@
 
 
 #include "triangulation.hpp"
+#include "raster_output.hpp"
+#include "ugrid_output.hpp"
+#include "face_aggregator.hpp"
 #include "gtest/gtest.h"
 #include "readjson.hpp"
 #include <boost/property_tree/ptree.hpp>
+#include <sstream>
 
 struct test_module_data : face_info
 {
@@ -183,4 +187,351 @@ TEST_F(TriangulationTest, ModuleData)
 
 
 
-}
\ No newline at end of file
+}
+
+// Two ensemble members taking turns on the faces: each member's state comes back unchanged however often they swap,
+// and the variable lookup both share is not touched
+TEST_F(TriangulationTest, EnsembleSwapState)
+{
+    ASSERT_NO_THROW(mesh.init_module_data(modules));
+
+    auto t = [](size_t m, size_t i) { return m == 0 ? double(i) : -double(i); };
+
+    std::vector<test_module_data*> data[2];
+    for (size_t i = 0; i < mesh.size_faces(); i++)
+    {
+        auto f = mesh.face(i);
+        (*f)["t"] = t(0, i);
+        data[0].push_back(f->make_module_data<test_module_data>("module_42"));
+    }
+
+    // member 1 starts as a copy of member 0's values, with no module data of its own
+    std::vector<face_state> member;
+    mesh.copy_state(member);
+    ASSERT_EQ(member.size(), mesh.size_faces());
+
+    std::vector<std::shared_ptr<const variablestorage<double>::boophf_t>> lookup;
+    std::vector<std::string> saved;
+    for (auto& s : member)
+    {
+        ASSERT_EQ(s.module_data["module_42"], nullptr);
+
+        lookup.push_back(s.variables.lookup());
+        std::stringstream ss;
+        s.variables.lookup()->save(ss);
+        saved.push_back(ss.str());
+    }
+
+    mesh.swap_state(member);
+    for (size_t i = 0; i < mesh.size_faces(); i++)
+    {
+        auto f = mesh.face(i);
+        ASSERT_EQ((*f)["t"], t(0, i));
+        (*f)["t"] = t(1, i);
+        f->parameter("MS0") += 1;
+        data[1].push_back(f->make_module_data<test_module_data>("module_42"));
+    }
+
+    for (int swaps = 0; swaps < 5; swaps++)
+    {
+        mesh.swap_state(member);
+        size_t live = swaps % 2 == 0 ? 0 : 1;
+
+        for (size_t i = 0; i < mesh.size_faces(); i++)
+        {
+            auto f = mesh.face(i);
+            ASSERT_EQ((*f)["t"], t(live, i));
+            ASSERT_EQ(f->get_module_data<test_module_data>("module_42"), data[live][i]);
+            ASSERT_EQ(member[i].variables["t"], t(1 - live, i));
+            ASSERT_EQ(member[i].module_data["module_42"], data[1 - live][i]);
+            ASSERT_DOUBLE_EQ(member[i].parameters["MS0"] - f->parameter("MS0"), live == 0 ? 1 : -1);
+
+            ASSERT_EQ(member[i].variables.lookup(), lookup[i]);
+        }
+    }
+
+    // member 0 is back on the faces and the lookups are as they were built
+    for (size_t i = 0; i < mesh.size_faces(); i++)
+    {
+        std::stringstream ss;
+        lookup[i]->save(ss);
+        ASSERT_EQ(ss.str(), saved[i]);
+    }
+    ASSERT_DOUBLE_EQ(mesh.face(0)->parameter("MS0"), 0.972731475402661);
+
+    std::vector<face_state> wrong_size(1);
+    ASSERT_THROW(mesh.swap_state(wrong_size), mesh_error);
+}
+
+TEST_F(TriangulationTest, Geometry)
+{
+    auto& g = mesh.geometry();
+    ASSERT_EQ(mesh.size_faces(), g.x.size());
+
+    for (size_t i = 0; i < mesh.size_faces(); i++)
+    {
+        auto f = mesh.face(i);
+        auto c = CGAL::centroid(f->vertex(0)->point(), f->vertex(1)->point(), f->vertex(2)->point());
+
+        ASSERT_DOUBLE_EQ(c.x(), f->get_x());
+        ASSERT_DOUBLE_EQ(c.y(), f->get_y());
+        ASSERT_DOUBLE_EQ(c.z(), f->center().z());
+        ASSERT_GT(f->get_area(), 0);
+
+        for (int j = 0; j < 3; j++)
+            ASSERT_DOUBLE_EQ(CGAL::sqrt(f->edge(j).squared_length()), f->edge_length(j));
+    }
+
+    // raise one vertex, only the faces using it change
+    auto f = mesh.face(0);
+    auto v = f->vertex(0);
+    auto p = v->point();
+
+    std::vector<double> z(mesh.size_faces());
+    for (size_t i = 0; i < mesh.size_faces(); i++)
+        z[i] = mesh.face(i)->get_z();
+
+    v->set_point(Point_3(p.x(), p.y(), p.z() + 30));
+    mesh.update_geometry({v->get_id()});
+
+    EXPECT_NEAR(z[0] + 10, f->get_z(), 1e-6);
+
+    auto n = CGAL::unit_normal(f->vertex(0)->point(), f->vertex(1)->point(), f->vertex(2)->point());
+    EXPECT_DOUBLE_EQ(n[2], f->normal()[2]);
+    EXPECT_NEAR(acos(n[2]), g.raw_slope[0], 1e-12);
+
+    for (size_t i = 0; i < mesh.size_faces(); i++)
+    {
+        auto fi = mesh.face(i);
+        bool uses = fi->vertex(0) == v || fi->vertex(1) == v || fi->vertex(2) == v;
+        if (!uses)
+            ASSERT_EQ(z[i], fi->get_z());
+    }
+}
+
+TEST_F(TriangulationTest, Operators)
+{
+    auto& ops = mesh.operators();
+    size_t n = mesh.size_faces();
+    ASSERT_EQ(n, ops.smoothing.rows());
+
+    std::vector<double> phi(n);
+    for (size_t i = 0; i < n; i++)
+        phi[i] = 3 * mesh.face(i)->get_x() - 2 * mesh.face(i)->get_y() + 5;
+
+    // smoothing is the per-face thin plate spline of the neighbours
+    std::vector<double> smoothed;
+    ops.smoothing.apply(phi, smoothed);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        auto f = mesh.face(i);
+        std::vector<boost::tuple<double, double, double> > u;
+        for (int j = 0; j < 3; j++)
+        {
+            auto neigh = f->neighbor(j);
+            if (neigh != nullptr && !neigh->_is_ghost)
+                u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(), phi[neigh->cell_local_id]));
+        }
+
+        double expected = phi[i];
+        if (u.size() > 0)
+        {
+            interpolation interp(interp_alg::tpspline, 3, {{"reuse_LU", "true"}});
+            auto query = boost::make_tuple(f->get_x(), f->get_y(), f->get_z());
+            expected = interp(u, query);
+        }
+        ASSERT_NEAR(expected, smoothed[i], 1e-8);
+    }
+
+    // the gradient of a plane is exact where there are at least two neighbours
+    std::vector<double> gx, gy;
+    ops.grad_x.apply(phi, gx);
+    ops.grad_y.apply(phi, gy);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (ops.grad_x.ptr[i + 1] - ops.grad_x.ptr[i] < 3)
+            continue;
+        ASSERT_NEAR(3, gx[i], 1e-6);
+        ASSERT_NEAR(-2, gy[i], 1e-6);
+    }
+
+    // no flux for a constant field
+    std::vector<double> c(n, 1.), lap;
+    ops.laplacian.apply(c, lap);
+    for (size_t i = 0; i < n; i++)
+        ASSERT_NEAR(0, lap[i], 1e-12);
+}
+
+TEST_F(TriangulationTest, RasterOutput)
+{
+    auto m = boost::make_shared<triangulation>();
+    m->from_json(mesh_json);
+    m->init_timeseries(variables);
+
+    auto bbox = m->bounding_box();
+    double resolution = (bbox.xmax() - bbox.xmin()) / 100.;
+
+    raster_output r(m, "raster_test", {"t"}, raster_output::format::tiff, resolution);
+    ASSERT_GT(r.faces().size(), 0u);
+
+    // each pixel is the face its centre is in
+    std::vector<float> id(r.faces().size());
+    for (size_t i = 0; i < id.size(); i++)
+        id[i] = i;
+
+    std::vector<float> out(r.cols() * r.rows());
+    r.rasterise(id.data(), out.data());
+
+    size_t covered = 0;
+    for (size_t j = 0; j < r.rows(); j++)
+    {
+        for (size_t i = 0; i < r.cols(); i++)
+        {
+            float v = out[j * r.cols() + i];
+            auto face = m->locate_face(r.x(i), r.y(j));
+
+            if (v == raster_output::nodata)
+            {
+                ASSERT_EQ(face, nullptr);
+                continue;
+            }
+
+            ASSERT_EQ(face, r.faces().at(static_cast<size_t>(v)));
+            covered++;
+        }
+    }
+    ASSERT_GT(covered, 0u);
+
+    // aggregated pixels are means of the faces under them
+    raster_output coarse(m, "raster_test", {"t"}, raster_output::format::tiff, resolution, 4);
+    ASSERT_DOUBLE_EQ(4 * resolution, coarse.x(1) - coarse.x(0));
+
+    std::vector<float> constant(coarse.faces().size(), 2.5f);
+    constant.at(0) = raster_output::nodata; // missing values are skipped
+
+    out.resize(coarse.cols() * coarse.rows());
+    coarse.rasterise(constant.data(), out.data());
+
+    covered = 0;
+    for (auto v : out)
+    {
+        if (v != raster_output::nodata)
+        {
+            ASSERT_FLOAT_EQ(2.5f, v);
+            covered++;
+        }
+    }
+    ASSERT_GT(covered, 0u);
+}
+
+TEST_F(TriangulationTest, UgridOutput)
+{
+    auto m = boost::make_shared<triangulation>();
+    m->from_json(mesh_json);
+    m->init_timeseries(variables);
+
+    size_t steps = 5;
+    {
+        ugrid_output out(m, "ugrid_test.nc", {"t", "u"}, true, 2);
+        for (size_t k = 0; k < steps; k++)
+        {
+            for (size_t i = 0; i < m->size_faces(); i++)
+            {
+                (*m->face(i))["t"] = k * 1000. + m->face(i)->cell_global_id;
+                (*m->face(i))["u"] = i == 0 ? -9999. : 1.;
+            }
+            out.write(1000 + k * 3600);
+        }
+        ASSERT_EQ(2u, out.chunk_time());
+        out.finish();
+    }
+
+    netCDF::NcFile nc("ugrid_test.nc", netCDF::NcFile::read);
+    ASSERT_EQ(steps, nc.getDim("time").getSize());
+    ASSERT_EQ(m->size_faces(), nc.getDim("nMesh2_face").getSize());
+    ASSERT_EQ(m->size_vertex(), nc.getDim("nMesh2_node").getSize());
+    ASSERT_FALSE(nc.getVar("param_MS0").isNull());
+
+    // the last (partial) chunk was flushed, faces are in global id order
+    std::vector<double> t(m->size_faces());
+    nc.getVar("t").getVar({steps - 1, 0}, {1, t.size()}, t.data());
+    for (size_t i = 0; i < t.size(); i++)
+        ASSERT_DOUBLE_EQ((steps - 1) * 1000. + i, t[i]);
+
+    size_t id = m->face(0)->cell_global_id;
+
+    double u;
+    nc.getVar("u").getVar({0, id}, {1, 1}, &u);
+    ASSERT_TRUE(std::isnan(u));
+
+    long long time;
+    nc.getVar("time").getVar({steps - 1}, {1}, &time);
+    ASSERT_EQ(1000 + (steps - 1) * 3600, static_cast<size_t>(time));
+
+    std::vector<int> nodes(3);
+    nc.getVar("Mesh2_face_nodes").getVar({id, 0}, {1, 3}, nodes.data());
+    for (int k = 0; k < 3; k++)
+        ASSERT_EQ(m->face(0)->vertex(k)->get_id(), static_cast<size_t>(nodes[k]));
+}
+
+TEST_F(TriangulationTest, Aggregate)
+{
+    auto m = boost::make_shared<triangulation>();
+    m->from_json(mesh_json);
+
+    std::vector<face_aggregator::statistic> stats = {face_aggregator::statistic::mean, face_aggregator::statistic::min,
+                                                     face_aggregator::statistic::max, face_aggregator::statistic::sum,
+                                                     face_aggregator::statistic::count};
+    face_aggregator agg(m, {"t"}, stats, face_aggregator::window::daily);
+
+    std::set<std::string> vars = {"t"};
+    vars.insert(agg.output_variables().begin(), agg.output_variables().end());
+    m->init_timeseries(vars);
+
+    boost::posix_time::ptime start(boost::gregorian::date(2020, 1, 31));
+    boost::posix_time::hours dt(1);
+
+    // hourly steps t = 0..23 with a missing value at 5
+    for (int h = 0; h < 24; h++)
+    {
+        for (size_t i = 0; i < m->size_faces(); i++)
+            (*m->face(i))["t"] = h == 5 ? -9999. : h + static_cast<double>(i);
+
+        auto time = start + dt * h;
+        agg.update(time);
+        ASSERT_EQ(h == 23, agg.window_complete(time, time + dt));
+    }
+
+    ASSERT_EQ(24u, agg.steps());
+    ASSERT_EQ(start, agg.emit());
+    ASSERT_EQ(0u, agg.steps());
+
+    for (size_t i = 0; i < m->size_faces(); i++)
+    {
+        auto f = m->face(i);
+        ASSERT_EQ(23., (*f)["t_count"]);
+        ASSERT_DOUBLE_EQ((276. - 5) + 23. * i, (*f)["t_sum"]);
+        ASSERT_DOUBLE_EQ(((276. - 5) + 23. * i) / 23., (*f)["t_mean"]);
+        ASSERT_EQ(0. + i, (*f)["t_min"]);
+        ASSERT_EQ(23. + i, (*f)["t_max"]);
+    }
+
+    // an empty window is missing
+    for (size_t i = 0; i < m->size_faces(); i++)
+        (*m->face(i))["t"] = -9999.;
+    face_aggregator monthly(m, {"t"}, stats, face_aggregator::window::monthly);
+    monthly.update(start);
+    ASSERT_TRUE(monthly.window_complete(start + boost::posix_time::hours(23), start + boost::posix_time::hours(24)));
+    ASSERT_FALSE(monthly.window_complete(start, start + boost::posix_time::hours(1)));
+    monthly.emit();
+    ASSERT_EQ(-9999., (*m->face(0))["t_mean"]);
+    ASSERT_EQ(0., (*m->face(0))["t_count"]);
+
+    size_t n;
+    ASSERT_EQ(face_aggregator::window::timesteps, face_aggregator::to_window("6", n));
+    ASSERT_EQ(6u, n);
+    ASSERT_THROW(face_aggregator::to_window("weekly", n), config_error);
+    ASSERT_THROW(face_aggregator::to_statistic("median"), config_error);
+}
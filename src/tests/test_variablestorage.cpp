@@ -21,6 +21,8 @@
 // <http://www.gnu.org/licenses/>.
 //
 
+#include <sstream>
+
 #include "variablestorage.hpp"
 #include "gtest/gtest.h"
 
@@ -142,4 +144,60 @@ TEST_F(VariableStorageTest, uninit)
 {
     variablestorage<double> v;
     ASSERT_ANY_THROW(v["t"] = 1);
-}
\ No newline at end of file
+}
+TEST_F(VariableStorageTest, copyAndSwap)
+{
+    variablestorage<double> v (variables);
+    v["t"] = 1;
+
+    variablestorage<double> copy(v);
+    copy["t"] = 2;
+    ASSERT_EQ(v["t"] , 1);
+    ASSERT_EQ(copy["t"] , 2);
+
+    variablestorage<double> other;
+    other.swap(copy);
+    ASSERT_EQ(copy.size() , 0);
+    ASSERT_FALSE(copy.has("t"));
+    ASSERT_EQ(other["t"] , 2);
+
+    copy = v;
+    ASSERT_EQ(copy["t"] , 1);
+}
+
+// two ensemble members exchanging their values through one storage, as face::swap_state does
+TEST_F(VariableStorageTest, membersSwapRoundTrip)
+{
+    variablestorage<double> live (variables);
+    live["t"] = 1;
+    live["rh"] = 50;
+
+    variablestorage<double> member(live);
+    member["t"] = -1;
+    member["rh"] = 90;
+
+    auto lookup = live.lookup();
+    ASSERT_NE(lookup, nullptr);
+    ASSERT_EQ(member.lookup(), lookup);
+
+    std::stringstream before;
+    lookup->save(before);
+
+    for (int i = 0; i < 4; i++)
+    {
+        live.swap(member);
+        bool swapped = i % 2 == 0;
+        ASSERT_EQ(live["t"] , swapped ? -1 : 1);
+        ASSERT_EQ(live["rh"] , swapped ? 90 : 50);
+        ASSERT_EQ(member["t"] , swapped ? 1 : -1);
+        ASSERT_EQ(member["rh"] , swapped ? 50 : 90);
+        ASSERT_EQ(live.lookup(), lookup);
+        ASSERT_EQ(member.lookup(), lookup);
+    }
+
+    // the shared lookup is untouched by the copies and swaps
+    std::stringstream after;
+    lookup->save(after);
+    ASSERT_EQ(before.str(), after.str());
+    ASSERT_EQ(live.variables(), member.variables());
+}
@@ -28,18 +28,32 @@
 netcdf::netcdf()
 {
     _is_open = false;
+    xgrid = ygrid = 0;
+    _xstart = _ystart = 0;
+    _xgrid_full = _ygrid_full = 0;
 }
 netcdf::~netcdf()
 {
+    // close here, under the lock, instead of in the NcFile dtor
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
+    if(!_data.isNull())
+        _data.close();
+}
 
+std::recursive_mutex& netcdf::library_mutex()
+{
+    static std::recursive_mutex m;
+    return m;
 }
  void netcdf::add_dim1D(const std::string& var, size_t length)
  {
+     std::lock_guard<std::recursive_mutex> lock(library_mutex());
      auto nTri = _data.addDim(var, length);
      _dimVector.push_back(nTri);
  }
 void netcdf::create_variable1D( const std::string& var, size_t length)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     //only create the dim and variables once
     try
     {
@@ -70,6 +84,7 @@ netCDF::NcFile& netcdf::get_ncfile()
 
 void netcdf::put_var1D(const std::string& var, size_t index, double value)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     auto vars = _data.getVars();
 
     auto itr = vars.find(var);
@@ -93,15 +108,18 @@ void netcdf::put_var1D(const std::string& var, size_t index, double value)
 
 void netcdf::create(const std::string& file)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     _data.open(file.c_str(), netCDF::NcFile::replace);
 
 }
 void netcdf::open(const std::string &file)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     _data.open(file.c_str(), netCDF::NcFile::read);
 }
 void netcdf::open_GEM(const std::string &file)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     _data.open(file.c_str(), netCDF::NcFile::read);
 
     //gem netcdf files have 1 coordinate, datetime
@@ -218,11 +236,53 @@ void netcdf::open_GEM(const std::string &file)
             ygrid = itr.second.getSize();
     }
 
+    // until told otherwise, we read the entire grid
+    _xgrid_full = xgrid;
+    _ygrid_full = ygrid;
+    _xstart = _ystart = 0;
+
     LOG_DEBUG << "NetCDF grid is " << xgrid << " (x) by " << ygrid << " (y)";
 
 
 }
 
+void netcdf::subset_grid(size_t xstart, size_t ystart, size_t nx, size_t ny)
+{
+    if( nx == 0 || ny == 0 ||
+        xstart + nx > _xgrid_full ||
+        ystart + ny > _ygrid_full)
+    {
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("NetCDF subset window [" + std::to_string(ystart) + ":" +
+                                                             std::to_string(ystart + ny) + ", " + std::to_string(xstart) + ":" +
+                                                             std::to_string(xstart + nx) + "] is outside of the grid."));
+    }
+
+    _xstart = xstart;
+    _ystart = ystart;
+    xgrid = nx;
+    ygrid = ny;
+
+    LOG_DEBUG << "NetCDF grid subset to [" << _ystart << ":" << _ystart + ygrid << ", " << _xstart << ":" << _xstart + xgrid << "]";
+}
+
+size_t netcdf::get_xstart()
+{
+    return _xstart;
+}
+size_t netcdf::get_ystart()
+{
+    return _ystart;
+}
+
+size_t netcdf::get_xsize_full()
+{
+    return _xgrid_full;
+}
+size_t netcdf::get_ysize_full()
+{
+    return _ygrid_full;
+}
+
 size_t netcdf::get_ntimesteps()
 {
     return _datetime_length;
@@ -249,6 +309,7 @@ netcdf::data netcdf::get_z()
 
 std::set<std::string> netcdf::get_variable_names()
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     if(_variable_names.empty())
     {
         auto vars = _data.getVars();
@@ -271,6 +332,7 @@ std::set<std::string> netcdf::get_variable_names()
 
 std::set<std::string> netcdf::get_coordinate_names()
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::set<std::string> names;
     auto vars = _data.getCoordVars();
 
@@ -286,6 +348,7 @@ std::set<std::string> netcdf::get_coordinate_names()
 
 double netcdf::get_var1D(std::string var, size_t index)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
 
     startp.push_back(index);
@@ -303,10 +366,11 @@ double netcdf::get_var1D(std::string var, size_t index)
 
 netcdf::data netcdf::get_var2D(std::string var)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
 
-    startp.push_back(0);
-    startp.push_back(0);
+    startp.push_back(_ystart);
+    startp.push_back(_xstart);
 
     countp.push_back(ygrid);
     countp.push_back(xgrid);
@@ -322,10 +386,11 @@ netcdf::data netcdf::get_var2D(std::string var)
 
 double netcdf::get_var2D(std::string var, size_t x, size_t y)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
 
-    startp.push_back(y);
-    startp.push_back(x);
+    startp.push_back(_ystart + y);
+    startp.push_back(_xstart + x);
 
     countp.push_back(1);
     countp.push_back(1);
@@ -375,10 +440,11 @@ double netcdf::get_z(size_t x, size_t y)
 
 double netcdf::get_var(std::string var, size_t timestep, size_t x, size_t y)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
     startp.push_back(0);
-    startp.push_back(y);
-    startp.push_back(x);
+    startp.push_back(_ystart + y);
+    startp.push_back(_xstart + x);
 
     countp.push_back(1);
     countp.push_back(1);
@@ -392,20 +458,18 @@ double netcdf::get_var(std::string var, size_t timestep, size_t x, size_t y)
     double val=-9999;
 
     auto itr = vars.find(var);
-#pragma omp critical
-    {
-        itr->second.getVar(startp, countp, &val);
-    }
+    itr->second.getVar(startp, countp, &val);
 
     return val;
 }
 
 netcdf::data netcdf::get_var(std::string var, size_t timestep)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
     startp.push_back(0);
-    startp.push_back(0);
-    startp.push_back(0);
+    startp.push_back(_ystart);
+    startp.push_back(_xstart);
 
     countp.push_back(1);
     countp.push_back(ygrid);
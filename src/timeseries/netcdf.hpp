@@ -28,6 +28,7 @@
 #include <boost/date_time/posix_time/posix_time.hpp> // for boost::posix
 #include <netcdf>
 #include <string>
+#include <mutex>
 
 #include "logger.hpp"
 #include "exception.hpp"
@@ -55,6 +56,28 @@ public:
     void open(const std::string &file);
 
     void create(const std::string& file);
+
+    /**
+     * Restricts all subsequent grid reads to the [ystart:ystart+ny, xstart:xstart+nx] hyperslab of the file.
+     * After this call, all x,y indexes and grid sizes are relative to this window.
+     * @param xstart x index of the first column in the window
+     * @param ystart y index of the first row in the window
+     * @param nx number of columns in the window
+     * @param ny number of rows in the window
+     */
+    void subset_grid(size_t xstart, size_t ystart, size_t nx, size_t ny);
+
+    /// x offset of the current window into the full file grid
+    size_t get_xstart();
+    /// y offset of the current window into the full file grid
+    size_t get_ystart();
+
+    /// Number of x cells in the full file grid, regardless of any subsetting
+    size_t get_xsize_full();
+    /// Number of y cells in the full file grid, regardless of any subsetting
+    size_t get_ysize_full();
+
+    // size of the current (potentially subset) grid
     size_t get_xsize();
     size_t get_ysize();
     size_t get_ntimesteps();
@@ -90,12 +113,22 @@ public:
     double get_var2D(std::string var, size_t x, size_t y);
 
     netCDF::NcFile& get_ncfile();
+
+    /**
+     * The netCDF/HDF5 libraries are not thread safe, even across different files. All netcdf calls in this class
+     * are serialized on this mutex so that files may be read from background threads (e.g., forcing prefetch).
+     * Callers that use get_ncfile() directly while other threads might be reading must also hold this.
+     * @return
+     */
+    static std::recursive_mutex& library_mutex();
 private:
 
     netCDF::NcFile _data; // main netcdf file
     std::string _datetime_field; // name of the datetime field, the unlimited dimension
     std::string _lat, _lon; //name of lat and long fields
-    size_t xgrid, ygrid;
+    size_t xgrid, ygrid; // size of the grid window that is read
+    size_t _xstart, _ystart; // offset of the grid window into the full grid
+    size_t _xgrid_full, _ygrid_full; // size of the full grid in the file
 
     std::set<std::string> _variable_names; //set of variables this nc file provides
 
@@ -32,6 +32,7 @@
 #include "logger.hpp"
 #include "exception.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <set>
@@ -49,6 +50,14 @@ class variablestorage
     variablestorage(std::set<std::string>& variables);
     ~variablestorage();
 
+    /// Copies the values. The variable lookup is immutable once built and is shared with the copy.
+    variablestorage(const variablestorage& other);
+    variablestorage& operator=(const variablestorage& other);
+
+    /// Exchanges the variables and values with other
+    /// @param other
+    void swap(variablestorage& other);
+
     /// Get and set the variable to a specific value. Use _s for compile-time hash.
     /// Throws if not found or init/ctor not yet called.
     /// @param variable
@@ -82,8 +91,6 @@ class variablestorage
     /// @return
     size_t size();
 
-  private:
-    const uint64_t seed = 2654435761U;
     template <typename Item> class wyandFunctor
     {
       public:
@@ -96,6 +103,13 @@ class variablestorage
     typedef wyandFunctor<uint64_t> hasher_t;
     typedef boomphf::mphf< uint64_t, hasher_t  > boophf_t;
 
+    /// The perfect hash used to find the variables. It is shared by copies and never modified once built.
+    /// @return nullptr if not initialized
+    std::shared_ptr<const boophf_t> lookup() const;
+
+  private:
+    const uint64_t seed = 2654435761U;
+
     // sets the default value of newly created variables
     // needs to be like this because of the template and do specialization
     T get_default_value();
@@ -113,7 +127,7 @@ class variablestorage
     // https://github.com/rizkg/BBHash/issues/12
 
     // perfect hashfn + variable storage
-    std::unique_ptr<boophf_t> _variable_bphf;
+    std::shared_ptr<boophf_t> _variable_bphf;
     std::vector<var> _variables;
 
     // Total number of variables stored
@@ -135,6 +149,37 @@ variablestorage<T>::~variablestorage()
 
 }
 
+template<typename T>
+variablestorage<T>::variablestorage(const variablestorage& other)
+    : _variable_bphf(other._variable_bphf), _variables(other._variables), _size(other._size)
+{
+
+}
+
+template<typename T>
+variablestorage<T>& variablestorage<T>::operator=(const variablestorage& other)
+{
+    _variable_bphf = other._variable_bphf;
+    _variables = other._variables;
+    _size = other._size;
+
+    return *this;
+}
+
+template<typename T>
+std::shared_ptr<const typename variablestorage<T>::boophf_t> variablestorage<T>::lookup() const
+{
+    return _variable_bphf;
+}
+
+template<typename T>
+void variablestorage<T>::swap(variablestorage& other)
+{
+    _variable_bphf.swap(other._variable_bphf);
+    _variables.swap(other._variables);
+    std::swap(_size, other._size);
+}
+
 template<typename T>
 T& variablestorage<T>::operator[](const uint64_t& hash)
 {
@@ -182,7 +227,8 @@ bool variablestorage<T>::has(const uint64_t& hash)
 
     // did the table return garabage?
     //mphf might return an index, but it isn't actually what we want. double check the hash
-    if(_variables[idx].xxhash != hash)
+    if(idx >= _size ||
+       _variables[idx].xxhash != hash)
         return false;
 
     return true;
@@ -227,8 +273,7 @@ void variablestorage<T>::init(std::set<std::string>& variables)
         hash_vec.push_back(hash);
     }
 
-    _variable_bphf = std::unique_ptr<boomphf::mphf<u_int64_t,hasher_t>>(
-        new boomphf::mphf<u_int64_t,hasher_t>(hash_vec.size(),hash_vec,1,2,false,false));
+    _variable_bphf = std::make_shared<boomphf::mphf<u_int64_t,hasher_t>>(hash_vec.size(),hash_vec,1,2,false,false);
 
     _variables.resize(variables.size());
     for(auto& v : variables)